@@ -1 +1 @@
-MATCH (a:Crate)-[:USES]->(b) WHERE a.name = 'nervusdb-cli' RETURN b.name LIMIT 10
+MATCH (a)-[:USES]->(b:Crate {name: 'nervusdb'}) RETURN a.name LIMIT 10
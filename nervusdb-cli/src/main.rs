@@ -1,6 +1,7 @@
 use clap::{Parser, Subcommand, ValueEnum};
 use nervusdb::Db;
 use nervusdb::GraphSnapshot;
+use nervusdb::GraphStatistics;
 use nervusdb::admin::{FsckIssue, FsckIssueKind, FsckOptions, FsckRepairKind, FsckReport};
 use nervusdb::query::Value as V2Value;
 use nervusdb::query::prepare;
@@ -34,6 +35,7 @@ enum V2Commands {
     Write(V2WriteArgs),
     Repl(V2ReplArgs),
     Fsck(V2FsckArgs),
+    Analyze(V2AnalyzeArgs),
 }
 
 #[derive(Parser)]
@@ -58,6 +60,17 @@ struct V2FsckArgs {
     json: bool,
 }
 
+#[derive(Parser)]
+struct V2AnalyzeArgs {
+    /// Local database directory
+    #[arg(long)]
+    db: PathBuf,
+
+    /// Emit the statistics as JSON
+    #[arg(long)]
+    json: bool,
+}
+
 #[derive(Clone, Copy, Debug, ValueEnum)]
 enum OutputFormat {
     Ndjson,
@@ -277,7 +290,7 @@ fn write_fsck_report(report: &FsckReport, json: bool) -> Result<(), String> {
 
     println!("fsck: {}", if report.ok { "ok" } else { "failed" });
     println!(
-        "checked: nodes={} node_labels={} label_nodes={} node_props={} idx_node_props={} adj_out={} adj_in={} edge_props={}",
+        "checked: nodes={} node_labels={} label_nodes={} node_props={} idx_node_props={} adj_out={} adj_in={} adj_deltas={} edge_props={} idx_edge_props={} counters={}",
         report.checked.nodes,
         report.checked.node_labels,
         report.checked.label_nodes,
@@ -285,7 +298,10 @@ fn write_fsck_report(report: &FsckReport, json: bool) -> Result<(), String> {
         report.checked.idx_node_props,
         report.checked.adj_out,
         report.checked.adj_in,
-        report.checked.edge_props
+        report.checked.adj_deltas,
+        report.checked.edge_props,
+        report.checked.idx_edge_props,
+        report.checked.counters
     );
     println!("issues: {}", report.issues.len());
     for issue in &report.issues {
@@ -303,6 +319,65 @@ fn write_fsck_report(report: &FsckReport, json: bool) -> Result<(), String> {
     Ok(())
 }
 
+fn run_v2_analyze(args: V2AnalyzeArgs) -> Result<(), String> {
+    let db = Db::open(&args.db).map_err(|e| e.to_string())?;
+    let statistics = db.analyze().map_err(|e| e.to_string())?;
+    db.close().map_err(|e| e.to_string())?;
+    if args.json {
+        serde_json::to_writer_pretty(std::io::stdout().lock(), &statistics)
+            .map_err(|e| e.to_string())?;
+        println!();
+        return Ok(());
+    }
+    for line in format_statistics(&statistics) {
+        println!("{line}");
+    }
+    Ok(())
+}
+
+fn format_statistics(statistics: &GraphStatistics) -> Vec<String> {
+    let mut lines = vec![format!("analyzed_at: {}", statistics.analyzed_at)];
+    lines.push(format!("labels: {}", statistics.labels.len()));
+    for label in &statistics.labels {
+        lines.push(format!("- {} nodes={}", label.label, label.nodes));
+    }
+    lines.push(format!("rel_types: {}", statistics.rel_types.len()));
+    for rel in &statistics.rel_types {
+        lines.push(format!("- {} edges={}", rel.rel_type, rel.edges));
+    }
+    lines.push(format!("degrees: {}", statistics.degrees.len()));
+    for degree in &statistics.degrees {
+        let buckets = degree
+            .nodes_by_degree
+            .iter()
+            .map(u64::to_string)
+            .collect::<Vec<_>>()
+            .join(",");
+        lines.push(format!(
+            "- {} {} {} edges={} nodes_by_degree=[{buckets}]",
+            degree.label,
+            match degree.direction {
+                nervusdb::DegreeDirection::Outgoing => "out",
+                nervusdb::DegreeDirection::Incoming => "in",
+            },
+            degree.rel_type,
+            degree.edges
+        ));
+    }
+    lines.push(format!("properties: {}", statistics.properties.len()));
+    for property in &statistics.properties {
+        lines.push(format!(
+            "- {}.{} values={} distinct={} most_common={}",
+            property.label,
+            property.key,
+            property.values,
+            property.distinct,
+            property.most_common.len()
+        ));
+    }
+    lines
+}
+
 fn format_fsck_issue(issue: &FsckIssue) -> String {
     let mut out = format_fsck_issue_kind(issue.kind).to_string();
     if let Some(node) = issue.node {
@@ -329,6 +404,8 @@ fn format_fsck_issue_kind(kind: FsckIssueKind) -> &'static str {
         FsckIssueKind::StaleLabelNodeIndex => "stale_label_node_index",
         FsckIssueKind::MissingNodePropertyIndex => "missing_node_property_index",
         FsckIssueKind::StaleNodePropertyIndex => "stale_node_property_index",
+        FsckIssueKind::MissingEdgePropertyIndex => "missing_edge_property_index",
+        FsckIssueKind::StaleEdgePropertyIndex => "stale_edge_property_index",
         FsckIssueKind::AdjacencyMismatch => "adjacency_mismatch",
         FsckIssueKind::OrphanEdgeProperty => "orphan_edge_property",
         FsckIssueKind::OrphanNodeProperty => "orphan_node_property",
@@ -340,7 +417,13 @@ fn format_fsck_issue_kind(kind: FsckIssueKind) -> &'static str {
         FsckIssueKind::MalformedNodePropertyIndex => "malformed_node_property_index",
         FsckIssueKind::MalformedAdjOut => "malformed_adj_out",
         FsckIssueKind::MalformedAdjIn => "malformed_adj_in",
+        FsckIssueKind::MalformedAdjDelta => "malformed_adj_delta",
         FsckIssueKind::MalformedEdgeProperty => "malformed_edge_property",
+        FsckIssueKind::MalformedEdgePropertyIndex => "malformed_edge_property_index",
+        FsckIssueKind::LabelCountMismatch => "label_count_mismatch",
+        FsckIssueKind::RelCountMismatch => "rel_count_mismatch",
+        FsckIssueKind::MalformedCounter => "malformed_counter",
+        FsckIssueKind::DuplicateUniqueValue => "duplicate_unique_value",
     }
 }
 
@@ -348,6 +431,8 @@ fn format_fsck_repair_kind(kind: FsckRepairKind) -> &'static str {
     match kind {
         FsckRepairKind::RebuiltLabelNodes => "rebuilt_label_nodes",
         FsckRepairKind::RebuiltNodePropertyIndex => "rebuilt_node_property_index",
+        FsckRepairKind::RebuiltCounters => "rebuilt_counters",
+        FsckRepairKind::RebuiltEdgePropertyIndex => "rebuilt_edge_property_index",
     }
 }
 
@@ -366,6 +451,7 @@ fn main() {
             V2Commands::Write(args) => CliExit::Command(run_v2_write(args)),
             V2Commands::Repl(args) => CliExit::Command(repl::run_repl(&args.db)),
             V2Commands::Fsck(args) => run_v2_fsck(args),
+            V2Commands::Analyze(args) => CliExit::Command(run_v2_analyze(args)),
         },
     };
 
@@ -409,4 +495,25 @@ mod tests {
             "rebuilt_node_property_index"
         );
     }
+
+    #[test]
+    fn analyze_text_lists_degrees_by_bucket() {
+        let statistics = GraphStatistics {
+            analyzed_at: 7,
+            degrees: vec![nervusdb::DegreeStatistics {
+                label: "Crate".to_string(),
+                rel_type: "DEPENDS_ON".to_string(),
+                direction: nervusdb::DegreeDirection::Outgoing,
+                edges: 5,
+                nodes_by_degree: vec![1, 1, 2],
+            }],
+            ..GraphStatistics::default()
+        };
+
+        let lines = format_statistics(&statistics);
+        assert_eq!(lines[0], "analyzed_at: 7");
+        assert!(
+            lines.contains(&"- Crate out DEPENDS_ON edges=5 nodes_by_degree=[1,1,2]".to_string())
+        );
+    }
 }
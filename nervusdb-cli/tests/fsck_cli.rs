@@ -58,7 +58,8 @@ fn cli_fsck_repair_rebuilds_derived_property_index() {
         let graph_data = db
             .keyspace("graph_data", KeyspaceCreateOptions::default)
             .unwrap();
-        let key = node_prop_index_key(1, "name", &encoded_string("Alice"), 0);
+        // "name" is the first interned property key, so its id is 0.
+        let key = node_prop_index_key(1, 0, &ordered_string("Alice"), 0);
         let mut batch = db.batch().durability(Some(PersistMode::SyncAll));
         batch.remove(&graph_data, key);
         batch.commit().unwrap();
@@ -101,24 +102,25 @@ fn stderr(output: &std::process::Output) -> String {
     String::from_utf8_lossy(&output.stderr).into_owned()
 }
 
-fn node_prop_index_key(label: u32, key: &str, encoded_value: &[u8], node: u32) -> Vec<u8> {
-    let key_len = u16::try_from(key.len()).unwrap();
-    let value_len = u32::try_from(encoded_value.len()).unwrap();
-    let mut out = Vec::with_capacity(15 + key.len() + encoded_value.len());
-    out.push(0x50);
+fn node_prop_index_key(label: u32, key_id: u32, ordered_value: &[u8], node: u32) -> Vec<u8> {
+    let mut out = Vec::with_capacity(13 + ordered_value.len());
+    out.push(0x51);
     out.extend_from_slice(&label.to_be_bytes());
-    out.extend_from_slice(&key_len.to_be_bytes());
-    out.extend_from_slice(key.as_bytes());
-    out.extend_from_slice(&value_len.to_be_bytes());
-    out.extend_from_slice(encoded_value);
+    out.extend_from_slice(&key_id.to_be_bytes());
+    out.extend_from_slice(ordered_value);
     out.extend_from_slice(&node.to_be_bytes());
     out
 }
 
-fn encoded_string(value: &str) -> Vec<u8> {
-    let bytes = value.as_bytes();
-    let mut out = vec![4];
-    out.extend_from_slice(&(bytes.len() as u32).to_le_bytes());
-    out.extend_from_slice(bytes);
+/// Order-preserving string encoding used by index keys.
+fn ordered_string(value: &str) -> Vec<u8> {
+    let mut out = vec![0x04];
+    for &byte in value.as_bytes() {
+        out.push(byte);
+        if byte == 0 {
+            out.push(0xFF);
+        }
+    }
+    out.extend_from_slice(&[0x00, 0x01]);
     out
 }
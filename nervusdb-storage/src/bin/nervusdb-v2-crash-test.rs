@@ -7,19 +7,33 @@
 //!   directory.
 //! - `verify` reopens the directory and checks graph-level invariants.
 //!
+//! Durability: `--durability` picks the commit mode. Every commit advances a
+//! progress node's `seq`, and the writer appends `seq millis` to `<dir>.acks`
+//! once `commit` returns. After each kill the driver checks the mode's
+//! guarantee: `sync-all`, `sync-data`, and `buffered` keep every acknowledged
+//! commit across a process crash; `periodic` keeps every commit acknowledged
+//! at least two flush intervals before the kill.
+//!
 //! Usage:
 //!   cargo run -p nervusdb-storage --bin nervusdb-v2-crash-test -- driver <dir>
 //!   cargo run -p nervusdb-storage --bin nervusdb-v2-crash-test -- writer <dir>
 //!   cargo run -p nervusdb-storage --bin nervusdb-v2-crash-test -- verify <dir>
 
-use nervusdb::storage::engine::GraphEngine;
+use nervusdb::storage::engine::{DbOptions, Durability, GraphEngine};
 use nervusdb::{GraphSnapshot, PropertyValue};
 use std::collections::HashSet;
+use std::fs::OpenOptions;
+use std::io::Write;
 use std::path::{Path, PathBuf};
 use std::process::{Command, ExitCode};
 use std::thread;
 use std::time::{Duration, SystemTime, UNIX_EPOCH};
 
+/// External id of the node whose `seq` property counts committed writer
+/// transactions.
+#[cfg(not(target_arch = "wasm32"))]
+const PROGRESS_EXTERNAL_ID: u64 = u64::MAX - 1;
+
 fn main() -> ExitCode {
     #[cfg(target_arch = "wasm32")]
     {
@@ -54,7 +68,7 @@ fn real_main() -> Result<(), String> {
 #[cfg(not(target_arch = "wasm32"))]
 fn print_usage() {
     eprintln!(
-        "Usage:\n  nervusdb-v2-crash-test driver <dir> [--iterations N] [--min-ms A] [--max-ms B] [--batch N] [--node-pool N] [--rel-pool N]\n  nervusdb-v2-crash-test writer <dir> [--batch N] [--node-pool N] [--rel-pool N] [--persist-every N] [--seed S]\n  nervusdb-v2-crash-test verify <dir> [--node-pool N]"
+        "Usage:\n  nervusdb-v2-crash-test driver <dir> [--iterations N] [--min-ms A] [--max-ms B] [--batch N] [--node-pool N] [--rel-pool N] [--durability MODE] [--flush-ms N]\n  nervusdb-v2-crash-test writer <dir> [--batch N] [--node-pool N] [--rel-pool N] [--persist-every N] [--seed S] [--durability MODE] [--flush-ms N]\n  nervusdb-v2-crash-test verify <dir> [--node-pool N] [--min-seq N]\n\nMODE is sync-all (default), sync-data, buffered, or periodic."
     );
 }
 
@@ -70,6 +84,8 @@ struct DriverArgs {
     rel_pool: u32,
     verify_retries: usize,
     verify_backoff_ms: u64,
+    durability: Durability,
+    flush_ms: u64,
 }
 
 #[cfg(not(target_arch = "wasm32"))]
@@ -81,6 +97,8 @@ struct WriterArgs {
     rel_pool: u32,
     persist_every: usize,
     seed: u64,
+    durability: Durability,
+    flush_ms: u64,
 }
 
 #[cfg(not(target_arch = "wasm32"))]
@@ -88,6 +106,8 @@ struct WriterArgs {
 struct VerifyArgs {
     path: PathBuf,
     node_pool: u64,
+    /// Lowest progress `seq` the mode's guarantee allows after the crash.
+    min_seq: Option<i64>,
 }
 
 #[cfg(not(target_arch = "wasm32"))]
@@ -103,6 +123,8 @@ fn parse_driver_args(mut args: impl Iterator<Item = String>) -> Result<DriverArg
         rel_pool: 16,
         verify_retries: 30,
         verify_backoff_ms: 20,
+        durability: Durability::SyncAll,
+        flush_ms: 100,
     };
 
     while let Some(arg) = args.next() {
@@ -119,6 +141,10 @@ fn parse_driver_args(mut args: impl Iterator<Item = String>) -> Result<DriverArg
             "--verify-backoff-ms" => {
                 out.verify_backoff_ms = parse_u64(&next_value(&mut args, &arg)?, &arg)?;
             }
+            "--durability" => {
+                out.durability = parse_durability(&next_value(&mut args, &arg)?)?;
+            }
+            "--flush-ms" => out.flush_ms = parse_u64(&next_value(&mut args, &arg)?, &arg)?,
             _ => {
                 print_usage();
                 return Err(format!("unknown flag: {arg}"));
@@ -144,6 +170,8 @@ fn parse_writer_args(mut args: impl Iterator<Item = String>) -> Result<WriterArg
         rel_pool: 16,
         persist_every: 10,
         seed: default_seed(),
+        durability: Durability::SyncAll,
+        flush_ms: 100,
     };
 
     while let Some(arg) = args.next() {
@@ -155,6 +183,10 @@ fn parse_writer_args(mut args: impl Iterator<Item = String>) -> Result<WriterArg
                 out.persist_every = parse_usize(&next_value(&mut args, &arg)?, &arg)?;
             }
             "--seed" => out.seed = parse_u64(&next_value(&mut args, &arg)?, &arg)?,
+            "--durability" => {
+                out.durability = parse_durability(&next_value(&mut args, &arg)?)?;
+            }
+            "--flush-ms" => out.flush_ms = parse_u64(&next_value(&mut args, &arg)?, &arg)?,
             _ => {
                 print_usage();
                 return Err(format!("unknown flag: {arg}"));
@@ -173,10 +205,18 @@ fn parse_verify_args(mut args: impl Iterator<Item = String>) -> Result<VerifyArg
     let mut out = VerifyArgs {
         path,
         node_pool: 200,
+        min_seq: None,
     };
     while let Some(arg) = args.next() {
         match arg.as_str() {
             "--node-pool" => out.node_pool = parse_u64(&next_value(&mut args, &arg)?, &arg)?,
+            "--min-seq" => {
+                let raw = next_value(&mut args, &arg)?;
+                out.min_seq = Some(
+                    raw.parse::<i64>()
+                        .map_err(|_| format!("invalid {arg}: {raw}"))?,
+                );
+            }
             _ => {
                 print_usage();
                 return Err(format!("unknown flag: {arg}"));
@@ -221,6 +261,69 @@ fn parse_usize(raw: &str, name: &str) -> Result<usize, String> {
         .map_err(|_| format!("invalid {name}: {raw}"))
 }
 
+#[cfg(not(target_arch = "wasm32"))]
+fn parse_durability(raw: &str) -> Result<Durability, String> {
+    match raw {
+        "sync-all" => Ok(Durability::SyncAll),
+        "sync-data" => Ok(Durability::SyncData),
+        "buffered" => Ok(Durability::Buffered),
+        "periodic" => Ok(Durability::Periodic),
+        _ => Err(format!("invalid --durability: {raw}")),
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+fn durability_flag(durability: Durability) -> &'static str {
+    match durability {
+        Durability::SyncAll => "sync-all",
+        Durability::SyncData => "sync-data",
+        Durability::Buffered => "buffered",
+        Durability::Periodic => "periodic",
+    }
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+fn open_engine(path: &Path, durability: Durability, flush_ms: u64) -> Result<GraphEngine, String> {
+    GraphEngine::open_with(
+        path,
+        DbOptions {
+            durability,
+            flush_interval: Duration::from_millis(flush_ms),
+            ..DbOptions::default()
+        },
+    )
+    .map_err(|e| e.to_string())
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+fn acks_path(path: &Path) -> PathBuf {
+    path.with_extension("acks")
+}
+
+#[cfg(not(target_arch = "wasm32"))]
+fn now_ms() -> u64 {
+    SystemTime::now()
+        .duration_since(UNIX_EPOCH)
+        .unwrap_or_default()
+        .as_millis() as u64
+}
+
+/// Highest acknowledged `seq` that `durability` must keep across a kill at
+/// `killed_ms`. Torn trailing lines from the kill are skipped.
+#[cfg(not(target_arch = "wasm32"))]
+fn required_seq(acks: &str, durability: Durability, flush_ms: u64, killed_ms: u64) -> Option<i64> {
+    acks.lines()
+        .filter_map(|line| {
+            let (seq, at_ms) = line.split_once(' ')?;
+            Some((seq.parse::<i64>().ok()?, at_ms.parse::<u64>().ok()?))
+        })
+        .filter(|(_, at_ms)| {
+            durability != Durability::Periodic || at_ms + 2 * flush_ms <= killed_ms
+        })
+        .map(|(seq, _)| seq)
+        .max()
+}
+
 #[cfg(not(target_arch = "wasm32"))]
 fn default_seed() -> u64 {
     let nanos = SystemTime::now()
@@ -266,9 +369,17 @@ fn driver(args: DriverArgs) -> Result<(), String> {
     let mut rng = XorShift64::new(default_seed());
 
     bootstrap(&args.path, args.node_pool, args.rel_pool)?;
+    let acks = acks_path(&args.path);
+    // Extra syncs would hide what the weaker modes lose.
+    let persist_every = if args.durability == Durability::SyncAll {
+        10
+    } else {
+        0
+    };
 
     for i in 0..args.iterations {
         let delay_ms = args.min_delay_ms + rng.gen_range(args.max_delay_ms - args.min_delay_ms + 1);
+        let _ = std::fs::remove_file(&acks);
 
         let mut child = Command::new(&exe)
             .arg("writer")
@@ -280,21 +391,33 @@ fn driver(args: DriverArgs) -> Result<(), String> {
             .arg("--rel-pool")
             .arg(args.rel_pool.to_string())
             .arg("--persist-every")
-            .arg("10")
+            .arg(persist_every.to_string())
             .arg("--seed")
             .arg(default_seed().to_string())
+            .arg("--durability")
+            .arg(durability_flag(args.durability))
+            .arg("--flush-ms")
+            .arg(args.flush_ms.to_string())
             .spawn()
             .map_err(|e| e.to_string())?;
 
         thread::sleep(Duration::from_millis(delay_ms));
+        let killed_ms = now_ms();
         let _ = child.kill();
         let _ = child.wait();
+        let min_seq = required_seq(
+            &std::fs::read_to_string(&acks).unwrap_or_default(),
+            args.durability,
+            args.flush_ms,
+            killed_ms,
+        );
 
         let mut ok = false;
         for attempt in 0..=args.verify_retries {
             match verify(VerifyArgs {
                 path: args.path.clone(),
                 node_pool: args.node_pool,
+                min_seq,
             }) {
                 Ok(()) => {
                     ok = true;
@@ -339,6 +462,11 @@ fn bootstrap(path: &Path, node_pool: u64, _rel_pool: u32) -> Result<(), String>
     tx.create_edge(a, rel, b).map_err(|e| e.to_string())?;
     tx.set_node_property(a, "seed".to_string(), "bootstrap".into())
         .map_err(|e| e.to_string())?;
+    let progress = ensure_node(&engine, &mut tx, PROGRESS_EXTERNAL_ID, label)?;
+    if engine.begin_read().node_property(progress, "seq").is_none() {
+        tx.set_node_property(progress, "seq".to_string(), PropertyValue::Int(0))
+            .map_err(|e| e.to_string())?;
+    }
     tx.commit().map_err(|e| e.to_string())?;
     engine.persist().map_err(|e| e.to_string())?;
     drop(engine);
@@ -346,17 +474,37 @@ fn bootstrap(path: &Path, node_pool: u64, _rel_pool: u32) -> Result<(), String>
     verify(VerifyArgs {
         path: path.to_path_buf(),
         node_pool,
+        min_seq: None,
     })
 }
 
+#[cfg(not(target_arch = "wasm32"))]
+fn progress_seq(engine: &GraphEngine) -> Result<(u32, i64), String> {
+    let progress = engine
+        .lookup_internal_id(PROGRESS_EXTERNAL_ID)
+        .ok_or_else(|| "progress node missing".to_string())?;
+    match engine.begin_read().node_property(progress, "seq") {
+        Some(PropertyValue::Int(seq)) => Ok((progress, seq)),
+        _ => Err("progress seq missing".to_string()),
+    }
+}
+
 #[cfg(not(target_arch = "wasm32"))]
 fn writer(args: WriterArgs) -> Result<(), String> {
-    let engine = GraphEngine::open(&args.path).map_err(|e| e.to_string())?;
+    let engine = open_engine(&args.path, args.durability, args.flush_ms)?;
+    let mut acks = OpenOptions::new()
+        .create(true)
+        .append(true)
+        .open(acks_path(&args.path))
+        .map_err(|e| e.to_string())?;
+    let (progress, mut seq) = progress_seq(&engine)?;
     let mut rng = XorShift64::new(args.seed);
     let mut tx_counter: usize = 0;
 
     loop {
         let mut tx = engine.begin_write();
+        tx.set_node_property(progress, "seq".to_string(), PropertyValue::Int(seq + 1))
+            .map_err(|e| e.to_string())?;
         let label = tx
             .get_or_create_label("CrashNode")
             .map_err(|e| e.to_string())?;
@@ -387,7 +535,11 @@ fn writer(args: WriterArgs) -> Result<(), String> {
                 .map_err(|e| e.to_string())?;
         }
 
-        let _ = tx.commit();
+        if tx.commit().is_ok() {
+            seq += 1;
+            // Unbuffered, so the line reaches the OS before the next commit.
+            writeln!(acks, "{seq} {}", now_ms()).map_err(|e| e.to_string())?;
+        }
         tx_counter += 1;
         if args.persist_every > 0 && tx_counter % args.persist_every == 0 {
             let _ = engine.persist();
@@ -454,5 +606,14 @@ fn verify(args: VerifyArgs) -> Result<(), String> {
         }
     }
 
+    if let Some(min_seq) = args.min_seq {
+        let (_, seq) = progress_seq(&engine)?;
+        if seq < min_seq {
+            return Err(format!(
+                "acknowledged commit lost: progress seq {seq} < acknowledged {min_seq}"
+            ));
+        }
+    }
+
     Ok(())
 }
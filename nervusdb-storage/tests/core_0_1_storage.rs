@@ -1,7 +1,11 @@
 use fjall::{Database, KeyspaceCreateOptions, PersistMode};
-use nervusdb::storage::engine::GraphEngine;
+use nervusdb::storage::engine::{
+    BulkEdge, BulkNode, DbOptions, Durability, GraphEngine, bulk_load,
+};
 use nervusdb::storage::{Error, STORAGE_FORMAT_EPOCH};
 use nervusdb::{EdgeKey, GraphSnapshot, PropertyValue};
+use std::ops::Bound;
+use std::time::Duration;
 use tempfile::tempdir;
 
 fn db_dir(dir: &tempfile::TempDir) -> std::path::PathBuf {
@@ -49,7 +53,7 @@ fn storage_epoch_2_database_is_rejected() {
 }
 
 #[test]
-fn storage_epoch_4_uses_meta_graph_data_and_adjacency_keyspaces() {
+fn storage_epoch_9_uses_meta_graph_data_adjacency_and_vector_keyspaces() {
     let dir = tempdir().unwrap();
     let path = db_dir(&dir);
     {
@@ -70,14 +74,15 @@ fn storage_epoch_4_uses_meta_graph_data_and_adjacency_keyspaces() {
         .collect::<Vec<_>>();
     names.sort();
 
-    assert_eq!(db.keyspace_count(), 4);
+    assert_eq!(db.keyspace_count(), 5);
     assert_eq!(
         names,
         vec![
             "adj_in".to_string(),
             "adj_out".to_string(),
             "graph_data".to_string(),
-            "meta".to_string()
+            "meta".to_string(),
+            "vectors".to_string()
         ]
     );
 }
@@ -123,6 +128,199 @@ fn close_checkpoints_journal_without_losing_committed_graph() {
     assert_core_edge(&engine, 1, rel, 2);
 }
 
+#[test]
+fn supernode_adjacency_splits_into_buckets_and_merges_back() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let rel;
+    let hub;
+    let mut leaves = Vec::new();
+
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let label = engine.get_or_create_label("Node").unwrap();
+        rel = engine.get_or_create_rel_type("LINK").unwrap();
+        let mut tx = engine.begin_write();
+        hub = tx.create_node(1, label).unwrap();
+        for i in 0..3000 {
+            leaves.push(tx.create_node(i + 2, label).unwrap());
+        }
+        for leaf in &leaves[..2000] {
+            tx.create_edge(hub, rel, *leaf).unwrap();
+        }
+        tx.commit().unwrap();
+
+        for chunk in leaves[2000..].chunks(250) {
+            let mut tx = engine.begin_write();
+            for leaf in chunk {
+                tx.create_edge(hub, rel, *leaf).unwrap();
+                tx.create_edge(*leaf, rel, hub).unwrap();
+            }
+            tx.commit().unwrap();
+        }
+        engine.close().unwrap();
+    }
+
+    {
+        let db = Database::builder(&path).open().unwrap();
+        let adj_out = db
+            .keyspace("adj_out", KeyspaceCreateOptions::default)
+            .unwrap();
+        let hub_records = adj_out.prefix(hub.to_be_bytes()).count();
+        assert!(
+            hub_records > 2,
+            "hub list should be bucketed: {hub_records}"
+        );
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    {
+        let snapshot = engine.snapshot();
+        let dsts = snapshot
+            .neighbors(hub, Some(rel))
+            .map(|edge| edge.dst)
+            .collect::<Vec<_>>();
+        assert_eq!(dsts, leaves);
+        assert_eq!(snapshot.neighbors(hub, None).count(), 3000);
+        assert_eq!(snapshot.incoming_neighbors(hub, Some(rel)).count(), 1000);
+        assert_eq!(snapshot.edge_count(Some(rel)), 4000);
+    }
+
+    let mut tx = engine.begin_write();
+    for leaf in leaves.iter().skip(1).step_by(2) {
+        tx.tombstone_edge(hub, rel, *leaf).unwrap();
+    }
+    tx.commit().unwrap();
+    let mut tx = engine.begin_write();
+    for leaf in leaves.iter().step_by(2).skip(10) {
+        tx.tombstone_edge(hub, rel, *leaf).unwrap();
+    }
+    tx.commit().unwrap();
+    engine.close().unwrap();
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let expected = leaves
+        .iter()
+        .step_by(2)
+        .take(10)
+        .copied()
+        .collect::<Vec<_>>();
+    let dsts = snapshot
+        .neighbors(hub, Some(rel))
+        .map(|edge| edge.dst)
+        .collect::<Vec<_>>();
+    assert_eq!(dsts, expected);
+    assert_eq!(snapshot.edge_count(Some(rel)), 1010);
+    let mut tx = engine.begin_write();
+    assert!(matches!(
+        tx.tombstone_edge(hub, rel, leaves[2998]),
+        Err(Error::EdgeNotFound { .. })
+    ));
+    tx.tombstone_edge(hub, rel, leaves[18]).unwrap();
+    assert_eq!(
+        snapshot
+            .incoming_neighbors(leaves[2998], Some(rel))
+            .collect::<Vec<_>>(),
+        Vec::<EdgeKey>::new()
+    );
+}
+
+#[test]
+fn edge_writes_on_existing_nodes_append_deltas_until_merged() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let rel;
+    let hub;
+    let mut leaves = Vec::new();
+
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let label = engine.get_or_create_label("Node").unwrap();
+        rel = engine.get_or_create_rel_type("LINK").unwrap();
+        let mut tx = engine.begin_write();
+        hub = tx.create_node(1, label).unwrap();
+        for i in 0..8 {
+            leaves.push(tx.create_node(i + 2, label).unwrap());
+        }
+        for leaf in &leaves[..4] {
+            tx.create_edge(hub, rel, *leaf).unwrap();
+        }
+        tx.commit().unwrap();
+
+        let before = engine.snapshot();
+        for leaf in &leaves[4..] {
+            let mut tx = engine.begin_write();
+            tx.create_edge(hub, rel, *leaf).unwrap();
+            tx.commit().unwrap();
+        }
+        let mut tx = engine.begin_write();
+        tx.tombstone_edge(hub, rel, leaves[1]).unwrap();
+        tx.tombstone_edge(hub, rel, leaves[5]).unwrap();
+        tx.commit().unwrap();
+
+        let expected = [0, 2, 3, 4, 6, 7].map(|i| leaves[i]).to_vec();
+        let snapshot = engine.snapshot();
+        let dsts = snapshot
+            .neighbors(hub, Some(rel))
+            .map(|edge| edge.dst)
+            .collect::<Vec<_>>();
+        assert_eq!(dsts, expected);
+        assert_eq!(snapshot.neighbors(hub, None).count(), 6);
+        assert_eq!(
+            snapshot.incoming_neighbors(leaves[6], Some(rel)).next(),
+            Some(EdgeKey {
+                src: hub,
+                rel,
+                dst: leaves[6]
+            })
+        );
+        assert!(
+            snapshot
+                .incoming_neighbors(leaves[5], Some(rel))
+                .next()
+                .is_none()
+        );
+        assert_eq!(snapshot.edge_count(Some(rel)), 6);
+        assert_eq!(before.neighbors(hub, Some(rel)).count(), 4);
+        assert!(matches!(
+            engine.begin_write().tombstone_edge(hub, rel, leaves[5]),
+            Err(Error::EdgeNotFound { .. })
+        ));
+        // Dropped without close: the delta records must survive reopen as-is.
+    }
+
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let snapshot = engine.snapshot();
+        assert_eq!(snapshot.neighbors(hub, Some(rel)).count(), 6);
+        let mut tx = engine.begin_write();
+        tx.tombstone_node(leaves[7]).unwrap();
+        tx.commit().unwrap();
+        let snapshot = engine.snapshot();
+        assert_eq!(snapshot.neighbors(hub, Some(rel)).count(), 5);
+        assert_eq!(snapshot.edge_count(None), 5);
+        engine.close().unwrap();
+    }
+
+    {
+        let db = Database::builder(&path).open().unwrap();
+        let graph_data = db
+            .keyspace("graph_data", KeyspaceCreateOptions::default)
+            .unwrap();
+        assert_eq!(graph_data.prefix([0x30]).count(), 0);
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let expected = [0, 2, 3, 4, 6].map(|i| leaves[i]).to_vec();
+    let dsts = engine
+        .snapshot()
+        .neighbors(hub, Some(rel))
+        .map(|edge| edge.dst)
+        .collect::<Vec<_>>();
+    assert_eq!(dsts, expected);
+}
+
 #[test]
 fn core_0_1_committed_graph_survives_reopen() {
     let dir = tempdir().unwrap();
@@ -253,6 +451,181 @@ fn core_0_1_label_scan_uses_label_nodes_keyspace() {
     }
 }
 
+#[test]
+fn core_0_1_node_property_record_updates_in_place_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let node;
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let mut tx = engine.begin_write();
+        node = tx.create_node(10, person).unwrap();
+        for i in 0..64 {
+            tx.set_node_property(node, format!("p{i:02}"), PropertyValue::Int(i))
+                .unwrap();
+        }
+        tx.commit().unwrap();
+
+        let mut tx = engine.begin_write();
+        tx.set_node_property(node, "p07".to_string(), "seven".into())
+            .unwrap();
+        tx.set_node_property(node, "extra".to_string(), PropertyValue::Bool(true))
+            .unwrap();
+        tx.remove_node_property(node, "p00").unwrap();
+        tx.set_node_property(node, "gone".to_string(), PropertyValue::Null)
+            .unwrap();
+        tx.remove_node_property(node, "gone").unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let props = snapshot.node_properties(node).unwrap();
+    assert_eq!(props.len(), 64);
+    assert_eq!(props.get("p63"), Some(&PropertyValue::Int(63)));
+    assert_eq!(
+        snapshot.node_property(node, "p07"),
+        Some(PropertyValue::String("seven".into()))
+    );
+    assert_eq!(
+        snapshot.node_property(node, "extra"),
+        Some(PropertyValue::Bool(true))
+    );
+    assert_eq!(snapshot.node_property(node, "p00"), None);
+    assert_eq!(snapshot.node_property(node, "gone"), None);
+
+    let mut tx = engine.begin_write();
+    for key in props.keys() {
+        tx.remove_node_property(node, key).unwrap();
+    }
+    tx.commit().unwrap();
+    assert_eq!(engine.snapshot().node_properties(node), None);
+}
+
+#[test]
+fn core_0_1_property_key_dictionary_is_shared_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let (person, knows, alice, bob);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        person = engine.get_or_create_label("Person").unwrap();
+        knows = engine.get_or_create_rel_type("KNOWS").unwrap();
+        let mut tx = engine.begin_write();
+        alice = tx.create_node(10, person).unwrap();
+        bob = tx.create_node(20, person).unwrap();
+        tx.create_edge(alice, knows, bob).unwrap();
+        tx.set_node_property(alice, "name".to_string(), "Alice".into())
+            .unwrap();
+        tx.set_node_property(bob, "name".to_string(), "Bob".into())
+            .unwrap();
+        tx.set_edge_property(alice, knows, bob, "since".to_string(), 2020.into())
+            .unwrap();
+        tx.remove_node_property(bob, "never_set").unwrap();
+        tx.commit().unwrap();
+    }
+
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let mut tx = engine.begin_write();
+        tx.set_edge_property(alice, knows, bob, "name".to_string(), "friends".into())
+            .unwrap();
+        tx.set_node_property(bob, "since".to_string(), 1999.into())
+            .unwrap();
+        tx.set_node_property(alice, "age".to_string(), 30.into())
+            .unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let edge = EdgeKey {
+        src: alice,
+        rel: knows,
+        dst: bob,
+    };
+    assert_eq!(
+        snapshot.node_property(alice, "name"),
+        Some(PropertyValue::String("Alice".into()))
+    );
+    assert_eq!(
+        snapshot.node_property(alice, "age"),
+        Some(PropertyValue::Int(30))
+    );
+    assert_eq!(
+        snapshot.node_property(bob, "since"),
+        Some(PropertyValue::Int(1999))
+    );
+    let edge_props = snapshot.edge_properties(edge).unwrap();
+    assert_eq!(edge_props.get("since"), Some(&PropertyValue::Int(2020)));
+    assert_eq!(
+        edge_props.get("name"),
+        Some(&PropertyValue::String("friends".into()))
+    );
+    assert_eq!(snapshot.node_property(bob, "never_set"), None);
+    let named_bob: Vec<_> = snapshot
+        .nodes_with_label_and_property(person, "name", &"Bob".into())
+        .collect();
+    assert_eq!(named_bob, vec![bob]);
+    assert_eq!(
+        snapshot
+            .nodes_with_label_and_property(person, "missing", &"Bob".into())
+            .count(),
+        0
+    );
+}
+
+#[test]
+fn core_0_1_multi_label_scan_intersects_label_bitmaps() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let (person, admin, alice, bob, carol, dave);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        person = engine.get_or_create_label("Person").unwrap();
+        admin = engine.get_or_create_label("Admin").unwrap();
+        let mut tx = engine.begin_write();
+        alice = tx.create_node(10, person).unwrap();
+        bob = tx.create_node(20, person).unwrap();
+        carol = tx.create_node(30, admin).unwrap();
+        dave = tx.create_node(40, person).unwrap();
+        tx.add_node_label(alice, admin).unwrap();
+        tx.add_node_label(dave, admin).unwrap();
+        tx.commit().unwrap();
+
+        let mut tx = engine.begin_write();
+        tx.add_node_label(bob, admin).unwrap();
+        tx.remove_node_label(alice, admin).unwrap();
+        tx.tombstone_node(dave).unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    assert_eq!(
+        snapshot
+            .nodes_with_labels(&[person, admin])
+            .collect::<Vec<_>>(),
+        vec![bob]
+    );
+    assert_eq!(
+        snapshot
+            .nodes_with_labels(&[admin, admin])
+            .collect::<Vec<_>>(),
+        vec![bob, carol]
+    );
+    assert_eq!(
+        snapshot.nodes_with_label(person).collect::<Vec<_>>(),
+        vec![alice, bob]
+    );
+    assert_eq!(snapshot.nodes_with_labels(&[]).count(), 3);
+    assert_eq!(snapshot.node_count(Some(admin)), 2);
+}
+
 #[test]
 fn core_0_1_node_and_edge_properties_survive_reopen() {
     let dir = tempdir().unwrap();
@@ -334,6 +707,142 @@ fn core_0_1_snapshot_isolation_holds_across_commits() {
     assert_eq!(engine.snapshot().node_count(Some(person)), 2);
 }
 
+#[test]
+fn core_0_1_node_liveness_is_versioned_per_snapshot_and_rebuilt_on_open() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let (alice, bob, carol) = {
+        let engine = GraphEngine::open(&path).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let mut tx = engine.begin_write();
+        let alice = tx.create_node(10, person).unwrap();
+        let bob = tx.create_node(20, person).unwrap();
+        let carol = tx.create_node(30, person).unwrap();
+        tx.commit().unwrap();
+
+        let before = engine.snapshot();
+        let mut tx = engine.begin_write();
+        tx.tombstone_node(bob).unwrap();
+        let dave = tx.create_node(40, person).unwrap();
+        tx.commit().unwrap();
+        let after = engine.snapshot();
+
+        assert_eq!(before.nodes().collect::<Vec<_>>(), vec![alice, bob, carol]);
+        assert!(!before.is_tombstoned_node(bob));
+        assert_eq!(before.node_count(None), 3);
+        assert_eq!(after.nodes().collect::<Vec<_>>(), vec![alice, carol, dave]);
+        assert!(after.is_tombstoned_node(bob));
+        assert!(!after.is_tombstoned_node(dave + 1));
+        assert_eq!(after.resolve_external(bob), None);
+        assert_eq!(after.node_count(None), 3);
+        assert_eq!(after.nodes_with_label(person).count(), 3);
+
+        // A commit that leaves liveness unchanged keeps the current version.
+        let mut tx = engine.begin_write();
+        tx.set_node_property(alice, "name".to_string(), "Alice".into())
+            .unwrap();
+        tx.commit().unwrap();
+        assert_eq!(engine.snapshot().node_count(None), 3);
+        (alice, bob, carol)
+    };
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    assert!(snapshot.is_tombstoned_node(bob));
+    assert_eq!(
+        snapshot.nodes().take(2).collect::<Vec<_>>(),
+        vec![alice, carol]
+    );
+    assert_eq!(snapshot.node_count(None), 3);
+
+    let person = engine.get_label_id("Person").unwrap();
+    let mut tx = engine.begin_write();
+    tx.tombstone_node(alice).unwrap();
+    tx.commit().unwrap();
+    assert_eq!(engine.snapshot().node_count(None), 2);
+    assert_eq!(engine.snapshot().nodes_with_label(person).count(), 2);
+    assert_eq!(snapshot.node_count(None), 3);
+}
+
+#[test]
+fn core_0_1_stored_counters_track_commits_and_rebuild_on_open() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let (person, admin, knows, likes) = {
+        let engine = GraphEngine::open(&path).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let admin = engine.get_or_create_label("Admin").unwrap();
+        let knows = engine.get_or_create_rel_type("KNOWS").unwrap();
+        let likes = engine.get_or_create_rel_type("LIKES").unwrap();
+
+        let mut tx = engine.begin_write();
+        let alice = tx.create_node(10, person).unwrap();
+        let bob = tx.create_node(20, person).unwrap();
+        let carol = tx.create_node(30, person).unwrap();
+        tx.add_node_label(carol, admin).unwrap();
+        tx.create_edge(alice, knows, bob).unwrap();
+        tx.create_edge(bob, knows, carol).unwrap();
+        tx.create_edge(carol, likes, alice).unwrap();
+        tx.commit().unwrap();
+
+        // Re-creating an existing edge and re-adding a label change nothing.
+        let mut tx = engine.begin_write();
+        tx.create_edge(alice, knows, bob).unwrap();
+        tx.add_node_label(carol, admin).unwrap();
+        tx.add_node_label(alice, admin).unwrap();
+        tx.create_edge(alice, likes, carol).unwrap();
+        tx.tombstone_edge(bob, knows, carol).unwrap();
+        tx.commit().unwrap();
+        let snapshot = engine.snapshot();
+        assert_eq!(snapshot.node_count(Some(person)), 3);
+        assert_eq!(snapshot.node_count(Some(admin)), 2);
+        assert_eq!(snapshot.edge_count(Some(knows)), 1);
+        assert_eq!(snapshot.edge_count(Some(likes)), 2);
+        assert_eq!(snapshot.edge_count(None), 3);
+
+        // Detaching a node removes its labels and every incident edge.
+        let mut tx = engine.begin_write();
+        tx.tombstone_node(carol).unwrap();
+        tx.remove_node_label(alice, admin).unwrap();
+        let dave = tx.create_node(40, person).unwrap();
+        tx.create_edge(dave, knows, alice).unwrap();
+        tx.commit().unwrap();
+        let after = engine.snapshot();
+        assert_eq!(after.node_count(Some(person)), 3);
+        assert_eq!(after.node_count(Some(admin)), 0);
+        assert_eq!(after.edge_count(Some(knows)), 2);
+        assert_eq!(after.edge_count(Some(likes)), 0);
+        for label in [person, admin] {
+            assert_eq!(
+                after.node_count(Some(label)),
+                after.nodes_with_label(label).count() as u64
+            );
+        }
+        // Snapshots keep the counters of the commit they observe.
+        assert_eq!(snapshot.edge_count(Some(likes)), 2);
+        (person, admin, knows, likes)
+    };
+
+    // Directories written before the counters existed rebuild them on open.
+    {
+        let db = Database::builder(&path).open().unwrap();
+        let meta = db.keyspace("meta", KeyspaceCreateOptions::default).unwrap();
+        let mut batch = db.batch().durability(Some(PersistMode::SyncAll));
+        for guard in meta.prefix(b"count/") {
+            batch.remove(&meta, guard.key().unwrap());
+        }
+        batch.remove(&meta, b"counters");
+        batch.commit().unwrap();
+    }
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    assert_eq!(snapshot.node_count(Some(person)), 3);
+    assert_eq!(snapshot.node_count(Some(admin)), 0);
+    assert_eq!(snapshot.edge_count(Some(knows)), 2);
+    assert_eq!(snapshot.edge_count(Some(likes)), 0);
+    assert_eq!(snapshot.edge_count(None), 2);
+}
+
 #[test]
 fn core_0_1_batch_node_ids_are_committed_atomically() {
     let dir = tempdir().unwrap();
@@ -739,6 +1248,335 @@ fn core_0_1_node_property_equality_index_tracks_writes_and_reopen() {
     );
 }
 
+#[test]
+fn core_0_1_node_property_range_index_orders_values_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let person;
+    let ages: Vec<PropertyValue> = vec![
+        (-5).into(),
+        0.5.into(),
+        30.into(),
+        30.5.into(),
+        31.into(),
+        40.into(),
+        "forty".into(),
+    ];
+    let mut nodes = Vec::new();
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        person = engine.get_or_create_label("Person").unwrap();
+        let mut tx = engine.begin_write();
+        for (ext, age) in ages.iter().enumerate() {
+            let node = tx.create_node(ext as u64 + 1, person).unwrap();
+            tx.set_node_property(node, "age".to_string(), age.clone())
+                .unwrap();
+            nodes.push(node);
+        }
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let range = |lower: Bound<&PropertyValue>, upper: Bound<&PropertyValue>| {
+        let mut found: Vec<_> = snapshot
+            .nodes_with_label_and_property_range(person, "age", lower, upper)
+            .collect();
+        found.sort_unstable();
+        found
+    };
+
+    assert_eq!(
+        range(Bound::Excluded(&30.into()), Bound::Unbounded),
+        vec![nodes[3], nodes[4], nodes[5]]
+    );
+    assert_eq!(
+        range(Bound::Included(&30.0.into()), Bound::Excluded(&40.into())),
+        vec![nodes[2], nodes[3], nodes[4]]
+    );
+    assert_eq!(
+        range(Bound::Unbounded, Bound::Included(&0.5.into())),
+        vec![nodes[0], nodes[1]]
+    );
+    assert_eq!(
+        range(Bound::Included(&"a".into()), Bound::Unbounded),
+        vec![nodes[6]]
+    );
+    assert!(range(Bound::Included(&1.into()), Bound::Included(&"z".into())).is_empty());
+    assert!(
+        snapshot
+            .nodes_with_label_and_property_range(
+                person,
+                "missing",
+                Bound::Unbounded,
+                Bound::Unbounded
+            )
+            .next()
+            .is_none()
+    );
+}
+
+#[test]
+fn core_0_1_composite_index_is_backfilled_maintained_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let file;
+    let (a, b, c);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        file = engine.get_or_create_label("File").unwrap();
+        let mut tx = engine.begin_write();
+        a = tx.create_node(1, file).unwrap();
+        b = tx.create_node(2, file).unwrap();
+        for (node, path) in [(a, "src/lib.rs"), (b, "src/main.rs")] {
+            tx.set_node_property(node, "repo".to_string(), "nervusdb".into())
+                .unwrap();
+            tx.set_node_property(node, "path".to_string(), path.into())
+                .unwrap();
+        }
+        tx.commit().unwrap();
+
+        assert!(matches!(
+            engine.create_composite_index(file, &["repo"]),
+            Err(Error::InvalidIndexDefinition(_))
+        ));
+        assert!(matches!(
+            engine.create_composite_index(file, &["repo", "repo"]),
+            Err(Error::InvalidIndexDefinition(_))
+        ));
+        engine
+            .create_composite_index(file, &["repo", "path", "lang"])
+            .unwrap();
+        engine
+            .create_composite_index(file, &["repo", "path", "lang"])
+            .unwrap();
+
+        let mut tx = engine.begin_write();
+        c = tx.create_node(3, file).unwrap();
+        tx.set_node_property(c, "repo".to_string(), "nervusdb".into())
+            .unwrap();
+        tx.set_node_property(c, "path".to_string(), "src/lib.rs".into())
+            .unwrap();
+        tx.set_node_property(c, "lang".to_string(), "rust".into())
+            .unwrap();
+        tx.set_node_property(b, "path".to_string(), "src/lib.rs".into())
+            .unwrap();
+        tx.commit().unwrap();
+
+        let mut tx = engine.begin_write();
+        tx.remove_node_label(a, file).unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let find = |props: &[(&str, &PropertyValue)]| {
+        let mut found: Vec<_> = snapshot
+            .nodes_with_label_and_properties(file, props)
+            .collect();
+        found.sort_unstable();
+        found
+    };
+    let repo = PropertyValue::from("nervusdb");
+    let lib = PropertyValue::from("src/lib.rs");
+    assert_eq!(find(&[("repo", &repo), ("path", &lib)]), vec![b, c]);
+    assert_eq!(find(&[("path", &lib), ("repo", &repo)]), vec![b, c]);
+    assert_eq!(
+        find(&[("repo", &repo), ("path", &lib), ("lang", &"rust".into())]),
+        vec![c]
+    );
+    assert!(find(&[("repo", &repo), ("path", &"src/main.rs".into())]).is_empty());
+    assert!(find(&[("repo", &repo), ("missing", &lib)]).is_empty());
+    drop(snapshot);
+
+    let mut tx = engine.begin_write();
+    tx.tombstone_node(c).unwrap();
+    tx.remove_node_property(b, "repo").unwrap();
+    tx.commit().unwrap();
+    assert!(
+        engine
+            .snapshot()
+            .nodes_with_label_and_properties(file, &[("repo", &repo), ("path", &lib)])
+            .next()
+            .is_none()
+    );
+}
+
+#[test]
+fn core_0_1_unique_constraint_rejects_duplicates_and_serves_merge() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let user;
+    let (alice, bob);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        user = engine.get_or_create_label("User").unwrap();
+        let mut tx = engine.begin_write();
+        alice = tx.create_node(1, user).unwrap();
+        bob = tx.create_node(2, user).unwrap();
+        tx.set_node_property(alice, "email".to_string(), "a@x".into())
+            .unwrap();
+        tx.set_node_property(bob, "email".to_string(), "a@x".into())
+            .unwrap();
+        tx.commit().unwrap();
+
+        assert!(matches!(
+            engine.create_unique_constraint(user, "email"),
+            Err(Error::UniqueConstraintViolation { .. })
+        ));
+        let mut tx = engine.begin_write();
+        tx.set_node_property(bob, "email".to_string(), "b@x".into())
+            .unwrap();
+        tx.commit().unwrap();
+        engine.create_unique_constraint(user, "email").unwrap();
+        engine.create_unique_constraint(user, "email").unwrap();
+
+        let mut tx = engine.begin_write();
+        let carol = tx.create_node(3, user).unwrap();
+        tx.set_node_property(carol, "email".to_string(), "a@x".into())
+            .unwrap();
+        assert!(matches!(
+            tx.commit(),
+            Err(Error::UniqueConstraintViolation { node, .. }) if node == alice
+        ));
+
+        let mut tx = engine.begin_write();
+        let carol = tx.create_node(3, user).unwrap();
+        let dave = tx.create_node(4, user).unwrap();
+        tx.set_node_property(carol, "email".to_string(), "c@x".into())
+            .unwrap();
+        tx.set_node_property(dave, "email".to_string(), "c@x".into())
+            .unwrap();
+        assert!(matches!(
+            tx.commit(),
+            Err(Error::UniqueConstraintViolation { .. })
+        ));
+
+        // A value released in the same transaction can be claimed again.
+        let mut tx = engine.begin_write();
+        tx.set_node_property(alice, "email".to_string(), "old@x".into())
+            .unwrap();
+        tx.set_node_property(bob, "email".to_string(), "a@x".into())
+            .unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    assert_eq!(
+        snapshot.node_by_unique_property(user, "email", &"a@x".into()),
+        Some(bob)
+    );
+    assert_eq!(
+        snapshot.node_by_unique_property(user, "email", &"old@x".into()),
+        Some(alice)
+    );
+    assert_eq!(
+        snapshot.node_by_unique_property(user, "email", &"b@x".into()),
+        None
+    );
+    drop(snapshot);
+
+    let mut tx = engine.begin_write();
+    let found = tx
+        .merge_node(10, user, "email".to_string(), "a@x".into())
+        .unwrap();
+    let created = tx
+        .merge_node(11, user, "email".to_string(), "e@x".into())
+        .unwrap();
+    let again = tx
+        .merge_node(12, user, "email".to_string(), "e@x".into())
+        .unwrap();
+    tx.commit().unwrap();
+    assert_eq!(found, bob);
+    assert_eq!(again, created);
+    assert_eq!(engine.lookup_internal_id(12), None);
+
+    let mut tx = engine.begin_write();
+    tx.tombstone_node(bob).unwrap();
+    tx.commit().unwrap();
+    assert_eq!(
+        engine
+            .snapshot()
+            .node_by_unique_property(user, "email", &"a@x".into()),
+        None
+    );
+}
+
+#[test]
+fn core_0_1_edge_property_index_tracks_writes_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let calls;
+    let (a, b, c, d);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let function = engine.get_or_create_label("Function").unwrap();
+        calls = engine.get_or_create_rel_type("CALLS").unwrap();
+        let mut tx = engine.begin_write();
+        a = tx.create_node(1, function).unwrap();
+        b = tx.create_node(2, function).unwrap();
+        c = tx.create_node(3, function).unwrap();
+        d = tx.create_node(4, function).unwrap();
+        for (src, dst, weight) in [(a, b, 5), (a, c, 5), (b, c, 7), (c, d, 5)] {
+            tx.create_edge(src, calls, dst).unwrap();
+            tx.set_edge_property(
+                src,
+                calls,
+                dst,
+                "weight".to_string(),
+                PropertyValue::Int(weight),
+            )
+            .unwrap();
+        }
+        tx.set_edge_property(b, calls, c, "ratio".to_string(), PropertyValue::Float(0.5))
+            .unwrap();
+        tx.commit().unwrap();
+
+        let mut tx = engine.begin_write();
+        tx.set_edge_property(a, calls, c, "weight".to_string(), PropertyValue::Int(7))
+            .unwrap();
+        tx.remove_edge_property(c, calls, d, "weight").unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let find = |value: PropertyValue| {
+        let mut found: Vec<_> = engine
+            .snapshot()
+            .edges_with_rel_and_property(calls, "weight", &value)
+            .collect();
+        found.sort_unstable();
+        found
+    };
+    let edge = |src, dst| EdgeKey {
+        src,
+        rel: calls,
+        dst,
+    };
+    assert_eq!(find(PropertyValue::Int(5)), vec![edge(a, b)]);
+    assert_eq!(find(PropertyValue::Int(7)), vec![edge(a, c), edge(b, c)]);
+    assert!(find(PropertyValue::Float(5.0)).is_empty());
+    assert!(
+        engine
+            .snapshot()
+            .edges_with_rel_and_property(calls, "ratio", &PropertyValue::Float(0.5))
+            .next()
+            .is_none()
+    );
+
+    let mut tx = engine.begin_write();
+    tx.tombstone_edge(a, calls, b).unwrap();
+    tx.tombstone_node(c).unwrap();
+    tx.commit().unwrap();
+    assert!(find(PropertyValue::Int(5)).is_empty());
+    assert!(find(PropertyValue::Int(7)).is_empty());
+}
+
 #[test]
 fn core_0_1_node_property_equality_index_tracks_property_update_and_remove() {
     let dir = tempdir().unwrap();
@@ -885,3 +1723,623 @@ fn core_0_1_node_property_equality_index_uses_final_same_txn_state() {
     );
     assert_eq!(snapshot.node_count(Some(person)), 1);
 }
+
+#[test]
+fn core_0_1_fulltext_index_tracks_commits_and_answers_terms_and_phrases() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+
+    let doc;
+    let (a, b, c);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        doc = engine.get_or_create_label("Doc").unwrap();
+        let mut tx = engine.begin_write();
+        a = tx.create_node(1, doc).unwrap();
+        b = tx.create_node(2, doc).unwrap();
+        tx.set_node_property(a, "body".to_string(), "Graph databases store edges".into())
+            .unwrap();
+        tx.set_node_property(b, "body".to_string(), "Edges store graph data".into())
+            .unwrap();
+        tx.commit().unwrap();
+
+        // Built from committed nodes, then maintained by every commit.
+        engine.create_fulltext_index(doc, "body").unwrap();
+        let mut tx = engine.begin_write();
+        c = tx.create_node(3, doc).unwrap();
+        tx.set_node_property(c, "body".to_string(), "A graph of graph edges".into())
+            .unwrap();
+        tx.set_node_property(b, "body".to_string(), "Vectors only".into())
+            .unwrap();
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let terms = |query: &str| -> Vec<u32> {
+        snapshot
+            .nodes_with_label_and_terms(doc, "body", query)
+            .collect()
+    };
+    assert_eq!(terms("GRAPH edges"), vec![a, c]);
+    assert_eq!(terms("vectors"), vec![b]);
+    assert!(terms("data").is_empty());
+    assert!(terms("  ").is_empty());
+    let phrase: Vec<u32> = snapshot
+        .nodes_with_label_and_phrase(doc, "body", "graph edges")
+        .collect();
+    assert_eq!(phrase, vec![c]);
+
+    let mut tx = engine.begin_write();
+    tx.tombstone_node(c).unwrap();
+    tx.commit().unwrap();
+    let snapshot = engine.snapshot();
+    let after: Vec<u32> = snapshot
+        .nodes_with_label_and_terms(doc, "body", "graph")
+        .collect();
+    assert_eq!(after, vec![a]);
+}
+
+#[test]
+fn core_0_1_vector_index_searches_snapshots_and_survives_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let embedding = |seed: u32| -> Vec<f32> {
+        (0..16)
+            .map(|i| ((seed * 7 + i * 13) % 23) as f32 - 11.0 + seed as f32 * 0.01)
+            .collect()
+    };
+
+    let (doc, topic, cites);
+    let (docs, hub);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        doc = engine.get_or_create_label("Doc").unwrap();
+        topic = engine.get_or_create_label("Topic").unwrap();
+        cites = engine.get_or_create_rel_type("CITES").unwrap();
+        let mut tx = engine.begin_write();
+        docs = (0..300)
+            .map(|seed| {
+                let node = tx.create_node(u64::from(seed) + 1, doc).unwrap();
+                tx.set_vector(node, &embedding(seed)).unwrap();
+                node
+            })
+            .collect::<Vec<_>>();
+        hub = tx.create_node(1000, topic).unwrap();
+        tx.set_vector(hub, &embedding(42)).unwrap();
+        tx.create_edge(docs[42], cites, docs[7]).unwrap();
+        assert!(matches!(
+            tx.set_vector(hub, &[1.0, 2.0]),
+            Err(Error::InvalidVector(_))
+        ));
+        assert!(matches!(
+            tx.set_vector(hub, &[0.0; 16]),
+            Err(Error::InvalidVector(_))
+        ));
+        tx.commit().unwrap();
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let hits = snapshot.search_vectors(&embedding(42), 2, None);
+    assert_eq!(hits.len(), 2);
+    assert!(hits.iter().any(|(node, _)| *node == docs[42]));
+    assert!(hits.iter().any(|(node, _)| *node == hub));
+    assert!(hits[0].1 < 1e-4);
+    let docs_only = snapshot.search_vectors(&embedding(42), 1, Some(doc));
+    assert_eq!(docs_only[0].0, docs[42]);
+    let scaled: Vec<f32> = embedding(42).iter().map(|x| x * 3.0).collect();
+    assert_eq!(snapshot.search_vectors(&scaled, 1, Some(topic))[0].0, hub);
+
+    // Seeds and their expansion come from the same snapshot, whatever
+    // commits in between.
+    let mut tx = engine.begin_write();
+    tx.set_vector(docs[42], &embedding(200)).unwrap();
+    tx.tombstone_node(hub).unwrap();
+    tx.commit().unwrap();
+    let seeds = snapshot.search_vectors(&embedding(42), 1, Some(doc));
+    let expanded: Vec<u32> = seeds
+        .iter()
+        .flat_map(|(seed, _)| snapshot.neighbors(*seed, Some(cites)))
+        .map(|edge| edge.dst)
+        .collect();
+    assert_eq!(seeds[0].0, docs[42]);
+    assert_eq!(expanded, vec![docs[7]]);
+    assert_eq!(snapshot.node_vector(docs[42]).unwrap().len(), 16);
+
+    let latest = engine.snapshot();
+    assert!(
+        latest
+            .search_vectors(&embedding(42), 1, Some(topic))
+            .is_empty()
+    );
+    assert_ne!(
+        latest.search_vectors(&embedding(42), 1, Some(doc))[0].0,
+        docs[42]
+    );
+    assert!(latest.node_vector(hub).is_none());
+}
+
+#[test]
+fn core_0_1_concurrent_writers_commit_through_group_sync() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let (threads, commits) = (8u64, 25u64);
+    let person;
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        person = engine.get_or_create_label("Person").unwrap();
+        std::thread::scope(|scope| {
+            for thread in 0..threads {
+                let engine = &engine;
+                scope.spawn(move || {
+                    for commit in 0..commits {
+                        let mut tx = engine.begin_write();
+                        let node = tx.create_node(thread * 1000 + commit + 1, person).unwrap();
+                        tx.set_node_property(node, "n".to_string(), PropertyValue::Int(1))
+                            .unwrap();
+                        tx.commit().unwrap();
+                        // A returned commit is visible to new snapshots.
+                        assert!(
+                            engine
+                                .lookup_internal_id(thread * 1000 + commit + 1)
+                                .is_some()
+                        );
+                    }
+                });
+            }
+        });
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    assert_eq!(snapshot.node_count(Some(person)), threads * commits);
+    assert_eq!(
+        snapshot.nodes_with_label(person).count() as u64,
+        threads * commits
+    );
+}
+
+#[test]
+fn core_0_1_every_durability_mode_survives_reopen() {
+    let modes = [
+        Durability::SyncAll,
+        Durability::SyncData,
+        Durability::Buffered,
+        Durability::Periodic,
+    ];
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let person;
+    {
+        let engine = GraphEngine::open_with(
+            &path,
+            DbOptions {
+                durability: Durability::Periodic,
+                flush_interval: Duration::from_millis(10),
+                ..DbOptions::default()
+            },
+        )
+        .unwrap();
+        person = engine.get_or_create_label("Person").unwrap();
+        for (i, mode) in modes.into_iter().enumerate() {
+            let mut tx = engine.begin_write_with(mode);
+            tx.create_node(i as u64 + 1, person).unwrap();
+            tx.commit().unwrap();
+        }
+        // The database default applies to `begin_write`.
+        let mut tx = engine.begin_write();
+        tx.create_node(100, person).unwrap();
+        tx.commit().unwrap();
+        // Dropping the engine stops the flusher after one last sync.
+    }
+
+    let engine = GraphEngine::open(&path).unwrap();
+    for external_id in [1, 2, 3, 4, 100] {
+        assert!(engine.lookup_internal_id(external_id).is_some());
+    }
+    assert_eq!(engine.snapshot().node_count(Some(person)), 5);
+}
+
+#[test]
+fn core_0_1_bulk_load_matches_transactional_layout() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    // Node 1 is a hub with more neighbors than one adjacency bucket holds.
+    let node_count = 3000u64;
+    let nodes = (1..=node_count).map(|id| BulkNode {
+        external_id: id,
+        labels: if id % 2 == 0 {
+            vec!["Person".to_string(), "Even".to_string()]
+        } else {
+            vec!["Person".to_string()]
+        },
+        properties: vec![
+            ("name".to_string(), PropertyValue::String(format!("n{id}"))),
+            ("group".to_string(), PropertyValue::Int((id % 7) as i64)),
+        ],
+    });
+    let edges = (2..=node_count)
+        .map(|dst| BulkEdge {
+            src: 1,
+            rel: "LINK".to_string(),
+            dst,
+            properties: vec![("w".to_string(), PropertyValue::Int(1))],
+        })
+        .chain((2..node_count).map(|src| BulkEdge {
+            src,
+            rel: "NEXT".to_string(),
+            dst: src + 1,
+            properties: Vec::new(),
+        }))
+        // A repeated edge merges, and its last property value wins.
+        .chain([BulkEdge {
+            src: 1,
+            rel: "LINK".to_string(),
+            dst: 2,
+            properties: vec![("w".to_string(), PropertyValue::Int(9))],
+        }]);
+    let stats = bulk_load(&path, nodes, edges).unwrap();
+    assert_eq!(stats.nodes, node_count);
+    assert_eq!(stats.edges, 2 * (node_count - 1) - 1);
+
+    let engine = GraphEngine::open(&path).unwrap();
+    let snapshot = engine.snapshot();
+    let person = snapshot.resolve_label_id("Person").unwrap();
+    let even = snapshot.resolve_label_id("Even").unwrap();
+    let link = snapshot.resolve_rel_type_id("LINK").unwrap();
+    let next = snapshot.resolve_rel_type_id("NEXT").unwrap();
+    assert_eq!(snapshot.node_count(Some(person)), node_count);
+    assert_eq!(snapshot.node_count(Some(even)), node_count / 2);
+    assert_eq!(
+        snapshot.nodes_with_label(even).count() as u64,
+        node_count / 2
+    );
+    assert_eq!(snapshot.edge_count(Some(link)), node_count - 1);
+    assert_eq!(snapshot.edge_count(Some(next)), node_count - 2);
+
+    let hub = engine.lookup_internal_id(1).unwrap();
+    let two = engine.lookup_internal_id(2).unwrap();
+    assert_eq!(
+        snapshot.neighbors(hub, Some(link)).count() as u64,
+        node_count - 1
+    );
+    assert_eq!(snapshot.incoming_neighbors(two, Some(link)).count(), 1);
+    assert_eq!(
+        snapshot.node_property(two, "name"),
+        Some(PropertyValue::String("n2".to_string()))
+    );
+    let edge = EdgeKey {
+        src: hub,
+        rel: link,
+        dst: two,
+    };
+    assert_eq!(
+        snapshot.edge_property(edge, "w"),
+        Some(PropertyValue::Int(9))
+    );
+    assert_eq!(
+        snapshot
+            .nodes_with_label_and_property(even, "group", &PropertyValue::Int(3))
+            .count() as u64,
+        (1..=node_count)
+            .filter(|id| id % 2 == 0 && id % 7 == 3)
+            .count() as u64
+    );
+    assert_eq!(
+        snapshot
+            .edges_with_rel_and_property(link, "w", &PropertyValue::Int(9))
+            .collect::<Vec<_>>(),
+        vec![edge]
+    );
+    assert_eq!(
+        snapshot
+            .edges_with_rel_and_property(link, "w", &PropertyValue::Int(1))
+            .count() as u64,
+        node_count - 2
+    );
+
+    // The loaded graph takes ordinary transactions afterwards.
+    let mut tx = engine.begin_write();
+    let fresh = tx.create_node(node_count + 1, person).unwrap();
+    tx.create_edge(hub, link, fresh).unwrap();
+    tx.commit().unwrap();
+    assert_eq!(engine.snapshot().edge_count(Some(link)), node_count);
+}
+
+#[test]
+fn core_0_1_bulk_load_refuses_used_and_unfinished_directories() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    GraphEngine::open(&path).unwrap().close().unwrap();
+    assert!(matches!(
+        bulk_load(&path, Vec::new(), Vec::new()),
+        Err(Error::BulkLoad(_))
+    ));
+
+    let unfinished = dir.path().join("unfinished");
+    let edges = [BulkEdge {
+        src: 1,
+        rel: "LINK".to_string(),
+        dst: 2,
+        properties: Vec::new(),
+    }];
+    let nodes = [BulkNode {
+        external_id: 1,
+        labels: vec!["Person".to_string()],
+        properties: Vec::new(),
+    }];
+    // Node 2 is missing, so the load fails after its marker is written.
+    assert!(matches!(
+        bulk_load(&unfinished, nodes, edges),
+        Err(Error::BulkLoad(_))
+    ));
+    assert!(matches!(
+        GraphEngine::open(&unfinished),
+        Err(Error::BulkLoad(_))
+    ));
+}
+
+#[test]
+fn core_0_1_streamed_commit_spills_edges_and_applies_them_atomically() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let staging = dir.path().join("core-db.staging");
+    let options = DbOptions {
+        staging_budget: Some(4 << 10),
+        ..DbOptions::default()
+    };
+    let engine = GraphEngine::open_with(&path, options.clone()).unwrap();
+    let person = engine.get_or_create_label("Person").unwrap();
+    let link = engine.get_or_create_rel_type("LINK").unwrap();
+    let mut tx = engine.begin_write();
+    let hub = tx.create_node(1, person).unwrap();
+    let old = tx.create_node(2, person).unwrap();
+    tx.create_edge(hub, link, old).unwrap();
+    tx.set_edge_property(hub, link, old, "w".to_string(), PropertyValue::Int(0))
+        .unwrap();
+    tx.commit().unwrap();
+
+    let before = engine.snapshot();
+    let count = 2000u64;
+    let mut created = Vec::new();
+    let mut tx = engine.begin_write();
+    for id in 0..count {
+        let node = tx.create_node(100 + id, person).unwrap();
+        // The existing hub gets delta records; new nodes get packed lists.
+        tx.create_edge(hub, link, node).unwrap();
+        tx.set_edge_property(hub, link, node, "w".to_string(), PropertyValue::Int(1))
+            .unwrap();
+        if let Some(prev) = created.last() {
+            tx.create_edge(*prev, link, node).unwrap();
+        }
+        created.push(node);
+    }
+    assert!(staging.is_dir(), "the transaction should have spilled");
+    // Edges that only the runs hold can still be changed.
+    tx.set_edge_property(
+        hub,
+        link,
+        created[0],
+        "w".to_string(),
+        PropertyValue::Int(9),
+    )
+    .unwrap();
+    tx.tombstone_edge(hub, link, created[1]).unwrap();
+    tx.remove_edge_property(hub, link, created[2], "w").unwrap();
+    tx.set_edge_property(hub, link, old, "w".to_string(), PropertyValue::Int(5))
+        .unwrap();
+    tx.commit().unwrap();
+    assert!(!staging.exists());
+
+    // A snapshot from before the commit sees none of it.
+    assert_eq!(before.edge_count(Some(link)), 1);
+    assert_eq!(before.neighbors(hub, Some(link)).count(), 1);
+    assert_eq!(
+        before.edge_property(
+            EdgeKey {
+                src: hub,
+                rel: link,
+                dst: old
+            },
+            "w"
+        ),
+        Some(PropertyValue::Int(0))
+    );
+
+    let check = |engine: &GraphEngine| {
+        let snapshot = engine.snapshot();
+        let hub_edge = |dst| EdgeKey {
+            src: hub,
+            rel: link,
+            dst,
+        };
+        assert_eq!(snapshot.edge_count(Some(link)), 1 + (count - 1) * 2);
+        assert_eq!(snapshot.neighbors(hub, Some(link)).count() as u64, count);
+        assert_eq!(
+            snapshot.incoming_neighbors(created[1], Some(link)).count(),
+            1
+        );
+        assert_eq!(
+            snapshot.incoming_neighbors(created[5], Some(link)).count(),
+            2
+        );
+        assert_eq!(
+            snapshot
+                .neighbors(created[5], Some(link))
+                .collect::<Vec<_>>(),
+            vec![EdgeKey {
+                src: created[5],
+                rel: link,
+                dst: created[6],
+            }]
+        );
+        assert_eq!(
+            snapshot.edge_property(hub_edge(created[0]), "w"),
+            Some(PropertyValue::Int(9))
+        );
+        assert_eq!(snapshot.edge_property(hub_edge(created[2]), "w"), None);
+        assert_eq!(
+            snapshot.edge_property(hub_edge(created[3]), "w"),
+            Some(PropertyValue::Int(1))
+        );
+        assert_eq!(
+            snapshot
+                .edges_with_rel_and_property(link, "w", &PropertyValue::Int(1))
+                .count() as u64,
+            count - 3
+        );
+        assert_eq!(
+            snapshot
+                .edges_with_rel_and_property(link, "w", &PropertyValue::Int(5))
+                .collect::<Vec<_>>(),
+            vec![hub_edge(old)]
+        );
+        assert_eq!(
+            snapshot
+                .edges_with_rel_and_property(link, "w", &PropertyValue::Int(0))
+                .count(),
+            0
+        );
+    };
+    check(&engine);
+    drop(engine);
+    check(&GraphEngine::open_with(&path, options).unwrap());
+}
+
+#[test]
+fn core_0_1_failed_streamed_apply_rejects_writes_until_reopen() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let staging = dir.path().join("core-db.staging");
+    let options = DbOptions {
+        staging_budget: Some(4 << 10),
+        ..DbOptions::default()
+    };
+    let engine = GraphEngine::open_with(&path, options.clone()).unwrap();
+    let person = engine.get_or_create_label("Person").unwrap();
+    let link = engine.get_or_create_rel_type("LINK").unwrap();
+    let mut tx = engine.begin_write();
+    let hub = tx.create_node(1, person).unwrap();
+    tx.commit().unwrap();
+
+    let count = 500u64;
+    let mut tx = engine.begin_write();
+    for id in 0..count {
+        let node = tx.create_node(100 + id, person).unwrap();
+        tx.create_edge(hub, link, node).unwrap();
+    }
+    // Commit checks the outgoing runs only, so a torn incoming run fails
+    // while the runs are applied, after the marker is written.
+    let run = staging.join("in-000000.run");
+    let intact = std::fs::read(&run).unwrap();
+    std::fs::write(&run, &intact[..10]).unwrap();
+    assert!(matches!(tx.commit(), Err(Error::StorageCorrupted(_))));
+
+    // Readers keep the snapshot from before the commit.
+    let snapshot = engine.snapshot();
+    assert_eq!(snapshot.edge_count(Some(link)), 0);
+    assert_eq!(snapshot.neighbors(hub, Some(link)).count(), 0);
+
+    // Writes would be hidden and then overwritten, so they are refused.
+    let mut tx = engine.begin_write();
+    tx.create_node(1_000_000, person).unwrap();
+    assert!(matches!(tx.commit(), Err(Error::StreamedCommitUnfinished)));
+    assert!(matches!(
+        engine.get_or_create_label("Other"),
+        Err(Error::StreamedCommitUnfinished)
+    ));
+    assert!(matches!(
+        engine.merge_adjacency_deltas(),
+        Err(Error::StreamedCommitUnfinished)
+    ));
+    drop(engine);
+
+    std::fs::write(&run, &intact).unwrap();
+    let engine = GraphEngine::open_with(&path, options).unwrap();
+    assert!(!staging.exists());
+    let snapshot = engine.snapshot();
+    assert_eq!(snapshot.edge_count(Some(link)), count);
+    assert_eq!(snapshot.neighbors(hub, Some(link)).count() as u64, count);
+    assert!(engine.lookup_internal_id(1_000_000).is_none());
+    let mut tx = engine.begin_write();
+    tx.create_node(1_000_000, person).unwrap();
+    tx.commit().unwrap();
+}
+
+#[test]
+fn core_0_1_interrupted_streamed_commit_finishes_on_open() {
+    let dir = tempdir().unwrap();
+    let path = db_dir(&dir);
+    let staging = dir.path().join("core-db.staging");
+    let (a, b, c, link);
+    {
+        let engine = GraphEngine::open(&path).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        link = engine.get_or_create_rel_type("LINK").unwrap();
+        let mut tx = engine.begin_write();
+        a = tx.create_node(1, person).unwrap();
+        b = tx.create_node(2, person).unwrap();
+        c = tx.create_node(3, person).unwrap();
+        tx.set_node_property(a, "w".to_string(), PropertyValue::Int(0))
+            .unwrap();
+        tx.commit().unwrap();
+        engine.close().unwrap();
+    }
+
+    // Crash state: the marker batch is committed and the runs are persisted,
+    // but none of them was applied.
+    {
+        let db = Database::builder(&path).open().unwrap();
+        let meta = db.keyspace("meta", KeyspaceCreateOptions::default).unwrap();
+        let mut batch = db.batch().durability(Some(PersistMode::SyncAll));
+        batch.insert(&meta, b"streamed_commit", [0u8; 8]);
+        batch.commit().unwrap();
+    }
+    let run_key = |node: u32, other: u32| {
+        [node.to_be_bytes(), link.to_be_bytes(), other.to_be_bytes()].concat()
+    };
+    let write_run = |name: &str, records: Vec<(Vec<u8>, Vec<u8>)>| {
+        let mut bytes = Vec::new();
+        for (key, value) in records {
+            bytes.extend_from_slice(&(key.len() as u32).to_be_bytes());
+            bytes.extend_from_slice(&(value.len() as u32).to_be_bytes());
+            bytes.extend_from_slice(&key);
+            bytes.extend_from_slice(&value);
+        }
+        std::fs::write(staging.join(format!("{name}-000000.run")), bytes).unwrap();
+    };
+    std::fs::create_dir_all(&staging).unwrap();
+    write_run(
+        "out",
+        vec![(run_key(a, b), Vec::new()), (run_key(a, c), Vec::new())],
+    );
+    write_run(
+        "in",
+        vec![(run_key(b, a), Vec::new()), (run_key(c, a), Vec::new())],
+    );
+    write_run(
+        "props",
+        vec![(
+            [run_key(a, b), b"w".to_vec()].concat(),
+            PropertyValue::Int(7).encode(),
+        )],
+    );
+
+    let engine = GraphEngine::open(&path).unwrap();
+    assert!(!staging.exists());
+    let snapshot = engine.snapshot();
+    assert_eq!(snapshot.neighbors(a, Some(link)).count(), 2);
+    assert_eq!(snapshot.incoming_neighbors(c, Some(link)).count(), 1);
+    assert_eq!(
+        snapshot.edge_property(
+            EdgeKey {
+                src: a,
+                rel: link,
+                dst: b,
+            },
+            "w"
+        ),
+        Some(PropertyValue::Int(7))
+    );
+}
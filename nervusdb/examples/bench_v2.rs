@@ -4,6 +4,7 @@
 //! public `nervusdb::Db` facade so benchmark scripts do not depend on local
 //! `publish = false` wrapper crates.
 
+use nervusdb::query::{ExecuteOptions, Params, prepare};
 use nervusdb::{Db, GraphSnapshot, PropertyValue};
 use std::time::Instant;
 use tempfile::tempdir;
@@ -14,6 +15,7 @@ struct Config {
     degree: usize,
     iters: usize,
     write_iters: usize,
+    supernode_degree: usize,
 }
 
 #[derive(Debug, Clone, Copy)]
@@ -40,6 +42,19 @@ struct PropertyLookupBenchResult {
     p99_us: f64,
 }
 
+#[derive(Debug, Clone, Copy)]
+struct KHopBenchResult {
+    paths_total: u64,
+    paths_per_sec: f64,
+    p99_us: f64,
+}
+
+#[derive(Debug, Clone, Copy)]
+struct PipelineBenchResult {
+    rows_total: u64,
+    rows_per_sec: f64,
+}
+
 #[derive(Debug, Clone)]
 struct InsertBenchResult {
     nodes: Vec<u32>,
@@ -67,6 +82,7 @@ impl Config {
             degree: 8,
             iters: 2_000,
             write_iters: 200,
+            supernode_degree: 16_384,
         };
 
         let mut args = std::env::args().skip(1);
@@ -76,9 +92,10 @@ impl Config {
                 "--degree" => cfg.degree = parse_usize(args.next()),
                 "--iters" => cfg.iters = parse_usize(args.next()),
                 "--write-iters" => cfg.write_iters = parse_usize(args.next()),
+                "--supernode-degree" => cfg.supernode_degree = parse_usize(args.next()),
                 _ => {
                     eprintln!(
-                        "unknown arg: {arg}\n  supported: --nodes N --degree D --iters I --write-iters W"
+                        "unknown arg: {arg}\n  supported: --nodes N --degree D --iters I --write-iters W --supernode-degree S"
                     );
                     std::process::exit(2);
                 }
@@ -101,6 +118,10 @@ impl Config {
             eprintln!("--write-iters must be > 0");
             std::process::exit(2);
         }
+        if cfg.supernode_degree == 0 {
+            eprintln!("--supernode-degree must be > 0");
+            std::process::exit(2);
+        }
 
         cfg
     }
@@ -240,9 +261,48 @@ fn main() {
     );
     let property_lookup_speedup =
         stage_property_lookup_scan_ms / stage_property_lookup_index_ms.max(1e-9);
+    let stage_csr_build_start = Instant::now();
+    let lsm = db.snapshot();
+    let csr = lsm.build_csr_view();
+    let stage_csr_build_ms = elapsed_ms(stage_csr_build_start);
+    let csr_heap_bytes = csr.heap_bytes();
+    let two_hop_lsm = bench_khop(&lsm, &insert.nodes, insert.rel, 2, cfg.iters);
+    let two_hop_csr = bench_khop(&csr, &insert.nodes, insert.rel, 2, cfg.iters);
+    let three_hop_lsm = bench_khop(&lsm, &insert.nodes, insert.rel, 3, cfg.iters);
+    let three_hop_csr = bench_khop(&csr, &insert.nodes, insert.rel, 3, cfg.iters);
+    assert_eq!(
+        two_hop_lsm.paths_total, two_hop_csr.paths_total,
+        "LSM and CSR 2-hop expansion must visit the same paths"
+    );
+    assert_eq!(
+        three_hop_lsm.paths_total, three_hop_csr.paths_total,
+        "LSM and CSR 3-hop expansion must visit the same paths"
+    );
+    let two_hop_speedup = two_hop_csr.paths_per_sec / two_hop_lsm.paths_per_sec.max(1e-9);
+    let three_hop_speedup = three_hop_csr.paths_per_sec / three_hop_lsm.paths_per_sec.max(1e-9);
+    drop(csr);
+    drop(lsm);
+    let pipeline_passes = (2_000_000 / total_edges.max(1)).clamp(1, cfg.iters);
+    let pipeline_row = bench_pipeline(&db, 0, pipeline_passes);
+    let pipeline_batch = bench_pipeline(&db, ExecuteOptions::default().batch_rows, pipeline_passes);
+    assert_eq!(
+        pipeline_row.rows_total, pipeline_batch.rows_total,
+        "row and batched execution must return the same rows"
+    );
+    let pipeline_batch_speedup = pipeline_batch.rows_per_sec / pipeline_row.rows_per_sec.max(1e-9);
     let stage_write_txn_start = Instant::now();
     let write_txn = bench_write_txn(&db, insert.label, cfg.nodes as u64 + 1, cfg.write_iters);
     let stage_write_txn_ms = elapsed_ms(stage_write_txn_start);
+    let stage_supernode_commit_start = Instant::now();
+    let supernode_commit = bench_supernode_commit(
+        &db,
+        insert.label,
+        insert.rel,
+        (cfg.nodes + cfg.write_iters) as u64 + 1,
+        cfg.supernode_degree,
+        cfg.write_iters,
+    );
+    let stage_supernode_commit_ms = elapsed_ms(stage_supernode_commit_start);
     let read_query_p99_ms = neighbors_cold.p99_us / 1_000.0;
     let write_txn_p99_ms = write_txn.p99_us / 1_000.0;
     let estimated_kv_writes = (6 * cfg.nodes) + (2 * total_edges);
@@ -286,6 +346,13 @@ fn main() {
         "write_txn: avg={:.2}us, p95={:.2}us, p99={:.2}us ({:.4}ms)",
         write_txn.avg_us, write_txn.p95_us, write_txn.p99_us, write_txn_p99_ms
     );
+    println!(
+        "supernode_commit: degree={} avg={:.2}us, p95={:.2}us, p99={:.2}us",
+        cfg.supernode_degree,
+        supernode_commit.avg_us,
+        supernode_commit.p95_us,
+        supernode_commit.p99_us
+    );
     println!(
         "property_lookup: scan={:.2}ms p99={:.2}us index={:.2}ms p99={:.2}us speedup={:.2}x rows={}",
         stage_property_lookup_scan_ms,
@@ -295,14 +362,34 @@ fn main() {
         property_lookup_speedup,
         property_lookup_index.rows_total
     );
+    println!(
+        "csr_view: build={:.2}ms heap={}B 2hop lsm={:.0} csr={:.0} paths/sec ({:.2}x) 3hop lsm={:.0} csr={:.0} paths/sec ({:.2}x)",
+        stage_csr_build_ms,
+        csr_heap_bytes,
+        two_hop_lsm.paths_per_sec,
+        two_hop_csr.paths_per_sec,
+        two_hop_speedup,
+        three_hop_lsm.paths_per_sec,
+        three_hop_csr.paths_per_sec,
+        three_hop_speedup
+    );
+    println!(
+        "pipeline: passes={} rows={} row={:.0} batch={:.0} rows/sec ({:.2}x)",
+        pipeline_passes,
+        pipeline_batch.rows_total,
+        pipeline_row.rows_per_sec,
+        pipeline_batch.rows_per_sec,
+        pipeline_batch_speedup
+    );
 
     println!(
-        "{{\"nodes\":{},\"degree\":{},\"edges\":{},\"iters\":{},\"write_iters\":{},\"stage_open_ms\":{:.3},\"stage_get_schema_ms\":{:.3},\"stage_create_nodes_ms\":{:.3},\"stage_create_edges_ms\":{:.3},\"stage_commit_ms\":{:.3},\"stage_reopen_verify_ms\":{:.3},\"stage_neighbors_hot_ms\":{:.3},\"stage_neighbors_cold_ms\":{:.3},\"stage_property_lookup_scan_ms\":{:.3},\"stage_property_lookup_index_ms\":{:.3},\"stage_write_txn_ms\":{:.3},\"insert_total_ms\":{:.3},\"insert_edges_per_sec\":{:.3},\"estimated_kv_writes\":{},\"neighbors_hot_edges_per_sec\":{:.3},\"neighbors_cold_edges_per_sec\":{:.3},\"neighbors_hot_avg_us\":{:.3},\"neighbors_hot_p95_us\":{:.3},\"neighbors_hot_p99_us\":{:.3},\"neighbors_cold_avg_us\":{:.3},\"neighbors_cold_p95_us\":{:.3},\"neighbors_cold_p99_us\":{:.3},\"property_lookup_iters\":{},\"property_lookup_rows\":{},\"property_lookup_scan_avg_us\":{:.3},\"property_lookup_scan_p95_us\":{:.3},\"property_lookup_scan_p99_us\":{:.3},\"property_lookup_index_avg_us\":{:.3},\"property_lookup_index_p95_us\":{:.3},\"property_lookup_index_p99_us\":{:.3},\"property_lookup_speedup\":{:.3},\"write_txn_avg_us\":{:.3},\"write_txn_p95_us\":{:.3},\"write_txn_p99_us\":{:.3},\"write_txn_p99_ms\":{:.6},\"read_query_p99_ms\":{:.6}}}",
+        "{{\"nodes\":{},\"degree\":{},\"edges\":{},\"iters\":{},\"write_iters\":{},\"supernode_degree\":{},\"stage_open_ms\":{:.3},\"stage_get_schema_ms\":{:.3},\"stage_create_nodes_ms\":{:.3},\"stage_create_edges_ms\":{:.3},\"stage_commit_ms\":{:.3},\"stage_reopen_verify_ms\":{:.3},\"stage_neighbors_hot_ms\":{:.3},\"stage_neighbors_cold_ms\":{:.3},\"stage_property_lookup_scan_ms\":{:.3},\"stage_property_lookup_index_ms\":{:.3},\"stage_write_txn_ms\":{:.3},\"stage_supernode_commit_ms\":{:.3},\"insert_total_ms\":{:.3},\"insert_edges_per_sec\":{:.3},\"estimated_kv_writes\":{},\"neighbors_hot_edges_per_sec\":{:.3},\"neighbors_cold_edges_per_sec\":{:.3},\"neighbors_hot_avg_us\":{:.3},\"neighbors_hot_p95_us\":{:.3},\"neighbors_hot_p99_us\":{:.3},\"neighbors_cold_avg_us\":{:.3},\"neighbors_cold_p95_us\":{:.3},\"neighbors_cold_p99_us\":{:.3},\"property_lookup_iters\":{},\"property_lookup_rows\":{},\"property_lookup_scan_avg_us\":{:.3},\"property_lookup_scan_p95_us\":{:.3},\"property_lookup_scan_p99_us\":{:.3},\"property_lookup_index_avg_us\":{:.3},\"property_lookup_index_p95_us\":{:.3},\"property_lookup_index_p99_us\":{:.3},\"property_lookup_speedup\":{:.3},\"write_txn_avg_us\":{:.3},\"write_txn_p95_us\":{:.3},\"write_txn_p99_us\":{:.3},\"write_txn_p99_ms\":{:.6},\"supernode_commit_avg_us\":{:.3},\"supernode_commit_p95_us\":{:.3},\"supernode_commit_p99_us\":{:.3},\"stage_csr_build_ms\":{:.3},\"csr_heap_bytes\":{},\"two_hop_lsm_paths_per_sec\":{:.3},\"two_hop_csr_paths_per_sec\":{:.3},\"two_hop_lsm_p99_us\":{:.3},\"two_hop_csr_p99_us\":{:.3},\"two_hop_csr_speedup\":{:.3},\"three_hop_lsm_paths_per_sec\":{:.3},\"three_hop_csr_paths_per_sec\":{:.3},\"three_hop_lsm_p99_us\":{:.3},\"three_hop_csr_p99_us\":{:.3},\"three_hop_csr_speedup\":{:.3},\"pipeline_passes\":{},\"pipeline_row_rows_per_sec\":{:.3},\"pipeline_batch_rows_per_sec\":{:.3},\"pipeline_batch_speedup\":{:.3},\"read_query_p99_ms\":{:.6}}}",
         cfg.nodes,
         cfg.degree,
         total_edges,
         cfg.iters,
         cfg.write_iters,
+        cfg.supernode_degree,
         stage_open_ms,
         insert.stage_get_schema_ms,
         insert.stage_create_nodes_ms,
@@ -314,6 +401,7 @@ fn main() {
         stage_property_lookup_scan_ms,
         stage_property_lookup_index_ms,
         stage_write_txn_ms,
+        stage_supernode_commit_ms,
         insert_total_ms,
         insert_edges_per_sec,
         estimated_kv_writes,
@@ -338,6 +426,25 @@ fn main() {
         write_txn.p95_us,
         write_txn.p99_us,
         write_txn_p99_ms,
+        supernode_commit.avg_us,
+        supernode_commit.p95_us,
+        supernode_commit.p99_us,
+        stage_csr_build_ms,
+        csr_heap_bytes,
+        two_hop_lsm.paths_per_sec,
+        two_hop_csr.paths_per_sec,
+        two_hop_lsm.p99_us,
+        two_hop_csr.p99_us,
+        two_hop_speedup,
+        three_hop_lsm.paths_per_sec,
+        three_hop_csr.paths_per_sec,
+        three_hop_lsm.p99_us,
+        three_hop_csr.p99_us,
+        three_hop_speedup,
+        pipeline_passes,
+        pipeline_row.rows_per_sec,
+        pipeline_batch.rows_per_sec,
+        pipeline_batch_speedup,
         read_query_p99_ms
     );
 }
@@ -486,6 +593,110 @@ fn bench_write_txn(
     summarize_write_txn_bench(latencies_us)
 }
 
+/// Measures single-edge commits against a node that already has
+/// `supernode_degree` outgoing edges. With bucketed adjacency this should stay
+/// close to `write_txn` latency instead of growing with the hub degree.
+fn bench_supernode_commit(
+    db: &Db,
+    label: u32,
+    rel: u32,
+    start_external_id: u64,
+    supernode_degree: usize,
+    write_iters: usize,
+) -> WriteTxnBenchResult {
+    let mut tx = db.begin_write();
+    let hub = tx.create_node(start_external_id, label).unwrap();
+    let mut leaves = Vec::with_capacity(supernode_degree + write_iters);
+    for i in 0..(supernode_degree + write_iters) {
+        leaves.push(
+            tx.create_node(start_external_id + 1 + i as u64, label)
+                .unwrap(),
+        );
+    }
+    for leaf in &leaves[..supernode_degree] {
+        tx.create_edge(hub, rel, *leaf).unwrap();
+    }
+    tx.commit().unwrap();
+
+    let mut latencies_us = Vec::with_capacity(write_iters);
+    for leaf in &leaves[supernode_degree..] {
+        let t0 = Instant::now();
+        let mut tx = db.begin_write();
+        tx.create_edge(hub, rel, *leaf).unwrap();
+        tx.commit().unwrap();
+        latencies_us.push(t0.elapsed().as_secs_f64() * 1_000_000.0);
+    }
+    summarize_write_txn_bench(latencies_us)
+}
+
+/// Expands `hops` levels of `rel` from random start nodes and counts the
+/// paths reached. Generic so the same loop runs on the LSM snapshot and on
+/// the CSR view.
+fn bench_khop<S: GraphSnapshot>(
+    snap: &S,
+    nodes: &[u32],
+    rel: u32,
+    hops: usize,
+    iters: usize,
+) -> KHopBenchResult {
+    let mut rng = SplitMix64::new(0x1319_8a2e_0370_7344);
+    let mut latencies_us = Vec::with_capacity(iters);
+    let mut paths_total: u64 = 0;
+    let mut frontier = Vec::new();
+    let mut next = Vec::new();
+    let start = Instant::now();
+    for _ in 0..iters {
+        let idx = (rng.next_u64() as usize) % nodes.len();
+        let t0 = Instant::now();
+        frontier.clear();
+        frontier.push(nodes[idx]);
+        for _ in 0..hops {
+            next.clear();
+            for node in &frontier {
+                next.extend(snap.neighbors(*node, Some(rel)).map(|edge| edge.dst));
+            }
+            std::mem::swap(&mut frontier, &mut next);
+        }
+        paths_total += frontier.len() as u64;
+        latencies_us.push(t0.elapsed().as_secs_f64() * 1_000_000.0);
+    }
+    let secs = start.elapsed().as_secs_f64().max(1e-9);
+    KHopBenchResult {
+        paths_total,
+        paths_per_sec: paths_total as f64 / secs,
+        p99_us: percentile_us(latencies_us, 0.99),
+    }
+}
+
+/// Runs a scan, expand, filter, and project query over the whole graph
+/// `passes` times, a row at a time when `batch_rows` is 0 and in batches
+/// otherwise.
+fn bench_pipeline(db: &Db, batch_rows: usize, passes: usize) -> PipelineBenchResult {
+    let query = prepare(
+        "MATCH (a:BenchNode)-[:BENCH_EDGE]->(b) WHERE b.name <> 'node_0' RETURN a.name, b.name",
+    )
+    .unwrap();
+    let params = Params::with_execute_options(ExecuteOptions {
+        batch_rows,
+        soft_timeout_ms: 0,
+        ..ExecuteOptions::default()
+    });
+    let snap = db.snapshot();
+    let mut rows_total: u64 = 0;
+    let start = Instant::now();
+    for _ in 0..passes {
+        for row in query.execute_streaming(&snap, &params) {
+            row.unwrap();
+            rows_total += 1;
+        }
+    }
+    let secs = start.elapsed().as_secs_f64().max(1e-9);
+    PipelineBenchResult {
+        rows_total,
+        rows_per_sec: rows_total as f64 / secs,
+    }
+}
+
 #[derive(Debug, Clone)]
 struct SplitMix64 {
     state: u64,
@@ -4,7 +4,7 @@
 //! released NervusDB facade against two SQLite graph schemas using the same
 //! generated property-graph workload.
 
-use nervusdb::{Db, GraphSnapshot, PropertyValue};
+use nervusdb::{BulkEdge, BulkNode, Db, GraphSnapshot, PropertyValue};
 use rusqlite::{Connection, OptionalExtension, params};
 use serde_json::{Map, Value, json};
 use std::cmp::min;
@@ -58,6 +58,8 @@ struct Config {
     iters: usize,
     mutation_iters: usize,
     seed: u64,
+    /// Load NervusDB through `Db::bulk_load` instead of one write transaction.
+    bulk_load: bool,
 }
 
 impl Config {
@@ -68,6 +70,7 @@ impl Config {
         let mut iters = 1_000;
         let mut mutation_iters: Option<usize> = None;
         let mut seed = 1;
+        let mut bulk_load = false;
 
         let mut args = std::env::args().skip(1);
         while let Some(arg) = args.next() {
@@ -80,9 +83,19 @@ impl Config {
                     mutation_iters = Some(parse_usize(args.next(), "--mutation-iters"));
                 }
                 "--seed" => seed = parse_u64(args.next(), "--seed"),
+                "--nervusdb-load" => {
+                    bulk_load = match required_value(args.next(), "--nervusdb-load").as_str() {
+                        "txn" => false,
+                        "bulk" => true,
+                        other => {
+                            eprintln!("unknown --nervusdb-load: {other}\n  supported: txn | bulk");
+                            std::process::exit(2);
+                        }
+                    };
+                }
                 _ => {
                     eprintln!(
-                        "unknown arg: {arg}\n  supported: --system S --nodes N --degree D --iters I --mutation-iters M --seed SEED"
+                        "unknown arg: {arg}\n  supported: --system S --nodes N --degree D --iters I --mutation-iters M --seed SEED --nervusdb-load txn|bulk"
                     );
                     std::process::exit(2);
                 }
@@ -114,6 +127,7 @@ impl Config {
             iters,
             mutation_iters,
             seed,
+            bulk_load,
         }
     }
 
@@ -278,7 +292,12 @@ fn metrics_json(cfg: &Config, metrics: &RunMetrics) -> Value {
     out.insert("system".to_string(), json!(cfg.system.as_str()));
     out.insert("system_version".to_string(), json!(metrics.system_version));
     out.insert("profile".to_string(), json!("safe"));
-    out.insert("load_mode".to_string(), json!("single_transaction"));
+    let load_mode = if cfg.system == System::NervusDb && cfg.bulk_load {
+        "bulk_load"
+    } else {
+        "single_transaction"
+    };
+    out.insert("load_mode".to_string(), json!(load_mode));
     out.insert("dataset".to_string(), json!("custom"));
     out.insert("shape".to_string(), json!("uniform_degree"));
     out.insert("seed".to_string(), json!(cfg.seed));
@@ -396,11 +415,15 @@ fn metrics_json(cfg: &Config, metrics: &RunMetrics) -> Value {
 
 fn run_nervusdb(cfg: &Config, temp: &TempDir) -> AnyResult<RunMetrics> {
     let path = temp.path().join("nervusdb");
-    let db = Db::open(&path)?;
-
-    let (node_ids, label, rel, load_nodes_ms, load_edges_ms, commit_ms) = load_nervusdb(&db, cfg)?;
+    let (node_ids, label, rel, load_nodes_ms, load_edges_ms, commit_ms) = if cfg.bulk_load {
+        load_nervusdb_bulk(&path, cfg)?
+    } else {
+        let db = Db::open(&path)?;
+        let loaded = load_nervusdb(&db, cfg)?;
+        db.close()?;
+        loaded
+    };
 
-    db.close()?;
     let reopen = reopen_verify_nervusdb(&path, label, rel, cfg)?;
     let db = Db::open(&path)?;
 
@@ -438,7 +461,11 @@ fn run_nervusdb(cfg: &Config, temp: &TempDir) -> AnyResult<RunMetrics> {
         correctness_hash,
         notes: vec![
             "NervusDB public Rust facade".to_string(),
-            "load_nodes_ms and load_edges_ms measure public API staging loops; commit_ms is the durable batch boundary".to_string(),
+            if cfg.bulk_load {
+                "bulk load: load_nodes_ms and load_edges_ms build the inputs; commit_ms is Db::bulk_load through its final sync".to_string()
+            } else {
+                "load_nodes_ms and load_edges_ms measure public API staging loops; commit_ms is the durable batch boundary".to_string()
+            },
         ],
     })
 }
@@ -521,6 +548,69 @@ fn load_nervusdb(db: &Db, cfg: &Config) -> AnyResult<(Vec<u32>, u32, u32, f64, f
     ))
 }
 
+fn load_nervusdb_bulk(path: &Path, cfg: &Config) -> AnyResult<(Vec<u32>, u32, u32, f64, f64, f64)> {
+    let load_nodes_start = Instant::now();
+    let nodes = (0..cfg.nodes)
+        .map(|i| BulkNode {
+            external_id: (i + 1) as u64,
+            labels: vec![LABEL_NAME.to_string()],
+            properties: vec![
+                ("name".to_string(), PropertyValue::String(node_name(i))),
+                ("kind".to_string(), PropertyValue::String(node_kind(i))),
+                (
+                    "status".to_string(),
+                    PropertyValue::String("active".to_string()),
+                ),
+                ("chapter".to_string(), PropertyValue::Int((i % 64) as i64)),
+            ],
+        })
+        .collect::<Vec<_>>();
+    let load_nodes_ms = elapsed_ms(load_nodes_start);
+
+    let load_edges_start = Instant::now();
+    let edges = generated_edges(cfg)
+        .map(|(src_idx, dst_idx)| BulkEdge {
+            src: (src_idx + 1) as u64,
+            rel: REL_NAME.to_string(),
+            dst: (dst_idx + 1) as u64,
+            properties: Vec::new(),
+        })
+        .collect::<Vec<_>>();
+    let load_edges_ms = elapsed_ms(load_edges_start);
+
+    let commit_start = Instant::now();
+    Db::bulk_load(path, nodes, edges)?;
+    let commit_ms = elapsed_ms(commit_start);
+
+    let db = Db::open(path)?;
+    let (node_ids, label, rel) = {
+        let snapshot = db.snapshot();
+        let mut node_ids = vec![0u32; cfg.nodes];
+        for node in snapshot.nodes() {
+            if let Some(external_id) = snapshot.resolve_external(node) {
+                node_ids[external_id as usize - 1] = node;
+            }
+        }
+        let label = snapshot
+            .resolve_label_id(LABEL_NAME)
+            .ok_or("bulk-loaded label missing")?;
+        let rel = snapshot
+            .resolve_rel_type_id(REL_NAME)
+            .ok_or("bulk-loaded rel type missing")?;
+        (node_ids, label, rel)
+    };
+    db.close()?;
+
+    Ok((
+        node_ids,
+        label,
+        rel,
+        load_nodes_ms,
+        load_edges_ms,
+        commit_ms,
+    ))
+}
+
 fn bench_nervusdb_lookup(
     db: &Db,
     label: u32,
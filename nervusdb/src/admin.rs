@@ -5,8 +5,16 @@
 //! maintenance commands.
 
 use crate::api::{EdgeKey, InternalNodeId, LabelId, PropertyValue, RelTypeId};
+use crate::storage::composite_index::{CompositeDefs, composite_index_keys};
 use crate::storage::engine::{GraphEngine, scalar_indexable_value};
+use crate::storage::fulltext_index::{
+    FulltextDefs, build_postings, decode_posting, encode_posting, fulltext_entries,
+};
+use crate::storage::label_bitmap::{LabelChunk, join_node_id, split_node_id};
 use crate::storage::layout::*;
+use crate::storage::property_keys::PropertyKeyId;
+use crate::storage::property_row::PropertyRow;
+use crate::storage::unique_constraint::{UniqueDefs, unique_index_keys};
 use crate::{Error, Result};
 use fjall::{PersistMode, Readable};
 use serde::Serialize;
@@ -40,7 +48,10 @@ pub struct FsckChecked {
     pub idx_node_props: u64,
     pub adj_out: u64,
     pub adj_in: u64,
+    pub adj_deltas: u64,
     pub edge_props: u64,
+    pub idx_edge_props: u64,
+    pub counters: u64,
 }
 
 /// One fsck-lite issue.
@@ -67,6 +78,8 @@ pub enum FsckIssueKind {
     StaleLabelNodeIndex,
     MissingNodePropertyIndex,
     StaleNodePropertyIndex,
+    MissingEdgePropertyIndex,
+    StaleEdgePropertyIndex,
     AdjacencyMismatch,
     OrphanEdgeProperty,
     OrphanNodeProperty,
@@ -78,7 +91,13 @@ pub enum FsckIssueKind {
     MalformedNodePropertyIndex,
     MalformedAdjOut,
     MalformedAdjIn,
+    MalformedAdjDelta,
     MalformedEdgeProperty,
+    MalformedEdgePropertyIndex,
+    LabelCountMismatch,
+    RelCountMismatch,
+    MalformedCounter,
+    DuplicateUniqueValue,
 }
 
 /// One fsck-lite repair action.
@@ -95,6 +114,8 @@ pub struct FsckRepair {
 pub enum FsckRepairKind {
     RebuiltLabelNodes,
     RebuiltNodePropertyIndex,
+    RebuiltCounters,
+    RebuiltEdgePropertyIndex,
 }
 
 #[derive(Debug, Default)]
@@ -103,21 +124,36 @@ struct CheckState {
     issues: Vec<FsckIssue>,
     live_nodes: BTreeSet<InternalNodeId>,
     node_labels: BTreeMap<InternalNodeId, BTreeSet<LabelId>>,
-    node_props: BTreeMap<InternalNodeId, BTreeMap<String, PropertyValue>>,
-    expected_label_nodes: BTreeSet<Vec<u8>>,
-    actual_label_nodes: BTreeSet<Vec<u8>>,
-    all_label_node_keys: Vec<Vec<u8>>,
+    property_keys: BTreeMap<PropertyKeyId, String>,
+    composite_defs: CompositeDefs,
+    unique_defs: UniqueDefs,
+    fulltext_defs: FulltextDefs,
+    node_props: BTreeMap<InternalNodeId, BTreeMap<PropertyKeyId, PropertyValue>>,
+    expected_label_nodes: BTreeSet<(LabelId, InternalNodeId)>,
+    actual_label_nodes: BTreeSet<(LabelId, InternalNodeId)>,
+    all_label_bitmap_keys: Vec<Vec<u8>>,
     expected_node_prop_indexes: BTreeSet<Vec<u8>>,
     actual_node_prop_indexes: BTreeSet<Vec<u8>>,
     all_node_prop_index_keys: Vec<Vec<u8>>,
+    expected_unique_entries: BTreeMap<Vec<u8>, InternalNodeId>,
+    all_unique_index_keys: Vec<Vec<u8>>,
+    expected_fulltext_postings: BTreeMap<Vec<u8>, Vec<InternalNodeId>>,
+    all_fulltext_posting_keys: Vec<Vec<u8>>,
     adj_out: BTreeSet<EdgeKey>,
     adj_in: BTreeSet<EdgeKey>,
+    expected_edge_prop_indexes: BTreeSet<Vec<u8>>,
+    actual_edge_prop_indexes: BTreeSet<Vec<u8>>,
+    all_edge_prop_index_keys: Vec<Vec<u8>>,
+    all_counter_keys: Vec<Vec<u8>>,
+    expected_label_counts: BTreeMap<LabelId, u64>,
+    expected_rel_counts: BTreeMap<RelTypeId, u64>,
 }
 
 /// Run fsck-lite against a database directory.
 ///
-/// `repair` mode is intended for offline use. It only rebuilds derived indexes
-/// (`label_nodes` and `idx_node_props`) from canonical graph keyspaces.
+/// `repair` mode is intended for offline use. It only rebuilds derived state
+/// (`label_nodes`, `idx_node_props`, `idx_edge_props`, and the `meta`
+/// counters) from canonical graph keyspaces.
 pub fn fsck(path: impl AsRef<Path>, options: FsckOptions) -> Result<FsckReport> {
     let engine = GraphEngine::open(path).map_err(Error::from)?;
     fsck_engine(&engine, options).map_err(Error::from)
@@ -129,7 +165,7 @@ fn fsck_engine(engine: &GraphEngine, options: FsckOptions) -> crate::storage::Re
         return Ok(report_from_state(false, initial, Vec::new()));
     }
 
-    let _guard = engine.write_lock.lock().unwrap();
+    let _guard = engine.lock_writes()?;
     let repairs = repair_derived_indexes(engine, &initial)?;
     drop(_guard);
 
@@ -137,6 +173,16 @@ fn fsck_engine(engine: &GraphEngine, options: FsckOptions) -> crate::storage::Re
     Ok(report_from_state(true, final_state, repairs))
 }
 
+impl CheckState {
+    /// Interned name of `id`, or `#id` when the dictionary has no entry.
+    fn property_key_name(&self, id: PropertyKeyId) -> String {
+        self.property_keys
+            .get(&id)
+            .cloned()
+            .unwrap_or_else(|| format!("#{id}"))
+    }
+}
+
 fn report_from_state(repaired: bool, state: CheckState, repairs: Vec<FsckRepair>) -> FsckReport {
     FsckReport {
         ok: state.issues.is_empty(),
@@ -193,9 +239,7 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
         };
         if state.live_nodes.contains(&node) {
             state.node_labels.entry(node).or_default().insert(label);
-            state
-                .expected_label_nodes
-                .insert(label_node_key(label, node));
+            state.expected_label_nodes.insert((label, node));
         } else {
             state.issues.push(
                 FsckIssue::new(FsckIssueKind::OrphanNodeLabel)
@@ -205,53 +249,129 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
         }
     }
 
-    for guard in snapshot.prefix(&keyspaces.graph_data, node_prop_scan_prefix()) {
-        state.checked.node_props += 1;
+    for guard in snapshot.prefix(&keyspaces.graph_data, prop_key_id_scan_prefix()) {
+        let Ok((key, value)) = guard.into_inner() else {
+            continue;
+        };
+        if let (Some(id), Ok(name)) = (
+            parse_prop_key_id_key(key.as_ref()),
+            String::from_utf8(value.as_ref().to_vec()),
+        ) {
+            state.property_keys.insert(id, name);
+        }
+    }
+
+    for guard in snapshot.prefix(&keyspaces.graph_data, node_props_scan_prefix()) {
         let Ok((key, value)) = guard.into_inner() else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedNodeProperty));
             continue;
         };
-        let Some((node, property_key)) = parse_node_prop_key(key.as_ref()) else {
+        let Some(node) = parse_node_props_key(key.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedNodeProperty));
             continue;
         };
-        let Ok(property_value) = parse_prop_value(value.as_ref()) else {
-            state.issues.push(
-                FsckIssue::new(FsckIssueKind::MalformedNodeProperty)
-                    .with_node(node)
-                    .with_property_key(property_key),
-            );
+        let Some(row) = PropertyRow::parse(value.as_ref()).filter(|row| row.validate()) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodeProperty).with_node(node));
             continue;
         };
-        if state.live_nodes.contains(&node) {
-            state
-                .node_props
-                .entry(node)
-                .or_default()
-                .insert(property_key, property_value);
-        } else {
-            state.issues.push(
-                FsckIssue::new(FsckIssueKind::OrphanNodeProperty)
-                    .with_node(node)
-                    .with_property_key(property_key),
-            );
+        for (key_id, raw_value) in row.entries() {
+            state.checked.node_props += 1;
+            let property_key = state.property_key_name(key_id);
+            let Ok(property_value) = parse_prop_value(raw_value) else {
+                state.issues.push(
+                    FsckIssue::new(FsckIssueKind::MalformedNodeProperty)
+                        .with_node(node)
+                        .with_property_key(property_key),
+                );
+                continue;
+            };
+            if !state.live_nodes.contains(&node) {
+                state.issues.push(
+                    FsckIssue::new(FsckIssueKind::OrphanNodeProperty)
+                        .with_node(node)
+                        .with_property_key(property_key),
+                );
+            } else if !state.property_keys.contains_key(&key_id) {
+                state.issues.push(
+                    FsckIssue::new(FsckIssueKind::MalformedNodeProperty)
+                        .with_node(node)
+                        .with_property_key(property_key),
+                );
+            } else {
+                state
+                    .node_props
+                    .entry(node)
+                    .or_default()
+                    .insert(key_id, property_value);
+            }
         }
     }
 
+    for guard in snapshot.prefix(&keyspaces.graph_data, composite_index_def_scan_prefix()) {
+        let Ok(key) = guard.key() else {
+            continue;
+        };
+        if let Some((label, keys)) = parse_composite_index_def_key(key.as_ref()) {
+            state.composite_defs.entry(label).or_default().push(keys);
+        }
+    }
+    for guard in snapshot.prefix(&keyspaces.graph_data, unique_constraint_scan_prefix()) {
+        let Ok(key) = guard.key() else {
+            continue;
+        };
+        if let Some((label, key)) = parse_unique_constraint_key(key.as_ref()) {
+            state.unique_defs.entry(label).or_default().insert(key);
+        }
+    }
+    for guard in snapshot.prefix(&keyspaces.graph_data, fulltext_index_def_scan_prefix()) {
+        let Ok(key) = guard.key() else {
+            continue;
+        };
+        if let Some((label, key)) = parse_fulltext_index_def_key(key.as_ref()) {
+            state.fulltext_defs.entry(label).or_default().insert(key);
+        }
+    }
+    state.expected_fulltext_postings =
+        build_postings(state.node_labels.iter().filter_map(|(node, labels)| {
+            let props = state.node_props.get(node)?;
+            Some((*node, fulltext_entries(labels, props, &state.fulltext_defs)))
+        }));
+
     for (node, labels) in &state.node_labels {
         let Some(props) = state.node_props.get(node) else {
             continue;
         };
+        state
+            .expected_node_prop_indexes
+            .extend(composite_index_keys(
+                *node,
+                labels,
+                props,
+                &state.composite_defs,
+            ));
+        for key in unique_index_keys(labels, props, &state.unique_defs) {
+            if let Some(other) = state.expected_unique_entries.insert(key.clone(), *node) {
+                let label = parse_unique_index_key(&key).map(|(label, _)| label);
+                let mut issue =
+                    FsckIssue::new(FsckIssueKind::DuplicateUniqueValue).with_node(other);
+                if let Some(label) = label {
+                    issue = issue.with_label(label);
+                }
+                state.issues.push(issue);
+            }
+        }
         for label in labels {
             for (property_key, property_value) in props {
                 if scalar_indexable_value(property_value) {
                     state.expected_node_prop_indexes.insert(node_prop_index_key(
                         *label,
-                        property_key,
+                        *property_key,
                         property_value,
                         *node,
                     ));
@@ -260,48 +380,54 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
         }
     }
 
-    for guard in snapshot.prefix(&keyspaces.graph_data, label_node_scan_prefix()) {
-        state.checked.label_nodes += 1;
-        let Ok((key, _)) = guard.into_inner() else {
+    for guard in snapshot.prefix(&keyspaces.graph_data, label_bitmap_scan_prefix()) {
+        let Ok((key, value)) = guard.into_inner() else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedLabelNode));
             continue;
         };
-        let raw_key = key.as_ref().to_vec();
-        state.all_label_node_keys.push(raw_key.clone());
-        let Some((label, node)) = parse_label_node_key(&raw_key) else {
+        state.all_label_bitmap_keys.push(key.as_ref().to_vec());
+        let Some((label, chunk)) = parse_label_bitmap_key(key.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedLabelNode));
             continue;
         };
-        state.actual_label_nodes.insert(raw_key);
-        if !state.live_nodes.contains(&node)
-            || !state
-                .node_labels
-                .get(&node)
-                .is_some_and(|labels| labels.contains(&label))
-        {
-            state.issues.push(
-                FsckIssue::new(FsckIssueKind::StaleLabelNodeIndex)
-                    .with_node(node)
-                    .with_label(label),
-            );
+        let Some(members) = LabelChunk::decode(value.as_ref()).filter(|m| !m.is_empty()) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedLabelNode).with_label(label));
+            continue;
+        };
+        for low in members.lows() {
+            state.checked.label_nodes += 1;
+            let node = join_node_id(chunk, low);
+            state.actual_label_nodes.insert((label, node));
+            if !state.live_nodes.contains(&node)
+                || !state
+                    .node_labels
+                    .get(&node)
+                    .is_some_and(|labels| labels.contains(&label))
+            {
+                state.issues.push(
+                    FsckIssue::new(FsckIssueKind::StaleLabelNodeIndex)
+                        .with_node(node)
+                        .with_label(label),
+                );
+            }
         }
     }
 
-    for key in state
+    for (label, node) in state
         .expected_label_nodes
         .difference(&state.actual_label_nodes)
     {
-        if let Some((label, node)) = parse_label_node_key(key) {
-            state.issues.push(
-                FsckIssue::new(FsckIssueKind::MissingLabelNodeIndex)
-                    .with_node(node)
-                    .with_label(label),
-            );
-        }
+        state.issues.push(
+            FsckIssue::new(FsckIssueKind::MissingLabelNodeIndex)
+                .with_node(*node)
+                .with_label(*label),
+        );
     }
 
     for guard in snapshot.prefix(&keyspaces.graph_data, node_prop_index_scan_prefix()) {
@@ -337,7 +463,119 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
                 FsckIssue::new(FsckIssueKind::StaleNodePropertyIndex)
                     .with_node(entry.node)
                     .with_label(entry.label)
-                    .with_property_key(entry.property_key),
+                    .with_property_key(state.property_key_name(entry.property_key)),
+            );
+        }
+    }
+
+    // Composite entries are derived whole from labels and property records,
+    // so they are checked by exact key.
+    for guard in snapshot.prefix(&keyspaces.graph_data, composite_index_scan_prefix()) {
+        state.checked.idx_node_props += 1;
+        let Ok(key) = guard.key() else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        let raw_key = key.as_ref().to_vec();
+        state.all_node_prop_index_keys.push(raw_key.clone());
+        let Some((label, node)) = parse_composite_index_key(&raw_key) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        if !state.expected_node_prop_indexes.contains(&raw_key) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::StaleNodePropertyIndex)
+                    .with_node(node)
+                    .with_label(label),
+            );
+        }
+        state.actual_node_prop_indexes.insert(raw_key);
+    }
+
+    // Unique entries are valued by their node, so they are checked by key
+    // and owner.
+    let mut actual_unique_keys = BTreeSet::new();
+    for guard in snapshot.prefix(&keyspaces.graph_data, unique_index_scan_prefix()) {
+        state.checked.idx_node_props += 1;
+        let Ok((key, value)) = guard.into_inner() else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        let raw_key = key.as_ref().to_vec();
+        state.all_unique_index_keys.push(raw_key.clone());
+        let (Some((label, _)), Some(node)) =
+            (parse_unique_index_key(&raw_key), decode_u32(value.as_ref()))
+        else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        if state.expected_unique_entries.get(&raw_key) != Some(&node) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::StaleNodePropertyIndex)
+                    .with_node(node)
+                    .with_label(label),
+            );
+        }
+        actual_unique_keys.insert(raw_key);
+    }
+    for (key, node) in &state.expected_unique_entries {
+        if !actual_unique_keys.contains(key)
+            && let Some((label, _)) = parse_unique_index_key(key)
+        {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::MissingNodePropertyIndex)
+                    .with_node(*node)
+                    .with_label(label),
+            );
+        }
+    }
+
+    // Posting chunks are derived whole, so they are checked by exact value.
+    let mut actual_postings = BTreeSet::new();
+    for guard in snapshot.prefix(&keyspaces.graph_data, fulltext_posting_scan_prefix()) {
+        state.checked.idx_node_props += 1;
+        let Ok((key, value)) = guard.into_inner() else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        let raw_key = key.as_ref().to_vec();
+        state.all_fulltext_posting_keys.push(raw_key.clone());
+        let (Some((label, key_id)), Some(ids)) = (
+            parse_fulltext_posting_key(&raw_key),
+            decode_posting(value.as_ref()),
+        ) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedNodePropertyIndex));
+            continue;
+        };
+        if state.expected_fulltext_postings.get(&raw_key) != Some(&ids) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::StaleNodePropertyIndex)
+                    .with_label(label)
+                    .with_property_key(state.property_key_name(key_id)),
+            );
+        }
+        actual_postings.insert(raw_key);
+    }
+    for key in state.expected_fulltext_postings.keys() {
+        if !actual_postings.contains(key)
+            && let Some((label, key_id)) = parse_fulltext_posting_key(key)
+        {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::MissingNodePropertyIndex)
+                    .with_label(label)
+                    .with_property_key(state.property_key_name(key_id)),
             );
         }
     }
@@ -351,11 +589,18 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
                 FsckIssue::new(FsckIssueKind::MissingNodePropertyIndex)
                     .with_node(entry.node)
                     .with_label(entry.label)
-                    .with_property_key(entry.property_key),
+                    .with_property_key(state.property_key_name(entry.property_key)),
+            );
+        } else if let Some((label, node)) = parse_composite_index_key(key) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::MissingNodePropertyIndex)
+                    .with_node(node)
+                    .with_label(label),
             );
         }
     }
 
+    let mut continued = None;
     for guard in snapshot.prefix(&keyspaces.adj_out, adj_out_scan_prefix()) {
         state.checked.adj_out += 1;
         let Ok((key, value)) = guard.into_inner() else {
@@ -364,23 +609,29 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjOut));
             continue;
         };
-        let Some((src, rel)) = parse_adj_out_key(key.as_ref()) else {
+        let Some((src, rel, fence)) = parse_adj_record_key(key.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjOut));
             continue;
         };
-        let Some(dsts) = decode_adjacent_nodes(value.as_ref()) else {
+        let Some((flags, dsts)) = decode_adjacent_nodes(value.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjOut));
             continue;
         };
+        if !adjacency_bucket_is_linked(&mut continued, src, rel, fence, flags) {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedAdjOut));
+        }
         for dst in dsts {
             state.adj_out.insert(EdgeKey { src, rel, dst });
         }
     }
 
+    let mut continued = None;
     for guard in snapshot.prefix(&keyspaces.adj_in, adj_in_scan_prefix()) {
         state.checked.adj_in += 1;
         let Ok((key, value)) = guard.into_inner() else {
@@ -389,23 +640,74 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjIn));
             continue;
         };
-        let Some((dst, rel)) = parse_adj_in_key(key.as_ref()) else {
+        let Some((dst, rel, fence)) = parse_adj_record_key(key.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjIn));
             continue;
         };
-        let Some(srcs) = decode_adjacent_nodes(value.as_ref()) else {
+        let Some((flags, srcs)) = decode_adjacent_nodes(value.as_ref()) else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedAdjIn));
             continue;
         };
+        if !adjacency_bucket_is_linked(&mut continued, dst, rel, fence, flags) {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedAdjIn));
+        }
         for src in srcs {
             state.adj_in.insert(EdgeKey { src, rel, dst });
         }
     }
 
+    for guard in snapshot.prefix(&keyspaces.graph_data, adj_delta_scan_prefix()) {
+        state.checked.adj_deltas += 1;
+        let Ok((key, value)) = guard.into_inner() else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedAdjDelta));
+            continue;
+        };
+        let Some((dir, node, rel, _)) = parse_adj_delta_key(key.as_ref()) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedAdjDelta));
+            continue;
+        };
+        let mut ops = BTreeMap::new();
+        if !apply_adj_delta(value.as_ref(), &mut ops) {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedAdjDelta).with_node(node));
+            continue;
+        }
+        let edges = match dir {
+            AdjDirection::Out => &mut state.adj_out,
+            AdjDirection::In => &mut state.adj_in,
+        };
+        for (other, present) in ops {
+            let edge = match dir {
+                AdjDirection::Out => EdgeKey {
+                    src: node,
+                    rel,
+                    dst: other,
+                },
+                AdjDirection::In => EdgeKey {
+                    src: other,
+                    rel,
+                    dst: node,
+                },
+            };
+            if present {
+                edges.insert(edge);
+            } else {
+                edges.remove(&edge);
+            }
+        }
+    }
+
     for edge in state.adj_out.difference(&state.adj_in) {
         state
             .issues
@@ -419,7 +721,7 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
 
     for guard in snapshot.prefix(&keyspaces.graph_data, edge_prop_scan_prefix()) {
         state.checked.edge_props += 1;
-        let Ok((key, _)) = guard.into_inner() else {
+        let Ok((key, value)) = guard.into_inner() else {
             state
                 .issues
                 .push(FsckIssue::new(FsckIssueKind::MalformedEdgeProperty));
@@ -435,8 +737,115 @@ fn check_engine(engine: &GraphEngine) -> crate::storage::Result<CheckState> {
             state.issues.push(
                 FsckIssue::new(FsckIssueKind::OrphanEdgeProperty)
                     .with_edge(edge)
-                    .with_property_key(property_key),
+                    .with_property_key(state.property_key_name(property_key)),
             );
+        } else if let Ok(property_value) = parse_prop_value(value.as_ref())
+            && scalar_indexable_value(&property_value)
+        {
+            state.expected_edge_prop_indexes.insert(edge_prop_index_key(
+                property_key,
+                &property_value,
+                edge,
+            ));
+        }
+    }
+
+    for guard in snapshot.prefix(&keyspaces.graph_data, edge_prop_index_scan_prefix()) {
+        state.checked.idx_edge_props += 1;
+        let Ok(key) = guard.key() else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedEdgePropertyIndex));
+            continue;
+        };
+        let raw_key = key.as_ref().to_vec();
+        state.all_edge_prop_index_keys.push(raw_key.clone());
+        let Some(entry) = parse_edge_prop_index_key(&raw_key) else {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::MalformedEdgePropertyIndex));
+            continue;
+        };
+        if !state.expected_edge_prop_indexes.contains(&raw_key) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::StaleEdgePropertyIndex)
+                    .with_edge(entry.edge)
+                    .with_property_key(state.property_key_name(entry.property_key)),
+            );
+        }
+        state.actual_edge_prop_indexes.insert(raw_key);
+    }
+
+    for key in state
+        .expected_edge_prop_indexes
+        .difference(&state.actual_edge_prop_indexes)
+    {
+        if let Some(entry) = parse_edge_prop_index_key(key) {
+            state.issues.push(
+                FsckIssue::new(FsckIssueKind::MissingEdgePropertyIndex)
+                    .with_edge(entry.edge)
+                    .with_property_key(state.property_key_name(entry.property_key)),
+            );
+        }
+    }
+
+    for labels in state.node_labels.values() {
+        for label in labels {
+            *state.expected_label_counts.entry(*label).or_insert(0) += 1;
+        }
+    }
+    for edge in &state.adj_out {
+        *state.expected_rel_counts.entry(edge.rel).or_insert(0) += 1;
+    }
+    let mut stored_label_counts = BTreeMap::new();
+    let mut stored_rel_counts = BTreeMap::new();
+    for (prefix, stored) in [
+        (META_LABEL_COUNT_PREFIX, &mut stored_label_counts),
+        (META_REL_COUNT_PREFIX, &mut stored_rel_counts),
+    ] {
+        for guard in snapshot.prefix(&keyspaces.meta, prefix) {
+            state.checked.counters += 1;
+            let Ok((key, value)) = guard.into_inner() else {
+                state
+                    .issues
+                    .push(FsckIssue::new(FsckIssueKind::MalformedCounter));
+                continue;
+            };
+            state.all_counter_keys.push(key.as_ref().to_vec());
+            let (Some(id), Some(count)) = (
+                parse_counter_key(prefix, key.as_ref()),
+                decode_counter(value.as_ref()),
+            ) else {
+                state
+                    .issues
+                    .push(FsckIssue::new(FsckIssueKind::MalformedCounter));
+                continue;
+            };
+            stored.insert(id, count);
+        }
+    }
+    for label in stored_label_counts
+        .keys()
+        .chain(state.expected_label_counts.keys())
+        .copied()
+        .collect::<BTreeSet<_>>()
+    {
+        if stored_label_counts.get(&label) != state.expected_label_counts.get(&label) {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::LabelCountMismatch).with_label(label));
+        }
+    }
+    for rel in stored_rel_counts
+        .keys()
+        .chain(state.expected_rel_counts.keys())
+        .copied()
+        .collect::<BTreeSet<_>>()
+    {
+        if stored_rel_counts.get(&rel) != state.expected_rel_counts.get(&rel) {
+            state
+                .issues
+                .push(FsckIssue::new(FsckIssueKind::RelCountMismatch).with_rel(rel));
         }
     }
 
@@ -447,12 +856,21 @@ fn repair_derived_indexes(
     engine: &GraphEngine,
     state: &CheckState,
 ) -> crate::storage::Result<Vec<FsckRepair>> {
+    let mut label_chunks: BTreeMap<(LabelId, u16), LabelChunk> = BTreeMap::new();
+    for (label, node) in &state.expected_label_nodes {
+        let (chunk, low) = split_node_id(*node);
+        label_chunks.entry((*label, chunk)).or_default().insert(low);
+    }
     let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
-    for key in &state.all_label_node_keys {
+    for key in &state.all_label_bitmap_keys {
         batch.remove(&engine.keyspaces.graph_data, key);
     }
-    for key in &state.expected_label_nodes {
-        batch.insert(&engine.keyspaces.graph_data, key, []);
+    for ((label, chunk), members) in &label_chunks {
+        batch.insert(
+            &engine.keyspaces.graph_data,
+            label_bitmap_key(*label, *chunk),
+            members.encode(),
+        );
     }
     for key in &state.all_node_prop_index_keys {
         batch.remove(&engine.keyspaces.graph_data, key);
@@ -460,22 +878,89 @@ fn repair_derived_indexes(
     for key in &state.expected_node_prop_indexes {
         batch.insert(&engine.keyspaces.graph_data, key, []);
     }
+    for key in &state.all_unique_index_keys {
+        batch.remove(&engine.keyspaces.graph_data, key);
+    }
+    for (key, node) in &state.expected_unique_entries {
+        batch.insert(&engine.keyspaces.graph_data, key, key_u32(*node));
+    }
+    for key in &state.all_fulltext_posting_keys {
+        batch.remove(&engine.keyspaces.graph_data, key);
+    }
+    for (key, ids) in &state.expected_fulltext_postings {
+        batch.insert(&engine.keyspaces.graph_data, key, encode_posting(ids));
+    }
+    for key in &state.all_edge_prop_index_keys {
+        batch.remove(&engine.keyspaces.graph_data, key);
+    }
+    for key in &state.expected_edge_prop_indexes {
+        batch.insert(&engine.keyspaces.graph_data, key, []);
+    }
+    for key in &state.all_counter_keys {
+        batch.remove(&engine.keyspaces.meta, key);
+    }
+    for (label, count) in &state.expected_label_counts {
+        batch.insert(
+            &engine.keyspaces.meta,
+            label_count_key(*label),
+            count.to_be_bytes(),
+        );
+    }
+    for (rel, count) in &state.expected_rel_counts {
+        batch.insert(
+            &engine.keyspaces.meta,
+            rel_count_key(*rel),
+            count.to_be_bytes(),
+        );
+    }
     batch.commit()?;
 
     Ok(vec![
         FsckRepair {
             kind: FsckRepairKind::RebuiltLabelNodes,
-            removed: state.all_label_node_keys.len() as u64,
-            inserted: state.expected_label_nodes.len() as u64,
+            removed: state.all_label_bitmap_keys.len() as u64,
+            inserted: label_chunks.len() as u64,
         },
         FsckRepair {
             kind: FsckRepairKind::RebuiltNodePropertyIndex,
-            removed: state.all_node_prop_index_keys.len() as u64,
-            inserted: state.expected_node_prop_indexes.len() as u64,
+            removed: (state.all_node_prop_index_keys.len()
+                + state.all_unique_index_keys.len()
+                + state.all_fulltext_posting_keys.len()) as u64,
+            inserted: (state.expected_node_prop_indexes.len()
+                + state.expected_unique_entries.len()
+                + state.expected_fulltext_postings.len()) as u64,
+        },
+        FsckRepair {
+            kind: FsckRepairKind::RebuiltCounters,
+            removed: state.all_counter_keys.len() as u64,
+            inserted: (state.expected_label_counts.len() + state.expected_rel_counts.len()) as u64,
+        },
+        FsckRepair {
+            kind: FsckRepairKind::RebuiltEdgePropertyIndex,
+            removed: state.all_edge_prop_index_keys.len() as u64,
+            inserted: state.expected_edge_prop_indexes.len() as u64,
         },
     ])
 }
 
+/// Tracks the base record flags of the list being scanned and reports whether
+/// an overflow bucket is reachable from a base record marked as continued.
+fn adjacency_bucket_is_linked(
+    continued: &mut Option<(InternalNodeId, RelTypeId)>,
+    node: InternalNodeId,
+    rel: RelTypeId,
+    fence: Option<u32>,
+    flags: u8,
+) -> bool {
+    match fence {
+        None => {
+            *continued = (flags & ADJ_FLAG_CONTINUED != 0).then_some((node, rel));
+            true
+        }
+        Some(_) => *continued == Some((node, rel)),
+    }
+}
+
 fn edge_is_visible(state: &CheckState, edge: EdgeKey) -> bool {
     state.live_nodes.contains(&edge.src)
         && state.live_nodes.contains(&edge.dst)
@@ -505,6 +990,11 @@ impl FsckIssue {
         self
     }
 
+    fn with_rel(mut self, rel: RelTypeId) -> Self {
+        self.rel = Some(rel);
+        self
+    }
+
     fn with_edge(mut self, edge: EdgeKey) -> Self {
         self.node = Some(edge.src);
         self.rel = Some(edge.rel);
@@ -522,6 +1012,7 @@ impl FsckIssue {
 mod tests {
     use super::*;
     use crate::GraphSnapshot;
+    use crate::storage::property_row::encode_property_row;
     use tempfile::tempdir;
 
     fn seed_indexed_node(path: &Path) -> (InternalNodeId, LabelId) {
@@ -556,7 +1047,11 @@ mod tests {
         {
             let engine = GraphEngine::open(dir.path()).unwrap();
             let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
-            batch.remove(&engine.keyspaces.graph_data, label_node_key(person, alice));
+            let (chunk, _) = split_node_id(alice);
+            batch.remove(
+                &engine.keyspaces.graph_data,
+                label_bitmap_key(person, chunk),
+            );
             batch.commit().unwrap();
         }
 
@@ -588,7 +1083,13 @@ mod tests {
         {
             let engine = GraphEngine::open(dir.path()).unwrap();
             let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
-            batch.insert(&engine.keyspaces.graph_data, label_node_key(99, 999), []);
+            let mut members = LabelChunk::default();
+            members.insert(999);
+            batch.insert(
+                &engine.keyspaces.graph_data,
+                label_bitmap_key(99, 0),
+                members.encode(),
+            );
             batch.commit().unwrap();
         }
 
@@ -605,6 +1106,33 @@ mod tests {
         assert!(repaired.ok, "{:?}", repaired.issues);
     }
 
+    #[test]
+    fn fsck_reports_truncated_node_property_record() {
+        let dir = tempdir().unwrap();
+        let (alice, _) = seed_indexed_node(dir.path());
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            let record = engine
+                .db
+                .snapshot()
+                .get(&engine.keyspaces.graph_data, node_props_key(alice))
+                .unwrap()
+                .unwrap();
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.insert(
+                &engine.keyspaces.graph_data,
+                node_props_key(alice),
+                &record[..record.len() - 1],
+            );
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(broken.issues.iter().any(|issue| {
+            issue.kind == FsckIssueKind::MalformedNodeProperty && issue.node == Some(alice)
+        }));
+    }
+
     #[test]
     fn fsck_detects_and_repairs_missing_node_property_index() {
         let dir = tempdir().unwrap();
@@ -613,7 +1141,7 @@ mod tests {
             let engine = GraphEngine::open(dir.path()).unwrap();
             let key = node_prop_index_key(
                 person,
-                "name",
+                engine.property_keys.id("name").unwrap(),
                 &PropertyValue::String("Alice".to_string()),
                 alice,
             );
@@ -635,14 +1163,192 @@ mod tests {
         assert!(repaired.ok, "{:?}", repaired.issues);
     }
 
+    #[test]
+    fn fsck_detects_and_repairs_missing_composite_index_entry() {
+        let dir = tempdir().unwrap();
+        let (alice, person) = seed_indexed_node(dir.path());
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            engine
+                .create_composite_index(person, &["name", "age"])
+                .unwrap();
+            let keys = [
+                engine.property_keys.id("name").unwrap(),
+                engine.property_keys.id("age").unwrap(),
+            ];
+            let key = composite_index_key(
+                person,
+                &keys,
+                &[
+                    &PropertyValue::String("Alice".to_string()),
+                    &PropertyValue::Null,
+                ],
+                alice,
+            );
+            assert!(engine.keyspaces.graph_data.contains_key(&key).unwrap());
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.remove(&engine.keyspaces.graph_data, key);
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(broken.issues.iter().any(|issue| {
+            issue.kind == FsckIssueKind::MissingNodePropertyIndex
+                && issue.node == Some(alice)
+                && issue.label == Some(person)
+                && issue.property_key.is_none()
+        }));
+
+        let repaired = fsck(dir.path(), FsckOptions { repair: true }).unwrap();
+        assert!(repaired.ok, "{:?}", repaired.issues);
+    }
+
+    #[test]
+    fn fsck_detects_and_repairs_unique_index_entry() {
+        let dir = tempdir().unwrap();
+        let (alice, person) = seed_indexed_node(dir.path());
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            engine.create_unique_constraint(person, "name").unwrap();
+            let key = unique_index_key(
+                person,
+                engine.property_keys.id("name").unwrap(),
+                &PropertyValue::String("Alice".to_string()),
+            );
+            assert!(engine.keyspaces.graph_data.contains_key(&key).unwrap());
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.remove(&engine.keyspaces.graph_data, key);
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(broken.issues.iter().any(|issue| {
+            issue.kind == FsckIssueKind::MissingNodePropertyIndex
+                && issue.node == Some(alice)
+                && issue.label == Some(person)
+                && issue.property_key.is_none()
+        }));
+
+        let repaired = fsck(dir.path(), FsckOptions { repair: true }).unwrap();
+        assert!(repaired.ok, "{:?}", repaired.issues);
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        assert_eq!(
+            engine
+                .snapshot()
+                .node_by_unique_property(person, "name", &"Alice".into()),
+            Some(alice)
+        );
+    }
+
+    #[test]
+    fn fsck_detects_and_repairs_fulltext_posting() {
+        let dir = tempdir().unwrap();
+        let (alice, person) = seed_indexed_node(dir.path());
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            engine.create_fulltext_index(person, "name").unwrap();
+            let key =
+                fulltext_posting_key(person, engine.property_keys.id("name").unwrap(), "alice", 0);
+            assert!(engine.keyspaces.graph_data.contains_key(&key).unwrap());
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.remove(&engine.keyspaces.graph_data, key);
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(broken.issues.iter().any(|issue| {
+            issue.kind == FsckIssueKind::MissingNodePropertyIndex
+                && issue.label == Some(person)
+                && issue.property_key.as_deref() == Some("name")
+        }));
+
+        let repaired = fsck(dir.path(), FsckOptions { repair: true }).unwrap();
+        assert!(repaired.ok, "{:?}", repaired.issues);
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        let snapshot = engine.snapshot();
+        let found: Vec<_> = snapshot
+            .nodes_with_label_and_terms(person, "name", "ALICE")
+            .collect();
+        assert_eq!(found, vec![alice]);
+    }
+
+    #[test]
+    fn fsck_detects_and_repairs_edge_property_index() {
+        let dir = tempdir().unwrap();
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let calls = engine.get_or_create_rel_type("CALLS").unwrap();
+        let mut tx = engine.begin_write();
+        let alice = tx.create_node(10, person).unwrap();
+        let bob = tx.create_node(20, person).unwrap();
+        tx.create_edge(alice, calls, bob).unwrap();
+        tx.set_edge_property(alice, calls, bob, "weight".to_string(), 5.into())
+            .unwrap();
+        tx.commit().unwrap();
+        let edge = EdgeKey {
+            src: alice,
+            rel: calls,
+            dst: bob,
+        };
+        let weight = engine.property_keys.id("weight").unwrap();
+        {
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.remove(
+                &engine.keyspaces.graph_data,
+                edge_prop_index_key(weight, &PropertyValue::Int(5), edge),
+            );
+            batch.insert(
+                &engine.keyspaces.graph_data,
+                edge_prop_index_key(weight, &PropertyValue::Int(7), edge),
+                [],
+            );
+            batch.commit().unwrap();
+        }
+        drop(engine);
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert_eq!(broken.checked.idx_edge_props, 1);
+        assert!(
+            broken.issues.contains(
+                &FsckIssue::new(FsckIssueKind::MissingEdgePropertyIndex)
+                    .with_edge(edge)
+                    .with_property_key("weight".to_string())
+            )
+        );
+        assert!(
+            broken.issues.contains(
+                &FsckIssue::new(FsckIssueKind::StaleEdgePropertyIndex)
+                    .with_edge(edge)
+                    .with_property_key("weight".to_string())
+            )
+        );
+
+        let repaired = fsck(dir.path(), FsckOptions { repair: true }).unwrap();
+        assert!(repaired.ok, "{:?}", repaired.issues);
+        assert!(repaired.repairs.contains(&FsckRepair {
+            kind: FsckRepairKind::RebuiltEdgePropertyIndex,
+            removed: 1,
+            inserted: 1,
+        }));
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        assert_eq!(
+            engine
+                .snapshot()
+                .edges_with_rel_and_property(calls, "weight", &PropertyValue::Int(5))
+                .collect::<Vec<_>>(),
+            vec![edge]
+        );
+    }
+
     #[test]
     fn fsck_detects_and_repairs_stale_node_property_index() {
         let dir = tempdir().unwrap();
         let (_, person) = seed_indexed_node(dir.path());
         {
             let engine = GraphEngine::open(dir.path()).unwrap();
+            let name = engine.property_keys.id("name").unwrap();
             let stale_key =
-                node_prop_index_key(person, "name", &PropertyValue::String("Ghost".into()), 999);
+                node_prop_index_key(person, name, &PropertyValue::String("Ghost".into()), 999);
             let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
             batch.insert(&engine.keyspaces.graph_data, stale_key, []);
             batch.commit().unwrap();
@@ -661,6 +1367,147 @@ mod tests {
         assert!(repaired.ok, "{:?}", repaired.issues);
     }
 
+    #[test]
+    fn fsck_checks_bucketed_supernode_adjacency() {
+        let dir = tempdir().unwrap();
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let knows = engine.get_or_create_rel_type("KNOWS").unwrap();
+        let mut tx = engine.begin_write();
+        let hub = tx.create_node(1, person).unwrap();
+        for i in 0..(ADJ_BUCKET_CAPACITY as u64 * 2) {
+            let leaf = tx.create_node(i + 2, person).unwrap();
+            tx.create_edge(hub, knows, leaf).unwrap();
+        }
+        tx.commit().unwrap();
+        drop(engine);
+
+        let clean = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(clean.ok, "{:?}", clean.issues);
+        assert!(clean.checked.adj_out > 2);
+
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.insert(
+                &engine.keyspaces.adj_out,
+                adj_out_key(hub, knows),
+                encode_adjacent_nodes(0, &[1]),
+            );
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(
+            broken
+                .issues
+                .iter()
+                .any(|issue| issue.kind == FsckIssueKind::MalformedAdjOut)
+        );
+    }
+
+    #[test]
+    fn fsck_applies_pending_adjacency_deltas() {
+        let dir = tempdir().unwrap();
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        let person = engine.get_or_create_label("Person").unwrap();
+        let knows = engine.get_or_create_rel_type("KNOWS").unwrap();
+        let mut tx = engine.begin_write();
+        let alice = tx.create_node(10, person).unwrap();
+        let bob = tx.create_node(20, person).unwrap();
+        let carol = tx.create_node(30, person).unwrap();
+        tx.create_edge(alice, knows, bob).unwrap();
+        tx.commit().unwrap();
+        let mut tx = engine.begin_write();
+        tx.create_edge(alice, knows, carol).unwrap();
+        tx.tombstone_edge(alice, knows, bob).unwrap();
+        tx.set_edge_property(alice, knows, carol, "since".to_string(), 2024.into())
+            .unwrap();
+        tx.commit().unwrap();
+        drop(engine);
+
+        let clean = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(clean.ok, "{:?}", clean.issues);
+        assert_eq!(clean.checked.adj_deltas, 3);
+
+        {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.insert(
+                &engine.keyspaces.graph_data,
+                adj_delta_key(AdjDirection::Out, alice, knows, 1000),
+                [0xFF],
+            );
+            batch.commit().unwrap();
+        }
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(
+            broken
+                .issues
+                .iter()
+                .any(|issue| issue.kind == FsckIssueKind::MalformedAdjDelta)
+        );
+    }
+
+    #[test]
+    fn fsck_detects_and_rebuilds_stale_counters() {
+        let dir = tempdir().unwrap();
+        let (person, knows) = {
+            let engine = GraphEngine::open(dir.path()).unwrap();
+            let person = engine.get_or_create_label("Person").unwrap();
+            let knows = engine.get_or_create_rel_type("KNOWS").unwrap();
+            let mut tx = engine.begin_write();
+            let alice = tx.create_node(10, person).unwrap();
+            let bob = tx.create_node(20, person).unwrap();
+            tx.create_edge(alice, knows, bob).unwrap();
+            tx.commit().unwrap();
+
+            let mut batch = engine.db.batch().durability(Some(PersistMode::SyncAll));
+            batch.insert(
+                &engine.keyspaces.meta,
+                label_count_key(person),
+                7u64.to_be_bytes(),
+            );
+            batch.remove(&engine.keyspaces.meta, rel_count_key(knows));
+            batch.insert(&engine.keyspaces.meta, label_count_key(99), [1]);
+            batch.commit().unwrap();
+            (person, knows)
+        };
+
+        let broken = fsck(dir.path(), FsckOptions { repair: false }).unwrap();
+        assert!(!broken.ok);
+        assert!(
+            broken
+                .issues
+                .contains(&FsckIssue::new(FsckIssueKind::LabelCountMismatch).with_label(person))
+        );
+        assert!(
+            broken
+                .issues
+                .contains(&FsckIssue::new(FsckIssueKind::RelCountMismatch).with_rel(knows))
+        );
+        assert!(
+            broken
+                .issues
+                .contains(&FsckIssue::new(FsckIssueKind::MalformedCounter))
+        );
+
+        let repaired = fsck(dir.path(), FsckOptions { repair: true }).unwrap();
+        assert!(repaired.ok, "{:?}", repaired.issues);
+        assert!(repaired.repairs.contains(&FsckRepair {
+            kind: FsckRepairKind::RebuiltCounters,
+            removed: 2,
+            inserted: 2,
+        }));
+
+        let engine = GraphEngine::open(dir.path()).unwrap();
+        let snapshot = engine.snapshot();
+        assert_eq!(snapshot.node_count(Some(person)), 2);
+        assert_eq!(snapshot.edge_count(Some(knows)), 1);
+        assert_eq!(snapshot.edge_count(None), 1);
+    }
+
     #[test]
     fn fsck_reports_adjacency_and_orphan_props_without_repairing_them() {
         let dir = tempdir().unwrap();
@@ -682,13 +1529,16 @@ mod tests {
             batch.remove(&engine.keyspaces.adj_in, adj_in_key(edge.dst, edge.rel));
             batch.insert(
                 &engine.keyspaces.graph_data,
-                edge_prop_key(edge, "since"),
+                edge_prop_key(edge, 0),
                 PropertyValue::Int(2024).encode(),
             );
             batch.insert(
                 &engine.keyspaces.graph_data,
-                node_prop_key(999, "name"),
-                PropertyValue::String("Ghost".into()).encode(),
+                node_props_key(999),
+                encode_property_row(&BTreeMap::from([(
+                    0,
+                    PropertyValue::String("Ghost".into()),
+                )])),
             );
             batch.commit().unwrap();
         }
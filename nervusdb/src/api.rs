@@ -1,4 +1,6 @@
+use std::cmp::Ordering;
 use std::collections::BTreeMap;
+use std::ops::Bound;
 
 pub type GraphWriteResult<T> = Result<T, Box<dyn std::error::Error + Send + Sync + 'static>>;
 
@@ -268,6 +270,115 @@ impl PropertyValue {
     }
 }
 
+/// Whether `value` satisfies one range bound; `admits` tests the ordering of
+/// `value` against an inclusive bound.
+fn bound_admits(
+    value: &PropertyValue,
+    bound: Bound<&PropertyValue>,
+    admits: fn(Ordering) -> bool,
+) -> bool {
+    let (bound, inclusive) = match bound {
+        Bound::Included(bound) => (bound, true),
+        Bound::Excluded(bound) => (bound, false),
+        Bound::Unbounded => return true,
+    };
+    let ordering = match (value, bound) {
+        (
+            PropertyValue::Int(_) | PropertyValue::Float(_),
+            PropertyValue::Int(_) | PropertyValue::Float(_),
+        ) => numeric_value(value).partial_cmp(&numeric_value(bound)),
+        (PropertyValue::Bool(l), PropertyValue::Bool(r)) => Some(l.cmp(r)),
+        (PropertyValue::String(l), PropertyValue::String(r)) => Some(l.cmp(r)),
+        (PropertyValue::DateTime(l), PropertyValue::DateTime(r)) => Some(l.cmp(r)),
+        (PropertyValue::Blob(l), PropertyValue::Blob(r)) => Some(l.cmp(r)),
+        _ => None,
+    };
+    ordering.is_some_and(|ordering| admits(ordering) && (inclusive || ordering.is_ne()))
+}
+
+fn numeric_value(value: &PropertyValue) -> f64 {
+    match value {
+        PropertyValue::Int(value) => *value as f64,
+        PropertyValue::Float(value) => *value,
+        _ => f64::NAN,
+    }
+}
+
+/// Longest term kept by [`text_terms`], in bytes.
+pub const MAX_TEXT_TERM_BYTES: usize = 128;
+
+/// Terms of `text` as seen by full-text matching, in order: maximal runs of
+/// alphanumeric characters, lowercased. Runs longer than
+/// [`MAX_TEXT_TERM_BYTES`] are dropped.
+pub fn text_terms(text: &str) -> Vec<String> {
+    text.split(|c: char| !c.is_alphanumeric())
+        .filter(|term| !term.is_empty())
+        .map(str::to_lowercase)
+        .filter(|term| term.len() <= MAX_TEXT_TERM_BYTES)
+        .collect()
+}
+
+/// Whether `text` contains every term of `query`. A query without terms
+/// matches nothing.
+pub fn text_matches(text: &str, query: &str) -> bool {
+    let wanted = text_terms(query);
+    if wanted.is_empty() {
+        return false;
+    }
+    let terms = text_terms(text);
+    wanted.iter().all(|term| terms.contains(term))
+}
+
+/// Whether the terms of `phrase` occur consecutively in `text`. A phrase
+/// without terms matches nothing.
+pub fn text_phrase_matches(text: &str, phrase: &str) -> bool {
+    let wanted = text_terms(phrase);
+    if wanted.is_empty() {
+        return false;
+    }
+    text_terms(text)
+        .windows(wanted.len())
+        .any(|window| window == wanted.as_slice())
+}
+
+/// `vector` scaled to unit length, the form vectors are stored and searched
+/// in. `None` when it is empty, holds a non-finite component, or is zero.
+pub fn normalize_vector(vector: &[f32]) -> Option<Vec<f32>> {
+    if vector.is_empty() || vector.iter().any(|x| !x.is_finite()) {
+        return None;
+    }
+    let norm = vector_dot(vector, vector).sqrt();
+    norm.is_normal()
+        .then(|| vector.iter().map(|x| x / norm).collect())
+}
+
+/// Cosine distance of two unit vectors of the same length: `1 - a·b`, from
+/// 0 (same direction) to 2 (opposite).
+#[inline]
+pub fn vector_distance(a: &[f32], b: &[f32]) -> f32 {
+    1.0 - vector_dot(a, b)
+}
+
+/// Dot product over eight independent lanes, which the compiler keeps in
+/// SIMD registers.
+#[inline]
+fn vector_dot(a: &[f32], b: &[f32]) -> f32 {
+    let mut lanes = [0.0f32; 8];
+    let (a_chunks, b_chunks) = (a.chunks_exact(8), b.chunks_exact(8));
+    let tail: f32 = a_chunks
+        .remainder()
+        .iter()
+        .zip(b_chunks.remainder())
+        .map(|(x, y)| x * y)
+        .sum();
+    for (x, y) in a_chunks.zip(b_chunks) {
+        for ((lane, x), y) in lanes.iter_mut().zip(x).zip(y) {
+            *lane += x * y;
+        }
+    }
+    lanes.iter().sum::<f32>() + tail
+}
+
 #[derive(Debug)]
 pub enum DecodeError {
     Empty,
@@ -430,6 +541,28 @@ pub trait GraphSnapshot {
         }))
     }
 
+    /// Get an iterator over all non-tombstoned nodes carrying every label in
+    /// `labels`; an empty slice means all nodes.
+    ///
+    /// Implementations should intersect their label indexes. The default
+    /// implementation filters `nodes_with_label` of the first label.
+    fn nodes_with_labels(
+        &self,
+        labels: &[LabelId],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let Some((first, rest)) = labels.split_first() else {
+            return self.nodes();
+        };
+        if rest.is_empty() {
+            return self.nodes_with_label(*first);
+        }
+        let rest = rest.to_vec();
+        Box::new(self.nodes_with_label(*first).filter(move |iid| {
+            self.resolve_node_labels(*iid)
+                .is_some_and(|found| rest.iter().all(|label| found.contains(label)))
+        }))
+    }
+
     /// Get an iterator over all non-tombstoned nodes with a label and exact
     /// property value.
     ///
@@ -450,6 +583,175 @@ pub trait GraphSnapshot {
         )
     }
 
+    /// Get an iterator over all non-tombstoned nodes with a label whose
+    /// properties equal every `(key, value)` pair.
+    ///
+    /// Implementations should probe a declared composite index whose leading
+    /// keys are all given. The default implementation anchors on the first
+    /// pair with `nodes_with_label_and_property` and filters the rest.
+    fn nodes_with_label_and_properties(
+        &self,
+        label: LabelId,
+        props: &[(&str, &PropertyValue)],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let Some(((key, value), rest)) = props.split_first() else {
+            return self.nodes_with_label(label);
+        };
+        let rest: Vec<(String, PropertyValue)> = rest
+            .iter()
+            .map(|(key, value)| (key.to_string(), (*value).clone()))
+            .collect();
+        Box::new(
+            self.nodes_with_label_and_property(label, key, value)
+                .filter(move |iid| {
+                    rest.iter().all(|(key, value)| {
+                        self.node_property(*iid, key).is_some_and(|v| &v == value)
+                    })
+                }),
+        )
+    }
+
+    /// Get an iterator over all non-tombstoned nodes with a label whose
+    /// property lies between `lower` and `upper`, in Cypher comparison order:
+    /// integers and floats compare as numbers, other values only with their
+    /// own type.
+    ///
+    /// Implementations should use a storage-level ordered index when
+    /// available and may return extra nodes, so callers re-check the
+    /// predicate. The default implementation filters `nodes_with_label`.
+    fn nodes_with_label_and_property_range(
+        &self,
+        label: LabelId,
+        key: &str,
+        lower: Bound<&PropertyValue>,
+        upper: Bound<&PropertyValue>,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let key = key.to_string();
+        let lower = lower.cloned();
+        let upper = upper.cloned();
+        Box::new(self.nodes_with_label(label).filter(move |iid| {
+            self.node_property(*iid, &key).is_some_and(|value| {
+                bound_admits(&value, lower.as_ref(), Ordering::is_ge)
+                    && bound_admits(&value, upper.as_ref(), Ordering::is_le)
+            })
+        }))
+    }
+
+    /// Get an iterator over all non-tombstoned nodes with a label whose
+    /// string property `key` contains every term of `query`; see
+    /// [`text_matches`].
+    ///
+    /// Implementations should intersect the posting lists of a declared
+    /// full-text index. The default implementation filters
+    /// `nodes_with_label`.
+    fn nodes_with_label_and_terms(
+        &self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let key = key.to_string();
+        let query = query.to_string();
+        Box::new(self.nodes_with_label(label).filter(move |iid| {
+            matches!(self.node_property(*iid, &key),
+                Some(PropertyValue::String(text)) if text_matches(&text, &query))
+        }))
+    }
+
+    /// Get an iterator over all non-tombstoned nodes with a label whose
+    /// string property `key` contains the terms of `phrase` consecutively;
+    /// see [`text_phrase_matches`].
+    ///
+    /// Implementations should narrow the candidates with a declared
+    /// full-text index before checking term order. The default
+    /// implementation filters `nodes_with_label`.
+    fn nodes_with_label_and_phrase(
+        &self,
+        label: LabelId,
+        key: &str,
+        phrase: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let key = key.to_string();
+        let phrase = phrase.to_string();
+        Box::new(self.nodes_with_label(label).filter(move |iid| {
+            matches!(self.node_property(*iid, &key),
+                Some(PropertyValue::String(text)) if text_phrase_matches(&text, &phrase))
+        }))
+    }
+
+    /// Get the unit-normalized vector stored for a node, if any.
+    fn node_vector(&self, _iid: InternalNodeId) -> Option<Vec<f32>> {
+        None
+    }
+
+    /// Get up to `k` non-tombstoned nodes with a vector, optionally limited to
+    /// `label`, nearest to `query` by [`vector_distance`], nearest first.
+    ///
+    /// Implementations should answer from an approximate nearest-neighbor
+    /// index over the vectors visible in this snapshot, so traversals from
+    /// the hits see the same commit. The default implementation compares
+    /// `query` with every candidate's vector. A query that cannot be
+    /// normalized matches nothing.
+    fn search_vectors(
+        &self,
+        query: &[f32],
+        k: usize,
+        label: Option<LabelId>,
+    ) -> Vec<(InternalNodeId, f32)> {
+        let Some(query) = normalize_vector(query) else {
+            return Vec::new();
+        };
+        let candidates = match label {
+            Some(label) => self.nodes_with_label(label),
+            None => self.nodes(),
+        };
+        let mut hits: Vec<(InternalNodeId, f32)> = candidates
+            .filter_map(|iid| {
+                let vector = self.node_vector(iid)?;
+                (vector.len() == query.len()).then(|| (iid, vector_distance(&query, &vector)))
+            })
+            .collect();
+        hits.sort_by(|a, b| a.1.total_cmp(&b.1).then(a.0.cmp(&b.0)));
+        hits.truncate(k);
+        hits
+    }
+
+    /// Get the non-tombstoned node with `label` whose property `key` equals
+    /// `value`, if any.
+    ///
+    /// When `key` is declared unique for `label`, implementations should
+    /// answer with one point read of the unique index. Otherwise the first
+    /// match of [`Self::nodes_with_label_and_property`] is returned.
+    fn node_by_unique_property(
+        &self,
+        label: LabelId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Option<InternalNodeId> {
+        self.nodes_with_label_and_property(label, key, value).next()
+    }
+
+    /// Get an iterator over the edges of type `rel` between non-tombstoned
+    /// nodes whose property `key` equals `value`.
+    ///
+    /// Implementations should use a storage-level edge property index when
+    /// available. The default implementation preserves correctness by walking
+    /// the `rel` lists of every node.
+    fn edges_with_rel_and_property(
+        &self,
+        rel: RelTypeId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Box<dyn Iterator<Item = EdgeKey> + '_> {
+        let key = key.to_string();
+        let value = value.clone();
+        Box::new(
+            self.nodes()
+                .flat_map(move |src| self.neighbors(src, Some(rel)))
+                .filter(move |edge| self.edge_property(*edge, &key).is_some_and(|v| v == value)),
+        )
+    }
+
     /// Resolve an internal node ID to its external ID.
     ///
     /// Returns `Some(external_id)` if the node exists and has an external ID,
@@ -528,6 +830,24 @@ pub trait GraphSnapshot {
     fn edge_count(&self, _rel: Option<RelTypeId>) -> u64 {
         0
     }
+
+    /// Get the estimated number of distinct values of property `key` among
+    /// nodes with `label`, from collected statistics.
+    ///
+    /// The query planner uses it to weigh equality anchors. The default
+    /// implementation has no statistics and returns `None`.
+    fn property_distinct_count(&self, _label: LabelId, _key: &str) -> Option<u64> {
+        None
+    }
+
+    /// Get the average number of `rel` edges per node with `label`, outgoing
+    /// or `incoming`, from collected statistics.
+    ///
+    /// The query planner uses it to size expansions from an anchored node.
+    /// The default implementation has no statistics and returns `None`.
+    fn average_degree(&self, _label: LabelId, _rel: RelTypeId, _incoming: bool) -> Option<f64> {
+        None
+    }
 }
 
 #[cfg(test)]
@@ -92,6 +92,13 @@ pub use crate::api::{
     RelTypeId, WriteableGraph,
 };
 pub use crate::storage::PAGE_SIZE;
+pub use crate::storage::csr::{CsrNeighbors, CsrSnapshot};
+pub use crate::storage::engine::{BulkEdge, BulkLoadStats, BulkNode, DbOptions, Durability};
+pub use crate::storage::snapshot::NeighborCursor;
+pub use crate::storage::statistics::{
+    CommonValue, DegreeDirection, DegreeStatistics, GraphStatistics, LabelStatistics,
+    PropertyStatistics, RelTypeStatistics,
+};
 pub use error::{Error, Result};
 
 /// Open and manage an embedded property graph database.
@@ -127,14 +134,85 @@ impl Db {
     /// Returns an error if the directory cannot be created or opened, or if
     /// storage recovery fails.
     pub fn open(path: impl AsRef<Path>) -> Result<Self> {
+        Self::open_with(path, DbOptions::default())
+    }
+
+    /// Open a database directory with explicit [`DbOptions`].
+    ///
+    /// `options.durability` applies to every [`Db::begin_write`]
+    /// transaction; `options.flush_interval` paces the background flusher
+    /// that syncs [`Durability::Periodic`] commits.
+    ///
+    /// # Example
+    ///
+    /// ```rust,ignore
+    /// use nervusdb::{Db, DbOptions, Durability};
+    /// use std::time::Duration;
+    ///
+    /// let db = Db::open_with(
+    ///     "cache_graph",
+    ///     DbOptions {
+    ///         durability: Durability::Periodic,
+    ///         flush_interval: Duration::from_millis(200),
+    ///         ..DbOptions::default()
+    ///     },
+    /// )
+    /// .unwrap();
+    /// ```
+    ///
+    /// # Errors
+    ///
+    /// Same as [`Db::open`].
+    pub fn open_with(path: impl AsRef<Path>, options: DbOptions) -> Result<Self> {
         let storage_dir = path.as_ref().to_path_buf();
-        let engine = GraphEngine::open(&storage_dir)?;
+        let engine = GraphEngine::open_with(&storage_dir, options)?;
         Ok(Self {
             engine,
             storage_dir,
         })
     }
 
+    /// Load a whole graph into a fresh directory without write transactions.
+    ///
+    /// `path` must be missing or empty. Nodes get internal ids in input
+    /// order, and edges name their endpoints by external id. Repeated edges
+    /// merge. Edges are sorted on disk in bounded runs, so the edge input can
+    /// be larger than memory. The directory is synced and closed on return;
+    /// open it with [`Db::open`].
+    ///
+    /// # Example
+    ///
+    /// ```rust,ignore
+    /// use nervusdb::{BulkEdge, BulkNode, Db};
+    ///
+    /// let nodes = (1..=3).map(|id| BulkNode {
+    ///     external_id: id,
+    ///     labels: vec!["Person".to_string()],
+    ///     properties: vec![("name".to_string(), format!("p{id}").into())],
+    /// });
+    /// let edges = [(1, 2), (2, 3)].map(|(src, dst)| BulkEdge {
+    ///     src,
+    ///     rel: "KNOWS".to_string(),
+    ///     dst,
+    ///     properties: Vec::new(),
+    /// });
+    /// Db::bulk_load("people_graph", nodes, edges).unwrap();
+    /// let db = Db::open("people_graph").unwrap();
+    /// ```
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `path` is not empty, if an external id repeats or
+    /// is 0, if an edge names an unknown node, or if a write fails. A failed
+    /// or interrupted load leaves a directory that [`Db::open`] refuses.
+    pub fn bulk_load(
+        path: impl AsRef<Path>,
+        nodes: impl IntoIterator<Item = BulkNode>,
+        edges: impl IntoIterator<Item = BulkEdge>,
+    ) -> Result<BulkLoadStats> {
+        crate::storage::engine::bulk_load(path, nodes, edges).map_err(Error::from)
+    }
+
     /// Path to the local database directory.
     #[inline]
     pub fn storage_dir(&self) -> &Path {
@@ -153,6 +231,13 @@ impl Db {
         DbSnapshot(self.engine.snapshot())
     }
 
+    /// Build an in-memory CSR view of a fresh snapshot.
+    ///
+    /// See [`DbSnapshot::build_csr_view`].
+    pub fn build_csr_view(&self) -> CsrSnapshot {
+        self.snapshot().build_csr_view()
+    }
+
     /// Begin a read-only transaction.
     ///
     /// Returns a [`ReadTxn`] providing low-level neighbor traversal. For
@@ -189,8 +274,103 @@ impl Db {
         }
     }
 
-    /// Persist committed graph data through the storage backend.
+    /// Begin a write transaction whose commit persists to `durability`
+    /// instead of the database default.
+    ///
+    /// Commits stay atomic in every mode; see [`Durability`] for what each
+    /// mode keeps after a crash.
+    pub fn begin_write_with(&self, durability: Durability) -> WriteTxn<'_> {
+        WriteTxn {
+            inner: self.engine.begin_write_with(durability),
+        }
+    }
+
+    /// Declare a composite index over an ordered list of property keys of
+    /// `label` and build it from the committed nodes.
+    ///
+    /// Queries binding the leading keys with equality, such as
+    /// `MATCH (f:File {repo: $r, path: $p})`, then find their nodes with one
+    /// index probe. Declaring an existing index does nothing.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if `keys` does not hold 2 to 255 distinct keys, or if
+    /// the write fails.
+    pub fn create_composite_index(&self, label: &str, keys: &[&str]) -> Result<()> {
+        let label = self.engine.get_or_create_label(label)?;
+        self.engine
+            .create_composite_index(label, keys)
+            .map_err(Error::from)
+    }
+
+    /// Declare `key` unique among the nodes of `label` and build its index
+    /// from the committed nodes.
+    ///
+    /// Commits that would give two nodes of `label` the same value then fail,
+    /// and [`WriteTxn::merge_node`] finds an existing node with one point
+    /// read. Nulls, lists, and maps are not constrained. Declaring an
+    /// existing constraint does nothing.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if committed nodes already share a value, or if the
+    /// write fails.
+    pub fn create_unique_constraint(&self, label: &str, key: &str) -> Result<()> {
+        let label = self.engine.get_or_create_label(label)?;
+        self.engine
+            .create_unique_constraint(label, key)
+            .map_err(Error::from)
+    }
+
+    /// Declare a full-text index over the string values of `key` on nodes of
+    /// `label` and build its posting lists from the committed nodes.
+    ///
+    /// Values are split into lowercased alphanumeric terms (see
+    /// [`api::text_terms`]). Snapshots then answer
+    /// [`GraphSnapshot::nodes_with_label_and_terms`] and
+    /// [`GraphSnapshot::nodes_with_label_and_phrase`] from the posting lists,
+    /// and `textMatch` / `textPhrase` predicates can anchor a `MATCH`.
+    /// Declaring an existing index does nothing.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the write fails.
+    pub fn create_fulltext_index(&self, label: &str, key: &str) -> Result<()> {
+        let label = self.engine.get_or_create_label(label)?;
+        self.engine
+            .create_fulltext_index(label, key)
+            .map_err(Error::from)
+    }
+
+    /// Collect graph statistics in one parallel pass over a fresh snapshot
+    /// and store them, replacing earlier ones.
+    ///
+    /// Statistics cover nodes per label, edges per relationship type, out-
+    /// and in-degree histograms per label and relationship type, and the
+    /// distinct-value estimate and most common values of every scalar
+    /// property per label. Later commits keep the counts, degree histograms,
+    /// and distinct estimates current (see [`GraphStatistics`]); the query
+    /// planner sizes expansions and equality lookups from them. Commits wait
+    /// while the pass runs; snapshots do not.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the write fails.
+    pub fn analyze(&self) -> Result<GraphStatistics> {
+        self.engine.analyze().map_err(Error::from)?;
+        Ok(self.statistics().unwrap_or_default())
+    }
+
+    /// Statistics stored by [`Db::analyze`] as of now, or `None` if it has
+    /// never run.
+    pub fn statistics(&self) -> Option<GraphStatistics> {
+        self.engine.snapshot().statistics()
+    }
+
+    /// Fold pending adjacency delta records into their packed lists, then
+    /// persist committed graph data through the storage backend.
     pub fn checkpoint(&self) -> Result<()> {
+        self.engine.merge_adjacency_deltas().map_err(Error::from)?;
         self.engine.persist().map_err(Error::from)
     }
 
@@ -222,11 +402,24 @@ impl Db {
 /// - `node_count()` / `edge_count()` — count entities
 pub struct DbSnapshot(StorageSnapshot);
 
+impl DbSnapshot {
+    /// Copy this snapshot's adjacency into contiguous in-memory arrays.
+    ///
+    /// The returned [`CsrSnapshot`] answers `neighbors` and
+    /// `incoming_neighbors` from memory and everything else from this
+    /// snapshot, so it sees exactly the same commit. Building scans both
+    /// adjacency keyspaces once, split across the available cores. Use it for
+    /// repeated read-heavy traversals; it does not follow later commits.
+    pub fn build_csr_view(&self) -> CsrSnapshot {
+        CsrSnapshot::build(self.0.clone())
+    }
+}
+
 impl GraphSnapshot for DbSnapshot {
-    type Neighbors<'a> = Box<dyn Iterator<Item = EdgeKey> + 'a>;
+    type Neighbors<'a> = NeighborCursor<'a>;
 
     fn neighbors(&self, src: InternalNodeId, rel: Option<RelTypeId>) -> Self::Neighbors<'_> {
-        Box::new(self.0.neighbors(src, rel))
+        self.0.neighbors(src, rel)
     }
 
     fn incoming_neighbors(
@@ -234,7 +427,7 @@ impl GraphSnapshot for DbSnapshot {
         dst: InternalNodeId,
         rel: Option<RelTypeId>,
     ) -> Self::Neighbors<'_> {
-        Box::new(self.0.incoming_neighbors(dst, rel))
+        self.0.incoming_neighbors(dst, rel)
     }
 
     fn nodes(&self) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
@@ -245,6 +438,13 @@ impl GraphSnapshot for DbSnapshot {
         self.0.nodes_with_label(label)
     }
 
+    fn nodes_with_labels(
+        &self,
+        labels: &[LabelId],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.0.nodes_with_labels(labels)
+    }
+
     fn nodes_with_label_and_property(
         &self,
         label: LabelId,
@@ -254,6 +454,74 @@ impl GraphSnapshot for DbSnapshot {
         self.0.nodes_with_label_and_property(label, key, value)
     }
 
+    fn nodes_with_label_and_properties(
+        &self,
+        label: LabelId,
+        props: &[(&str, &PropertyValue)],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.0.nodes_with_label_and_properties(label, props)
+    }
+
+    fn nodes_with_label_and_property_range(
+        &self,
+        label: LabelId,
+        key: &str,
+        lower: std::ops::Bound<&PropertyValue>,
+        upper: std::ops::Bound<&PropertyValue>,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.0
+            .nodes_with_label_and_property_range(label, key, lower, upper)
+    }
+
+    fn nodes_with_label_and_terms(
+        &self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.0.nodes_with_label_and_terms(label, key, query)
+    }
+
+    fn nodes_with_label_and_phrase(
+        &self,
+        label: LabelId,
+        key: &str,
+        phrase: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.0.nodes_with_label_and_phrase(label, key, phrase)
+    }
+
+    fn node_vector(&self, iid: InternalNodeId) -> Option<Vec<f32>> {
+        self.0.node_vector(iid)
+    }
+
+    fn search_vectors(
+        &self,
+        query: &[f32],
+        k: usize,
+        label: Option<LabelId>,
+    ) -> Vec<(InternalNodeId, f32)> {
+        self.0.search_vectors(query, k, label)
+    }
+
+    fn node_by_unique_property(
+        &self,
+        label: LabelId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Option<InternalNodeId> {
+        self.0.node_by_unique_property(label, key, value)
+    }
+
+    fn edges_with_rel_and_property(
+        &self,
+        rel: RelTypeId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Box<dyn Iterator<Item = EdgeKey> + '_> {
+        self.0.edges_with_rel_and_property(rel, key, value)
+    }
+
     fn resolve_external(&self, iid: InternalNodeId) -> Option<ExternalId> {
         self.0.resolve_external(iid)
     }
@@ -309,6 +577,14 @@ impl GraphSnapshot for DbSnapshot {
     fn edge_count(&self, rel: Option<RelTypeId>) -> u64 {
         self.0.edge_count(rel)
     }
+
+    fn property_distinct_count(&self, label: LabelId, key: &str) -> Option<u64> {
+        self.0.property_distinct_count(label, key)
+    }
+
+    fn average_degree(&self, label: LabelId, rel: RelTypeId, incoming: bool) -> Option<f64> {
+        self.0.average_degree(label, rel, incoming)
+    }
 }
 
 /// A low-level read transaction returned by [`Db::begin_read`].
@@ -380,6 +656,26 @@ impl<'a> WriteTxn<'a> {
             .map_err(Error::from)
     }
 
+    /// Return the node of `label_id` whose `key` holds `value`, creating it
+    /// with `external_id` and that property when none exists.
+    ///
+    /// Repeated calls in one transaction return the same staged node. The
+    /// committed node is found with one point read when `(label, key)` is
+    /// declared with [`Db::create_unique_constraint`], and with an index
+    /// probe otherwise. The transaction holds the writer lock, so no other
+    /// writer can create the node in between.
+    pub fn merge_node(
+        &mut self,
+        external_id: ExternalId,
+        label_id: LabelId,
+        key: String,
+        value: PropertyValue,
+    ) -> Result<InternalNodeId> {
+        self.inner
+            .merge_node(external_id, label_id, key, value)
+            .map_err(Error::from)
+    }
+
     /// Get or create a label by name. Returns the label ID.
     pub fn get_or_create_label(&mut self, name: &str) -> Result<LabelId> {
         self.inner.get_or_create_label(name).map_err(Error::from)
@@ -431,6 +727,21 @@ impl<'a> WriteTxn<'a> {
     }
 
     /// Set a property on an edge. Overwrites existing value.
+    /// Set the embedding of a node, replacing any previous one.
+    ///
+    /// Vectors are stored unit-normalized and searched by cosine distance
+    /// with [`GraphSnapshot::search_vectors`]. Every vector of a database has
+    /// the dimension of the first one committed. Tombstoning the node drops
+    /// its vector.
+    ///
+    /// # Errors
+    ///
+    /// Returns an error if the node does not exist, or if the vector is
+    /// empty, zero, non-finite, or of another dimension.
+    pub fn set_vector(&mut self, node: InternalNodeId, vector: &[f32]) -> Result<()> {
+        self.inner.set_vector(node, vector).map_err(Error::from)
+    }
+
     pub fn set_edge_property(
         &mut self,
         src: InternalNodeId,
@@ -467,8 +778,9 @@ impl<'a> WriteTxn<'a> {
     /// Commit this transaction atomically.
     ///
     /// Writes all buffered modifications through Fjall, then makes them
-    /// visible to new read snapshots. Consumes the transaction; call once per
-    /// `begin_write`.
+    /// visible to new read snapshots. Returns once the transaction is
+    /// persisted to its [`Durability`]. Consumes the transaction; call once
+    /// per `begin_write`.
     pub fn commit(self) -> Result<()> {
         self.inner.commit().map_err(Error::from)
     }
@@ -161,88 +161,12 @@ pub fn evaluate_expression_value<S: GraphSnapshot>(
         }
         Expression::Unary(u) => {
             let v = evaluate_expression_value(&u.operand, row, snapshot, params);
-            match u.operator {
-                UnaryOperator::Not => match v {
-                    Value::Bool(b) => Value::Bool(!b),
-                    Value::Null => Value::Null,
-                    _ => Value::Null,
-                },
-                UnaryOperator::Negate => match v {
-                    Value::Int(i) => i
-                        .checked_neg()
-                        .map(Value::Int)
-                        .unwrap_or_else(|| Value::Float(-(i as f64))),
-                    Value::Float(f) => Value::Float(-f),
-                    Value::Null => Value::Null,
-                    _ => Value::Null,
-                },
-            }
+            evaluate_unary(&u.operator, v)
         }
         Expression::Binary(b) => {
             let left = evaluate_expression_value(&b.left, row, snapshot, params);
             let right = evaluate_expression_value(&b.right, row, snapshot, params);
-
-            match b.operator {
-                BinaryOperator::Equals => cypher_equals(&left, &right),
-                BinaryOperator::NotEquals => match cypher_equals(&left, &right) {
-                    Value::Bool(v) => Value::Bool(!v),
-                    Value::Null => Value::Null,
-                    _ => Value::Null,
-                },
-                BinaryOperator::And => match (left, right) {
-                    (Value::Bool(false), _) | (_, Value::Bool(false)) => Value::Bool(false),
-                    (Value::Bool(true), Value::Bool(true)) => Value::Bool(true),
-                    (Value::Bool(true), Value::Null)
-                    | (Value::Null, Value::Bool(true))
-                    | (Value::Null, Value::Null)
-                    | (Value::Bool(true), _)
-                    | (_, Value::Bool(true))
-                    | (Value::Null, _)
-                    | (_, Value::Null) => Value::Null,
-                    _ => Value::Null,
-                },
-                BinaryOperator::Or => match (left, right) {
-                    (Value::Bool(true), _) | (_, Value::Bool(true)) => Value::Bool(true),
-                    (Value::Bool(false), Value::Bool(false)) => Value::Bool(false),
-                    (Value::Bool(false), Value::Null)
-                    | (Value::Null, Value::Bool(false))
-                    | (Value::Null, Value::Null)
-                    | (Value::Bool(false), _)
-                    | (_, Value::Bool(false))
-                    | (Value::Null, _)
-                    | (_, Value::Null) => Value::Null,
-                    _ => Value::Null,
-                },
-                BinaryOperator::Xor => match (left, right) {
-                    (Value::Bool(l), Value::Bool(r)) => Value::Bool(l ^ r),
-                    (Value::Null, _) | (_, Value::Null) => Value::Null,
-                    _ => Value::Null,
-                },
-                BinaryOperator::LessThan => compare_values(&left, &right, |ord| ord.is_lt()),
-                BinaryOperator::LessEqual => {
-                    compare_values(&left, &right, |ord| ord.is_lt() || ord.is_eq())
-                }
-                BinaryOperator::GreaterThan => compare_values(&left, &right, |ord| ord.is_gt()),
-
-                BinaryOperator::GreaterEqual => {
-                    compare_values(&left, &right, |ord| ord.is_gt() || ord.is_eq())
-                }
-                BinaryOperator::Add => add_values(&left, &right),
-                BinaryOperator::Subtract => subtract_values(&left, &right),
-                BinaryOperator::Multiply => multiply_values(&left, &right),
-                BinaryOperator::Divide => divide_values(&left, &right),
-                BinaryOperator::Modulo => numeric_mod(&left, &right),
-                BinaryOperator::Power => numeric_pow(&left, &right),
-                BinaryOperator::In => in_list(&left, &right),
-                BinaryOperator::StartsWith => {
-                    string_predicate(&left, &right, |l, r| l.starts_with(r))
-                }
-                BinaryOperator::EndsWith => string_predicate(&left, &right, |l, r| l.ends_with(r)),
-                BinaryOperator::Contains => string_predicate(&left, &right, |l, r| l.contains(r)),
-                BinaryOperator::HasLabel => evaluate_has_label(&left, &right, snapshot),
-                BinaryOperator::IsNull => Value::Bool(matches!(left, Value::Null)),
-                BinaryOperator::IsNotNull => Value::Bool(!matches!(left, Value::Null)),
-            }
+            evaluate_binary(&b.operator, left, right, snapshot)
         }
         Expression::Case(case) => {
             for (cond, val) in &case.when_clauses {
@@ -290,6 +214,96 @@ pub fn evaluate_expression_value<S: GraphSnapshot>(
     }
 }
 
+/// Applies a unary operator to an evaluated operand, for row and column
+/// evaluation alike.
+pub(crate) fn evaluate_unary(operator: &UnaryOperator, value: Value) -> Value {
+    match operator {
+        UnaryOperator::Not => match value {
+            Value::Bool(b) => Value::Bool(!b),
+            Value::Null => Value::Null,
+            _ => Value::Null,
+        },
+        UnaryOperator::Negate => match value {
+            Value::Int(i) => i
+                .checked_neg()
+                .map(Value::Int)
+                .unwrap_or_else(|| Value::Float(-(i as f64))),
+            Value::Float(f) => Value::Float(-f),
+            Value::Null => Value::Null,
+            _ => Value::Null,
+        },
+    }
+}
+
+/// Applies a binary operator to evaluated operands, for row and column
+/// evaluation alike. `AND` and `OR` follow three-valued logic.
+pub(crate) fn evaluate_binary<S: GraphSnapshot>(
+    operator: &BinaryOperator,
+    left: Value,
+    right: Value,
+    snapshot: &S,
+) -> Value {
+    match operator {
+        BinaryOperator::Equals => cypher_equals(&left, &right),
+        BinaryOperator::NotEquals => match cypher_equals(&left, &right) {
+            Value::Bool(v) => Value::Bool(!v),
+            Value::Null => Value::Null,
+            _ => Value::Null,
+        },
+        BinaryOperator::And => match (left, right) {
+            (Value::Bool(false), _) | (_, Value::Bool(false)) => Value::Bool(false),
+            (Value::Bool(true), Value::Bool(true)) => Value::Bool(true),
+            (Value::Bool(true), Value::Null)
+            | (Value::Null, Value::Bool(true))
+            | (Value::Null, Value::Null)
+            | (Value::Bool(true), _)
+            | (_, Value::Bool(true))
+            | (Value::Null, _)
+            | (_, Value::Null) => Value::Null,
+            _ => Value::Null,
+        },
+        BinaryOperator::Or => match (left, right) {
+            (Value::Bool(true), _) | (_, Value::Bool(true)) => Value::Bool(true),
+            (Value::Bool(false), Value::Bool(false)) => Value::Bool(false),
+            (Value::Bool(false), Value::Null)
+            | (Value::Null, Value::Bool(false))
+            | (Value::Null, Value::Null)
+            | (Value::Bool(false), _)
+            | (_, Value::Bool(false))
+            | (Value::Null, _)
+            | (_, Value::Null) => Value::Null,
+            _ => Value::Null,
+        },
+        BinaryOperator::Xor => match (left, right) {
+            (Value::Bool(l), Value::Bool(r)) => Value::Bool(l ^ r),
+            (Value::Null, _) | (_, Value::Null) => Value::Null,
+            _ => Value::Null,
+        },
+        BinaryOperator::LessThan => compare_values(&left, &right, |ord| ord.is_lt()),
+        BinaryOperator::LessEqual => {
+            compare_values(&left, &right, |ord| ord.is_lt() || ord.is_eq())
+        }
+        BinaryOperator::GreaterThan => compare_values(&left, &right, |ord| ord.is_gt()),
+
+        BinaryOperator::GreaterEqual => {
+            compare_values(&left, &right, |ord| ord.is_gt() || ord.is_eq())
+        }
+        BinaryOperator::Add => add_values(&left, &right),
+        BinaryOperator::Subtract => subtract_values(&left, &right),
+        BinaryOperator::Multiply => multiply_values(&left, &right),
+        BinaryOperator::Divide => divide_values(&left, &right),
+        BinaryOperator::Modulo => numeric_mod(&left, &right),
+        BinaryOperator::Power => numeric_pow(&left, &right),
+        BinaryOperator::In => in_list(&left, &right),
+        BinaryOperator::StartsWith => string_predicate(&left, &right, |l, r| l.starts_with(r)),
+        BinaryOperator::EndsWith => string_predicate(&left, &right, |l, r| l.ends_with(r)),
+        BinaryOperator::Contains => string_predicate(&left, &right, |l, r| l.contains(r)),
+        BinaryOperator::HasLabel => evaluate_has_label(&left, &right, snapshot),
+        BinaryOperator::IsNull => Value::Bool(matches!(left, Value::Null)),
+        BinaryOperator::IsNotNull => Value::Bool(!matches!(left, Value::Null)),
+    }
+}
+
 fn evaluate_function<S: GraphSnapshot>(
     call: &crate::query::ast::FunctionCall,
     row: &Row,
@@ -369,6 +383,12 @@ enum LargeTemporal {
     LocalDateTime(LargeDateTime),
 }
 
+/// Whether comparisons against `s` may use temporal instead of lexicographic
+/// order, because `s` parses as a temporal value.
+pub(crate) fn compares_as_temporal(s: &str) -> bool {
+    evaluator_temporal_map::parse_temporal_string(s).is_some()
+}
+
 pub fn order_compare(left: &Value, right: &Value) -> Ordering {
     match (left, right) {
         (Value::Null, Value::Null) => Ordering::Equal,
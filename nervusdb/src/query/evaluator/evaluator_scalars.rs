@@ -1,5 +1,6 @@
 use super::Value;
 use super::evaluator_duration::{duration_from_value, duration_iso_components};
+use crate::api::{text_matches, text_phrase_matches};
 use crate::query::executor::PathValue;
 
 pub(super) fn evaluate_scalar_function(name: &str, args: &[Value]) -> Option<Value> {
@@ -19,6 +20,8 @@ pub(super) fn evaluate_scalar_function(name: &str, args: &[Value]) -> Option<Val
         "right" => Some(evaluate_right(args)),
         "replace" => Some(evaluate_replace(args)),
         "split" => Some(evaluate_split(args)),
+        "textmatch" => Some(evaluate_text_predicate(args, text_matches)),
+        "textphrase" => Some(evaluate_text_predicate(args, text_phrase_matches)),
         "coalesce" => Some(evaluate_coalesce(args)),
         "sqrt" => Some(evaluate_sqrt(args)),
         "sign" => Some(evaluate_sign(args)),
@@ -221,6 +224,16 @@ fn evaluate_split(args: &[Value]) -> Value {
     }
 }
 
+/// `textMatch(text, query)` / `textPhrase(text, phrase)`: term matching as
+/// done by full-text indexes; null unless both arguments are strings.
+fn evaluate_text_predicate(args: &[Value], matches: fn(&str, &str) -> bool) -> Value {
+    if let (Some(Value::String(text)), Some(Value::String(query))) = (args.first(), args.get(1)) {
+        Value::Bool(matches(text, query))
+    } else {
+        Value::Null
+    }
+}
+
 fn evaluate_coalesce(args: &[Value]) -> Value {
     for arg in args {
         if !matches!(arg, Value::Null) {
@@ -389,6 +402,31 @@ mod tests {
         }
     }
 
+    #[test]
+    fn text_predicates_match_terms_and_phrases() {
+        let text = || Value::String("The Quick-brown fox".into());
+        assert_eq!(
+            evaluate_scalar_function("textmatch", &[text(), Value::String("FOX quick".into())]),
+            Some(Value::Bool(true))
+        );
+        assert_eq!(
+            evaluate_scalar_function("textmatch", &[text(), Value::String("qui".into())]),
+            Some(Value::Bool(false))
+        );
+        assert_eq!(
+            evaluate_scalar_function("textphrase", &[text(), Value::String("quick brown".into())]),
+            Some(Value::Bool(true))
+        );
+        assert_eq!(
+            evaluate_scalar_function("textphrase", &[text(), Value::String("brown quick".into())]),
+            Some(Value::Bool(false))
+        );
+        assert_eq!(
+            evaluate_scalar_function("textmatch", &[Value::Null, Value::String("fox".into())]),
+            Some(Value::Null)
+        );
+    }
+
     #[test]
     fn left_and_right_return_expected_substrings() {
         assert_eq!(
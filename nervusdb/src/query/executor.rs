@@ -1,7 +1,9 @@
 use crate::query::ast::{Expression, PathElement, Pattern, RelationshipDirection};
 use crate::query::error::{Error, Result};
 use crate::query::evaluator::evaluate_expression_value;
+mod batch;
 mod core_types;
+mod cost;
 mod create_delete_ops;
 mod label_constraint;
 mod match_bound_rel_plan;
@@ -17,6 +19,7 @@ mod write_dispatch;
 mod write_path;
 pub use crate::api::LabelId;
 use crate::api::{EdgeKey, ExternalId, GraphSnapshot, InternalNodeId, RelTypeId};
+use batch::BatchRows;
 use create_delete_ops::{execute_create, execute_delete};
 use label_constraint::{LabelConstraint, node_matches_label_constraint, resolve_label_constraint};
 use match_bound_rel_plan::MatchBoundRelIter;
@@ -29,7 +32,8 @@ use write_path::{convert_executor_value_to_property, execute_set};
 
 const UNLABELED_LABEL_ID: LabelId = LabelId::MAX;
 pub use core_types::{NodeValue, PathValue, ReifiedPathValue, RelationshipValue, Row, Value};
-pub use plan_types::{Plan, PlanIterator};
+pub(crate) use cost::Estimator;
+pub use plan_types::{NodeAnchor, Plan, PlanIterator, PropertyRange, TextSearch};
 
 pub fn execute_plan<'a, S: GraphSnapshot + 'a>(
     snapshot: &'a S,
@@ -0,0 +1,921 @@
+//! Batched execution of scan, hop, filter, and project subtrees.
+//!
+//! Row operators hand each other one `Row` per call, and filters and
+//! projections check the soft timeout on every row. A read subtree made only
+//! of node scans, plain single hops, filters, and projections runs here
+//! instead. Its operators exchange [`RowBatch`]es in which node and edge
+//! bindings are id columns, and they check the timeout once per batch.
+//! Literals, parameters, variables, property reads, and operators over them
+//! are evaluated a column at a time; these never fail the runtime checks,
+//! so they skip them. Other expressions are checked and evaluated row by row
+//! inside the batch. [`BatchRows`] turns batches back into rows at the root
+//! of the subtree, in the order the row operators produce them.
+//!
+//! Batches start at [`FIRST_BATCH_ROWS`] rows and double up to
+//! `ExecuteOptions::batch_rows`, so a `LIMIT` above reads little past its
+//! last row.
+
+use super::label_constraint::{node_matches_label_constraint, resolve_label_constraint};
+use super::match_out_plan::{fresh_hop_start, resolve_rel_ids};
+use super::plan_head::node_scan_nodes;
+use super::plan_mid::ensure_runtime_expression_compatible;
+use super::read_path::NodeEdges;
+use super::{
+    EdgeKey, Error, GraphSnapshot, InternalNodeId, LabelConstraint, Plan, PlanIterator, RelTypeId,
+    Result, Row, Value, convert_api_property_to_value,
+};
+use crate::query::ast::Expression;
+use crate::query::evaluator::{
+    evaluate_binary, evaluate_expression_bool, evaluate_expression_value, evaluate_unary,
+};
+use crate::query::query_api::Params;
+
+const FIRST_BATCH_ROWS: usize = 64;
+
+/// Runs `plan` in batches when batching is enabled and its whole subtree
+/// supports it; `None` leaves it to the row operators.
+pub(super) fn execute_batched<'a, S: GraphSnapshot + 'a>(
+    snapshot: &'a S,
+    plan: &'a Plan,
+    params: &'a Params,
+) -> Option<PlanIterator<'a, S>> {
+    let max_rows = params.execute_options().batch_rows;
+    let root = matches!(
+        plan,
+        Plan::Filter { .. } | Plan::Project { .. } | Plan::MatchOut { .. }
+    );
+    if max_rows == 0 || !root || !batchable(plan) {
+        return None;
+    }
+    Some(PlanIterator::Batched(Box::new(BatchRows {
+        op: build(snapshot, plan, params, max_rows),
+        batch: None,
+        next: 0,
+    })))
+}
+
+/// Scans, non-optional hops without a path or limit whose aliases differ,
+/// filters, and projections.
+fn batchable(plan: &Plan) -> bool {
+    match plan {
+        Plan::NodeScan { .. } => true,
+        Plan::MatchOut {
+            input,
+            src_alias,
+            edge_alias,
+            dst_alias,
+            limit: None,
+            optional: false,
+            path_alias: None,
+            ..
+        } => {
+            src_alias != dst_alias
+                && edge_alias
+                    .as_ref()
+                    .is_none_or(|edge| edge != src_alias && edge != dst_alias)
+                && input.as_deref().is_none_or(batchable)
+        }
+        Plan::Filter { input, .. } | Plan::Project { input, .. } => batchable(input),
+        _ => false,
+    }
+}
+
+fn build<'a, S: GraphSnapshot + 'a>(
+    snapshot: &'a S,
+    plan: &'a Plan,
+    params: &'a Params,
+    max_rows: usize,
+) -> BatchOp<'a, S> {
+    match plan {
+        Plan::NodeScan {
+            alias,
+            labels,
+            property_eq,
+            composite_eq,
+            text_search,
+            property_range,
+            optional: _,
+        } => {
+            let nodes = node_scan_nodes(
+                snapshot,
+                labels,
+                property_eq,
+                composite_eq,
+                text_search,
+                property_range,
+                params,
+            )
+            .unwrap_or_else(|| Box::new(std::iter::empty()));
+            BatchOp::Scan(ScanOp {
+                snapshot,
+                nodes,
+                alias,
+                size: BatchSize::new(max_rows),
+            })
+        }
+        Plan::MatchOut {
+            input,
+            src_alias,
+            rels,
+            edge_alias,
+            edge_eq,
+            src_anchor,
+            dst_anchor,
+            dst_alias,
+            dst_labels,
+            ..
+        } => {
+            let rel_ids = resolve_rel_ids(snapshot, rels);
+            let dst_labels = resolve_label_constraint(snapshot, dst_labels);
+            match input {
+                Some(input) => BatchOp::Expand(Box::new(ExpandOp {
+                    snapshot,
+                    input: build(snapshot, input, params, max_rows),
+                    src_alias,
+                    edge_alias: edge_alias.as_deref(),
+                    dst_alias,
+                    rels: rel_ids,
+                    dst_labels,
+                    current: None,
+                    src_column: None,
+                    dst_column: None,
+                    row: 0,
+                    edges: None,
+                    pending: None,
+                    size: BatchSize::new(max_rows),
+                })),
+                None => {
+                    let start = fresh_hop_start(
+                        snapshot,
+                        rels,
+                        rel_ids.as_deref(),
+                        edge_eq,
+                        src_anchor,
+                        dst_anchor,
+                        params,
+                    );
+                    let sources: Box<dyn Iterator<Item = InternalNodeId> + 'a> =
+                        if start.anchor.is_some() {
+                            Box::new(std::iter::empty())
+                        } else {
+                            start.sources.unwrap_or_else(|| snapshot.nodes())
+                        };
+                    BatchOp::FreshExpand(Box::new(FreshExpandOp {
+                        snapshot,
+                        src_alias,
+                        edge_alias: edge_alias.as_deref(),
+                        dst_alias,
+                        rels: rel_ids,
+                        dst_labels,
+                        anchor: start.anchor,
+                        sources,
+                        incoming: start.incoming,
+                        edges: None,
+                        size: BatchSize::new(max_rows),
+                    }))
+                }
+            }
+        }
+        Plan::Filter { input, predicate } => BatchOp::Filter(Box::new(FilterOp {
+            snapshot,
+            params,
+            input: build(snapshot, input, params, max_rows),
+            predicate,
+            vectorized: vectorizable(predicate),
+            held: None,
+            pending: None,
+        })),
+        Plan::Project { input, projections } => BatchOp::Project(Box::new(ProjectOp {
+            snapshot,
+            params,
+            input: build(snapshot, input, params, max_rows),
+            projections,
+            vectorized: projections
+                .iter()
+                .map(|(_, expr)| vectorizable(expr))
+                .collect(),
+            held: None,
+            pending: None,
+        })),
+        _ => unreachable!("batchable admits only scans, hops, filters, and projections"),
+    }
+}
+
+/// Rows a producer aims for in its next batch, doubling from
+/// `FIRST_BATCH_ROWS` up to the configured maximum.
+struct BatchSize {
+    next: usize,
+    max: usize,
+}
+
+impl BatchSize {
+    fn new(max: usize) -> Self {
+        Self {
+            next: FIRST_BATCH_ROWS.min(max),
+            max,
+        }
+    }
+
+    fn take(&mut self) -> usize {
+        let rows = self.next;
+        self.next = rows.saturating_mul(2).min(self.max);
+        rows
+    }
+}
+
+/// One binding across a batch. Scans and hops bind node and edge ids;
+/// projections produce values.
+#[derive(Clone)]
+enum Column {
+    Nodes(Vec<InternalNodeId>),
+    Edges(Vec<EdgeKey>),
+    Values(Vec<Value>),
+}
+
+impl Column {
+    fn value(&self, row: usize) -> Value {
+        match self {
+            Column::Nodes(ids) => Value::NodeId(ids[row]),
+            Column::Edges(edges) => Value::EdgeKey(edges[row]),
+            Column::Values(values) => values[row].clone(),
+        }
+    }
+
+    /// Moves the value of `row` out, leaving `Null` in a value column.
+    fn take(&mut self, row: usize) -> Value {
+        match self {
+            Column::Values(values) => std::mem::replace(&mut values[row], Value::Null),
+            _ => self.value(row),
+        }
+    }
+
+    fn gather(&self, rows: &[usize]) -> Self {
+        match self {
+            Column::Nodes(ids) => Column::Nodes(rows.iter().map(|row| ids[*row]).collect()),
+            Column::Edges(edges) => Column::Edges(rows.iter().map(|row| edges[*row]).collect()),
+            Column::Values(values) => {
+                Column::Values(rows.iter().map(|row| values[*row].clone()).collect())
+            }
+        }
+    }
+
+    fn retain(&mut self, keep: &[bool]) {
+        match self {
+            Column::Nodes(ids) => retain_rows(ids, keep),
+            Column::Edges(edges) => retain_rows(edges, keep),
+            Column::Values(values) => retain_rows(values, keep),
+        }
+    }
+
+    fn into_values(self) -> Vec<Value> {
+        match self {
+            Column::Nodes(ids) => ids.into_iter().map(Value::NodeId).collect(),
+            Column::Edges(edges) => edges.into_iter().map(Value::EdgeKey).collect(),
+            Column::Values(values) => values,
+        }
+    }
+}
+
+fn retain_rows<T>(items: &mut Vec<T>, keep: &[bool]) {
+    let mut row = 0;
+    items.retain(|_| {
+        row += 1;
+        keep[row - 1]
+    });
+}
+
+/// Rows of one batch, column by column, named by the plan's aliases. Column
+/// order is the order the row operators would give a row's bindings.
+pub(super) struct RowBatch<'a> {
+    columns: Vec<(&'a str, Column)>,
+    len: usize,
+}
+
+impl<'a> RowBatch<'a> {
+    fn position(&self, name: &str) -> Option<usize> {
+        self.columns.iter().position(|(alias, _)| *alias == name)
+    }
+
+    fn column(&self, name: &str) -> Option<&Column> {
+        self.position(name).map(|index| &self.columns[index].1)
+    }
+
+    /// Replaces the column named `name`, or appends it, like `Row::with`.
+    fn set(&mut self, name: &'a str, column: Column) {
+        match self.position(name) {
+            Some(index) => self.columns[index].1 = column,
+            None => self.columns.push((name, column)),
+        }
+    }
+
+    fn row(&self, row: usize) -> Row {
+        Row::new(
+            self.columns
+                .iter()
+                .map(|(alias, column)| (alias.to_string(), column.value(row)))
+                .collect(),
+        )
+    }
+
+    fn gather(&self, rows: &[usize]) -> Self {
+        Self {
+            columns: self
+                .columns
+                .iter()
+                .map(|(alias, column)| (*alias, column.gather(rows)))
+                .collect(),
+            len: rows.len(),
+        }
+    }
+
+    fn retain(&mut self, keep: &[bool]) {
+        for (_, column) in &mut self.columns {
+            column.retain(keep);
+        }
+        self.len = keep.iter().filter(|kept| **kept).count();
+    }
+}
+
+enum BatchOp<'a, S: GraphSnapshot + 'a> {
+    Scan(ScanOp<'a, S>),
+    FreshExpand(Box<FreshExpandOp<'a, S>>),
+    Expand(Box<ExpandOp<'a, S>>),
+    Filter(Box<FilterOp<'a, S>>),
+    Project(Box<ProjectOp<'a, S>>),
+}
+
+impl<'a, S: GraphSnapshot + 'a> BatchOp<'a, S> {
+    /// The next non-empty batch, or `None` once the subtree is exhausted.
+    fn next_batch(&mut self) -> Option<Result<RowBatch<'a>>> {
+        match self {
+            BatchOp::Scan(op) => op.next_batch().map(Ok),
+            BatchOp::FreshExpand(op) => op.next_batch().map(Ok),
+            BatchOp::Expand(op) => op.next_batch(),
+            BatchOp::Filter(op) => op.next_batch(),
+            BatchOp::Project(op) => op.next_batch(),
+        }
+    }
+}
+
+struct ScanOp<'a, S: GraphSnapshot + 'a> {
+    snapshot: &'a S,
+    nodes: Box<dyn Iterator<Item = InternalNodeId> + 'a>,
+    alias: &'a str,
+    size: BatchSize,
+}
+
+impl<'a, S: GraphSnapshot + 'a> ScanOp<'a, S> {
+    fn next_batch(&mut self) -> Option<RowBatch<'a>> {
+        let target = self.size.take();
+        let mut ids = Vec::with_capacity(target);
+        for iid in self.nodes.by_ref() {
+            if self.snapshot.is_tombstoned_node(iid) {
+                continue;
+            }
+            ids.push(iid);
+            if ids.len() == target {
+                break;
+            }
+        }
+        if ids.is_empty() {
+            return None;
+        }
+        Some(RowBatch {
+            len: ids.len(),
+            columns: vec![(self.alias, Column::Nodes(ids))],
+        })
+    }
+}
+
+/// An input-less hop, as `MatchOutIter` walks it.
+struct FreshExpandOp<'a, S: GraphSnapshot + 'a> {
+    snapshot: &'a S,
+    src_alias: &'a str,
+    edge_alias: Option<&'a str>,
+    dst_alias: &'a str,
+    rels: Option<Vec<RelTypeId>>,
+    dst_labels: LabelConstraint,
+    anchor: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+    sources: Box<dyn Iterator<Item = InternalNodeId> + 'a>,
+    incoming: bool,
+    edges: Option<NodeEdges<'a, S>>,
+    size: BatchSize,
+}
+
+impl<'a, S: GraphSnapshot + 'a> FreshExpandOp<'a, S> {
+    fn next_edge(&mut self) -> Option<EdgeKey> {
+        if let Some(anchor) = &mut self.anchor {
+            return anchor.next();
+        }
+        let snapshot = self.snapshot;
+        loop {
+            if let Some(edges) = &mut self.edges
+                && let Some(edge) = edges.next(snapshot, self.rels.as_deref())
+            {
+                return Some(edge);
+            }
+            let node = self
+                .sources
+                .by_ref()
+                .find(|node| !snapshot.is_tombstoned_node(*node))?;
+            self.edges = Some(NodeEdges::walk(
+                snapshot,
+                node,
+                self.rels.as_deref(),
+                self.incoming,
+            ));
+        }
+    }
+
+    fn next_batch(&mut self) -> Option<RowBatch<'a>> {
+        let target = self.size.take();
+        let mut edges = Vec::with_capacity(target);
+        while edges.len() < target {
+            let Some(edge) = self.next_edge() else {
+                break;
+            };
+            if node_matches_label_constraint(self.snapshot, edge.dst, &self.dst_labels) {
+                edges.push(edge);
+            }
+        }
+        self.emit(edges)
+    }
+
+    fn emit(&self, edges: Vec<EdgeKey>) -> Option<RowBatch<'a>> {
+        if edges.is_empty() {
+            return None;
+        }
+        let srcs = edges.iter().map(|edge| edge.src).collect();
+        let dsts = edges.iter().map(|edge| edge.dst).collect();
+        let len = edges.len();
+        let mut columns = vec![(self.src_alias, Column::Nodes(srcs))];
+        if let Some(edge_alias) = self.edge_alias {
+            columns.push((edge_alias, Column::Edges(edges)));
+        }
+        columns.push((self.dst_alias, Column::Nodes(dsts)));
+        Some(RowBatch { columns, len })
+    }
+}
+
+/// A hop from the source bindings of its input, as `ExpandIter` walks it.
+struct ExpandOp<'a, S: GraphSnapshot + 'a> {
+    snapshot: &'a S,
+    input: BatchOp<'a, S>,
+    src_alias: &'a str,
+    edge_alias: Option<&'a str>,
+    dst_alias: &'a str,
+    rels: Option<Vec<RelTypeId>>,
+    dst_labels: LabelConstraint,
+    /// Input batch being walked, the positions of its source and already
+    /// bound destination columns, and the row whose edges `edges` walks.
+    current: Option<RowBatch<'a>>,
+    src_column: Option<usize>,
+    dst_column: Option<usize>,
+    row: usize,
+    edges: Option<NodeEdges<'a, S>>,
+    /// Error of a row after rows already produced in the same batch.
+    pending: Option<Error>,
+    size: BatchSize,
+}
+
+impl<'a, S: GraphSnapshot + 'a> ExpandOp<'a, S> {
+    fn next_batch(&mut self) -> Option<Result<RowBatch<'a>>> {
+        if let Some(err) = self.pending.take() {
+            return Some(Err(err));
+        }
+        let target = self.size.take();
+        let mut parents = Vec::with_capacity(target);
+        let mut found = Vec::with_capacity(target);
+        loop {
+            if self.current.is_none() {
+                let batch = match self.input.next_batch()? {
+                    Ok(batch) => batch,
+                    Err(err) => return Some(Err(err)),
+                };
+                self.src_column = batch.position(self.src_alias);
+                self.dst_column = batch.position(self.dst_alias);
+                self.current = Some(batch);
+                self.row = 0;
+            }
+            let current = self.current.as_ref().expect("input batch present");
+
+            let Some(edges) = &mut self.edges else {
+                if self.row == current.len {
+                    // Parents index into this batch, so its rows go out
+                    // before the next batch is read.
+                    let done = self.current.take().expect("input batch present");
+                    if parents.is_empty() {
+                        continue;
+                    }
+                    return Some(Ok(self.expanded(&done, &parents, found)));
+                }
+                let src = self.src_column.map(|index| &current.columns[index].1);
+                match hop_source(src, self.src_alias, self.row) {
+                    Ok(Some(node)) => {
+                        self.edges = Some(NodeEdges::new(self.snapshot, node, self.rels.as_deref()))
+                    }
+                    Ok(None) => self.row += 1,
+                    Err(err) => {
+                        self.row += 1;
+                        if parents.is_empty() {
+                            return Some(Err(err));
+                        }
+                        self.pending = Some(err);
+                        return Some(Ok(self.expanded(current, &parents, found)));
+                    }
+                }
+                continue;
+            };
+
+            let Some(edge) = edges.next(self.snapshot, self.rels.as_deref()) else {
+                self.edges = None;
+                self.row += 1;
+                continue;
+            };
+            let dst = self.dst_column.map(|index| &current.columns[index].1);
+            if binds_destination(dst, self.row, edge.dst)
+                && node_matches_label_constraint(self.snapshot, edge.dst, &self.dst_labels)
+            {
+                parents.push(self.row);
+                found.push(edge);
+                if found.len() == target {
+                    return Some(Ok(self.expanded(current, &parents, found)));
+                }
+            }
+        }
+    }
+
+    /// The `parents` rows of `input`, each bound to its edge and destination.
+    fn expanded(
+        &self,
+        input: &RowBatch<'a>,
+        parents: &[usize],
+        edges: Vec<EdgeKey>,
+    ) -> RowBatch<'a> {
+        let mut batch = input.gather(parents);
+        let dsts = edges.iter().map(|edge| edge.dst).collect();
+        if let Some(edge_alias) = self.edge_alias {
+            batch.set(edge_alias, Column::Edges(edges));
+        }
+        batch.set(self.dst_alias, Column::Nodes(dsts));
+        batch
+    }
+}
+
+/// The node a hop walks from in `row`: `None` for null, which matches
+/// nothing, and an error for a missing or non-node binding.
+fn hop_source(column: Option<&Column>, alias: &str, row: usize) -> Result<Option<InternalNodeId>> {
+    match column {
+        Some(Column::Nodes(ids)) => Ok(Some(ids[row])),
+        Some(Column::Values(values)) => match &values[row] {
+            Value::NodeId(id) => Ok(Some(*id)),
+            Value::Null => Ok(None),
+            _ => Err(Error::Other(format!("Variable {alias} is not a node"))),
+        },
+        Some(Column::Edges(_)) => Err(Error::Other(format!("Variable {alias} is not a node"))),
+        None => Err(Error::Other(format!("Variable {alias} not found"))),
+    }
+}
+
+/// Whether a hop may bind its destination to `node` in `row`: always when
+/// the destination is unbound, never when it is null.
+fn binds_destination(column: Option<&Column>, row: usize, node: InternalNodeId) -> bool {
+    match column {
+        None => true,
+        Some(Column::Nodes(ids)) => ids[row] == node,
+        Some(Column::Edges(_)) => false,
+        Some(Column::Values(values)) => match &values[row] {
+            Value::NodeId(id) => *id == node,
+            Value::Node(bound) => bound.id == node,
+            _ => false,
+        },
+    }
+}
+
+struct FilterOp<'a, S: GraphSnapshot + 'a> {
+    snapshot: &'a S,
+    params: &'a Params,
+    input: BatchOp<'a, S>,
+    predicate: &'a Expression,
+    vectorized: bool,
+    /// Batch whose rows from the given one on are still to be filtered,
+    /// after a row failed the runtime checks.
+    held: Option<(RowBatch<'a>, usize)>,
+    pending: Option<Error>,
+}
+
+impl<'a, S: GraphSnapshot + 'a> FilterOp<'a, S> {
+    fn next_batch(&mut self) -> Option<Result<RowBatch<'a>>> {
+        if let Some(err) = self.pending.take() {
+            return Some(Err(err));
+        }
+        loop {
+            let (mut batch, start) = match self.held.take() {
+                Some(held) => held,
+                None => match self.input.next_batch()? {
+                    Ok(batch) => (batch, 0),
+                    Err(err) => return Some(Err(err)),
+                },
+            };
+            if let Err(err) = self.params.check_timeout("Filter.next") {
+                return Some(Err(err));
+            }
+            if self.vectorized {
+                let keep: Vec<bool> =
+                    evaluate_column(self.predicate, &batch, self.snapshot, self.params)
+                        .into_values(batch.len)
+                        .iter()
+                        .map(|value| matches!(value, Value::Bool(true)))
+                        .collect();
+                batch.retain(&keep);
+            } else {
+                let mut passed = Vec::new();
+                let mut failed = None;
+                for row in start..batch.len {
+                    let values = batch.row(row);
+                    if let Err(err) = ensure_runtime_expression_compatible(
+                        self.predicate,
+                        &values,
+                        self.snapshot,
+                        self.params,
+                    ) {
+                        failed = Some((row, err));
+                        break;
+                    }
+                    if evaluate_expression_bool(self.predicate, &values, self.snapshot, self.params)
+                    {
+                        passed.push(row);
+                    }
+                }
+                let rows = batch.gather(&passed);
+                if let Some((row, err)) = failed {
+                    self.held = Some((batch, row + 1));
+                    if rows.len == 0 {
+                        return Some(Err(err));
+                    }
+                    self.pending = Some(err);
+                }
+                batch = rows;
+            }
+            if batch.len > 0 {
+                return Some(Ok(batch));
+            }
+        }
+    }
+}
+
+struct ProjectOp<'a, S: GraphSnapshot + 'a> {
+    snapshot: &'a S,
+    params: &'a Params,
+    input: BatchOp<'a, S>,
+    projections: &'a [(String, Expression)],
+    /// Per projection, whether it is evaluated a column at a time.
+    vectorized: Vec<bool>,
+    /// As in `FilterOp`.
+    held: Option<(RowBatch<'a>, usize)>,
+    pending: Option<Error>,
+}
+
+impl<'a, S: GraphSnapshot + 'a> ProjectOp<'a, S> {
+    fn next_batch(&mut self) -> Option<Result<RowBatch<'a>>> {
+        if let Some(err) = self.pending.take() {
+            return Some(Err(err));
+        }
+        loop {
+            let (batch, start) = match self.held.take() {
+                Some(held) => held,
+                None => match self.input.next_batch()? {
+                    Ok(batch) => (batch, 0),
+                    Err(err) => return Some(Err(err)),
+                },
+            };
+            if let Err(err) = self.params.check_timeout("Project.next") {
+                return Some(Err(err));
+            }
+
+            // Projections evaluated row by row need their rows, and the
+            // first row failing their checks ends this batch.
+            let mut rows = Vec::new();
+            let mut failed = None;
+            if self.vectorized.contains(&false) {
+                'rows: for row in start..batch.len {
+                    let values = batch.row(row);
+                    for ((_, expr), vectorized) in self.projections.iter().zip(&self.vectorized) {
+                        if *vectorized {
+                            continue;
+                        }
+                        if let Err(err) = ensure_runtime_expression_compatible(
+                            expr,
+                            &values,
+                            self.snapshot,
+                            self.params,
+                        ) {
+                            failed = Some((row, err));
+                            break 'rows;
+                        }
+                    }
+                    rows.push(values);
+                }
+            }
+            let end = failed.as_ref().map_or(batch.len, |(row, _)| *row);
+            let part = (start > 0 || end < batch.len)
+                .then(|| batch.gather(&(start..end).collect::<Vec<_>>()));
+            let input = part.as_ref().unwrap_or(&batch);
+
+            let mut out = RowBatch {
+                columns: Vec::with_capacity(self.projections.len()),
+                len: input.len,
+            };
+            for ((alias, expr), vectorized) in self.projections.iter().zip(&self.vectorized) {
+                let column = if *vectorized {
+                    evaluate_column(expr, input, self.snapshot, self.params).into_column(input.len)
+                } else {
+                    Column::Values(
+                        rows.iter()
+                            .map(|row| {
+                                evaluate_expression_value(expr, row, self.snapshot, self.params)
+                            })
+                            .collect(),
+                    )
+                };
+                out.set(alias, column);
+            }
+
+            if let Some((row, err)) = failed {
+                self.held = Some((batch, row + 1));
+                if out.len == 0 {
+                    return Some(Err(err));
+                }
+                self.pending = Some(err);
+            }
+            if out.len > 0 {
+                return Some(Ok(out));
+            }
+        }
+    }
+}
+
+/// Literals, parameters, variables, property reads, and unary and binary
+/// operators over them. `ensure_runtime_expression_compatible` accepts these
+/// on every row, so columns of them need no checks.
+fn vectorizable(expr: &Expression) -> bool {
+    match expr {
+        Expression::Literal(_)
+        | Expression::Parameter(_)
+        | Expression::Variable(_)
+        | Expression::PropertyAccess(_) => true,
+        Expression::Unary(unary) => vectorizable(&unary.operand),
+        Expression::Binary(binary) => vectorizable(&binary.left) && vectorizable(&binary.right),
+        _ => false,
+    }
+}
+
+/// A vectorizable expression evaluated over a batch: one value for every
+/// row, or a column.
+enum Evaluated {
+    Constant(Value),
+    Column(Column),
+}
+
+impl Evaluated {
+    fn into_column(self, len: usize) -> Column {
+        match self {
+            Evaluated::Constant(value) => Column::Values(vec![value; len]),
+            Evaluated::Column(column) => column,
+        }
+    }
+
+    fn into_values(self, len: usize) -> Vec<Value> {
+        self.into_column(len).into_values()
+    }
+}
+
+/// Evaluates a vectorizable expression over `batch` with the same results
+/// `evaluate_expression_value` gives row by row.
+fn evaluate_column<S: GraphSnapshot>(
+    expr: &Expression,
+    batch: &RowBatch<'_>,
+    snapshot: &S,
+    params: &Params,
+) -> Evaluated {
+    let constant = || {
+        Evaluated::Constant(evaluate_expression_value(
+            expr,
+            &Row::default(),
+            snapshot,
+            params,
+        ))
+    };
+    match expr {
+        Expression::Variable(name) => match batch.column(name) {
+            Some(column) => Evaluated::Column(column.clone()),
+            None => constant(),
+        },
+        Expression::PropertyAccess(access) => {
+            let key = access.property.as_str();
+            let values = match batch.column(&access.variable) {
+                Some(Column::Nodes(ids)) => ids
+                    .iter()
+                    .map(|id| {
+                        snapshot
+                            .node_property(*id, key)
+                            .as_ref()
+                            .map(convert_api_property_to_value)
+                            .unwrap_or(Value::Null)
+                    })
+                    .collect(),
+                Some(Column::Edges(edges)) => edges
+                    .iter()
+                    .map(|edge| {
+                        snapshot
+                            .edge_property(*edge, key)
+                            .as_ref()
+                            .map(convert_api_property_to_value)
+                            .unwrap_or(Value::Null)
+                    })
+                    .collect(),
+                Some(Column::Values(values)) => values
+                    .iter()
+                    .map(|value| {
+                        let row = Row::new(vec![(access.variable.clone(), value.clone())]);
+                        evaluate_expression_value(expr, &row, snapshot, params)
+                    })
+                    .collect(),
+                None => return constant(),
+            };
+            Evaluated::Column(Column::Values(values))
+        }
+        Expression::Unary(unary) => {
+            match evaluate_column(&unary.operand, batch, snapshot, params) {
+                Evaluated::Constant(value) => {
+                    Evaluated::Constant(evaluate_unary(&unary.operator, value))
+                }
+                Evaluated::Column(column) => Evaluated::Column(Column::Values(
+                    column
+                        .into_values()
+                        .into_iter()
+                        .map(|value| evaluate_unary(&unary.operator, value))
+                        .collect(),
+                )),
+            }
+        }
+        Expression::Binary(binary) => {
+            let left = evaluate_column(&binary.left, batch, snapshot, params);
+            let right = evaluate_column(&binary.right, batch, snapshot, params);
+            match (left, right) {
+                (Evaluated::Constant(left), Evaluated::Constant(right)) => {
+                    Evaluated::Constant(evaluate_binary(&binary.operator, left, right, snapshot))
+                }
+                (left, right) => Evaluated::Column(Column::Values(
+                    left.into_values(batch.len)
+                        .into_iter()
+                        .zip(right.into_values(batch.len))
+                        .map(|(left, right)| {
+                            evaluate_binary(&binary.operator, left, right, snapshot)
+                        })
+                        .collect(),
+                )),
+            }
+        }
+        _ => constant(),
+    }
+}
+
+/// Rows of a batched subtree, in the order its batches produce them.
+pub struct BatchRows<'a, S: GraphSnapshot + 'a> {
+    op: BatchOp<'a, S>,
+    batch: Option<RowBatch<'a>>,
+    next: usize,
+}
+
+impl<'a, S: GraphSnapshot + 'a> Iterator for BatchRows<'a, S> {
+    type Item = Result<Row>;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        loop {
+            if let Some(batch) = &mut self.batch
+                && self.next < batch.len
+            {
+                let row = self.next;
+                self.next += 1;
+                return Some(Ok(Row::new(
+                    batch
+                        .columns
+                        .iter_mut()
+                        .map(|(alias, column)| (alias.to_string(), column.take(row)))
+                        .collect(),
+                )));
+            }
+            match self.op.next_batch()? {
+                Ok(batch) => {
+                    self.batch = Some(batch);
+                    self.next = 0;
+                }
+                Err(err) => {
+                    self.batch = None;
+                    return Some(Err(err));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,284 @@
+//! Row estimates for plan operators.
+//!
+//! Node and edge totals come from the snapshot's maintained counters, so an
+//! estimate costs a few point reads. An expansion from an anchored label uses
+//! that label's average degree once ANALYZE has stored degree histograms;
+//! otherwise degrees are averages over all live nodes.
+//! An equality keeps `1 / distinct values` of a label when the snapshot has
+//! statistics for the property, and a fixed fraction otherwise; other
+//! predicates always keep a fixed fraction.
+//!
+//! Execution asks the estimator which end of an anchored hop to start from,
+//! by the edges each would read, and which hop order of a multi-hop chain to
+//! run, by the rows each plan yields in total. An equality probe always runs
+//! when it resolves: `1 / distinct values` assumes the value is present, so
+//! it cannot tell a frequent value from an absent one. `EXPLAIN` shows its
+//! estimate for every operator.
+
+use super::{
+    Expression, GraphSnapshot, LabelId, NodeAnchor, Plan, Row, Value, evaluate_expression_value,
+};
+use crate::query::ast::BinaryOperator;
+use crate::query::query_api::Params;
+
+/// Fraction an equality keeps when the property has no statistics.
+const EQUALITY_SELECTIVITY: f64 = 0.1;
+/// Fraction a range, full-text, or other predicate keeps.
+const PREDICATE_SELECTIVITY: f64 = 1.0 / 3.0;
+
+pub(crate) struct Estimator<'a, S: GraphSnapshot> {
+    snapshot: &'a S,
+    params: &'a Params,
+}
+
+impl<'a, S: GraphSnapshot> Estimator<'a, S> {
+    pub(crate) fn new(snapshot: &'a S, params: &'a Params) -> Self {
+        Self { snapshot, params }
+    }
+
+    /// Estimated rows `plan` yields.
+    pub(crate) fn rows(&self, plan: &Plan) -> f64 {
+        match plan {
+            Plan::ReturnOne => 1.0,
+            Plan::Values { rows } => rows.len() as f64,
+            Plan::NodeScan {
+                labels,
+                property_eq,
+                composite_eq,
+                text_search,
+                property_range,
+                ..
+            } => {
+                let Some(first) = labels.first() else {
+                    return self.all_nodes();
+                };
+                let mut rows = self.labels_rows(labels);
+                let keys: Vec<&str> = if composite_eq.is_empty() {
+                    property_eq.iter().map(|(key, _)| key.as_str()).collect()
+                } else {
+                    composite_eq.iter().map(|(key, _)| key.as_str()).collect()
+                };
+                if keys.is_empty() {
+                    if text_search.is_some() || property_range.is_some() {
+                        rows *= PREDICATE_SELECTIVITY;
+                    }
+                } else if let Some(label) = self.snapshot.resolve_label_id(first) {
+                    rows *= self.equalities_selectivity(label, &keys);
+                }
+                rows
+            }
+            Plan::MatchOut {
+                input,
+                rels,
+                edge_eq,
+                src_anchor,
+                dst_anchor,
+                dst_labels,
+                limit,
+                ..
+            } => {
+                let rows = match (input, src_anchor, dst_anchor) {
+                    (Some(input), _, _) => {
+                        self.rows(input) * self.degree(rels) * self.fraction(dst_labels)
+                    }
+                    (None, _, _) if edge_eq.is_some() => {
+                        self.rel_edges(rels) * EQUALITY_SELECTIVITY
+                    }
+                    (None, Some(src), Some(dst)) => self
+                        .anchored_edges(src, rels, false)
+                        .min(self.anchored_edges(dst, rels, true)),
+                    (None, Some(src), None) => {
+                        self.anchor_rows(src)
+                            * self.anchored_degree(src, rels, false)
+                            * self.fraction(dst_labels)
+                    }
+                    // Destination labels and filters are the anchor's.
+                    (None, None, Some(dst)) => {
+                        self.anchor_rows(dst) * self.anchored_degree(dst, rels, true)
+                    }
+                    (None, None, None) => self.rel_edges(rels) * self.fraction(dst_labels),
+                };
+                limit.map_or(rows, |limit| rows.min(f64::from(limit)))
+            }
+            Plan::MatchBoundRel { input, .. }
+            | Plan::Project { input, .. }
+            | Plan::Delete { input, .. }
+            | Plan::SetProperty { input, .. }
+            | Plan::Create { input, .. } => self.rows(input),
+            Plan::Filter { input, predicate } => self.rows(input) * selectivity(predicate),
+            Plan::Limit { input, limit } => {
+                let rows = self.rows(input);
+                match evaluate_expression_value(limit, &Row::default(), self.snapshot, self.params)
+                {
+                    Value::Int(limit) if limit >= 0 => rows.min(limit as f64),
+                    _ => rows,
+                }
+            }
+            Plan::CartesianProduct { left, right } => self.rows(left) * self.rows(right),
+        }
+    }
+
+    /// Estimated rows every operator of `plan` yields, summed: the work of
+    /// running it, for comparing plans that differ only in hop order.
+    pub(crate) fn cost(&self, plan: &Plan) -> f64 {
+        let inputs = match plan {
+            Plan::ReturnOne | Plan::Values { .. } | Plan::NodeScan { .. } => 0.0,
+            Plan::MatchOut { input, .. } => input.as_deref().map_or(0.0, |input| self.cost(input)),
+            Plan::MatchBoundRel { input, .. }
+            | Plan::Project { input, .. }
+            | Plan::Delete { input, .. }
+            | Plan::SetProperty { input, .. }
+            | Plan::Create { input, .. }
+            | Plan::Filter { input, .. }
+            | Plan::Limit { input, .. } => self.cost(input),
+            Plan::CartesianProduct { left, right } => self.cost(left) + self.cost(right),
+        };
+        self.rows(plan) + inputs
+    }
+
+    /// Estimated nodes `anchor` starts from.
+    pub(crate) fn anchor_rows(&self, anchor: &NodeAnchor) -> f64 {
+        let Some(label) = self.snapshot.resolve_label_id(&anchor.label) else {
+            return 0.0;
+        };
+        let rows = self.snapshot.node_count(Some(label)) as f64;
+        match &anchor.property_eq {
+            Some((key, _)) => rows * self.equalities_selectivity(label, &[key.as_str()]),
+            None => rows,
+        }
+    }
+
+    /// Estimated edges of `rels` read walking out of `anchor`'s nodes, or
+    /// into them when `incoming`.
+    pub(crate) fn anchored_edges(
+        &self,
+        anchor: &NodeAnchor,
+        rels: &[String],
+        incoming: bool,
+    ) -> f64 {
+        self.anchor_rows(anchor) * self.anchored_degree(anchor, rels, incoming)
+    }
+
+    fn equalities_selectivity(&self, label: LabelId, keys: &[&str]) -> f64 {
+        keys.iter()
+            .map(
+                |key| match self.snapshot.property_distinct_count(label, key) {
+                    Some(distinct) if distinct > 0 => 1.0 / distinct as f64,
+                    _ => EQUALITY_SELECTIVITY,
+                },
+            )
+            .product()
+    }
+
+    fn all_nodes(&self) -> f64 {
+        self.snapshot.node_count(None) as f64
+    }
+
+    /// Nodes carrying every label, bounded by the smallest label.
+    fn labels_rows(&self, labels: &[String]) -> f64 {
+        labels
+            .iter()
+            .map(|label| {
+                self.snapshot
+                    .resolve_label_id(label)
+                    .map_or(0.0, |id| self.snapshot.node_count(Some(id)) as f64)
+            })
+            .fold(self.all_nodes(), f64::min)
+    }
+
+    /// Share of all nodes that carry every label.
+    fn fraction(&self, labels: &[String]) -> f64 {
+        if labels.is_empty() {
+            return 1.0;
+        }
+        let all = self.all_nodes();
+        if all == 0.0 {
+            return 0.0;
+        }
+        self.labels_rows(labels) / all
+    }
+
+    /// Edges of any type in `rels`, or of every type when empty.
+    fn rel_edges(&self, rels: &[String]) -> f64 {
+        if rels.is_empty() {
+            return self.snapshot.edge_count(None) as f64;
+        }
+        rels.iter()
+            .filter_map(|rel| self.snapshot.resolve_rel_type_id(rel))
+            .map(|rel| self.snapshot.edge_count(Some(rel)) as f64)
+            .sum()
+    }
+
+    /// Average edges of `rels` per node of the anchor's label, outgoing or
+    /// `incoming`, from ANALYZE's degree histograms; the all-node average
+    /// without them or for an untyped hop.
+    fn anchored_degree(&self, anchor: &NodeAnchor, rels: &[String], incoming: bool) -> f64 {
+        let Some(label) = self.snapshot.resolve_label_id(&anchor.label) else {
+            return 0.0;
+        };
+        if rels.is_empty() {
+            return self.degree(rels);
+        }
+        rels.iter()
+            .filter_map(|rel| self.snapshot.resolve_rel_type_id(rel))
+            .map(|rel| self.snapshot.average_degree(label, rel, incoming))
+            .sum::<Option<f64>>()
+            .unwrap_or_else(|| self.degree(rels))
+    }
+
+    /// Average edges of `rels` per live node, either direction.
+    fn degree(&self, rels: &[String]) -> f64 {
+        let all = self.all_nodes();
+        if all == 0.0 {
+            return 0.0;
+        }
+        self.rel_edges(rels) / all
+    }
+}
+
+/// Fraction of rows `predicate` keeps.
+fn selectivity(predicate: &Expression) -> f64 {
+    let Expression::Binary(binary) = predicate else {
+        return PREDICATE_SELECTIVITY;
+    };
+    match binary.operator {
+        BinaryOperator::And => selectivity(&binary.left) * selectivity(&binary.right),
+        BinaryOperator::Or => (selectivity(&binary.left) + selectivity(&binary.right)).min(1.0),
+        BinaryOperator::Equals => EQUALITY_SELECTIVITY,
+        _ => PREDICATE_SELECTIVITY,
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{EQUALITY_SELECTIVITY, PREDICATE_SELECTIVITY, selectivity};
+    use crate::query::ast::{BinaryExpression, BinaryOperator, Expression, Literal};
+
+    fn binary(operator: BinaryOperator, left: Expression, right: Expression) -> Expression {
+        Expression::Binary(Box::new(BinaryExpression {
+            operator,
+            left,
+            right,
+        }))
+    }
+
+    #[test]
+    fn conjunctions_multiply_and_disjunctions_add() {
+        let eq = binary(
+            BinaryOperator::Equals,
+            Expression::Variable("n".to_string()),
+            Expression::Literal(Literal::Integer(1)),
+        );
+        let other = Expression::Variable("flag".to_string());
+        let both = binary(BinaryOperator::And, eq.clone(), other.clone());
+        let either = binary(BinaryOperator::Or, eq, other);
+        assert_eq!(
+            selectivity(&both),
+            EQUALITY_SELECTIVITY * PREDICATE_SELECTIVITY
+        );
+        assert_eq!(
+            selectivity(&either),
+            EQUALITY_SELECTIVITY + PREDICATE_SELECTIVITY
+        );
+    }
+}
@@ -1,8 +1,10 @@
+use super::cost::Estimator;
 use super::label_constraint::{node_matches_label_constraint, resolve_label_constraint};
+use super::plan_head::resolve_index_equality;
 use super::read_path::{ExpandIter, MatchOutIter};
 use super::{
-    GraphSnapshot, InternalNodeId, LabelConstraint, LimitIter, Plan, PlanIterator, RelTypeId,
-    Result, Row, Value, execute_plan,
+    EdgeKey, Expression, GraphSnapshot, InternalNodeId, LabelConstraint, LimitIter, NodeAnchor,
+    Plan, PlanIterator, RelTypeId, Result, Row, Value, execute_plan,
 };
 
 fn value_node_id(value: &Value) -> Option<InternalNodeId> {
@@ -63,7 +65,10 @@ impl<'a, S: GraphSnapshot + 'a> Iterator for FilteredMatchOutIter<'a, S> {
     }
 }
 
-fn resolve_rel_ids<S: GraphSnapshot>(snapshot: &S, rels: &[String]) -> Option<Vec<RelTypeId>> {
+pub(super) fn resolve_rel_ids<S: GraphSnapshot>(
+    snapshot: &S,
+    rels: &[String],
+) -> Option<Vec<RelTypeId>> {
     if rels.is_empty() {
         return None;
     }
@@ -76,6 +81,81 @@ fn resolve_rel_ids<S: GraphSnapshot>(snapshot: &S, rels: &[String]) -> Option<Ve
     Some(ids)
 }
 
+/// Nodes of `anchor`: an index probe when the equality resolves to an
+/// index value, else the label index. An unknown label matches nothing.
+fn anchor_nodes<'a, S: GraphSnapshot + 'a>(
+    snapshot: &'a S,
+    anchor: &NodeAnchor,
+    params: &crate::query::query_api::Params,
+) -> Box<dyn Iterator<Item = InternalNodeId> + 'a> {
+    let Some(label) = snapshot.resolve_label_id(&anchor.label) else {
+        return Box::new(std::iter::empty());
+    };
+    let equality = anchor
+        .property_eq
+        .as_ref()
+        .and_then(|(key, expr)| Some((key, resolve_index_equality(snapshot, expr, params)?)));
+    match equality {
+        Some((key, value)) => snapshot.nodes_with_label_and_property(label, key, &value),
+        None => snapshot.nodes_with_label(label),
+    }
+}
+
+/// Where a fresh hop's walk starts.
+pub(super) struct HopStart<'a> {
+    /// Edges from an edge-index probe; replaces the per-node walk when set.
+    pub(super) anchor: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+    /// Nodes whose lists are walked; every node when `None`.
+    pub(super) sources: Option<Box<dyn Iterator<Item = InternalNodeId> + 'a>>,
+    /// `sources` are destinations whose incoming lists are walked.
+    pub(super) incoming: bool,
+}
+
+/// Anchor edges or start nodes of an input-less hop, from `edge_eq` or the
+/// endpoint anchors.
+pub(super) fn fresh_hop_start<'a, S: GraphSnapshot + 'a>(
+    snapshot: &'a S,
+    rels: &[String],
+    rel_ids: Option<&[RelTypeId]>,
+    edge_eq: &Option<(String, Expression)>,
+    src_anchor: &Option<NodeAnchor>,
+    dst_anchor: &Option<NodeAnchor>,
+    params: &'a crate::query::query_api::Params,
+) -> HopStart<'a> {
+    let anchor = edge_eq.as_ref().and_then(|(key, expr)| {
+        let [rel] = rel_ids? else {
+            return None;
+        };
+        let value = resolve_index_equality(snapshot, expr, params)?;
+        Some(snapshot.edges_with_rel_and_property(*rel, key, &value))
+    });
+    // The walk starts from the destination when only it is anchored, or
+    // when it is estimated to read fewer edges.
+    let start = match (src_anchor, dst_anchor) {
+        _ if anchor.is_some() => None,
+        (Some(src), Some(dst)) => {
+            let estimator = Estimator::new(snapshot, params);
+            if estimator.anchored_edges(dst, rels, true)
+                < estimator.anchored_edges(src, rels, false)
+            {
+                Some((dst, true))
+            } else {
+                Some((src, false))
+            }
+        }
+        (Some(src), None) => Some((src, false)),
+        (None, Some(dst)) => Some((dst, true)),
+        (None, None) => None,
+    };
+    let incoming = start.is_some_and(|(_, incoming)| incoming);
+    let sources = start.map(|(start, _)| anchor_nodes(snapshot, start, params));
+    HopStart {
+        anchor,
+        sources,
+        incoming,
+    }
+}
+
 #[allow(clippy::too_many_arguments)]
 pub(super) fn execute_match_out<'a, S: GraphSnapshot + 'a>(
     snapshot: &'a S,
@@ -83,6 +163,9 @@ pub(super) fn execute_match_out<'a, S: GraphSnapshot + 'a>(
     src_alias: &'a str,
     rels: &[String],
     edge_alias: &'a Option<std::sync::Arc<str>>,
+    edge_eq: &Option<(String, Expression)>,
+    src_anchor: &Option<NodeAnchor>,
+    dst_anchor: &Option<NodeAnchor>,
     dst_alias: &'a str,
     dst_labels: &[String],
     src_prebound: bool,
@@ -119,6 +202,15 @@ pub(super) fn execute_match_out<'a, S: GraphSnapshot + 'a>(
             PlanIterator::Expand(Box::new(expand))
         }
     } else {
+        let start = fresh_hop_start(
+            snapshot,
+            rels,
+            rel_ids.as_deref(),
+            edge_eq,
+            src_anchor,
+            dst_anchor,
+            params,
+        );
         let base = MatchOutIter::new(
             snapshot,
             src_alias,
@@ -126,6 +218,9 @@ pub(super) fn execute_match_out<'a, S: GraphSnapshot + 'a>(
             edge_alias.as_deref(),
             dst_alias,
             path_alias.as_deref(),
+            start.anchor,
+            start.sources,
+            start.incoming,
         );
         let filtered = PlanIterator::MatchOutFiltered(Box::new(FilteredMatchOutIter::new(
             snapshot,
@@ -1,5 +1,5 @@
 use super::{
-    GraphSnapshot, Plan, PlanIterator, Row, match_bound_rel_plan, match_out_plan, plan_head,
+    GraphSnapshot, Plan, PlanIterator, Row, batch, match_bound_rel_plan, match_out_plan, plan_head,
     plan_mid, plan_tail,
 };
 
@@ -8,6 +8,9 @@ pub(super) fn execute_plan<'a, S: GraphSnapshot + 'a>(
     plan: &'a Plan,
     params: &'a crate::query::query_api::Params,
 ) -> PlanIterator<'a, S> {
+    if let Some(batched) = batch::execute_batched(snapshot, plan, params) {
+        return batched;
+    }
     match plan {
         Plan::ReturnOne => PlanIterator::ReturnOne(std::iter::once(Ok(Row::default()))),
         Plan::CartesianProduct { left, right } => {
@@ -15,15 +18,30 @@ pub(super) fn execute_plan<'a, S: GraphSnapshot + 'a>(
         }
         Plan::NodeScan {
             alias,
-            label,
+            labels,
             property_eq,
-            optional,
-        } => plan_head::execute_node_scan(snapshot, alias, label, property_eq, *optional),
+            composite_eq,
+            text_search,
+            property_range,
+            optional: _,
+        } => plan_head::execute_node_scan(
+            snapshot,
+            alias,
+            labels,
+            property_eq,
+            composite_eq,
+            text_search,
+            property_range,
+            params,
+        ),
         Plan::MatchOut {
             input,
             src_alias,
             rels,
             edge_alias,
+            edge_eq,
+            src_anchor,
+            dst_anchor,
             dst_alias,
             dst_labels,
             src_prebound,
@@ -39,6 +57,9 @@ pub(super) fn execute_plan<'a, S: GraphSnapshot + 'a>(
             src_alias,
             rels,
             edge_alias,
+            edge_eq,
+            src_anchor,
+            dst_anchor,
             dst_alias,
             dst_labels,
             *src_prebound,
@@ -1,10 +1,16 @@
-use super::{CartesianProductIter, GraphSnapshot, NodeScanIter, Plan, PlanIterator, execute_plan};
+use super::{
+    CartesianProductIter, Expression, GraphSnapshot, NodeScanIter, Plan, PlanIterator,
+    PropertyRange, PropertyValue, Row, TextSearch, Value, evaluate_expression_value, execute_plan,
+};
+use crate::query::evaluator::compares_as_temporal;
+use crate::query::query_api::Params;
+use std::ops::Bound;
 
 pub(super) fn execute_cartesian_product<'a, S: GraphSnapshot + 'a>(
     snapshot: &'a S,
     left: &'a Plan,
     right: &'a Plan,
-    params: &'a crate::query::query_api::Params,
+    params: &'a Params,
 ) -> PlanIterator<'a, S> {
     let left_iter = execute_plan(snapshot, left, params);
     PlanIterator::CartesianProduct(Box::new(CartesianProductIter {
@@ -20,34 +26,154 @@ pub(super) fn execute_cartesian_product<'a, S: GraphSnapshot + 'a>(
 pub(super) fn execute_node_scan<'a, S: GraphSnapshot + 'a>(
     snapshot: &'a S,
     alias: &'a str,
-    label: &'a Option<String>,
-    property_eq: &'a Option<(String, crate::api::PropertyValue)>,
-    _optional: bool,
+    labels: &'a [String],
+    property_eq: &'a Option<(String, PropertyValue)>,
+    composite_eq: &'a [(String, Expression)],
+    text_search: &'a Option<TextSearch>,
+    property_range: &'a Option<PropertyRange>,
+    params: &'a Params,
 ) -> PlanIterator<'a, S> {
-    let label_id = if let Some(l) = label {
-        match snapshot.resolve_label_id(l) {
-            Some(id) => Some(id),
-            None => {
-                return PlanIterator::Values(Box::new(super::ValuesIter {
-                    rows: Vec::new().into_iter(),
-                }));
-            }
-        }
-    } else {
-        None
+    let Some(node_iter) = node_scan_nodes(
+        snapshot,
+        labels,
+        property_eq,
+        composite_eq,
+        text_search,
+        property_range,
+        params,
+    ) else {
+        return PlanIterator::Values(Box::new(super::ValuesIter {
+            rows: Vec::new().into_iter(),
+        }));
     };
-
-    let iter = NodeScanIter {
+    PlanIterator::NodeScan(NodeScanIter {
         snapshot,
-        node_iter: match (label_id, property_eq) {
-            (Some(lid), Some((key, value))) => {
-                snapshot.nodes_with_label_and_property(lid, key, value)
-            }
-            (Some(lid), None) => snapshot.nodes_with_label(lid),
-            (None, _) => snapshot.nodes(),
-        },
+        node_iter,
         alias,
-    };
+    })
+}
+
+/// Candidate nodes of a `NodeScan`, from an index when one answers its
+/// anchors and the label index otherwise, or `None` when a label does not
+/// exist.
+pub(super) fn node_scan_nodes<'a, S: GraphSnapshot + 'a>(
+    snapshot: &'a S,
+    labels: &'a [String],
+    property_eq: &'a Option<(String, PropertyValue)>,
+    composite_eq: &'a [(String, Expression)],
+    text_search: &'a Option<TextSearch>,
+    property_range: &'a Option<PropertyRange>,
+    params: &'a Params,
+) -> Option<Box<dyn Iterator<Item = crate::api::InternalNodeId> + 'a>> {
+    let mut label_ids = Vec::with_capacity(labels.len());
+    for label in labels {
+        label_ids.push(snapshot.resolve_label_id(label)?);
+    }
 
-    PlanIterator::NodeScan(iter)
+    let equalities = resolve_equalities(snapshot, composite_eq, params);
+    let anchored = label_ids.split_first().and_then(|(first, rest)| {
+        let text_query = text_search.as_ref().and_then(|search| {
+            match evaluate_expression_value(&search.query, &Row::default(), snapshot, params) {
+                Value::String(query) => Some((search, query)),
+                _ => None,
+            }
+        });
+        let iter = match (property_eq, text_query, property_range) {
+            _ if !equalities.is_empty() => {
+                let props: Vec<(&str, &PropertyValue)> = equalities
+                    .iter()
+                    .map(|(key, value)| (key.as_str(), value))
+                    .collect();
+                snapshot.nodes_with_label_and_properties(*first, &props)
+            }
+            (Some((key, value)), _, _) => {
+                snapshot.nodes_with_label_and_property(*first, key, value)
+            }
+            (None, Some((search, query)), _) => {
+                if search.phrase {
+                    snapshot.nodes_with_label_and_phrase(*first, &search.key, &query)
+                } else {
+                    snapshot.nodes_with_label_and_terms(*first, &search.key, &query)
+                }
+            }
+            (None, None, Some(range)) => {
+                let (lower, upper) = resolve_range_bounds(snapshot, range, params)?;
+                snapshot.nodes_with_label_and_property_range(
+                    *first,
+                    &range.key,
+                    lower.as_ref(),
+                    upper.as_ref(),
+                )
+            }
+            (None, None, None) => return None,
+        };
+        if rest.is_empty() {
+            return Some(iter);
+        }
+        let rest = rest.to_vec();
+        Some(Box::new(iter.filter(move |iid| {
+            snapshot
+                .resolve_node_labels(*iid)
+                .is_some_and(|found| rest.iter().all(|label| found.contains(label)))
+        }))
+            as Box<dyn Iterator<Item = crate::api::InternalNodeId> + 'a>)
+    });
+    Some(anchored.unwrap_or_else(|| snapshot.nodes_with_labels(&label_ids)))
+}
+
+/// Equalities of `composite_eq` that an exact index probe can answer.
+fn resolve_equalities<S: GraphSnapshot>(
+    snapshot: &S,
+    composite_eq: &[(String, Expression)],
+    params: &Params,
+) -> Vec<(String, PropertyValue)> {
+    composite_eq
+        .iter()
+        .filter_map(|(key, expr)| {
+            Some((key.clone(), resolve_index_equality(snapshot, expr, params)?))
+        })
+        .collect()
+}
+
+/// Value of an equality operand when an exact index probe can answer it.
+/// Others are left to the `WHERE` filter: floats, which also equal integers,
+/// and the same values `resolve_range_bounds` rejects.
+pub(super) fn resolve_index_equality<S: GraphSnapshot>(
+    snapshot: &S,
+    expr: &Expression,
+    params: &Params,
+) -> Option<PropertyValue> {
+    match evaluate_expression_value(expr, &Row::default(), snapshot, params) {
+        Value::Int(value) => Some(PropertyValue::Int(value)),
+        Value::Bool(value) => Some(PropertyValue::Bool(value)),
+        Value::String(value) if !compares_as_temporal(&value) => Some(PropertyValue::String(value)),
+        _ => None,
+    }
+}
+
+/// Index bounds of `range`, or `None` when a bound cannot be answered from
+/// the ordered index: nulls, NaN, non-scalar values, and strings that compare
+/// temporally. The scan then falls back to the label index.
+fn resolve_range_bounds<S: GraphSnapshot>(
+    snapshot: &S,
+    range: &PropertyRange,
+    params: &Params,
+) -> Option<(Bound<PropertyValue>, Bound<PropertyValue>)> {
+    let resolve = |bound: &Option<(Expression, bool)>| {
+        let Some((expr, inclusive)) = bound else {
+            return Some(Bound::Unbounded);
+        };
+        let value = match evaluate_expression_value(expr, &Row::default(), snapshot, params) {
+            Value::Int(value) => PropertyValue::Int(value),
+            Value::Float(value) if !value.is_nan() => PropertyValue::Float(value),
+            Value::String(value) if !compares_as_temporal(&value) => PropertyValue::String(value),
+            _ => return None,
+        };
+        Some(if *inclusive {
+            Bound::Included(value)
+        } else {
+            Bound::Excluded(value)
+        })
+    };
+    Some((resolve(&range.lower)?, resolve(&range.upper)?))
 }
@@ -1,7 +1,7 @@
 use super::{
-    CartesianProductIter, ExpandIter, Expression, FilterIter, FilteredMatchOutIter, GraphSnapshot,
-    LimitIter, MatchBoundRelIter, NodeScanIter, Pattern, ProjectIter, RelationshipDirection,
-    Result, Row, ValuesIter,
+    BatchRows, CartesianProductIter, ExpandIter, Expression, FilterIter, FilteredMatchOutIter,
+    GraphSnapshot, LimitIter, MatchBoundRelIter, NodeScanIter, Pattern, ProjectIter,
+    RelationshipDirection, Result, Row, ValuesIter,
 };
 use crate::api::PropertyValue;
 use std::sync::Arc;
@@ -10,11 +10,19 @@ use std::sync::Arc;
 pub enum Plan {
     /// `RETURN 1`
     ReturnOne,
-    /// `MATCH (n) RETURN ...`
+    /// `MATCH (n) RETURN ...`; `labels` are intersected, empty scans all nodes.
     NodeScan {
         alias: Arc<str>,
-        label: Option<String>,
+        labels: Vec<String>,
         property_eq: Option<(String, PropertyValue)>,
+        /// Every equality on a literal or parameter when there are two or
+        /// more, answered together by `nodes_with_label_and_properties` so a
+        /// composite index can serve them. Takes precedence over `property_eq`.
+        composite_eq: Vec<(String, Expression)>,
+        /// Used only when `property_eq` is `None` and `composite_eq` is empty.
+        text_search: Option<TextSearch>,
+        /// Used only when no anchor above applies.
+        property_range: Option<PropertyRange>,
         optional: bool,
     },
     /// `MATCH (a)-[:rel]->(b) RETURN ...`
@@ -23,6 +31,18 @@ pub enum Plan {
         src_alias: Arc<str>,
         rels: Vec<String>,
         edge_alias: Option<Arc<str>>,
+        /// Equality on an edge property, a literal or parameter. Without
+        /// `input` and with a single relationship type, edges come from
+        /// `edges_with_rel_and_property` instead of every node's list.
+        edge_eq: Option<(String, Expression)>,
+        /// Index anchor on the source node. Without `input` and `edge_eq`,
+        /// sources come from it instead of a scan of every node.
+        src_anchor: Option<NodeAnchor>,
+        /// Index anchor on the destination node. Without `input` and
+        /// `edge_eq`, the hop walks the incoming lists of its nodes and binds
+        /// the pattern in its written orientation. With both anchors set, the
+        /// side estimated to read fewer edges starts.
+        dst_anchor: Option<NodeAnchor>,
         dst_alias: Arc<str>,
         dst_labels: Vec<String>,
         src_prebound: bool,
@@ -90,6 +110,37 @@ pub enum Plan {
     },
 }
 
+/// Ordered-index anchor of a `NodeScan` on its first label. The bounds are
+/// literals or parameters, resolved when the scan starts; the `WHERE` filter
+/// that produced them still runs on every row.
+#[derive(Debug, Clone)]
+pub struct PropertyRange {
+    pub key: String,
+    /// `(bound, inclusive)`
+    pub lower: Option<(Expression, bool)>,
+    pub upper: Option<(Expression, bool)>,
+}
+
+/// Endpoint anchor of an input-less `MatchOut`: the nodes of `label`,
+/// narrowed to an equality on a literal or parameter when one resolves to an
+/// index value. The endpoint's other labels and `WHERE` filters still run on
+/// every row.
+#[derive(Debug, Clone)]
+pub struct NodeAnchor {
+    pub label: String,
+    pub property_eq: Option<(String, Expression)>,
+}
+
+/// Full-text anchor of a `NodeScan` on its first label, from a
+/// `textMatch(n.key, query)` or `textPhrase(n.key, query)` conjunct. The
+/// query is a literal or parameter; the `WHERE` filter still runs.
+#[derive(Debug, Clone)]
+pub struct TextSearch {
+    pub key: String,
+    pub query: Expression,
+    pub phrase: bool,
+}
+
 #[allow(clippy::large_enum_variant)]
 pub enum PlanIterator<'a, S: GraphSnapshot> {
     ReturnOne(std::iter::Once<Result<Row>>),
@@ -102,6 +153,7 @@ pub enum PlanIterator<'a, S: GraphSnapshot> {
     MatchOutFiltered(Box<FilteredMatchOutIter<'a, S>>),
     MatchBoundRel(Box<MatchBoundRelIter<'a, S>>),
     CartesianProduct(Box<CartesianProductIter<'a, S>>),
+    Batched(Box<BatchRows<'a, S>>),
 }
 
 impl<'a, S: GraphSnapshot> Iterator for PlanIterator<'a, S> {
@@ -119,6 +171,7 @@ impl<'a, S: GraphSnapshot> Iterator for PlanIterator<'a, S> {
             PlanIterator::MatchOutFiltered(iter) => iter.next(),
             PlanIterator::MatchBoundRel(iter) => iter.next(),
             PlanIterator::CartesianProduct(iter) => iter.next(),
+            PlanIterator::Batched(iter) => iter.next(),
         }
     }
 }
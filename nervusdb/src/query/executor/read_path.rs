@@ -57,19 +57,80 @@ fn value_node_id(value: &Value) -> Option<InternalNodeId> {
 }
 use crate::api::GraphSnapshot;
 
+/// Outgoing, or incoming, edges of one node, optionally restricted to a
+/// relationship-type list. Walks the snapshot's neighbor cursors one type at a
+/// time instead of boxing a chained iterator per hop.
+pub(super) struct NodeEdges<'a, S: GraphSnapshot + 'a> {
+    node: InternalNodeId,
+    incoming: bool,
+    next_rel: usize,
+    current: Option<S::Neighbors<'a>>,
+}
+
+impl<'a, S: GraphSnapshot + 'a> NodeEdges<'a, S> {
+    pub(super) fn new(snapshot: &'a S, src: InternalNodeId, rels: Option<&[RelTypeId]>) -> Self {
+        Self::walk(snapshot, src, rels, false)
+    }
+
+    pub(super) fn walk(
+        snapshot: &'a S,
+        node: InternalNodeId,
+        rels: Option<&[RelTypeId]>,
+        incoming: bool,
+    ) -> Self {
+        let mut edges = Self {
+            node,
+            incoming,
+            next_rel: 0,
+            current: None,
+        };
+        if rels.is_none() {
+            edges.current = Some(edges.open(snapshot, None));
+        }
+        edges
+    }
+
+    fn open(&self, snapshot: &'a S, rel: Option<RelTypeId>) -> S::Neighbors<'a> {
+        if self.incoming {
+            snapshot.incoming_neighbors(self.node, rel)
+        } else {
+            snapshot.neighbors(self.node, rel)
+        }
+    }
+
+    pub(super) fn next(&mut self, snapshot: &'a S, rels: Option<&[RelTypeId]>) -> Option<EdgeKey> {
+        loop {
+            if let Some(edges) = &mut self.current
+                && let Some(edge) = edges.next()
+            {
+                return Some(edge);
+            }
+            let rel = *rels?.get(self.next_rel)?;
+            self.next_rel += 1;
+            self.current = Some(self.open(snapshot, Some(rel)));
+        }
+    }
+}
+
 pub(super) struct MatchOutIter<'a, S: GraphSnapshot + 'a> {
     snapshot: &'a S,
     src_alias: &'a str,
     rels: Option<Vec<RelTypeId>>,
     edge_alias: Option<&'a str>,
     dst_alias: &'a str,
+    /// Every node, or the nodes of a label or property index probe.
     node_iter: Box<dyn Iterator<Item = InternalNodeId> + 'a>,
+    /// Edges from an index probe; replaces the per-node walk when set.
+    anchor: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+    /// `node_iter` yields destinations whose incoming lists are walked.
+    incoming: bool,
     cur_src: Option<InternalNodeId>,
-    cur_edges: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+    cur_edges: Option<NodeEdges<'a, S>>,
     path_alias: Option<&'a str>,
 }
 
 impl<'a, S: GraphSnapshot + 'a> MatchOutIter<'a, S> {
+    #[allow(clippy::too_many_arguments)]
     pub(super) fn new(
         snapshot: &'a S,
         src_alias: &'a str,
@@ -77,20 +138,43 @@ impl<'a, S: GraphSnapshot + 'a> MatchOutIter<'a, S> {
         edge_alias: Option<&'a str>,
         dst_alias: &'a str,
         path_alias: Option<&'a str>,
+        anchor: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+        sources: Option<Box<dyn Iterator<Item = InternalNodeId> + 'a>>,
+        incoming: bool,
     ) -> Self {
+        let node_iter: Box<dyn Iterator<Item = InternalNodeId> + 'a> = if anchor.is_some() {
+            Box::new(std::iter::empty())
+        } else {
+            sources.unwrap_or_else(|| snapshot.nodes())
+        };
         Self {
             snapshot,
             src_alias,
             rels,
             edge_alias,
             dst_alias,
-            node_iter: snapshot.nodes(),
+            node_iter,
+            anchor,
+            incoming,
             cur_src: None,
             cur_edges: None,
             path_alias,
         }
     }
 
+    fn edge_row(&self, edge: EdgeKey) -> Row {
+        let mut row = Row::default().with(self.src_alias, Value::NodeId(edge.src));
+        if let Some(edge_alias) = self.edge_alias {
+            row = row.with(edge_alias, Value::EdgeKey(edge));
+        }
+        row = row.with(self.dst_alias, Value::NodeId(edge.dst));
+
+        if let Some(path_alias) = self.path_alias {
+            row.join_path(path_alias, edge.src, edge, edge.dst);
+        }
+        row
+    }
+
     fn next_src(&mut self) -> Option<InternalNodeId> {
         for src in self.node_iter.by_ref() {
             if self.snapshot.is_tombstoned_node(src) {
@@ -106,45 +190,27 @@ impl<'a, S: GraphSnapshot + 'a> Iterator for MatchOutIter<'a, S> {
     type Item = Result<Row>;
 
     fn next(&mut self) -> Option<Self::Item> {
+        if let Some(anchor) = &mut self.anchor {
+            let edge = anchor.next()?;
+            return Some(Ok(self.edge_row(edge)));
+        }
         loop {
             if self.cur_edges.is_none() {
                 let src = self.next_src()?;
                 self.cur_src = Some(src);
-
-                if let Some(rels) = &self.rels {
-                    // Chain multiple iterators
-                    let mut iter: Box<dyn Iterator<Item = EdgeKey> + 'a> =
-                        Box::new(std::iter::empty());
-                    for rel in rels {
-                        // Note: Depending on impl, this might need optimizing.
-                        // But for now we chain them.
-                        // We must clone rel because it's owned by the Vec in struct? No, rel is Copy (RelTypeId).
-                        let r = *rel;
-                        let neighbors = self.snapshot.neighbors(src, Some(r));
-                        iter = Box::new(iter.chain(neighbors));
-                    }
-                    self.cur_edges = Some(iter);
-                } else {
-                    // Match all
-                    self.cur_edges = Some(Box::new(self.snapshot.neighbors(src, None)));
-                }
+                self.cur_edges = Some(NodeEdges::walk(
+                    self.snapshot,
+                    src,
+                    self.rels.as_deref(),
+                    self.incoming,
+                ));
             }
 
             let edges = self.cur_edges.as_mut().expect("cur_edges must exist");
 
-            if let Some(edge) = edges.next() {
-                let mut row = Row::default().with(self.src_alias, Value::NodeId(edge.src));
-                if let Some(edge_alias) = self.edge_alias {
-                    row = row.with(edge_alias, Value::EdgeKey(edge));
-                }
-                row = row.with(self.dst_alias, Value::NodeId(edge.dst));
-
-                if let Some(path_alias) = self.path_alias {
-                    row.join_path(path_alias, edge.src, edge, edge.dst);
-                }
-
+            if let Some(edge) = edges.next(self.snapshot, self.rels.as_deref()) {
                 // Always return full row - projection happens in Plan::Project
-                return Some(Ok(row));
+                return Some(Ok(self.edge_row(edge)));
             }
 
             self.cur_edges = None;
@@ -165,7 +231,7 @@ pub struct ExpandIter<'a, S: GraphSnapshot + 'a> {
     optional_unbind: Vec<String>,
     dst_label_constraint: LabelConstraint,
     cur_row: Option<Row>,
-    cur_edges: Option<Box<dyn Iterator<Item = EdgeKey> + 'a>>,
+    cur_edges: Option<NodeEdges<'a, S>>,
     yielded_any: bool,
     path_alias: Option<&'a str>,
 }
@@ -219,19 +285,8 @@ impl<'a, S: GraphSnapshot + 'a> Iterator for ExpandIter<'a, S> {
                             .map(|(_, v)| v);
                         match src_val {
                             Some(Value::NodeId(id)) => {
-                                if let Some(rels) = &self.rels {
-                                    let mut iter: Box<dyn Iterator<Item = EdgeKey> + 'a> =
-                                        Box::new(std::iter::empty());
-                                    // Reverse iteration to maintain chain order? Or standard.
-                                    for rel in rels {
-                                        let neighbors = self.snapshot.neighbors(*id, Some(*rel));
-                                        iter = Box::new(iter.chain(neighbors));
-                                    }
-                                    self.cur_edges = Some(iter);
-                                } else {
-                                    self.cur_edges =
-                                        Some(Box::new(self.snapshot.neighbors(*id, None)));
-                                }
+                                self.cur_edges =
+                                    Some(NodeEdges::new(self.snapshot, *id, self.rels.as_deref()));
                                 self.yielded_any = false;
                             }
                             Some(Value::Null) => {
@@ -270,7 +325,7 @@ impl<'a, S: GraphSnapshot + 'a> Iterator for ExpandIter<'a, S> {
             }
 
             let edges = self.cur_edges.as_mut().unwrap();
-            if let Some(edge) = edges.next() {
+            if let Some(edge) = edges.next(self.snapshot, self.rels.as_deref()) {
                 if path_alias_contains_edge(
                     self.snapshot,
                     self.cur_row.as_ref().unwrap(),
@@ -28,7 +28,10 @@ mod where_validation;
 mod write_compile;
 mod write_create_merge;
 mod write_validation;
-use ast_walk::{extract_predicates, extract_variables_from_expr};
+use ast_walk::{
+    extract_predicates, extract_range_predicates, extract_text_predicates,
+    extract_variables_from_expr,
+};
 use binding_analysis::{
     extract_output_var_kinds, infer_expression_binding_kind, validate_match_pattern_bindings,
     variable_already_bound_error,
@@ -43,7 +46,7 @@ use match_anchor::{
 use match_compile::compile_match_plan;
 use pattern_predicate::ensure_no_pattern_predicate;
 use plan_introspection::plan_contains_write;
-use plan_render::render_plan;
+use plan_render::render_plan_with_estimates;
 use projection_alias::default_projection_alias;
 use projection_compile::compile_projection_aggregation;
 use return_with::compile_return_plan;
@@ -74,6 +77,9 @@ pub struct ExecuteOptions {
     pub max_collection_items: usize,
     pub soft_timeout_ms: u64,
     pub max_apply_rows_per_outer: usize,
+    /// Rows per batch when scans, hops, filters, and projections run
+    /// batched; `0` runs every operator a row at a time.
+    pub batch_rows: usize,
 }
 
 impl Default for ExecuteOptions {
@@ -83,6 +89,7 @@ impl Default for ExecuteOptions {
             max_collection_items: 200_000,
             soft_timeout_ms: 5_000,
             max_apply_rows_per_outer: 200_000,
+            batch_rows: 1024,
         }
     }
 }
@@ -210,7 +217,12 @@ impl Params {
 #[derive(Debug, Clone)]
 pub struct PreparedQuery {
     plan: Plan,
-    explain: Option<String>,
+    /// `plan` with its doubly anchored chains compiled from the other end;
+    /// execution runs whichever the estimator expects to read fewer rows.
+    reversed: Option<Plan>,
+    /// Set for `EXPLAIN`; the plan is rendered against a snapshot, since
+    /// the hop order and estimates depend on it.
+    explain: bool,
 }
 
 /// Parses and prepares a Mini-Cypher 0.1 query for execution.
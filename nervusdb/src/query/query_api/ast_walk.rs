@@ -1,4 +1,5 @@
-use crate::query::ast::{BinaryOperator, Expression};
+use crate::query::ast::{BinaryOperator, Expression, Literal};
+use crate::query::executor::{PropertyRange, TextSearch};
 use std::collections::{BTreeMap, HashSet};
 
 pub(super) fn extract_predicates(
@@ -28,6 +29,95 @@ pub(super) fn extract_predicates(
     }
 }
 
+/// Collects `n.key < bound` style conjuncts whose bound is a number, string, or
+/// parameter. Only the first lower and first upper bound per property are kept;
+/// the WHERE filter still checks every conjunct.
+pub(super) fn extract_range_predicates(
+    expr: &Expression,
+    map: &mut BTreeMap<String, BTreeMap<String, PropertyRange>>,
+) {
+    let Expression::Binary(bin) = expr else {
+        return;
+    };
+    if matches!(bin.operator, BinaryOperator::And) {
+        extract_range_predicates(&bin.left, map);
+        extract_range_predicates(&bin.right, map);
+        return;
+    }
+    // (property is on the left, is a lower bound, inclusive)
+    let (lower_when_left, inclusive) = match bin.operator {
+        BinaryOperator::GreaterThan => (true, false),
+        BinaryOperator::GreaterEqual => (true, true),
+        BinaryOperator::LessThan => (false, false),
+        BinaryOperator::LessEqual => (false, true),
+        _ => return,
+    };
+    let (pa, bound, is_lower) = match (&bin.left, &bin.right) {
+        (Expression::PropertyAccess(pa), bound) => (pa, bound, lower_when_left),
+        (bound, Expression::PropertyAccess(pa)) => (pa, bound, !lower_when_left),
+        _ => return,
+    };
+    if !matches!(
+        bound,
+        Expression::Literal(Literal::Integer(_) | Literal::Float(_) | Literal::String(_))
+            | Expression::Parameter(_)
+    ) {
+        return;
+    }
+    let range = map
+        .entry(pa.variable.clone())
+        .or_default()
+        .entry(pa.property.clone())
+        .or_insert_with(|| PropertyRange {
+            key: pa.property.clone(),
+            lower: None,
+            upper: None,
+        });
+    let slot = if is_lower {
+        &mut range.lower
+    } else {
+        &mut range.upper
+    };
+    slot.get_or_insert_with(|| (bound.clone(), inclusive));
+}
+
+/// Collects `textMatch(n.key, query)` and `textPhrase(n.key, query)`
+/// conjuncts whose query is a string literal or parameter. Only the first per
+/// alias is kept.
+pub(super) fn extract_text_predicates(expr: &Expression, map: &mut BTreeMap<String, TextSearch>) {
+    match expr {
+        Expression::Binary(bin) if matches!(bin.operator, BinaryOperator::And) => {
+            extract_text_predicates(&bin.left, map);
+            extract_text_predicates(&bin.right, map);
+        }
+        Expression::FunctionCall(call) => {
+            let phrase = if call.name.eq_ignore_ascii_case("textPhrase") {
+                true
+            } else if call.name.eq_ignore_ascii_case("textMatch") {
+                false
+            } else {
+                return;
+            };
+            let [Expression::PropertyAccess(pa), query] = call.args.as_slice() else {
+                return;
+            };
+            if !matches!(
+                query,
+                Expression::Literal(Literal::String(_)) | Expression::Parameter(_)
+            ) {
+                return;
+            }
+            map.entry(pa.variable.clone())
+                .or_insert_with(|| TextSearch {
+                    key: pa.property.clone(),
+                    query: query.clone(),
+                    phrase,
+                });
+        }
+        _ => {}
+    }
+}
+
 pub(super) fn extract_variables_from_expr(expr: &Expression, vars: &mut HashSet<String>) {
     match expr {
         Expression::Variable(v) => {
@@ -89,7 +179,7 @@ pub(super) fn extract_variables_from_expr(expr: &Expression, vars: &mut HashSet<
 
 #[cfg(test)]
 mod tests {
-    use super::{extract_predicates, extract_variables_from_expr};
+    use super::{extract_predicates, extract_range_predicates, extract_variables_from_expr};
     use crate::query::ast::{
         BinaryExpression, BinaryOperator, Expression, FunctionCall, Literal, PropertyAccess,
     };
@@ -151,4 +241,50 @@ mod tests {
         assert!(n_map.contains_key("name"));
         assert!(n_map.contains_key("age"));
     }
+
+    #[test]
+    fn extract_range_predicates_orients_bounds() {
+        let age = || {
+            Expression::PropertyAccess(PropertyAccess {
+                variable: "n".to_string(),
+                property: "age".to_string(),
+            })
+        };
+        let lower = Expression::Binary(Box::new(BinaryExpression {
+            left: age(),
+            operator: BinaryOperator::GreaterThan,
+            right: Expression::Literal(Literal::Integer(30)),
+        }));
+        let upper = Expression::Binary(Box::new(BinaryExpression {
+            left: Expression::Parameter("max".to_string()),
+            operator: BinaryOperator::GreaterEqual,
+            right: age(),
+        }));
+        let ignored = Expression::Binary(Box::new(BinaryExpression {
+            left: age(),
+            operator: BinaryOperator::LessThan,
+            right: Expression::Variable("m".to_string()),
+        }));
+        let expr = [upper, ignored].into_iter().fold(lower, |acc, next| {
+            Expression::Binary(Box::new(BinaryExpression {
+                left: acc,
+                operator: BinaryOperator::And,
+                right: next,
+            }))
+        });
+
+        let mut map = BTreeMap::new();
+        extract_range_predicates(&expr, &mut map);
+
+        let range = &map["n"]["age"];
+        assert_eq!(range.key, "age");
+        assert!(matches!(
+            range.lower,
+            Some((Expression::Literal(Literal::Integer(30)), false))
+        ));
+        assert!(matches!(
+            &range.upper,
+            Some((Expression::Parameter(name), true)) if name == "max"
+        ));
+    }
 }
@@ -299,8 +299,11 @@ mod tests {
         let with_project = Plan::Project {
             input: Box::new(Plan::NodeScan {
                 alias: "a".to_string().into(),
-                label: None,
+                labels: Vec::new(),
                 property_eq: None,
+                composite_eq: Vec::new(),
+                text_search: None,
+                property_range: None,
                 optional: false,
             }),
             projections: vec![("a".to_string(), Expression::Variable("a".to_string()))],
@@ -310,6 +313,9 @@ mod tests {
             src_alias: "a".to_string().into(),
             rels: vec![],
             edge_alias: None,
+            edge_eq: None,
+            src_anchor: None,
+            dst_anchor: None,
             dst_alias: "b".to_string().into(),
             dst_labels: vec![],
             src_prebound: true,
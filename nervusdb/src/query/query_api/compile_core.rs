@@ -1,8 +1,8 @@
 use super::{
     BTreeMap, BindingKind, Clause, Error, Expression, Plan, Query, Result, compile_create_plan,
     compile_delete_plan_v2, compile_match_plan, compile_return_plan, compile_set_plan_v2,
-    extract_output_var_kinds, extract_predicates, validate_expression_types,
-    validate_where_expression_bindings,
+    extract_output_var_kinds, extract_predicates, extract_range_predicates,
+    extract_text_predicates, validate_expression_types, validate_where_expression_bindings,
 };
 
 pub(crate) struct CompiledQuery {
@@ -24,14 +24,20 @@ pub(crate) fn compile_m3_plan(query: Query, initial_input: Option<Plan>) -> Resu
                 }
 
                 let mut predicates = BTreeMap::new();
+                let mut ranges = BTreeMap::new();
+                let mut texts = BTreeMap::new();
                 if let Some(Clause::Where(w)) = clauses.peek() {
                     extract_predicates(&w.expression, &mut predicates);
+                    extract_range_predicates(&w.expression, &mut ranges);
+                    extract_text_predicates(&w.expression, &mut texts);
                 }
 
                 plan = Some(compile_match_plan(
                     plan,
                     m.clone(),
                     &predicates,
+                    &ranges,
+                    &texts,
                     &mut next_anon_id,
                 )?);
             }
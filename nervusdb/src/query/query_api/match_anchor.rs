@@ -105,6 +105,12 @@ pub(super) fn maybe_reanchor_pattern(
         return pattern;
     }
 
+    reverse_pattern(pattern)
+}
+
+/// The same pattern written from its last node, with every relationship
+/// direction flipped.
+pub(super) fn reverse_pattern(pattern: crate::query::ast::Pattern) -> crate::query::ast::Pattern {
     let mut reversed_elements = Vec::with_capacity(pattern.elements.len());
     for element in pattern.elements.into_iter().rev() {
         match element {
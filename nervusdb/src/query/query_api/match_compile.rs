@@ -4,12 +4,15 @@ use super::{
     maybe_reanchor_pattern, pattern_has_bound_relationship, validate_match_pattern_bindings,
 };
 use crate::api::PropertyValue;
+use crate::query::executor::{NodeAnchor, PropertyRange, TextSearch};
 use crate::query::query_api::ast_walk::extract_variables_from_expr;
 
 pub(super) fn compile_match_plan(
     input: Option<Plan>,
     m: crate::query::ast::MatchClause,
     predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+    ranges: &BTreeMap<String, BTreeMap<String, PropertyRange>>,
+    texts: &BTreeMap<String, TextSearch>,
     next_anon_id: &mut u32,
 ) -> Result<Plan> {
     let mut plan = input;
@@ -53,6 +56,8 @@ pub(super) fn compile_match_plan(
                 plan,
                 &pattern,
                 predicates,
+                ranges,
+                texts,
                 m.optional,
                 &known_bindings,
                 next_anon_id,
@@ -63,6 +68,8 @@ pub(super) fn compile_match_plan(
                 None,
                 &pattern,
                 predicates,
+                ranges,
+                texts,
                 m.optional,
                 &known_bindings,
                 next_anon_id,
@@ -91,6 +98,8 @@ fn compile_pattern_chain(
     input: Option<Plan>,
     pattern: &crate::query::ast::Pattern,
     predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+    ranges: &BTreeMap<String, BTreeMap<String, PropertyRange>>,
+    texts: &BTreeMap<String, TextSearch>,
     optional: bool,
     known_bindings: &BTreeMap<String, BindingKind>,
     next_anon_id: &mut u32,
@@ -113,9 +122,15 @@ fn compile_pattern_chain(
         name
     };
     let src_labels = src_node_el.labels.clone();
-    let src_label = src_labels.first().cloned();
+    let fresh = input.is_none() && !optional;
+    // An unlabeled first node of a fresh pattern has no index of its own, so
+    // the first hop may start from the edge property index instead.
+    let edge_anchorable = fresh && src_labels.is_empty();
 
     let mut local_predicates = predicates.clone();
+    // Set only for a fresh pattern whose first hop may start from the
+    // source's label or equality index without a separate scan.
+    let mut src_anchor = None;
     let mut plan = if let Some(existing_plan) = input {
         let src_is_bound = matches!(
             known_bindings.get(&src_alias),
@@ -151,19 +166,28 @@ fn compile_pattern_chain(
                 &mut local_predicates,
             );
 
+            let NodeScanAnchors {
+                property_eq,
+                composite_eq,
+                text_search,
+                property_range,
+            } = node_scan_anchor(&src_alias, &src_labels, &local_predicates, ranges, texts);
             let start_plan = Plan::NodeScan {
                 alias: src_alias.clone().into(),
-                label: src_label.clone(),
-                property_eq: node_scan_property_eq(&src_alias, &src_label, &local_predicates),
+                labels: src_labels.clone(),
+                property_eq,
+                composite_eq,
+                text_search,
+                property_range,
                 optional,
             };
 
+            // The scan already intersects every source label.
             let joined = Plan::CartesianProduct {
                 left: Box::new(existing_plan),
                 right: Box::new(start_plan),
             };
-            let joined = apply_filters_for_alias(joined, &src_alias, &local_predicates);
-            apply_label_filters_for_alias(joined, &src_alias, &src_labels)
+            apply_filters_for_alias(joined, &src_alias, &local_predicates)
         }
     } else {
         // Build Initial Plan (always NodeScan; property filters applied below)
@@ -173,15 +197,26 @@ fn compile_pattern_chain(
             &mut local_predicates,
         );
 
+        let NodeScanAnchors {
+            property_eq,
+            composite_eq,
+            text_search,
+            property_range,
+        } = node_scan_anchor(&src_alias, &src_labels, &local_predicates, ranges, texts);
+        if fresh && composite_eq.is_empty() && text_search.is_none() && property_range.is_none() {
+            src_anchor = node_anchor(&src_alias, &src_labels, &local_predicates);
+        }
         let start_plan = Plan::NodeScan {
             alias: src_alias.clone().into(),
-            label: src_label.clone(),
-            property_eq: node_scan_property_eq(&src_alias, &src_label, &local_predicates),
+            labels: src_labels.clone(),
+            property_eq,
+            composite_eq,
+            text_search,
+            property_range,
             optional,
         };
 
-        let plan = apply_filters_for_alias(start_plan, &src_alias, &local_predicates);
-        apply_label_filters_for_alias(plan, &src_alias, &src_labels)
+        apply_filters_for_alias(start_plan, &src_alias, &local_predicates)
     };
 
     // Subsequent hops
@@ -258,13 +293,60 @@ fn compile_pattern_chain(
         } else {
             match rel_el.direction {
                 crate::query::ast::RelationshipDirection::LeftToRight => {
+                    let edge_eq = if edge_anchorable && i == 1 && dst_alias != curr_src_alias {
+                        edge_scan_anchor(
+                            edge_alias.as_deref(),
+                            &rel_types,
+                            &rel_el.properties,
+                            &local_predicates,
+                        )
+                    } else {
+                        None
+                    };
+                    let (hop_src_anchor, hop_dst_anchor) =
+                        if edge_eq.is_none() && i == 1 && dst_alias != curr_src_alias {
+                            let dst_anchor = if fresh && !known_bindings.contains_key(&dst_alias) {
+                                let mut dst_predicates = BTreeMap::new();
+                                if let Some(existing) = local_predicates.get(&dst_alias) {
+                                    dst_predicates.insert(dst_alias.clone(), existing.clone());
+                                }
+                                extend_predicates_from_properties(
+                                    &dst_alias,
+                                    &dst_node_el.properties,
+                                    &mut dst_predicates,
+                                );
+                                node_anchor(&dst_alias, &dst_labels, &dst_predicates)
+                            } else {
+                                None
+                            };
+                            hop_anchors(src_anchor.take(), dst_anchor, src_labels.is_empty())
+                        } else {
+                            (None, None)
+                        };
+                    let anchored =
+                        edge_eq.is_some() || hop_src_anchor.is_some() || hop_dst_anchor.is_some();
+                    // The anchored hop binds the source itself; the scan and
+                    // its filters are rebuilt on top of it.
+                    let hop_input = if anchored { None } else { Some(Box::new(plan)) };
+                    // A hop that may start from the destination checks every
+                    // source label above it.
+                    let extra_labels: &[String] = if hop_dst_anchor.is_some() {
+                        &src_labels
+                    } else if hop_src_anchor.is_some() {
+                        &src_labels[1..]
+                    } else {
+                        &[]
+                    };
                     plan = Plan::MatchOut {
-                        input: Some(Box::new(plan)),
+                        input: hop_input,
                         src_alias: curr_src_alias.clone().into(),
                         dst_alias: dst_alias.clone().into(),
                         dst_labels: dst_labels.clone(),
                         src_prebound,
                         edge_alias: edge_alias.clone().map(Into::into),
+                        edge_eq,
+                        src_anchor: hop_src_anchor,
+                        dst_anchor: hop_dst_anchor,
                         rels: rel_types,
                         limit: None,
                         project: Vec::new(),
@@ -273,6 +355,10 @@ fn compile_pattern_chain(
                         optional_unbind: optional_unbind.clone(),
                         path_alias: path_alias.clone().map(Into::into),
                     };
+                    if anchored {
+                        plan = apply_filters_for_alias(plan, &curr_src_alias, &local_predicates);
+                        plan = apply_label_filters_for_alias(plan, &curr_src_alias, extra_labels);
+                    }
                 }
                 crate::query::ast::RelationshipDirection::RightToLeft => {
                     // 0.1 slim: swap src/dst so MatchOut handles incoming via reversed traversal
@@ -281,6 +367,9 @@ fn compile_pattern_chain(
                         src_alias: dst_alias.clone().into(),
                         rels: rel_types,
                         edge_alias: edge_alias.clone().map(Into::into),
+                        edge_eq: None,
+                        src_anchor: None,
+                        dst_anchor: None,
                         dst_alias: curr_src_alias.clone().into(),
                         dst_labels: dst_labels.clone(),
                         src_prebound,
@@ -299,6 +388,9 @@ fn compile_pattern_chain(
                         src_alias: curr_src_alias.clone().into(),
                         rels: rel_types,
                         edge_alias: edge_alias.clone().map(Into::into),
+                        edge_eq: None,
+                        src_anchor: None,
+                        dst_anchor: None,
                         dst_alias: dst_alias.clone().into(),
                         dst_labels: dst_labels.clone(),
                         src_prebound,
@@ -368,10 +460,10 @@ fn compile_pattern_chain(
 
 fn node_scan_property_eq(
     alias: &str,
-    label: &Option<String>,
+    labels: &[String],
     local_predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
 ) -> Option<(String, PropertyValue)> {
-    label.as_ref()?;
+    labels.first()?;
     let predicates = local_predicates.get(alias)?;
     predicates
         .iter()
@@ -379,6 +471,142 @@ fn node_scan_property_eq(
         .next()
 }
 
+/// Index anchors of a `NodeScan`; see `Plan::NodeScan`.
+#[derive(Default)]
+struct NodeScanAnchors {
+    property_eq: Option<(String, PropertyValue)>,
+    composite_eq: Vec<(String, Expression)>,
+    text_search: Option<TextSearch>,
+    property_range: Option<PropertyRange>,
+}
+
+/// Picks the scan anchors: equalities on literals or parameters, jointly when
+/// there are two or more, otherwise the full-text predicate, otherwise the
+/// first range over the alias.
+fn node_scan_anchor(
+    alias: &str,
+    labels: &[String],
+    local_predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+    ranges: &BTreeMap<String, BTreeMap<String, PropertyRange>>,
+    texts: &BTreeMap<String, TextSearch>,
+) -> NodeScanAnchors {
+    if labels.is_empty() {
+        return NodeScanAnchors::default();
+    }
+    let composite_eq: Vec<(String, Expression)> = local_predicates
+        .get(alias)
+        .into_iter()
+        .flatten()
+        .filter(|(_, expr)| {
+            matches!(expr, Expression::Parameter(_)) || literal_to_index_value(expr).is_some()
+        })
+        .map(|(key, expr)| (key.clone(), expr.clone()))
+        .collect();
+    let composite_eq = if composite_eq.len() >= 2 {
+        composite_eq
+    } else {
+        Vec::new()
+    };
+    if let Some(eq) = node_scan_property_eq(alias, labels, local_predicates) {
+        return NodeScanAnchors {
+            property_eq: Some(eq),
+            composite_eq,
+            text_search: None,
+            property_range: None,
+        };
+    }
+    if let Some(search) = texts.get(alias) {
+        return NodeScanAnchors {
+            property_eq: None,
+            composite_eq,
+            text_search: Some(search.clone()),
+            property_range: None,
+        };
+    }
+    let range = ranges
+        .get(alias)
+        .and_then(|ranges| ranges.values().next().cloned());
+    NodeScanAnchors {
+        property_eq: None,
+        composite_eq,
+        text_search: None,
+        property_range: range,
+    }
+}
+
+/// Anchor of a fresh first-hop endpoint: the first label, with the first
+/// equality on a literal or parameter. A multi-label node without an
+/// equality is left to `NodeScan`, which intersects the label indexes.
+fn node_anchor(
+    alias: &str,
+    labels: &[String],
+    local_predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+) -> Option<NodeAnchor> {
+    let label = labels.first()?;
+    let property_eq = local_predicates
+        .get(alias)
+        .into_iter()
+        .flatten()
+        .find(|(_, expr)| {
+            matches!(expr, Expression::Parameter(_)) || literal_to_index_value(expr).is_some()
+        })
+        .map(|(key, expr)| (key.clone(), expr.clone()));
+    if property_eq.is_none() && labels.len() > 1 {
+        return None;
+    }
+    Some(NodeAnchor {
+        label: label.clone(),
+        property_eq,
+    })
+}
+
+/// Anchors kept for a fresh first hop. An equality beats a bare label, and a
+/// source that would scan every node yields to any destination anchor. When
+/// both ends are equally anchored both are kept, and execution starts from the
+/// end estimated to read fewer edges.
+fn hop_anchors(
+    src: Option<NodeAnchor>,
+    dst: Option<NodeAnchor>,
+    src_unlabeled: bool,
+) -> (Option<NodeAnchor>, Option<NodeAnchor>) {
+    match (src, dst) {
+        (src, None) => (src, None),
+        (None, dst) if src_unlabeled => (None, dst),
+        // The source keeps a richer `NodeScan` anchor.
+        (None, Some(_)) => (None, None),
+        (Some(src), Some(dst)) => match (src.property_eq.is_some(), dst.property_eq.is_some()) {
+            (true, false) => (Some(src), None),
+            (false, true) => (None, Some(dst)),
+            _ => (Some(src), Some(dst)),
+        },
+    }
+}
+
+/// Equality on a literal or parameter over the properties of a named,
+/// single-type relationship, inline or from `WHERE`.
+fn edge_scan_anchor(
+    edge_alias: Option<&str>,
+    rel_types: &[String],
+    properties: &Option<crate::query::ast::PropertyMap>,
+    local_predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+) -> Option<(String, Expression)> {
+    let alias = edge_alias?;
+    if rel_types.len() != 1 {
+        return None;
+    }
+    let mut predicates = BTreeMap::new();
+    extend_predicates_from_properties(alias, properties, &mut predicates);
+    local_predicates
+        .get(alias)
+        .into_iter()
+        .chain(predicates.get(alias))
+        .flatten()
+        .find(|(_, expr)| {
+            matches!(expr, Expression::Parameter(_)) || literal_to_index_value(expr).is_some()
+        })
+        .map(|(key, expr)| (key.clone(), expr.clone()))
+}
+
 fn literal_to_index_value(expr: &Expression) -> Option<PropertyValue> {
     match expr {
         Expression::Literal(crate::query::ast::Literal::Null) => Some(PropertyValue::Null),
@@ -1,9 +1,234 @@
+use super::super::match_anchor::reverse_pattern;
+use super::super::{BTreeMap, BTreeSet, Expression, extract_predicates};
 use super::logical::LogicalPlan;
+use crate::query::ast::{Clause, NodePattern, PathElement, Pattern, Query};
 
-/// Phase1c baseline optimizer: identity rewrite.
+/// How cheaply a node pattern can start a traversal, worst first.
 ///
-/// This keeps behavior stable while routing all queries through the
-/// LogicalPlan -> Optimizer -> PhysicalPlan pipeline.
+/// Compilation has no snapshot, so patterns are ranked by the anchors they
+/// offer; counter-based estimates take over at execution (see
+/// `executor::cost`).
+#[derive(Debug, Clone, Copy, PartialEq, Eq, PartialOrd, Ord)]
+enum AnchorRank {
+    /// Unlabelled: every node is a candidate.
+    Scan,
+    Label,
+    /// A label and an equality on a literal or parameter.
+    Equality,
+}
+
+/// Rewrites the query before compilation. A fresh multi-hop pattern in the
+/// leading MATCH clauses is written from whichever end anchors better, since
+/// compilation expands a chain from its first node. One-hop patterns are left
+/// to execution, which can start from either end.
 pub(crate) fn optimize(plan: LogicalPlan) -> LogicalPlan {
-    plan
+    let LogicalPlan { mut query } = plan;
+    reverse_patterns(&mut query, |first, last| last > first);
+    LogicalPlan { query }
+}
+
+/// `plan` with every chain that `optimize` could reverse and that has an
+/// anchor at both ends written from its other end, or `None` when there is
+/// no such chain. Ranks cannot tell two labels apart, so both orders are
+/// compiled and execution keeps the one `executor::cost` expects to read
+/// fewer rows.
+pub(crate) fn reversed(plan: &LogicalPlan) -> Option<LogicalPlan> {
+    let mut query = plan.query.clone();
+    reverse_patterns(&mut query, |first, last| {
+        first >= AnchorRank::Label && last >= AnchorRank::Label
+    })
+    .then_some(LogicalPlan { query })
+}
+
+/// Writes each reversible pattern for which `reverse(first, last)` holds from
+/// its last node. Returns whether any pattern changed.
+fn reverse_patterns(query: &mut Query, reverse: impl Fn(AnchorRank, AnchorRank) -> bool) -> bool {
+    let mut bound = BTreeSet::new();
+    let mut changed = false;
+    for index in 0..query.clauses.len() {
+        let mut predicates = BTreeMap::new();
+        if let Some(Clause::Where(w)) = query.clauses.get(index + 1) {
+            extract_predicates(&w.expression, &mut predicates);
+        }
+        match &mut query.clauses[index] {
+            Clause::Match(m) => {
+                let optional = m.optional;
+                for pattern in &mut m.patterns {
+                    let flip = !optional
+                        && reversible_ends(pattern, &bound).is_some_and(|(first, last)| {
+                            reverse(
+                                anchor_rank(first, &predicates),
+                                anchor_rank(last, &predicates),
+                            )
+                        });
+                    if flip {
+                        let written = std::mem::replace(
+                            pattern,
+                            Pattern {
+                                variable: None,
+                                elements: Vec::new(),
+                            },
+                        );
+                        *pattern = reverse_pattern(written);
+                        changed = true;
+                    }
+                    collect_variables(pattern, &mut bound);
+                }
+            }
+            Clause::Where(_) => {}
+            // Later clauses can bind names in ways patterns do not show.
+            _ => break,
+        }
+    }
+    changed
+}
+
+/// First and last node of a fresh chain of two or more hops. Patterns that
+/// touch an earlier binding keep their shape, since compilation anchors them
+/// on it, and so do named paths, whose order is visible.
+fn reversible_ends<'p>(
+    pattern: &'p Pattern,
+    bound: &BTreeSet<String>,
+) -> Option<(&'p NodePattern, &'p NodePattern)> {
+    if pattern.variable.is_some() || pattern.elements.len() < 5 {
+        return None;
+    }
+    for element in &pattern.elements {
+        let variable = match element {
+            PathElement::Node(node) => &node.variable,
+            PathElement::Relationship(rel) => {
+                if rel.variable_length.is_some() {
+                    return None;
+                }
+                &rel.variable
+            }
+        };
+        if variable.as_ref().is_some_and(|name| bound.contains(name)) {
+            return None;
+        }
+    }
+    match (pattern.elements.first(), pattern.elements.last()) {
+        (Some(PathElement::Node(first)), Some(PathElement::Node(last))) => Some((first, last)),
+        _ => None,
+    }
+}
+
+fn anchor_rank(
+    node: &NodePattern,
+    predicates: &BTreeMap<String, BTreeMap<String, Expression>>,
+) -> AnchorRank {
+    if node.labels.is_empty() {
+        return AnchorRank::Scan;
+    }
+    let anchors =
+        |value: &Expression| matches!(value, Expression::Literal(_) | Expression::Parameter(_));
+    let inline_equality = node
+        .properties
+        .as_ref()
+        .is_some_and(|props| props.properties.iter().any(|pair| anchors(&pair.value)));
+    // `a.x = b.y` compares two rows and cannot be probed.
+    let where_equality = node
+        .variable
+        .as_ref()
+        .and_then(|name| predicates.get(name))
+        .is_some_and(|keys| keys.values().any(anchors));
+    if inline_equality || where_equality {
+        AnchorRank::Equality
+    } else {
+        AnchorRank::Label
+    }
+}
+
+fn collect_variables(pattern: &Pattern, bound: &mut BTreeSet<String>) {
+    bound.extend(pattern.variable.iter().cloned());
+    for element in &pattern.elements {
+        let variable = match element {
+            PathElement::Node(node) => &node.variable,
+            PathElement::Relationship(rel) => &rel.variable,
+        };
+        bound.extend(variable.iter().cloned());
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{optimize, reversed};
+    use crate::query::ast::{Clause, PathElement, Query};
+    use crate::query::query_api::plan::logical::LogicalPlan;
+
+    fn parse(cypher: &str) -> LogicalPlan {
+        LogicalPlan::new(crate::query::parser::Parser::parse(cypher).expect("parse should succeed"))
+    }
+
+    fn first_nodes(cypher: &str) -> Vec<Option<String>> {
+        start_nodes(&optimize(parse(cypher)).query)
+    }
+
+    fn start_nodes(query: &Query) -> Vec<Option<String>> {
+        query
+            .clauses
+            .iter()
+            .filter_map(|clause| match clause {
+                Clause::Match(m) => Some(m),
+                _ => None,
+            })
+            .flat_map(|m| &m.patterns)
+            .map(|pattern| match &pattern.elements[0] {
+                PathElement::Node(node) => node.variable.clone(),
+                PathElement::Relationship(_) => None,
+            })
+            .collect()
+    }
+
+    #[test]
+    fn multi_hop_pattern_starts_from_the_better_anchor() {
+        assert_eq!(
+            first_nodes("MATCH (a)-[:R]->(b)-[:S]->(c:Crate {name: 'serde'}) RETURN a"),
+            vec![Some("c".to_string())]
+        );
+        assert_eq!(
+            first_nodes("MATCH (a:Crate)-[:R]->(b)-[:S]->(c:Crate) WHERE c.name = $n RETURN a"),
+            vec![Some("c".to_string())]
+        );
+        assert_eq!(
+            first_nodes("MATCH (a:Crate {name: 'x'})-[:R]->(b)-[:S]->(c:Crate) RETURN a"),
+            vec![Some("a".to_string())]
+        );
+        assert_eq!(
+            first_nodes(
+                "MATCH (a:Crate {name: 'x'})-[:R]->(b)-[:S]->(c:Crate) WHERE c.name = a.name RETURN a"
+            ),
+            vec![Some("a".to_string())]
+        );
+    }
+
+    #[test]
+    fn bound_named_and_one_hop_patterns_keep_their_shape() {
+        assert_eq!(
+            first_nodes("MATCH p = (a)-[:R]->(b)-[:S]->(c:Crate {name: 'x'}) RETURN p"),
+            vec![Some("a".to_string())]
+        );
+        assert_eq!(
+            first_nodes("MATCH (a)-[:R]->(c:Crate {name: 'x'}) RETURN a"),
+            vec![Some("a".to_string())]
+        );
+        assert_eq!(
+            first_nodes("MATCH (a:Crate) MATCH (a)-[:R]->(b)-[:S]->(c:Crate {name: 'x'}) RETURN a"),
+            vec![Some("a".to_string()), Some("a".to_string())]
+        );
+    }
+
+    #[test]
+    fn doubly_anchored_chain_has_a_reversed_alternative() {
+        let optimized = optimize(parse(
+            "MATCH (a:Person {name: $p})-[:R]->(b)-[:S]->(c:City) MATCH (x)-[:R]->(y)-[:S]->(z:City) RETURN a",
+        ));
+        let alternative = reversed(&optimized).expect("both ends of the first chain anchor");
+        assert_eq!(
+            start_nodes(&alternative.query),
+            vec![Some("c".to_string()), Some("z".to_string())]
+        );
+        assert!(reversed(&parse("MATCH (a)-[:R]->(b)-[:S]->(c:City) RETURN a")).is_none());
+        assert!(reversed(&parse("MATCH (a:Person)-[:R]->(c:City) RETURN a")).is_none());
+    }
 }
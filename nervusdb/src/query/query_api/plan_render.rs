@@ -1,13 +1,31 @@
-use crate::query::executor::Plan;
+use crate::query::ast::Expression;
+use crate::query::executor::{NodeAnchor, Plan};
 use std::fmt::Write as _;
 
-pub(super) fn render_plan(plan: &Plan) -> String {
+fn render_anchor(name: &str, anchor: &Option<NodeAnchor>) -> String {
+    match anchor {
+        Some(NodeAnchor {
+            label,
+            property_eq: Some((key, _)),
+        }) => format!(", {name}={label}.{key}"),
+        Some(NodeAnchor { label, .. }) => format!(", {name}={label}"),
+        None => String::new(),
+    }
+}
+
+/// Renders `plan` with `est_rows=<n>` after each operator, from `estimate`.
+pub(super) fn render_plan_with_estimates(plan: &Plan, estimate: &dyn Fn(&Plan) -> f64) -> String {
+    render_plan_with(plan, Some(estimate))
+}
+
+fn render_plan_with(plan: &Plan, estimate: Option<&dyn Fn(&Plan) -> f64>) -> String {
     fn indent(n: usize) -> String {
         "  ".repeat(n)
     }
 
-    fn go(out: &mut String, plan: &Plan, depth: usize) {
+    fn go(out: &mut String, plan: &Plan, depth: usize, estimate: Option<&dyn Fn(&Plan) -> f64>) {
         let pad = indent(depth);
+        let line_start = out.len();
         match plan {
             Plan::ReturnOne => {
                 let _ = writeln!(out, "{pad}ReturnOne");
@@ -21,25 +39,61 @@ pub(super) fn render_plan(plan: &Plan) -> String {
                 merge,
             } => {
                 let _ = writeln!(out, "{pad}Create(merge={merge}, pattern={pattern:?})");
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::NodeScan {
                 alias,
-                label,
+                labels,
                 property_eq,
+                composite_eq,
+                text_search,
+                property_range,
                 optional,
             } => {
                 let opt = if *optional { " OPTIONAL" } else { "" };
+                let range = property_range
+                    .as_ref()
+                    .map(|range| {
+                        let bound = |bound: &Option<(Expression, bool)>| match bound {
+                            Some((expr, true)) => format!("[{expr:?}"),
+                            Some((expr, false)) => format!("({expr:?}"),
+                            None => "unbounded".to_string(),
+                        };
+                        format!(
+                            ", property_range=({}, lower={}, upper={})",
+                            range.key,
+                            bound(&range.lower),
+                            bound(&range.upper)
+                        )
+                    })
+                    .unwrap_or_default();
+                let composite = if composite_eq.is_empty() {
+                    String::new()
+                } else {
+                    let keys: Vec<&str> =
+                        composite_eq.iter().map(|(key, _)| key.as_str()).collect();
+                    format!(", composite_eq={keys:?}")
+                };
+                let text = text_search
+                    .as_ref()
+                    .map(|search| {
+                        let kind = if search.phrase { "phrase" } else { "terms" };
+                        format!(", text_search=({}, {kind}={:?})", search.key, search.query)
+                    })
+                    .unwrap_or_default();
                 let _ = writeln!(
                     out,
-                    "{pad}NodeScan{opt}(alias={alias}, label={label:?}, property_eq={property_eq:?})"
+                    "{pad}NodeScan{opt}(alias={alias}, labels={labels:?}, property_eq={property_eq:?}{composite}{text}{range})"
                 );
             }
             Plan::MatchOut {
-                input: _,
+                input,
                 src_alias,
                 rels,
                 edge_alias,
+                edge_eq,
+                src_anchor,
+                dst_anchor,
                 dst_alias,
                 dst_labels: _,
                 src_prebound: _,
@@ -56,10 +110,19 @@ pub(super) fn render_plan(plan: &Plan) -> String {
                 } else {
                     "".to_string()
                 };
+                let edge_eq = edge_eq
+                    .as_ref()
+                    .map(|(key, _)| format!(", edge_eq={key}"))
+                    .unwrap_or_default();
+                let src_anchor = render_anchor("src_anchor", src_anchor);
+                let dst_anchor = render_anchor("dst_anchor", dst_anchor);
                 let _ = writeln!(
                     out,
-                    "{pad}MatchOut{opt_str}(src={src_alias}, rels={rels:?}, edge={edge_alias:?}, dst={dst_alias}, limit={limit:?}{path_str})"
+                    "{pad}MatchOut{opt_str}(src={src_alias}{src_anchor}, rels={rels:?}, edge={edge_alias:?}{edge_eq}, dst={dst_alias}{dst_anchor}, limit={limit:?}{path_str})"
                 );
+                if let Some(input) = input {
+                    go(out, input, depth + 1, estimate);
+                }
             }
             Plan::MatchBoundRel {
                 input,
@@ -84,24 +147,24 @@ pub(super) fn render_plan(plan: &Plan) -> String {
                     out,
                     "{pad}MatchBoundRel{opt_str}(rel={rel_alias}, src={src_alias}, rels={rels:?}, dst={dst_alias}, dir={direction:?}{path_str})"
                 );
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::Filter { input, predicate } => {
                 let _ = writeln!(out, "{pad}Filter(predicate={predicate:?})");
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::Project { input, projections } => {
                 let _ = writeln!(out, "{pad}Project(len={})", projections.len());
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::Limit { input, limit } => {
                 let _ = writeln!(out, "{pad}Limit(limit={limit:?})");
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::CartesianProduct { left, right } => {
                 let _ = writeln!(out, "{pad}CartesianProduct");
-                go(out, left, depth + 1);
-                go(out, right, depth + 1);
+                go(out, left, depth + 1, estimate);
+                go(out, right, depth + 1, estimate);
             }
             Plan::Delete {
                 input,
@@ -112,28 +175,52 @@ pub(super) fn render_plan(plan: &Plan) -> String {
                     out,
                     "{pad}Delete(detach={detach}, expressions={expressions:?})"
                 );
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
             Plan::SetProperty { input, items } => {
                 let _ = writeln!(out, "{pad}SetProperty(items={items:?})");
-                go(out, input, depth + 1);
+                go(out, input, depth + 1, estimate);
             }
         }
+
+        if let Some(estimate) = estimate {
+            let line_end = out[line_start..]
+                .find('\n')
+                .map_or(out.len(), |end| line_start + end);
+            out.insert_str(line_end, &format!(" est_rows={:.0}", estimate(plan)));
+        }
     }
 
     let mut out = String::new();
-    go(&mut out, plan, 0);
+    go(&mut out, plan, 0, estimate);
     out.trim_end().to_string()
 }
 
 #[cfg(test)]
 mod tests {
-    use super::render_plan;
+    use super::{render_plan_with, render_plan_with_estimates};
+    use crate::query::ast::Expression;
     use crate::query::executor::Plan;
 
     #[test]
     fn render_plan_handles_return_one() {
-        let out = render_plan(&Plan::ReturnOne);
+        let out = render_plan_with(&Plan::ReturnOne, None);
         assert_eq!(out, "ReturnOne");
     }
+
+    #[test]
+    fn estimates_follow_each_operator_line() {
+        let plan = Plan::Limit {
+            input: Box::new(Plan::ReturnOne),
+            limit: Expression::Literal(crate::query::ast::Literal::Integer(1)),
+        };
+        let out = render_plan_with_estimates(&plan, &|plan| match plan {
+            Plan::ReturnOne => 1.0,
+            _ => 0.4,
+        });
+        assert_eq!(
+            out,
+            "Limit(limit=Literal(Integer(1))) est_rows=0\n  ReturnOne est_rows=1"
+        );
+    }
 }
@@ -1,27 +1,36 @@
-use super::{Error, PreparedQuery, Result, render_plan, strip_explain_prefix};
+use super::plan::optimizer::{optimize, reversed};
+use super::{Error, Plan, PreparedQuery, Result, strip_explain_prefix};
 
 pub(super) fn prepare(cypher: &str) -> Result<PreparedQuery> {
     if let Some(inner) = strip_explain_prefix(cypher) {
         if inner.is_empty() {
             return Err(Error::Other("EXPLAIN requires a query".into()));
         }
-        let query = crate::query::parser::Parser::parse(inner)?;
-        let logical = super::planner::build_logical(query);
-        let optimized = super::plan::optimizer::optimize(logical);
-        let physical = super::planner::build_physical(optimized)?;
-        let explain = Some(render_plan(&physical.plan));
+        let (plan, reversed) = compile(inner)?;
         return Ok(PreparedQuery {
-            plan: physical.plan,
-            explain,
+            plan,
+            reversed,
+            explain: true,
         });
     }
 
+    let (plan, reversed) = compile(cypher)?;
+    Ok(PreparedQuery {
+        plan,
+        reversed,
+        explain: false,
+    })
+}
+
+/// The plan of `cypher` and, when the optimizer leaves a hop order to
+/// execution, the plan with the other order.
+fn compile(cypher: &str) -> Result<(Plan, Option<Plan>)> {
     let query = crate::query::parser::Parser::parse(cypher)?;
     let logical = super::planner::build_logical(query);
-    let optimized = super::plan::optimizer::optimize(logical);
+    let optimized = optimize(logical);
+    let reversed = reversed(&optimized)
+        .and_then(|plan| super::planner::build_physical(plan).ok())
+        .map(|physical| physical.plan);
     let physical = super::planner::build_physical(optimized)?;
-    Ok(PreparedQuery {
-        plan: physical.plan,
-        explain: None,
-    })
+    Ok((physical.plan, reversed))
 }
@@ -1,6 +1,8 @@
 use super::{
-    Error, GraphSnapshot, Params, PreparedQuery, Result, Row, Value, execute_plan, execute_write,
+    Error, GraphSnapshot, Params, Plan, PreparedQuery, Result, Row, Value, execute_plan,
+    execute_write, render_plan_with_estimates,
 };
+use crate::query::executor::Estimator;
 
 impl PreparedQuery {
     /// Executes a read query and returns a streaming iterator.
@@ -23,14 +25,16 @@ impl PreparedQuery {
         snapshot: &'a S,
         params: &'a Params,
     ) -> impl Iterator<Item = Result<Row>> + 'a {
-        if let Some(plan) = &self.explain {
+        let estimator = Estimator::new(snapshot, params);
+        if self.explain {
+            let plan = self.render(&estimator);
             let it: Box<dyn Iterator<Item = Result<Row>> + 'a> = Box::new(std::iter::once(Ok(
-                Row::default().with("plan", Value::String(plan.clone())),
+                Row::default().with("plan", Value::String(plan)),
             )));
             return it;
         }
         params.begin_execution();
-        Box::new(execute_plan(snapshot, &self.plan, params))
+        Box::new(execute_plan(snapshot, self.plan_for(&estimator), params))
     }
 
     /// Executes a write query (CREATE/DELETE) with a write transaction.
@@ -51,21 +55,44 @@ impl PreparedQuery {
         txn: &mut impl crate::query::executor::WriteableGraph,
         params: &Params,
     ) -> Result<u32> {
-        if self.explain.is_some() {
+        if self.explain {
             return Err(Error::Other(
                 "EXPLAIN cannot be executed as a write query".into(),
             ));
         }
         params.begin_execution();
-        execute_write(&self.plan, snapshot, txn, params)
+        let chosen = self.plan_for(&Estimator::new(snapshot, params));
+        execute_write(chosen, snapshot, txn, params)
+    }
+
+    /// The compiled plan, or its reversed hop order when that is estimated
+    /// to read fewer rows. Ties keep the optimizer's order.
+    fn plan_for<S: GraphSnapshot>(&self, estimator: &Estimator<'_, S>) -> &Plan {
+        match &self.reversed {
+            Some(reversed) if estimator.cost(reversed) < estimator.cost(&self.plan) => reversed,
+            _ => &self.plan,
+        }
+    }
+
+    /// The chosen plan with `est_rows` after each operator.
+    fn render<S: GraphSnapshot>(&self, estimator: &Estimator<'_, S>) -> String {
+        render_plan_with_estimates(self.plan_for(estimator), &|plan| estimator.rows(plan))
     }
 
     pub fn is_explain(&self) -> bool {
-        self.explain.is_some()
+        self.explain
     }
 
-    /// Returns the explained plan string if this query was an EXPLAIN query.
-    pub fn explain_string(&self) -> Option<&str> {
-        self.explain.as_deref()
+    /// Returns the explained plan string if this query was an EXPLAIN query:
+    /// the plan `execute_streaming` would run against `snapshot` with
+    /// `params`, with its estimates. It is the same text as the `plan`
+    /// column of the EXPLAIN row.
+    pub fn explain_string_for<S: GraphSnapshot>(
+        &self,
+        snapshot: &S,
+        params: &Params,
+    ) -> Option<String> {
+        self.explain
+            .then(|| self.render(&Estimator::new(snapshot, params)))
     }
 }
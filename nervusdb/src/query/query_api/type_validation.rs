@@ -316,6 +316,8 @@ fn is_supported_function_name(name: &str) -> bool {
             | "right"
             | "replace"
             | "split"
+            | "textmatch"
+            | "textphrase"
             | "coalesce"
             | "sqrt"
             | "sign"
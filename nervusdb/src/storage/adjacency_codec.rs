@@ -0,0 +1,366 @@
+//! Value codecs for packed adjacency lists.
+//!
+//! Every adjacency value starts with a header byte. The low nibble carries
+//! record flags (see `ADJ_FLAG_CONTINUED`); the high nibble names the codec of
+//! the body that follows:
+//!
+//! ```text
+//! ADJ_CODEC_RAW     repeated id:u32 BE
+//! ADJ_CODEC_PACKED  [count:u32 BE] block*
+//!   block           [first:u32 BE][width:u8][bit-packed (delta - 1) * (n - 1)]
+//! ```
+//!
+//! Packed blocks hold up to `PACKED_BLOCK_LEN` sorted ids. Each gap to the
+//! previous id is stored minus one (ids are unique) with a fixed per-block bit
+//! width, least-significant bit first. The encoder picks whichever codec is
+//! smaller, so short lists stay raw and point reads stay cheap.
+
+use crate::api::InternalNodeId;
+
+pub(crate) const ADJ_FLAGS_MASK: u8 = 0x0f;
+pub(crate) const ADJ_CODEC_MASK: u8 = 0xf0;
+pub(crate) const ADJ_CODEC_RAW: u8 = 0x00;
+pub(crate) const ADJ_CODEC_PACKED: u8 = 0x10;
+
+const PACKED_BLOCK_LEN: usize = 128;
+/// Packed bodies are copied into a buffer with this much zeroed tail so the
+/// unpack loop can always load a full `u64` without bounds branches.
+const UNPACK_SLACK: usize = 8;
+
+pub(crate) fn encode(flags: u8, nodes: &[InternalNodeId]) -> Vec<u8> {
+    debug_assert_eq!(flags & ADJ_CODEC_MASK, 0);
+    let flags = flags & ADJ_FLAGS_MASK;
+    let raw_len = nodes.len() * 4;
+    match packed_len(nodes) {
+        Some(packed) if packed < raw_len => encode_packed(flags, nodes, packed),
+        _ => encode_raw(flags, nodes),
+    }
+}
+
+/// Decodes a value into its record flags and neighbor ids.
+pub(crate) fn decode(bytes: &[u8]) -> Option<(u8, Vec<InternalNodeId>)> {
+    let (&header, body) = bytes.split_first()?;
+    let flags = header & ADJ_FLAGS_MASK;
+    let nodes = match header & ADJ_CODEC_MASK {
+        ADJ_CODEC_RAW => decode_raw(body)?,
+        ADJ_CODEC_PACKED => decode_packed(body)?,
+        _ => return None,
+    };
+    Some((flags, nodes))
+}
+
+/// Returns the neighbor count without materializing the ids.
+pub(crate) fn count(bytes: &[u8]) -> Option<usize> {
+    let (&header, body) = bytes.split_first()?;
+    match header & ADJ_CODEC_MASK {
+        ADJ_CODEC_RAW if body.len() % 4 == 0 => Some(body.len() / 4),
+        ADJ_CODEC_PACKED => Some(read_u32(body, 0)? as usize),
+        _ => None,
+    }
+}
+
+fn encode_raw(flags: u8, nodes: &[InternalNodeId]) -> Vec<u8> {
+    let mut out = Vec::with_capacity(1 + nodes.len() * 4);
+    out.push(flags | ADJ_CODEC_RAW);
+    for node in nodes {
+        out.extend_from_slice(&node.to_be_bytes());
+    }
+    out
+}
+
+fn decode_raw(body: &[u8]) -> Option<Vec<InternalNodeId>> {
+    let chunks = body.chunks_exact(4);
+    if !chunks.remainder().is_empty() {
+        return None;
+    }
+    Some(
+        chunks
+            .map(|chunk| u32::from_be_bytes([chunk[0], chunk[1], chunk[2], chunk[3]]))
+            .collect(),
+    )
+}
+
+/// Bit width needed for the gaps of one block, or `None` when the ids are not
+/// strictly increasing.
+fn block_width(block: &[InternalNodeId]) -> Option<u32> {
+    let mut max_gap = 0u32;
+    for pair in block.windows(2) {
+        let gap = pair[1].checked_sub(pair[0])?.checked_sub(1)?;
+        max_gap |= gap;
+    }
+    Some(u32::BITS - max_gap.leading_zeros())
+}
+
+fn packed_block_bytes(n: usize, width: u32) -> usize {
+    5 + ((n - 1) * width as usize).div_ceil(8)
+}
+
+fn packed_len(nodes: &[InternalNodeId]) -> Option<usize> {
+    if nodes.is_empty() {
+        return None;
+    }
+    let mut len = 4;
+    for block in nodes.chunks(PACKED_BLOCK_LEN) {
+        len += packed_block_bytes(block.len(), block_width(block)?);
+    }
+    Some(len)
+}
+
+fn encode_packed(flags: u8, nodes: &[InternalNodeId], body_len: usize) -> Vec<u8> {
+    let mut out = Vec::with_capacity(1 + body_len);
+    out.push(flags | ADJ_CODEC_PACKED);
+    out.extend_from_slice(&(nodes.len() as u32).to_be_bytes());
+    for block in nodes.chunks(PACKED_BLOCK_LEN) {
+        let width = block_width(block).expect("packed_len checked block order");
+        out.extend_from_slice(&block[0].to_be_bytes());
+        out.push(width as u8);
+        let mut acc = 0u64;
+        let mut bits = 0u32;
+        for pair in block.windows(2) {
+            acc |= u64::from(pair[1] - pair[0] - 1) << bits;
+            bits += width;
+            while bits >= 8 {
+                out.push(acc as u8);
+                acc >>= 8;
+                bits -= 8;
+            }
+        }
+        if bits > 0 {
+            out.push(acc as u8);
+        }
+    }
+    out
+}
+
+fn decode_packed(body: &[u8]) -> Option<Vec<InternalNodeId>> {
+    let count = read_u32(body, 0)? as usize;
+    // Every block costs at least five bytes, so a corrupt count cannot force a
+    // larger allocation than the body could describe.
+    let mut nodes = Vec::with_capacity(count.min(PACKED_BLOCK_LEN * (body.len() / 5 + 1)));
+    let mut block = [0u32; PACKED_BLOCK_LEN];
+    let mut pos = 4;
+    while nodes.len() < count {
+        let n = (count - nodes.len()).min(PACKED_BLOCK_LEN);
+        pos = decode_block(body, pos, &mut block[..n])?;
+        nodes.extend_from_slice(&block[..n]);
+    }
+    (pos == body.len()).then_some(nodes)
+}
+
+/// Decodes the packed block at `pos` into `out` and returns the position of
+/// the next block.
+fn decode_block(body: &[u8], pos: usize, out: &mut [InternalNodeId]) -> Option<usize> {
+    let n = out.len();
+    let first = read_u32(body, pos)?;
+    let width = u32::from(*body.get(pos + 4)?);
+    if width > 32 {
+        return None;
+    }
+    let packed_bytes = packed_block_bytes(n, width) - 5;
+    let packed = body.get(pos + 5..pos + 5 + packed_bytes)?;
+    let mut scratch = [0u8; PACKED_BLOCK_LEN * 4 + UNPACK_SLACK];
+    scratch[..packed_bytes].copy_from_slice(packed);
+    out[0] = first;
+    unpack_gaps(&scratch, width, &mut out[1..]);
+    prefix_sum(out)?;
+    Some(pos + 5 + packed_bytes)
+}
+
+/// Unpacks fixed-width gaps. Every lane is an independent shift-and-mask of
+/// one unaligned `u64` load, so the loop has no carried state and compiles to
+/// straight-line vector code on targets with wide registers.
+#[inline]
+fn unpack_gaps(packed: &[u8], width: u32, out: &mut [u32]) {
+    let mask = if width == 32 {
+        u32::MAX as u64
+    } else {
+        (1u64 << width) - 1
+    };
+    for (i, gap) in out.iter_mut().enumerate() {
+        let bit = i * width as usize;
+        let byte = bit / 8;
+        let word = u64::from_le_bytes(
+            packed[byte..byte + 8]
+                .try_into()
+                .expect("scratch has unpack slack"),
+        );
+        *gap = ((word >> (bit % 8)) & mask) as u32;
+    }
+}
+
+/// Turns `[first, gap - 1, gap - 1, ...]` into ids in place. The running sum
+/// is done in lanes of four so the carry chain is one add per lane group.
+#[inline]
+fn prefix_sum(ids: &mut [InternalNodeId]) -> Option<()> {
+    let (first, gaps) = ids.split_first_mut()?;
+    let mut current = u64::from(*first);
+    let mut lanes = gaps.chunks_exact_mut(4);
+    for lane in &mut lanes {
+        let a = current + u64::from(lane[0]) + 1;
+        let b = a + u64::from(lane[1]) + 1;
+        let c = b + u64::from(lane[2]) + 1;
+        let d = c + u64::from(lane[3]) + 1;
+        if d > u64::from(u32::MAX) {
+            return None;
+        }
+        lane.copy_from_slice(&[a as u32, b as u32, c as u32, d as u32]);
+        current = d;
+    }
+    for gap in lanes.into_remainder() {
+        current += u64::from(*gap) + 1;
+        if current > u64::from(u32::MAX) {
+            return None;
+        }
+        *gap = current as u32;
+    }
+    Some(())
+}
+
+fn read_u32(bytes: &[u8], pos: usize) -> Option<u32> {
+    let raw: [u8; 4] = bytes.get(pos..pos + 4)?.try_into().ok()?;
+    Some(u32::from_be_bytes(raw))
+}
+
+/// Lazy decoder over one encoded adjacency value.
+///
+/// Holds the value bytes (typically a reference-counted Fjall slice) and
+/// decodes at most one packed block at a time into an inline buffer, so
+/// walking a list performs no heap allocation.
+pub(crate) struct AdjacencyCursor<B> {
+    bytes: B,
+    codec: u8,
+    pos: usize,
+    remaining: usize,
+    block: [InternalNodeId; PACKED_BLOCK_LEN],
+    block_len: usize,
+    block_pos: usize,
+}
+
+impl<B: AsRef<[u8]>> AdjacencyCursor<B> {
+    /// Returns the record flags and a cursor positioned before the first id,
+    /// or `None` when the header or length framing is malformed.
+    pub(crate) fn new(bytes: B) -> Option<(u8, Self)> {
+        let value = bytes.as_ref();
+        let header = *value.first()?;
+        let codec = header & ADJ_CODEC_MASK;
+        let (pos, remaining) = match codec {
+            ADJ_CODEC_RAW if (value.len() - 1) % 4 == 0 => (1, (value.len() - 1) / 4),
+            ADJ_CODEC_PACKED => (5, read_u32(value, 1)? as usize),
+            _ => return None,
+        };
+        Some((
+            header & ADJ_FLAGS_MASK,
+            Self {
+                bytes,
+                codec,
+                pos,
+                remaining,
+                block: [0; PACKED_BLOCK_LEN],
+                block_len: 0,
+                block_pos: 0,
+            },
+        ))
+    }
+}
+
+impl<B: AsRef<[u8]>> Iterator for AdjacencyCursor<B> {
+    type Item = InternalNodeId;
+
+    fn next(&mut self) -> Option<InternalNodeId> {
+        if self.block_pos < self.block_len {
+            let id = self.block[self.block_pos];
+            self.block_pos += 1;
+            return Some(id);
+        }
+        if self.remaining == 0 {
+            return None;
+        }
+        let value = self.bytes.as_ref();
+        if self.codec == ADJ_CODEC_RAW {
+            let id = read_u32(value, self.pos)?;
+            self.pos += 4;
+            self.remaining -= 1;
+            return Some(id);
+        }
+        let n = self.remaining.min(PACKED_BLOCK_LEN);
+        // The packed body starts after the header byte.
+        let Some(next) = decode_block(&value[1..], self.pos - 1, &mut self.block[..n]) else {
+            self.remaining = 0;
+            return None;
+        };
+        self.pos = next + 1;
+        self.remaining -= n;
+        self.block_len = n;
+        self.block_pos = 1;
+        Some(self.block[0])
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        let len = self.remaining + (self.block_len - self.block_pos);
+        (0, Some(len))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn roundtrip(flags: u8, nodes: &[InternalNodeId]) -> Vec<u8> {
+        let bytes = encode(flags, nodes);
+        assert_eq!(decode(&bytes), Some((flags, nodes.to_vec())));
+        assert_eq!(count(&bytes), Some(nodes.len()));
+        let (cursor_flags, cursor) = AdjacencyCursor::new(bytes.as_slice()).unwrap();
+        assert_eq!(cursor_flags, flags);
+        assert_eq!(cursor.collect::<Vec<_>>(), nodes);
+        bytes
+    }
+
+    #[test]
+    fn short_lists_stay_raw() {
+        assert_eq!(roundtrip(0, &[]), vec![ADJ_CODEC_RAW]);
+        let bytes = roundtrip(1, &[7]);
+        assert_eq!(bytes[0], 1 | ADJ_CODEC_RAW);
+        assert_eq!(bytes.len(), 5);
+    }
+
+    #[test]
+    fn dense_lists_pack_smaller_than_raw() {
+        let nodes = (1_000..3_000).step_by(3).collect::<Vec<_>>();
+        let bytes = roundtrip(0, &nodes);
+        assert_eq!(bytes[0] & ADJ_CODEC_MASK, ADJ_CODEC_PACKED);
+        assert!(bytes.len() * 8 < nodes.len() * 4);
+    }
+
+    #[test]
+    fn packed_codec_handles_every_width_and_partial_blocks() {
+        for width in 0..=32u32 {
+            let gap = if width == 0 {
+                1
+            } else {
+                (1u32 << (width - 1)) + 1
+            };
+            let mut nodes = vec![3u32];
+            while nodes.len() < PACKED_BLOCK_LEN + 17 {
+                match nodes[nodes.len() - 1].checked_add(gap) {
+                    Some(next) => nodes.push(next),
+                    None => break,
+                }
+            }
+            assert_eq!(block_width(&nodes[..2]), Some(width));
+            let bytes = encode_packed(1, &nodes, packed_len(&nodes).unwrap());
+            assert_eq!(decode(&bytes), Some((1, nodes.clone())), "width {width}");
+            roundtrip(0, &nodes);
+        }
+        roundtrip(0, &[0, u32::MAX]);
+    }
+
+    #[test]
+    fn decode_rejects_truncated_or_unknown_values() {
+        let nodes = (0..500).map(|i| i * 2).collect::<Vec<_>>();
+        let bytes = encode(0, &nodes);
+        assert_eq!(bytes[0] & ADJ_CODEC_MASK, ADJ_CODEC_PACKED);
+        assert_eq!(decode(&bytes[..bytes.len() - 1]), None);
+        assert_eq!(decode(&[0xf0]), None);
+        assert_eq!(decode(&[ADJ_CODEC_RAW, 1, 2]), None);
+    }
+}
@@ -0,0 +1,175 @@
+//! Directory of adjacency lists that still have unmerged delta records.
+//!
+//! Edge writes against an existing node append a delta record instead of
+//! rewriting the packed list. Readers must apply those records, but probing
+//! `graph_data` for deltas on every hop would turn the point read of ADR 0010
+//! back into a prefix scan. The engine therefore keeps the set of lists with
+//! pending deltas in memory and hands each snapshot an immutable copy.
+
+use crate::api::{InternalNodeId, RelTypeId};
+use crate::storage::Result;
+use crate::storage::layout::{AdjDirection, adj_delta_scan_prefix, parse_adj_delta_key};
+use fjall::Keyspace;
+use std::collections::{BTreeMap, HashMap};
+use std::sync::{Arc, Mutex};
+
+/// A list is folded once it has accumulated this many delta records.
+pub(crate) const ADJ_DELTA_MERGE_RECORDS: u32 = 16;
+/// Every pending list is folded once this many lists carry deltas.
+pub(crate) const ADJ_DELTA_MERGE_LISTS: usize = 1024;
+
+pub(crate) type AdjacencyList = (AdjDirection, InternalNodeId, RelTypeId);
+
+/// Immutable view of the lists with pending deltas.
+///
+/// `generation` changes only when lists are forgotten after a merge; see
+/// [`DeltaDirectory::pin`] for why that is the one transition readers must
+/// detect.
+#[derive(Debug, Clone, Default)]
+pub(crate) struct PendingDeltas {
+    generation: u64,
+    next_seq: u64,
+    lists: HashMap<(AdjDirection, InternalNodeId), BTreeMap<RelTypeId, u32>>,
+    list_count: usize,
+}
+
+impl PendingDeltas {
+    pub(crate) fn has_node(&self, dir: AdjDirection, node: InternalNodeId) -> bool {
+        self.lists.contains_key(&(dir, node))
+    }
+
+    pub(crate) fn has_list(&self, dir: AdjDirection, node: InternalNodeId, rel: RelTypeId) -> bool {
+        self.lists
+            .get(&(dir, node))
+            .is_some_and(|rels| rels.contains_key(&rel))
+    }
+
+    pub(crate) fn rels(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+    ) -> impl Iterator<Item = RelTypeId> + '_ {
+        self.lists
+            .get(&(dir, node))
+            .into_iter()
+            .flat_map(|rels| rels.keys().copied())
+    }
+
+    pub(crate) fn lists(&self) -> impl Iterator<Item = AdjacencyList> + '_ {
+        self.lists
+            .iter()
+            .flat_map(|((dir, node), rels)| rels.keys().map(move |rel| (*dir, *node, *rel)))
+    }
+}
+
+#[derive(Debug, Default)]
+pub(crate) struct DeltaDirectory {
+    current: Mutex<Arc<PendingDeltas>>,
+}
+
+impl DeltaDirectory {
+    /// Rebuilds the directory from the delta records persisted in `graph_data`.
+    pub(crate) fn load(graph_data: &Keyspace) -> Result<Self> {
+        let mut pending = PendingDeltas::default();
+        for guard in graph_data.prefix(adj_delta_scan_prefix()) {
+            let key = guard.key()?;
+            let Some((dir, node, rel, seq)) = parse_adj_delta_key(key.as_ref()) else {
+                continue;
+            };
+            pending.next_seq = pending.next_seq.max(seq.saturating_add(1));
+            let records = pending
+                .lists
+                .entry((dir, node))
+                .or_default()
+                .entry(rel)
+                .or_insert(0);
+            if *records == 0 {
+                pending.list_count += 1;
+            }
+            *records += 1;
+        }
+        Ok(Self {
+            current: Mutex::new(Arc::new(pending)),
+        })
+    }
+
+    pub(crate) fn current(&self) -> Arc<PendingDeltas> {
+        self.current.lock().unwrap().clone()
+    }
+
+    /// Pins a directory view consistent with a storage snapshot.
+    ///
+    /// Lists are recorded before their delta batch commits and forgotten only
+    /// after the merge batch commits, so a view loaded after the snapshot is
+    /// a superset of what the snapshot needs unless a merge finished in
+    /// between. A changed generation detects that case and retries.
+    pub(crate) fn pin<T>(&self, mut open: impl FnMut() -> T) -> (T, Arc<PendingDeltas>) {
+        loop {
+            let before = self.current().generation;
+            let inner = open();
+            let pending = self.current();
+            if pending.generation == before {
+                return (inner, pending);
+            }
+        }
+    }
+
+    /// Registers one delta record for each list and returns its sequence number.
+    pub(crate) fn record(&self, lists: impl IntoIterator<Item = AdjacencyList>) -> u64 {
+        let mut current = self.current.lock().unwrap();
+        let pending = Arc::make_mut(&mut current);
+        let seq = pending.next_seq;
+        pending.next_seq += 1;
+        for (dir, node, rel) in lists {
+            let records = pending
+                .lists
+                .entry((dir, node))
+                .or_default()
+                .entry(rel)
+                .or_insert(0);
+            if *records == 0 {
+                pending.list_count += 1;
+            }
+            *records = records.saturating_add(1);
+        }
+        seq
+    }
+
+    /// Drops lists whose deltas were folded by a committed merge batch.
+    pub(crate) fn forget(&self, lists: &[AdjacencyList]) {
+        if lists.is_empty() {
+            return;
+        }
+        let mut current = self.current.lock().unwrap();
+        let pending = Arc::make_mut(&mut current);
+        pending.generation += 1;
+        for (dir, node, rel) in lists {
+            let Some(rels) = pending.lists.get_mut(&(*dir, *node)) else {
+                continue;
+            };
+            if rels.remove(rel).is_some() {
+                pending.list_count -= 1;
+            }
+            if rels.is_empty() {
+                pending.lists.remove(&(*dir, *node));
+            }
+        }
+    }
+
+    /// Lists the merge policy wants folded now.
+    pub(crate) fn due(&self) -> Vec<AdjacencyList> {
+        let pending = self.current();
+        if pending.list_count >= ADJ_DELTA_MERGE_LISTS {
+            return pending.lists().collect();
+        }
+        pending
+            .lists
+            .iter()
+            .flat_map(|((dir, node), rels)| {
+                rels.iter()
+                    .filter(|(_, records)| **records >= ADJ_DELTA_MERGE_RECORDS)
+                    .map(move |(rel, _)| (*dir, *node, *rel))
+            })
+            .collect()
+    }
+}
@@ -0,0 +1,97 @@
+//! Declared composite node property indexes.
+//!
+//! A composite index covers an ordered list of property keys of one label. Its
+//! entries concatenate the order-preserving values of every key (see
+//! `ordered_value.rs`), so equality on any leading run of keys is one prefix
+//! probe:
+//!
+//! ```text
+//! 0x52 COMPOSITE_INDEX_DEF [tag][label][count:u8][key_id]* -> empty
+//! 0x53 COMPOSITE_INDEX     [tag][label][count:u8][key_id]*[value]*[iid] -> empty
+//! ```
+//!
+//! A node has an entry when its first key holds a scalar. Later keys the node
+//! lacks are stored as null, so a probe on a leading prefix still finds every
+//! node that matches it.
+
+use crate::api::{InternalNodeId, LabelId, PropertyValue};
+use crate::storage::Result;
+use crate::storage::engine::scalar_indexable_value;
+use crate::storage::layout::{
+    composite_index_def_scan_prefix, composite_index_key, parse_composite_index_def_key,
+};
+use crate::storage::property_keys::PropertyKeyId;
+use fjall::Keyspace;
+use std::collections::{BTreeMap, BTreeSet};
+use std::sync::{RwLock, RwLockReadGuard};
+
+/// Declared key lists per label.
+pub(crate) type CompositeDefs = BTreeMap<LabelId, Vec<Vec<PropertyKeyId>>>;
+
+/// Resident copy of the declarations, used by commits to maintain entries.
+///
+/// Snapshots read declarations from their own view instead, so a snapshot
+/// opened before an index was built never probes it.
+#[derive(Debug, Default)]
+pub(crate) struct CompositeIndexes {
+    defs: RwLock<CompositeDefs>,
+}
+
+impl CompositeIndexes {
+    pub(crate) fn load(graph_data: &Keyspace) -> Result<Self> {
+        let mut defs = CompositeDefs::new();
+        for guard in graph_data.prefix(composite_index_def_scan_prefix()) {
+            let key = guard.key()?;
+            if let Some((label, keys)) = parse_composite_index_def_key(key.as_ref()) {
+                defs.entry(label).or_default().push(keys);
+            }
+        }
+        Ok(Self {
+            defs: RwLock::new(defs),
+        })
+    }
+
+    pub(crate) fn read(&self) -> RwLockReadGuard<'_, CompositeDefs> {
+        self.defs.read().unwrap()
+    }
+
+    pub(crate) fn contains(&self, label: LabelId, keys: &[PropertyKeyId]) -> bool {
+        self.read()
+            .get(&label)
+            .is_some_and(|declared| declared.iter().any(|found| found == keys))
+    }
+
+    /// Publishes a declaration whose entries are committed. Callers must hold
+    /// `write_lock`.
+    pub(crate) fn insert(&self, label: LabelId, keys: Vec<PropertyKeyId>) {
+        self.defs
+            .write()
+            .unwrap()
+            .entry(label)
+            .or_default()
+            .push(keys);
+    }
+}
+
+/// Entries `node` should have given its labels and properties.
+pub(crate) fn composite_index_keys<'l>(
+    node: InternalNodeId,
+    labels: impl IntoIterator<Item = &'l LabelId>,
+    props: &BTreeMap<PropertyKeyId, PropertyValue>,
+    defs: &CompositeDefs,
+) -> BTreeSet<Vec<u8>> {
+    let mut out = BTreeSet::new();
+    for label in labels {
+        for keys in defs.get(label).into_iter().flatten() {
+            if !props.get(&keys[0]).is_some_and(scalar_indexable_value) {
+                continue;
+            }
+            let values: Vec<&PropertyValue> = keys
+                .iter()
+                .map(|key| props.get(key).unwrap_or(&PropertyValue::Null))
+                .collect();
+            out.insert(composite_index_key(*label, keys, &values, node));
+        }
+    }
+    out
+}
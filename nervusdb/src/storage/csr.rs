@@ -0,0 +1,399 @@
+//! In-memory CSR projection of the adjacency keyspaces.
+//!
+//! A [`CsrSnapshot`] copies `adj_out` and `adj_in` of one storage snapshot into
+//! contiguous offset and target arrays, so traversal stops paying an LSM read
+//! per hop. Everything else (labels, properties, names) is still read from the
+//! pinned storage snapshot, so both halves describe the same commit.
+
+use crate::api::{
+    EdgeKey, ExternalId, GraphSnapshot, InternalNodeId, LabelId, PropertyValue, RelTypeId,
+};
+use crate::storage::layout::AdjDirection;
+use crate::storage::profile;
+use crate::storage::snapshot::Snapshot;
+use std::collections::BTreeMap;
+
+/// Node-id ranges smaller than this are not worth a dedicated build thread.
+const CSR_MIN_NODES_PER_THREAD: u32 = 4096;
+
+/// Compressed sparse rows for one direction.
+///
+/// Edges of node `n` occupy `offsets[n]..offsets[n + 1]` of `rels` and
+/// `targets`, sorted by `(rel, target)` exactly like the packed lists.
+#[derive(Debug, Default)]
+struct CsrAdjacency {
+    offsets: Vec<usize>,
+    rels: Vec<RelTypeId>,
+    targets: Vec<InternalNodeId>,
+}
+
+/// Edges of one contiguous node-id range, built by a single thread.
+#[derive(Debug, Default)]
+struct CsrChunk {
+    degrees: Vec<usize>,
+    rels: Vec<RelTypeId>,
+    targets: Vec<InternalNodeId>,
+}
+
+impl CsrAdjacency {
+    fn build(snapshot: &Snapshot, dir: AdjDirection, bound: u32, threads: u32) -> Self {
+        let span = bound.div_ceil(threads).max(1);
+        let chunks = std::thread::scope(|scope| {
+            let workers = (0..threads)
+                .map(|i| {
+                    let lo = (i * span).min(bound);
+                    let hi = lo.saturating_add(span).min(bound);
+                    scope.spawn(move || {
+                        let mut chunk = CsrChunk {
+                            degrees: vec![0; (hi - lo) as usize],
+                            ..CsrChunk::default()
+                        };
+                        snapshot.for_each_adjacency_in_range(dir, lo, hi, |node, rel, other| {
+                            chunk.degrees[(node - lo) as usize] += 1;
+                            chunk.rels.push(rel);
+                            chunk.targets.push(other);
+                        });
+                        chunk
+                    })
+                })
+                .collect::<Vec<_>>();
+            workers
+                .into_iter()
+                .map(|worker| worker.join().expect("CSR build thread panicked"))
+                .collect::<Vec<_>>()
+        });
+
+        let edges = chunks.iter().map(|chunk| chunk.targets.len()).sum();
+        let mut csr = Self {
+            offsets: Vec::with_capacity(bound as usize + 1),
+            rels: Vec::with_capacity(edges),
+            targets: Vec::with_capacity(edges),
+        };
+        csr.offsets.push(0);
+        for chunk in chunks {
+            for degree in chunk.degrees {
+                let last = *csr.offsets.last().expect("offsets start at zero");
+                csr.offsets.push(last + degree);
+            }
+            csr.rels.extend(chunk.rels);
+            csr.targets.extend(chunk.targets);
+        }
+        csr
+    }
+
+    fn slice(&self, node: InternalNodeId, rel: Option<RelTypeId>) -> (usize, usize) {
+        let node = node as usize;
+        if node + 1 >= self.offsets.len() {
+            return (0, 0);
+        }
+        let (lo, hi) = (self.offsets[node], self.offsets[node + 1]);
+        match rel {
+            None => (lo, hi),
+            Some(rel) => {
+                let rels = &self.rels[lo..hi];
+                (
+                    lo + rels.partition_point(|found| *found < rel),
+                    lo + rels.partition_point(|found| *found <= rel),
+                )
+            }
+        }
+    }
+
+    fn count(&self, rel: Option<RelTypeId>) -> u64 {
+        match rel {
+            None => self.targets.len() as u64,
+            Some(rel) => self.rels.iter().filter(|found| **found == rel).count() as u64,
+        }
+    }
+}
+
+/// Read-only graph view whose adjacency lives in memory as CSR arrays.
+///
+/// Built by [`crate::Db::build_csr_view`] or [`crate::DbSnapshot::build_csr_view`].
+/// It implements [`GraphSnapshot`], so Mini-Cypher queries and traversal code
+/// run against it unchanged. It never observes commits made after the snapshot
+/// it was built from; build a new view to refresh it.
+pub struct CsrSnapshot {
+    snapshot: Snapshot,
+    out: CsrAdjacency,
+    inc: CsrAdjacency,
+}
+
+impl std::fmt::Debug for CsrSnapshot {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("CsrSnapshot")
+            .field("nodes", &self.out.offsets.len().saturating_sub(1))
+            .field("edges", &self.out.targets.len())
+            .finish_non_exhaustive()
+    }
+}
+
+impl CsrSnapshot {
+    /// Materializes both adjacency directions of `snapshot`, splitting the
+    /// node-id space across the available cores.
+    pub(crate) fn build(snapshot: Snapshot) -> Self {
+        let started = profile::start();
+        let bound = snapshot.node_id_bound();
+        let cores = std::thread::available_parallelism().map_or(1, |n| n.get()) as u32;
+        let threads = cores.min(bound / CSR_MIN_NODES_PER_THREAD).max(1);
+        let (out, inc) = std::thread::scope(|scope| {
+            let inc =
+                scope.spawn(|| CsrAdjacency::build(&snapshot, AdjDirection::In, bound, threads));
+            let out = CsrAdjacency::build(&snapshot, AdjDirection::Out, bound, threads);
+            (out, inc.join().expect("CSR build thread panicked"))
+        });
+        profile::event_since(
+            "CsrSnapshot::build",
+            started,
+            &[
+                ("nodes", u64::from(bound)),
+                ("threads", u64::from(threads) * 2),
+                ("out_edges", out.targets.len() as u64),
+                ("in_edges", inc.targets.len() as u64),
+            ],
+        );
+        Self { snapshot, out, inc }
+    }
+
+    /// Approximate heap footprint of the CSR arrays in bytes.
+    pub fn heap_bytes(&self) -> usize {
+        [&self.out, &self.inc]
+            .iter()
+            .map(|csr| {
+                csr.offsets.capacity() * std::mem::size_of::<usize>()
+                    + csr.rels.capacity() * std::mem::size_of::<RelTypeId>()
+                    + csr.targets.capacity() * std::mem::size_of::<InternalNodeId>()
+            })
+            .sum()
+    }
+
+    fn cursor(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> CsrNeighbors<'_> {
+        let csr = match dir {
+            AdjDirection::Out => &self.out,
+            AdjDirection::In => &self.inc,
+        };
+        let (lo, hi) = csr.slice(node, rel);
+        CsrNeighbors {
+            dir,
+            node,
+            edges: csr.rels[lo..hi].iter().zip(&csr.targets[lo..hi]),
+        }
+    }
+}
+
+/// Neighbor iterator of a [`CsrSnapshot`]; a walk over two array slices.
+#[derive(Debug, Clone)]
+pub struct CsrNeighbors<'a> {
+    dir: AdjDirection,
+    node: InternalNodeId,
+    edges: std::iter::Zip<std::slice::Iter<'a, RelTypeId>, std::slice::Iter<'a, InternalNodeId>>,
+}
+
+impl Iterator for CsrNeighbors<'_> {
+    type Item = EdgeKey;
+
+    #[inline]
+    fn next(&mut self) -> Option<Self::Item> {
+        let (rel, other) = self.edges.next()?;
+        Some(match self.dir {
+            AdjDirection::Out => EdgeKey {
+                src: self.node,
+                rel: *rel,
+                dst: *other,
+            },
+            AdjDirection::In => EdgeKey {
+                src: *other,
+                rel: *rel,
+                dst: self.node,
+            },
+        })
+    }
+
+    fn size_hint(&self) -> (usize, Option<usize>) {
+        self.edges.size_hint()
+    }
+}
+
+impl ExactSizeIterator for CsrNeighbors<'_> {}
+
+impl GraphSnapshot for CsrSnapshot {
+    type Neighbors<'a>
+        = CsrNeighbors<'a>
+    where
+        Self: 'a;
+
+    fn neighbors(&self, src: InternalNodeId, rel: Option<RelTypeId>) -> Self::Neighbors<'_> {
+        self.cursor(AdjDirection::Out, src, rel)
+    }
+
+    fn incoming_neighbors(
+        &self,
+        dst: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> Self::Neighbors<'_> {
+        self.cursor(AdjDirection::In, dst, rel)
+    }
+
+    fn nodes(&self) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot.nodes()
+    }
+
+    fn nodes_with_label(&self, label: LabelId) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot.nodes_with_label(label)
+    }
+
+    fn nodes_with_labels(
+        &self,
+        labels: &[LabelId],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot.nodes_with_labels(labels)
+    }
+
+    fn nodes_with_label_and_property(
+        &self,
+        label: LabelId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot
+            .nodes_with_label_and_property(label, key, value)
+    }
+
+    fn nodes_with_label_and_properties(
+        &self,
+        label: LabelId,
+        props: &[(&str, &PropertyValue)],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot.nodes_with_label_and_properties(label, props)
+    }
+
+    fn nodes_with_label_and_property_range(
+        &self,
+        label: LabelId,
+        key: &str,
+        lower: std::ops::Bound<&PropertyValue>,
+        upper: std::ops::Bound<&PropertyValue>,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot
+            .nodes_with_label_and_property_range(label, key, lower, upper)
+    }
+
+    fn nodes_with_label_and_terms(
+        &self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot.nodes_with_label_and_terms(label, key, query)
+    }
+
+    fn nodes_with_label_and_phrase(
+        &self,
+        label: LabelId,
+        key: &str,
+        phrase: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        self.snapshot
+            .nodes_with_label_and_phrase(label, key, phrase)
+    }
+
+    fn node_vector(&self, iid: InternalNodeId) -> Option<Vec<f32>> {
+        self.snapshot.node_vector(iid)
+    }
+
+    fn search_vectors(
+        &self,
+        query: &[f32],
+        k: usize,
+        label: Option<LabelId>,
+    ) -> Vec<(InternalNodeId, f32)> {
+        self.snapshot.search_vectors(query, k, label)
+    }
+
+    fn node_by_unique_property(
+        &self,
+        label: LabelId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Option<InternalNodeId> {
+        self.snapshot.node_by_unique_property(label, key, value)
+    }
+
+    fn edges_with_rel_and_property(
+        &self,
+        rel: RelTypeId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Box<dyn Iterator<Item = EdgeKey> + '_> {
+        self.snapshot.edges_with_rel_and_property(rel, key, value)
+    }
+
+    fn resolve_external(&self, iid: InternalNodeId) -> Option<ExternalId> {
+        self.snapshot.resolve_external(iid)
+    }
+
+    fn node_label(&self, iid: InternalNodeId) -> Option<LabelId> {
+        self.snapshot.node_label(iid)
+    }
+
+    fn resolve_node_labels(&self, iid: InternalNodeId) -> Option<Vec<LabelId>> {
+        GraphSnapshot::resolve_node_labels(&self.snapshot, iid)
+    }
+
+    fn is_tombstoned_node(&self, iid: InternalNodeId) -> bool {
+        self.snapshot.is_tombstoned_node(iid)
+    }
+
+    fn node_property(&self, iid: InternalNodeId, key: &str) -> Option<PropertyValue> {
+        self.snapshot.node_property(iid, key)
+    }
+
+    fn edge_property(&self, edge: EdgeKey, key: &str) -> Option<PropertyValue> {
+        self.snapshot.edge_property(edge, key)
+    }
+
+    fn node_properties(&self, iid: InternalNodeId) -> Option<BTreeMap<String, PropertyValue>> {
+        self.snapshot.node_properties(iid)
+    }
+
+    fn edge_properties(&self, edge: EdgeKey) -> Option<BTreeMap<String, PropertyValue>> {
+        self.snapshot.edge_properties(edge)
+    }
+
+    fn resolve_label_id(&self, name: &str) -> Option<LabelId> {
+        self.snapshot.resolve_label_id(name)
+    }
+
+    fn resolve_rel_type_id(&self, name: &str) -> Option<RelTypeId> {
+        self.snapshot.resolve_rel_type_id(name)
+    }
+
+    fn resolve_label_name(&self, id: LabelId) -> Option<String> {
+        self.snapshot.resolve_label_name(id)
+    }
+
+    fn resolve_rel_type_name(&self, id: RelTypeId) -> Option<String> {
+        self.snapshot.resolve_rel_type_name(id)
+    }
+
+    fn node_count(&self, label: Option<LabelId>) -> u64 {
+        GraphSnapshot::node_count(&self.snapshot, label)
+    }
+
+    fn edge_count(&self, rel: Option<RelTypeId>) -> u64 {
+        self.out.count(rel)
+    }
+
+    fn property_distinct_count(&self, label: LabelId, key: &str) -> Option<u64> {
+        self.snapshot.property_distinct_count(label, key)
+    }
+
+    fn average_degree(&self, label: LabelId, rel: RelTypeId, incoming: bool) -> Option<f64> {
+        self.snapshot.average_degree(label, rel, incoming)
+    }
+}
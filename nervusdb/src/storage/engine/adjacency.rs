@@ -0,0 +1,294 @@
+use crate::api::{InternalNodeId, RelTypeId};
+use crate::storage::layout::*;
+use crate::storage::snapshot::Snapshot;
+use std::collections::{BTreeMap, HashSet};
+
+/// Key write produced when a staged adjacency list is finalized; `None` removes
+/// the key.
+pub(super) type AdjacencyWrite = (Vec<u8>, Option<Vec<u8>>);
+
+/// Key writes of a new list holding exactly `nodes`, which must be sorted and
+/// distinct. The layout matches a created list that `StagedAdjacency`
+/// finalizes after the same inserts: one base record, split into half-full
+/// overflow buckets once it outgrows a bucket.
+pub(super) fn packed_list_writes(
+    dir: AdjDirection,
+    node: InternalNodeId,
+    rel: RelTypeId,
+    nodes: &[InternalNodeId],
+) -> Vec<AdjacencyWrite> {
+    if nodes.len() <= ADJ_BUCKET_CAPACITY {
+        return vec![(
+            dir.base_key(node, rel),
+            Some(encode_adjacent_nodes(0, nodes)),
+        )];
+    }
+    let (base, tail) = nodes.split_at(ADJ_BUCKET_CAPACITY / 2);
+    let mut writes = vec![(
+        dir.base_key(node, rel),
+        Some(encode_adjacent_nodes(ADJ_FLAG_CONTINUED, base)),
+    )];
+    for bucket in tail.chunks(ADJ_BUCKET_CAPACITY / 2) {
+        writes.push((
+            adj_bucket_key(node, rel, bucket[0]),
+            Some(encode_adjacent_nodes(0, bucket)),
+        ));
+    }
+    writes
+}
+
+#[derive(Debug)]
+struct StagedBucket {
+    nodes: Vec<InternalNodeId>,
+    /// Fence of the next bucket at load time; bounds which ids this bucket owns.
+    upper: Option<u32>,
+    persisted: bool,
+    dirty: bool,
+}
+
+/// Commit-time view of one `(node, rel)` adjacency list.
+///
+/// Only the buckets touched by the transaction are loaded. The base record is
+/// always staged under fence `0`; overflow buckets are staged under their own
+/// fence and written back independently, so an insert into a supernode rewrites
+/// one bucket instead of the whole list.
+#[derive(Debug)]
+pub(super) struct StagedAdjacency {
+    dir: AdjDirection,
+    node: InternalNodeId,
+    rel: RelTypeId,
+    persisted_flags: Option<u8>,
+    buckets: BTreeMap<u32, StagedBucket>,
+    removed: HashSet<u32>,
+}
+
+impl StagedAdjacency {
+    pub(super) fn load(
+        snapshot: &Snapshot,
+        created: bool,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+    ) -> Self {
+        let base = if created {
+            None
+        } else {
+            snapshot.adjacency_base(dir, node, rel)
+        };
+        let persisted_flags = base.as_ref().map(|(flags, _)| *flags);
+        let upper = match persisted_flags {
+            Some(flags) if flags & ADJ_FLAG_CONTINUED != 0 => {
+                snapshot.next_adjacency_fence(dir, node, rel, 1)
+            }
+            _ => None,
+        };
+        let mut buckets = BTreeMap::new();
+        buckets.insert(
+            0,
+            StagedBucket {
+                nodes: base.map(|(_, nodes)| nodes).unwrap_or_default(),
+                upper,
+                persisted: persisted_flags.is_some(),
+                dirty: false,
+            },
+        );
+        Self {
+            dir,
+            node,
+            rel,
+            persisted_flags,
+            buckets,
+            removed: HashSet::new(),
+        }
+    }
+
+    pub(super) fn insert(&mut self, snapshot: &Snapshot, other: InternalNodeId) {
+        let bucket = self.bucket_for(snapshot, other);
+        if let Err(idx) = bucket.nodes.binary_search(&other) {
+            bucket.nodes.insert(idx, other);
+            bucket.dirty = true;
+        }
+    }
+
+    pub(super) fn remove(&mut self, snapshot: &Snapshot, other: InternalNodeId) {
+        let bucket = self.bucket_for(snapshot, other);
+        if let Ok(idx) = bucket.nodes.binary_search(&other) {
+            bucket.nodes.remove(idx);
+            bucket.dirty = true;
+        }
+    }
+
+    fn bucket_for(&mut self, snapshot: &Snapshot, other: InternalNodeId) -> &mut StagedBucket {
+        let (fence, upper) = self
+            .buckets
+            .range(..=other)
+            .next_back()
+            .map(|(fence, bucket)| (*fence, bucket.upper))
+            .expect("base bucket is always staged");
+        if upper.map_or(true, |upper| other < upper) {
+            return self.buckets.get_mut(&fence).expect("staged bucket");
+        }
+        match snapshot.adjacency_bucket(self.dir, self.node, self.rel, other) {
+            Some(loaded) => self.buckets.entry(loaded.fence).or_insert(StagedBucket {
+                nodes: loaded.nodes,
+                upper: loaded.upper,
+                persisted: true,
+                dirty: false,
+            }),
+            None => self.buckets.get_mut(&fence).expect("staged bucket"),
+        }
+    }
+
+    /// Rebalances the touched buckets and returns the key writes for the batch.
+    ///
+    /// Small dirty buckets absorb their right neighbor, oversized buckets split
+    /// into halves keyed by their first id, and the base record's continuation
+    /// flag is recomputed from the overflow buckets that remain.
+    pub(super) fn finalize(mut self, snapshot: &Snapshot) -> Vec<AdjacencyWrite> {
+        self.merge_small_buckets(snapshot);
+        self.split_large_buckets();
+
+        let continued = self.has_overflow(snapshot);
+        let mut writes = Vec::new();
+        for (fence, bucket) in &self.buckets {
+            if *fence == 0 {
+                let flags = if continued { ADJ_FLAG_CONTINUED } else { 0 };
+                let key = self.dir.base_key(self.node, self.rel);
+                if bucket.nodes.is_empty() && !continued {
+                    if bucket.persisted {
+                        writes.push((key, None));
+                    }
+                } else if bucket.dirty || self.persisted_flags != Some(flags) {
+                    writes.push((key, Some(encode_adjacent_nodes(flags, &bucket.nodes))));
+                }
+                continue;
+            }
+            let key = adj_bucket_key(self.node, self.rel, *fence);
+            if bucket.nodes.is_empty() {
+                if bucket.persisted {
+                    writes.push((key, None));
+                }
+            } else if bucket.dirty {
+                writes.push((key, Some(encode_adjacent_nodes(0, &bucket.nodes))));
+            }
+        }
+        for fence in &self.removed {
+            if !self.buckets.contains_key(fence) {
+                writes.push((adj_bucket_key(self.node, self.rel, *fence), None));
+            }
+        }
+        writes
+    }
+
+    fn merge_small_buckets(&mut self, snapshot: &Snapshot) {
+        let fences = self.buckets.keys().copied().collect::<Vec<_>>();
+        for fence in fences {
+            loop {
+                let Some(bucket) = self.buckets.get(&fence) else {
+                    break;
+                };
+                if !bucket.dirty || bucket.nodes.len() >= ADJ_BUCKET_MIN {
+                    break;
+                }
+                let Some(right_fence) = bucket.upper else {
+                    break;
+                };
+                let len = bucket.nodes.len();
+                let (right_nodes, right_upper) = match self.buckets.get(&right_fence) {
+                    Some(right) if len + right.nodes.len() <= ADJ_BUCKET_CAPACITY => {
+                        let right = self.buckets.remove(&right_fence).expect("staged bucket");
+                        (right.nodes, right.upper)
+                    }
+                    Some(_) => break,
+                    None => {
+                        let Some(nodes) = snapshot.adjacency_bucket_at(
+                            self.dir,
+                            self.node,
+                            self.rel,
+                            right_fence,
+                        ) else {
+                            break;
+                        };
+                        if len + nodes.len() > ADJ_BUCKET_CAPACITY {
+                            break;
+                        }
+                        let upper = right_fence.checked_add(1).and_then(|from| {
+                            snapshot.next_adjacency_fence(self.dir, self.node, self.rel, from)
+                        });
+                        (nodes, upper)
+                    }
+                };
+                self.removed.insert(right_fence);
+                let bucket = self.buckets.get_mut(&fence).expect("staged bucket");
+                bucket.nodes.extend(right_nodes);
+                bucket.upper = right_upper;
+            }
+        }
+    }
+
+    fn split_large_buckets(&mut self) {
+        let oversized = self
+            .buckets
+            .iter()
+            .filter(|(_, bucket)| bucket.nodes.len() > ADJ_BUCKET_CAPACITY)
+            .map(|(fence, _)| *fence)
+            .collect::<Vec<_>>();
+        for fence in oversized {
+            let bucket = self.buckets.get_mut(&fence).expect("staged bucket");
+            let upper = bucket.upper;
+            let tail = bucket.nodes.split_off(ADJ_BUCKET_CAPACITY / 2);
+            let mut chunks = tail
+                .chunks(ADJ_BUCKET_CAPACITY / 2)
+                .map(<[InternalNodeId]>::to_vec)
+                .collect::<Vec<_>>();
+            bucket.upper = chunks.first().map(|chunk| chunk[0]);
+            while let Some(nodes) = chunks.pop() {
+                let new_fence = nodes[0];
+                let next = self
+                    .buckets
+                    .range(new_fence + 1..)
+                    .next()
+                    .map(|(fence, _)| *fence)
+                    .filter(|next| upper.map_or(true, |upper| *next < upper))
+                    .or(upper);
+                self.buckets.insert(
+                    new_fence,
+                    StagedBucket {
+                        nodes,
+                        upper: next,
+                        persisted: self.removed.remove(&new_fence),
+                        dirty: true,
+                    },
+                );
+            }
+        }
+    }
+
+    /// Whether any overflow bucket survives this commit, staged or not.
+    fn has_overflow(&self, snapshot: &Snapshot) -> bool {
+        if self
+            .buckets
+            .iter()
+            .any(|(fence, bucket)| *fence != 0 && !bucket.nodes.is_empty())
+        {
+            return true;
+        }
+        if self
+            .persisted_flags
+            .map_or(true, |flags| flags & ADJ_FLAG_CONTINUED == 0)
+        {
+            return false;
+        }
+        let mut from = 1;
+        while let Some(fence) = snapshot.next_adjacency_fence(self.dir, self.node, self.rel, from) {
+            if !self.removed.contains(&fence) && !self.buckets.contains_key(&fence) {
+                return true;
+            }
+            let Some(next) = fence.checked_add(1) else {
+                break;
+            };
+            from = next;
+        }
+        false
+    }
+}
@@ -0,0 +1,283 @@
+//! ANALYZE: one parallel pass over a snapshot that stores graph statistics.
+//!
+//! Workers split the node-id space like the CSR build and walk their range
+//! in blocks. For each block they read labels and property rows with one
+//! range scan each, then both adjacency directions, and fold everything into
+//! label and relationship counts, degree histograms, and property sketches
+//! (see `storage::statistics`). Sketches merge, so the workers' results
+//! combine without a second pass.
+//!
+//! The pass holds `write_lock`, so no commit lands between the scan and the
+//! write of its results; readers are not blocked. It replaces the stored
+//! counters and statistics in one synced batch. From then on every commit
+//! folds its own edge and value changes in through [`StatisticsDelta`].
+
+use super::{GraphEngine, scalar_indexable_value};
+use crate::api::{EdgeKey, InternalNodeId, LabelId, PropertyValue, RelTypeId};
+use crate::storage::Result;
+use crate::storage::layout::*;
+use crate::storage::profile;
+use crate::storage::property_keys::PropertyKeyId;
+use crate::storage::snapshot::Snapshot;
+use crate::storage::statistics::{DegreeHistogram, PropertySketch, hash_value};
+use fjall::PersistMode;
+use std::collections::{BTreeMap, HashMap};
+use std::time::{SystemTime, UNIX_EPOCH};
+
+/// Node-id ranges smaller than this are not worth a dedicated thread.
+const ANALYZE_MIN_NODES_PER_THREAD: u32 = 4096;
+/// Nodes whose labels a worker holds at once.
+const ANALYZE_BLOCK_NODES: u32 = 64 * 1024;
+
+/// Statistics of one node-id range.
+#[derive(Debug, Default)]
+struct Collected {
+    label_nodes: BTreeMap<LabelId, u64>,
+    rel_edges: BTreeMap<RelTypeId, u64>,
+    degrees: HashMap<(AdjDirection, LabelId, RelTypeId), DegreeHistogram>,
+    properties: HashMap<(LabelId, PropertyKeyId), PropertySketch>,
+}
+
+impl Collected {
+    fn merge(&mut self, other: Self) {
+        for (label, nodes) in other.label_nodes {
+            *self.label_nodes.entry(label).or_insert(0) += nodes;
+        }
+        for (rel, edges) in other.rel_edges {
+            *self.rel_edges.entry(rel).or_insert(0) += edges;
+        }
+        for (key, histogram) in other.degrees {
+            self.degrees.entry(key).or_default().merge(&histogram);
+        }
+        for (key, sketch) in other.properties {
+            self.properties.entry(key).or_default().merge(&sketch);
+        }
+    }
+
+    /// Counts one node's edges per relationship type under each of its
+    /// labels, and clears `degrees`.
+    fn fold_degrees(
+        &mut self,
+        dir: AdjDirection,
+        labels: &[LabelId],
+        degrees: &mut BTreeMap<RelTypeId, u64>,
+    ) {
+        for (rel, degree) in std::mem::take(degrees) {
+            if dir == AdjDirection::Out {
+                *self.rel_edges.entry(rel).or_insert(0) += degree;
+            }
+            for label in labels {
+                self.degrees
+                    .entry((dir, *label, rel))
+                    .or_default()
+                    .add(degree);
+            }
+        }
+    }
+}
+
+fn collect_range(snapshot: &Snapshot, lo: InternalNodeId, hi: InternalNodeId) -> Collected {
+    let mut collected = Collected::default();
+    let mut block = lo;
+    while block < hi {
+        let end = block.saturating_add(ANALYZE_BLOCK_NODES).min(hi);
+        let labels = snapshot.node_labels_in_range(block, end);
+        for label in labels.iter().flatten() {
+            *collected.label_nodes.entry(*label).or_insert(0) += 1;
+        }
+        snapshot.for_each_node_properties_in_range(block, end, |node, props| {
+            let node_labels = &labels[(node - block) as usize];
+            for (key, value) in &props {
+                if !scalar_indexable_value(value) {
+                    continue;
+                }
+                for label in node_labels {
+                    collected
+                        .properties
+                        .entry((*label, *key))
+                        .or_default()
+                        .insert(value);
+                }
+            }
+        });
+        for dir in [AdjDirection::Out, AdjDirection::In] {
+            // Edges arrive grouped by node, so one node's degrees are
+            // complete when the next node starts.
+            let mut current = None;
+            let mut degrees = BTreeMap::new();
+            snapshot.for_each_adjacency_in_range(dir, block, end, |node, rel, other| {
+                if !snapshot.node_is_live(node) || !snapshot.node_is_live(other) {
+                    return;
+                }
+                if current != Some(node) {
+                    if let Some(done) = current {
+                        let done_labels = &labels[(done - block) as usize];
+                        collected.fold_degrees(dir, done_labels, &mut degrees);
+                    }
+                    current = Some(node);
+                }
+                *degrees.entry(rel).or_insert(0) += 1;
+            });
+            if let Some(done) = current {
+                collected.fold_degrees(dir, &labels[(done - block) as usize], &mut degrees);
+            }
+        }
+        block = end;
+    }
+    collected
+}
+
+impl GraphEngine {
+    /// Collects statistics from a fresh snapshot and replaces the stored
+    /// counters and statistics with them.
+    pub(crate) fn analyze(&self) -> Result<()> {
+        let started = profile::start();
+        let _guard = self.lock_writes()?;
+        let snapshot = self.begin_read();
+        let bound = snapshot.node_id_bound();
+        let cores = std::thread::available_parallelism().map_or(1, |n| n.get()) as u32;
+        let threads = cores.min(bound / ANALYZE_MIN_NODES_PER_THREAD).max(1);
+        let span = bound.div_ceil(threads).max(1);
+        let collected = std::thread::scope(|scope| {
+            let snapshot = &snapshot;
+            let workers = (0..threads)
+                .map(|i| {
+                    let lo = (i * span).min(bound);
+                    let hi = lo.saturating_add(span).min(bound);
+                    scope.spawn(move || collect_range(snapshot, lo, hi))
+                })
+                .collect::<Vec<_>>();
+            workers
+                .into_iter()
+                .fold(Collected::default(), |mut all, worker| {
+                    all.merge(worker.join().expect("ANALYZE thread panicked"));
+                    all
+                })
+        });
+
+        let meta = &self.keyspaces.meta;
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        for prefix in [
+            META_LABEL_COUNT_PREFIX,
+            META_REL_COUNT_PREFIX,
+            META_STATS_DEGREE_PREFIX,
+            META_STATS_PROPERTY_PREFIX,
+        ] {
+            for guard in meta.prefix(prefix) {
+                batch.remove(meta, guard.key()?.as_ref());
+            }
+        }
+        for (label, nodes) in &collected.label_nodes {
+            batch.insert(meta, label_count_key(*label), nodes.to_be_bytes());
+        }
+        for (rel, edges) in &collected.rel_edges {
+            batch.insert(meta, rel_count_key(*rel), edges.to_be_bytes());
+        }
+        for ((dir, label, rel), histogram) in &collected.degrees {
+            batch.insert(
+                meta,
+                degree_stats_key(*dir, *label, *rel),
+                histogram.encode(),
+            );
+        }
+        for ((label, key), sketch) in &collected.properties {
+            batch.insert(meta, property_stats_key(*label, *key), sketch.encode());
+        }
+        let analyzed_at = SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map_or(0, |elapsed| elapsed.as_secs());
+        batch.insert(meta, META_STATS_ANALYZED, analyzed_at.to_be_bytes());
+        batch.commit()?;
+        profile::event_since(
+            "GraphEngine::analyze",
+            started,
+            &[
+                ("threads", u64::from(threads)),
+                ("degree_records", collected.degrees.len() as u64),
+                ("property_records", collected.properties.len() as u64),
+            ],
+        );
+        Ok(())
+    }
+}
+
+/// Statistics changes of one commit, gathered while the database has been
+/// analyzed.
+///
+/// Degree histograms follow every edge that changes presence, under the
+/// labels its endpoint ends the commit with. Written values join the
+/// distinct-value estimates. Value counts and most common values, and the
+/// degrees of nodes that only gain or lose a label, wait for the next
+/// ANALYZE; so do edges staged to disk by a streamed commit.
+#[derive(Debug, Default)]
+pub(super) struct StatisticsDelta {
+    /// Edges gained or lost per `(direction, node, rel)` list.
+    degrees: HashMap<(AdjDirection, InternalNodeId, RelTypeId), i64>,
+    /// Hashes of the scalar values written per `(label, key)`.
+    values: HashMap<(LabelId, PropertyKeyId), Vec<u64>>,
+}
+
+impl StatisticsDelta {
+    pub(super) fn edge(&mut self, edge: &EdgeKey, delta: i64) {
+        for (dir, node) in [(AdjDirection::Out, edge.src), (AdjDirection::In, edge.dst)] {
+            *self.degrees.entry((dir, node, edge.rel)).or_insert(0) += delta;
+        }
+    }
+
+    pub(super) fn value(
+        &mut self,
+        labels: impl IntoIterator<Item = LabelId>,
+        key: PropertyKeyId,
+        value: &PropertyValue,
+    ) {
+        if !scalar_indexable_value(value) {
+            return;
+        }
+        let hash = hash_value(value);
+        for label in labels {
+            self.values.entry((label, key)).or_default().push(hash);
+        }
+    }
+
+    /// `meta` records to write, `None` meaning remove. `labels` gives the
+    /// labels a node's degrees count under.
+    pub(super) fn records(
+        self,
+        snapshot: &Snapshot,
+        labels: impl Fn(InternalNodeId) -> Vec<LabelId>,
+    ) -> Vec<(Vec<u8>, Option<Vec<u8>>)> {
+        let mut histograms: HashMap<(AdjDirection, LabelId, RelTypeId), DegreeHistogram> =
+            HashMap::new();
+        for ((dir, node, rel), delta) in self.degrees {
+            if delta == 0 {
+                continue;
+            }
+            let before = snapshot.adjacency_degree(dir, node, rel);
+            let after = before.saturating_add_signed(delta);
+            for label in labels(node) {
+                histograms
+                    .entry((dir, label, rel))
+                    .or_insert_with(|| {
+                        snapshot
+                            .degree_histogram(dir, label, rel)
+                            .unwrap_or_default()
+                    })
+                    .shift(before, after);
+            }
+        }
+
+        let mut records = Vec::with_capacity(histograms.len() + self.values.len());
+        for ((dir, label, rel), histogram) in histograms {
+            let key = degree_stats_key(dir, label, rel);
+            records.push((key, (histogram.nodes() > 0).then(|| histogram.encode())));
+        }
+        for ((label, key), hashes) in self.values {
+            let mut sketch = snapshot.property_sketch(label, key).unwrap_or_default();
+            for hash in hashes {
+                sketch.distinct.insert(hash);
+            }
+            records.push((property_stats_key(label, key), Some(sketch.encode())));
+        }
+        records
+    }
+}
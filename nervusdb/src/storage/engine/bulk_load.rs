@@ -0,0 +1,507 @@
+//! Offline bulk loader for a fresh database directory.
+//!
+//! `WriteTxn` stages every mutation in hash maps and merges it with persisted
+//! state at commit. A fresh directory has no persisted state, so the loader
+//! skips both. It assigns internal ids to nodes in input order and encodes
+//! node records on worker threads. It externally sorts edges by
+//! `(src, rel, dst)` and by `(dst, rel, src)`, then writes each adjacency list
+//! packed in one pass. Records go out in bounded unsynced batches, and one
+//! sync at the end makes the load durable.
+//!
+//! The first batch writes a `bulk_load` meta marker, and the last batch
+//! removes it. `GraphEngine::open` refuses a directory that still carries the
+//! marker, so a crashed load is never read as a complete graph.
+//!
+//! A fresh directory has no index declarations, unique constraints, or
+//! vectors. Declaring an index after the load builds it from the loaded
+//! nodes.
+
+use super::adjacency::packed_list_writes;
+use super::{GraphEngine, META_NEXT_NODE_ID, read_meta_u64, scalar_indexable_value};
+use crate::api::{EdgeKey, ExternalId, InternalNodeId, LabelId, PropertyValue, RelTypeId};
+use crate::storage::external_sort::{ExternalSorter, SortedRecords};
+use crate::storage::label_bitmap::{LabelChunk, split_node_id};
+use crate::storage::layout::*;
+use crate::storage::profile;
+use crate::storage::property_keys::PropertyKeyId;
+use crate::storage::property_row::encode_property_row;
+use crate::storage::{Error, Result};
+use fjall::Keyspace;
+use std::collections::{BTreeMap, BTreeSet, HashMap};
+use std::path::{Path, PathBuf};
+
+/// Present while a bulk load into the directory is unfinished.
+pub(super) const META_BULK_LOAD: &[u8] = b"bulk_load";
+
+/// Writes per unsynced batch.
+const BULK_BATCH_WRITES: usize = 64 * 1024;
+/// Nodes encoded per parallel round.
+const BULK_NODE_BLOCK: usize = 64 * 1024;
+/// Buffered bytes per edge sorter before it spills a run.
+const BULK_SORT_BUDGET: usize = 64 << 20;
+
+/// One node for [`bulk_load`].
+#[derive(Debug, Clone, Default)]
+pub struct BulkNode {
+    pub external_id: ExternalId,
+    pub labels: Vec<String>,
+    /// A key given twice keeps its last value.
+    pub properties: Vec<(String, PropertyValue)>,
+}
+
+/// One edge for [`bulk_load`]. Endpoints are external ids of loaded nodes.
+#[derive(Debug, Clone, Default)]
+pub struct BulkEdge {
+    pub src: ExternalId,
+    pub rel: String,
+    pub dst: ExternalId,
+    /// Repeated edges merge; a key set twice keeps its last value.
+    pub properties: Vec<(String, PropertyValue)>,
+}
+
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct BulkLoadStats {
+    pub nodes: u64,
+    /// Distinct `(src, rel, dst)` edges written.
+    pub edges: u64,
+    /// Sort runs spilled to disk; zero when the edges fit the sort budget.
+    pub spilled_runs: u64,
+}
+
+/// Loads `nodes` and `edges` into the fresh directory `path` and closes it.
+///
+/// `path` must be missing or empty. Open it normally once this returns. An
+/// error, or a crash, leaves a directory that `GraphEngine::open` refuses;
+/// delete it and load again.
+pub fn bulk_load(
+    path: impl AsRef<Path>,
+    nodes: impl IntoIterator<Item = BulkNode>,
+    edges: impl IntoIterator<Item = BulkEdge>,
+) -> Result<BulkLoadStats> {
+    let started = profile::start();
+    let path = path.as_ref();
+    if std::fs::read_dir(path).is_ok_and(|mut entries| entries.next().is_some()) {
+        return Err(Error::BulkLoad(format!(
+            "{} is not empty; bulk load needs a fresh directory",
+            path.display()
+        )));
+    }
+    let engine = GraphEngine::open(path)?;
+    let mut writer = BulkWriter::new(&engine);
+    writer.insert(
+        &engine.keyspaces.meta,
+        META_BULK_LOAD.to_vec(),
+        1u64.to_be_bytes().to_vec(),
+    )?;
+    writer.flush()?;
+
+    let runs = runs_dir(path);
+    std::fs::create_dir_all(&runs)?;
+    let loaded = load(&engine, &mut writer, &runs, nodes, edges);
+    let _ = std::fs::remove_dir_all(&runs);
+    let stats = loaded?;
+
+    writer.remove(&engine.keyspaces.meta, META_BULK_LOAD.to_vec())?;
+    writer.flush()?;
+    drop(writer);
+    engine.close()?;
+    profile::event_since(
+        "bulk_load",
+        started,
+        &[
+            ("nodes", stats.nodes),
+            ("edges", stats.edges),
+            ("spilled_runs", stats.spilled_runs),
+        ],
+    );
+    Ok(stats)
+}
+
+/// Sort runs live beside the directory, outside Fjall's file layout.
+fn runs_dir(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".bulk-load-runs");
+    path.with_file_name(name)
+}
+
+fn load<'e>(
+    engine: &'e GraphEngine,
+    writer: &mut BulkWriter<'e>,
+    runs: &Path,
+    nodes: impl IntoIterator<Item = BulkNode>,
+    edges: impl IntoIterator<Item = BulkEdge>,
+) -> Result<BulkLoadStats> {
+    let nodes: Vec<BulkNode> = nodes.into_iter().collect();
+    let mut names = Names::default();
+    for node in &nodes {
+        for label in &node.labels {
+            names.label(engine, label)?;
+        }
+        for (key, _) in &node.properties {
+            names.property_key(engine, writer, key)?;
+        }
+    }
+
+    // Ids are one contiguous range in input order.
+    let first = read_meta_u64(&engine.keyspaces.meta, META_NEXT_NODE_ID)?.unwrap_or(0);
+    let end = first + nodes.len() as u64;
+    if end > u64::from(u32::MAX) + 1 {
+        return Err(Error::StorageCorrupted(format!(
+            "counter {} exceeds u32",
+            String::from_utf8_lossy(META_NEXT_NODE_ID)
+        )));
+    }
+    let first = first as InternalNodeId;
+    let mut node_ids: HashMap<ExternalId, InternalNodeId> = HashMap::with_capacity(nodes.len());
+    for (offset, node) in nodes.iter().enumerate() {
+        if node.external_id == 0 {
+            return Err(Error::StorageCorrupted(
+                "external id 0 is reserved".to_string(),
+            ));
+        }
+        if node_ids
+            .insert(node.external_id, first + offset as InternalNodeId)
+            .is_some()
+        {
+            return Err(Error::DuplicateExternalId(node.external_id));
+        }
+    }
+
+    let nodes_started = profile::start();
+    let threads = std::thread::available_parallelism().map_or(1, usize::from);
+    let mut label_members: BTreeMap<(LabelId, u16), LabelChunk> = BTreeMap::new();
+    let mut label_counts: BTreeMap<LabelId, u64> = BTreeMap::new();
+    for (block_index, block) in nodes.chunks(BULK_NODE_BLOCK).enumerate() {
+        let block_first = first + (block_index * BULK_NODE_BLOCK) as InternalNodeId;
+        let per_thread = block.len().div_ceil(threads);
+        let encoded: Vec<Vec<(Vec<u8>, Vec<u8>)>> = std::thread::scope(|scope| {
+            let workers = block
+                .chunks(per_thread)
+                .enumerate()
+                .map(|(i, chunk)| {
+                    let chunk_first = block_first + (i * per_thread) as InternalNodeId;
+                    let names = &names;
+                    scope.spawn(move || encode_nodes(chunk_first, chunk, names))
+                })
+                .collect::<Vec<_>>();
+            workers
+                .into_iter()
+                .map(|worker| worker.join().expect("bulk load encoder panicked"))
+                .collect()
+        });
+        for records in encoded {
+            for (key, value) in records {
+                writer.insert(&engine.keyspaces.graph_data, key, value)?;
+            }
+        }
+        for (offset, node) in block.iter().enumerate() {
+            let iid = block_first + offset as InternalNodeId;
+            let (chunk, low) = split_node_id(iid);
+            for label in node_labels(node, &names) {
+                label_members.entry((label, chunk)).or_default().insert(low);
+                *label_counts.entry(label).or_insert(0) += 1;
+            }
+        }
+    }
+    for ((label, chunk), members) in label_members {
+        writer.insert(
+            &engine.keyspaces.graph_data,
+            label_bitmap_key(label, chunk),
+            members.encode(),
+        )?;
+    }
+    profile::event_since(
+        "bulk_load.nodes",
+        nodes_started,
+        &[("nodes", nodes.len() as u64)],
+    );
+    drop(nodes);
+
+    let edges_started = profile::start();
+    let mut out_runs = ExternalSorter::new(runs, "adj_out", BULK_SORT_BUDGET);
+    let mut in_runs = ExternalSorter::new(runs, "adj_in", BULK_SORT_BUDGET);
+    let mut prop_runs = ExternalSorter::new(runs, "edge_props", BULK_SORT_BUDGET);
+    let resolve = |external_id: ExternalId| {
+        node_ids.get(&external_id).copied().ok_or_else(|| {
+            Error::BulkLoad(format!("edge endpoint {external_id} is not a loaded node"))
+        })
+    };
+    for edge in edges {
+        let src = resolve(edge.src)?;
+        let dst = resolve(edge.dst)?;
+        let rel = names.rel_type(engine, &edge.rel)?;
+        out_runs.push(edge_run_key(src, rel, dst), Vec::new())?;
+        in_runs.push(edge_run_key(dst, rel, src), Vec::new())?;
+        for (key, value) in &edge.properties {
+            let key = names.property_key(engine, writer, key)?;
+            prop_runs.push(
+                edge_prop_key(EdgeKey { src, rel, dst }, key),
+                value.encode(),
+            )?;
+        }
+    }
+    let spilled_runs =
+        (out_runs.spilled_runs() + in_runs.spilled_runs() + prop_runs.spilled_runs()) as u64;
+
+    let mut rel_counts: BTreeMap<RelTypeId, u64> = BTreeMap::new();
+    let edges = write_adjacency(
+        engine,
+        writer,
+        out_runs.finish()?,
+        AdjDirection::Out,
+        &mut rel_counts,
+    )?;
+    write_adjacency(
+        engine,
+        writer,
+        in_runs.finish()?,
+        AdjDirection::In,
+        &mut BTreeMap::new(),
+    )?;
+    let mut props = prop_runs.finish()?;
+    while let Some((key, value)) = props.next_record()? {
+        let decoded =
+            PropertyValue::decode(&value).map_err(|err| Error::PropertyDecode(err.to_string()))?;
+        if scalar_indexable_value(&decoded)
+            && let Some((edge, key_id)) = parse_edge_prop_key(&key)
+        {
+            writer.insert(
+                &engine.keyspaces.graph_data,
+                edge_prop_index_key(key_id, &decoded, edge),
+                Vec::new(),
+            )?;
+        }
+        writer.insert(&engine.keyspaces.graph_data, key, value)?;
+    }
+    profile::event_since(
+        "bulk_load.edges",
+        edges_started,
+        &[("edges", edges), ("spilled_runs", spilled_runs)],
+    );
+
+    writer.insert(
+        &engine.keyspaces.meta,
+        META_NEXT_NODE_ID.to_vec(),
+        end.to_be_bytes().to_vec(),
+    )?;
+    for (label, count) in label_counts {
+        writer.insert(
+            &engine.keyspaces.meta,
+            label_count_key(label),
+            count.to_be_bytes().to_vec(),
+        )?;
+    }
+    for (rel, count) in rel_counts {
+        writer.insert(
+            &engine.keyspaces.meta,
+            rel_count_key(rel),
+            count.to_be_bytes().to_vec(),
+        )?;
+    }
+
+    Ok(BulkLoadStats {
+        nodes: end - u64::from(first),
+        edges,
+        spilled_runs,
+    })
+}
+
+/// Label, relationship-type, and property-key ids seen so far.
+#[derive(Debug, Default)]
+struct Names {
+    labels: HashMap<String, LabelId>,
+    rel_types: HashMap<String, RelTypeId>,
+    property_keys: HashMap<String, PropertyKeyId>,
+}
+
+impl Names {
+    fn label(&mut self, engine: &GraphEngine, name: &str) -> Result<LabelId> {
+        if let Some(id) = self.labels.get(name) {
+            return Ok(*id);
+        }
+        let id = engine.get_or_create_label(name)?;
+        self.labels.insert(name.to_string(), id);
+        Ok(id)
+    }
+
+    fn rel_type(&mut self, engine: &GraphEngine, name: &str) -> Result<RelTypeId> {
+        if let Some(id) = self.rel_types.get(name) {
+            return Ok(*id);
+        }
+        let id = engine.get_or_create_rel_type(name)?;
+        self.rel_types.insert(name.to_string(), id);
+        Ok(id)
+    }
+
+    fn property_key<'e>(
+        &mut self,
+        engine: &'e GraphEngine,
+        writer: &mut BulkWriter<'e>,
+        name: &str,
+    ) -> Result<PropertyKeyId> {
+        if let Some(id) = self.property_keys.get(name) {
+            return Ok(*id);
+        }
+        let created = engine.property_keys.intern([name]);
+        for (keyspace, key, value) in engine.property_key_writes(&created) {
+            writer.insert(keyspace, key, value)?;
+        }
+        let id = engine
+            .property_keys
+            .id(name)
+            .expect("property key was just interned");
+        self.property_keys.insert(name.to_string(), id);
+        Ok(id)
+    }
+}
+
+fn node_labels(node: &BulkNode, names: &Names) -> BTreeSet<LabelId> {
+    node.labels
+        .iter()
+        .map(|label| names.labels[label.as_str()])
+        .collect()
+}
+
+/// Every `graph_data` record of `nodes`, whose ids start at `first`.
+fn encode_nodes(
+    first: InternalNodeId,
+    nodes: &[BulkNode],
+    names: &Names,
+) -> Vec<(Vec<u8>, Vec<u8>)> {
+    let mut records = Vec::with_capacity(nodes.len() * 4);
+    for (offset, node) in nodes.iter().enumerate() {
+        let iid = first + offset as InternalNodeId;
+        records.push((node_key(iid), encode_node_value(node.external_id, 0)));
+        records.push((ext2node_key(node.external_id), key_u32(iid)));
+        let labels = node_labels(node, names);
+        for label in &labels {
+            records.push((node_label_key(iid, *label), Vec::new()));
+        }
+        let props: BTreeMap<PropertyKeyId, PropertyValue> = node
+            .properties
+            .iter()
+            .map(|(key, value)| (names.property_keys[key.as_str()], value.clone()))
+            .collect();
+        if props.is_empty() {
+            continue;
+        }
+        for (key, value) in &props {
+            if scalar_indexable_value(value) {
+                for label in &labels {
+                    records.push((node_prop_index_key(*label, *key, value, iid), Vec::new()));
+                }
+            }
+        }
+        records.push((node_props_key(iid), encode_property_row(&props)));
+    }
+    records
+}
+
+pub(super) fn edge_run_key(node: InternalNodeId, rel: RelTypeId, other: InternalNodeId) -> Vec<u8> {
+    let mut key = Vec::with_capacity(12);
+    key.extend_from_slice(&node.to_be_bytes());
+    key.extend_from_slice(&rel.to_be_bytes());
+    key.extend_from_slice(&other.to_be_bytes());
+    key
+}
+
+pub(super) fn parse_edge_run_key(
+    key: &[u8],
+) -> Option<(InternalNodeId, RelTypeId, InternalNodeId)> {
+    let word = |at: usize| Some(u32::from_be_bytes(key.get(at..at + 4)?.try_into().ok()?));
+    Some((word(0)?, word(4)?, word(8)?))
+}
+
+/// Writes the packed lists of one direction from its sorted, distinct edge
+/// stream and returns the number of edges. Counts per relationship type go
+/// to `rel_counts`.
+fn write_adjacency<'e>(
+    engine: &'e GraphEngine,
+    writer: &mut BulkWriter<'e>,
+    mut edges: SortedRecords,
+    dir: AdjDirection,
+    rel_counts: &mut BTreeMap<RelTypeId, u64>,
+) -> Result<u64> {
+    let keyspace = engine.keyspaces.adjacency(dir);
+    let mut total = 0u64;
+    let mut list: Option<(InternalNodeId, RelTypeId)> = None;
+    let mut others: Vec<InternalNodeId> = Vec::new();
+    loop {
+        let next = edges
+            .next_record()?
+            .map(|(key, _)| {
+                parse_edge_run_key(&key).ok_or_else(|| {
+                    Error::StorageCorrupted("invalid bulk load edge run".to_string())
+                })
+            })
+            .transpose()?;
+        if let Some((node, rel)) = list
+            && next.is_none_or(|(next_node, next_rel, _)| (next_node, next_rel) != (node, rel))
+        {
+            *rel_counts.entry(rel).or_insert(0) += others.len() as u64;
+            for (key, value) in packed_list_writes(dir, node, rel, &others) {
+                if let Some(value) = value {
+                    writer.insert(keyspace, key, value)?;
+                }
+            }
+            others.clear();
+        }
+        let Some((node, rel, other)) = next else {
+            return Ok(total);
+        };
+        list = Some((node, rel));
+        others.push(other);
+        total += 1;
+    }
+}
+
+/// Accumulates writes and commits them in unsynced batches of
+/// `BULK_BATCH_WRITES`. The caller syncs after the last one; the bulk loader
+/// does so in `GraphEngine::close`.
+pub(super) struct BulkWriter<'e> {
+    engine: &'e GraphEngine,
+    pending: Vec<(&'e Keyspace, Vec<u8>, Option<Vec<u8>>)>,
+}
+
+impl<'e> BulkWriter<'e> {
+    pub(super) fn new(engine: &'e GraphEngine) -> Self {
+        Self {
+            engine,
+            pending: Vec::with_capacity(BULK_BATCH_WRITES),
+        }
+    }
+
+    pub(super) fn insert(
+        &mut self,
+        keyspace: &'e Keyspace,
+        key: Vec<u8>,
+        value: Vec<u8>,
+    ) -> Result<()> {
+        self.pending.push((keyspace, key, Some(value)));
+        if self.pending.len() >= BULK_BATCH_WRITES {
+            self.flush()?;
+        }
+        Ok(())
+    }
+
+    pub(super) fn remove(&mut self, keyspace: &'e Keyspace, key: Vec<u8>) -> Result<()> {
+        self.pending.push((keyspace, key, None));
+        Ok(())
+    }
+
+    pub(super) fn flush(&mut self) -> Result<()> {
+        if self.pending.is_empty() {
+            return Ok(());
+        }
+        let mut batch = self.engine.db.batch().durability(None);
+        for (keyspace, key, value) in self.pending.drain(..) {
+            if let Some(value) = value {
+                batch.insert(keyspace, key, value);
+            } else {
+                batch.remove(keyspace, key);
+            }
+        }
+        batch.commit()?;
+        Ok(())
+    }
+}
@@ -1,21 +1,114 @@
+mod adjacency;
+mod analyze;
+mod bulk_load;
+mod streamed_commit;
+
 use crate::api::{
     EdgeKey, ExternalId, GraphSnapshot, GraphStore, InternalNodeId, LabelId, PropertyValue,
-    RelTypeId,
+    RelTypeId, normalize_vector,
+};
+use crate::storage::adjacency_delta::{AdjacencyList, DeltaDirectory};
+use crate::storage::composite_index::{CompositeIndexes, composite_index_keys};
+use crate::storage::fulltext_index::{
+    FulltextIndexes, build_postings, encode_posting, fulltext_entries,
 };
+use crate::storage::group_commit::{Flusher, GroupCommit};
+use crate::storage::label_bitmap::split_node_id;
 use crate::storage::layout::*;
+use crate::storage::node_liveness::{LivenessDirectory, resolve_liveness};
+use crate::storage::ordered_value::encode_ordered;
 use crate::storage::profile;
+use crate::storage::property_keys::{PropertyKeyId, PropertyKeys};
+use crate::storage::property_row::encode_property_row;
 use crate::storage::snapshot::Snapshot;
+use crate::storage::unique_constraint::{UniqueConstraints, unique_index_keys, unique_value};
+use crate::storage::vector_index::VectorIndex;
 use crate::storage::{Error, Result, STORAGE_FORMAT_EPOCH};
-use fjall::{Database, Keyspace, KeyspaceCreateOptions, PersistMode};
+use adjacency::StagedAdjacency;
+use analyze::StatisticsDelta;
+use bulk_load::META_BULK_LOAD;
+pub use bulk_load::{BulkEdge, BulkLoadStats, BulkNode, bulk_load};
+use fjall::{Database, Keyspace, KeyspaceCreateOptions, PersistMode, Readable};
 use std::collections::{BTreeMap, BTreeSet, HashMap, HashSet};
 use std::fs::{File, OpenOptions};
 use std::path::{Path, PathBuf};
-use std::sync::{Mutex, MutexGuard};
+use std::sync::{Arc, Mutex, MutexGuard, OnceLock, RwLock};
+use std::time::Duration;
+use streamed_commit::{
+    EdgeSpill, META_STREAMED_COMMIT, STAGED_EDGE_BYTES, StreamCheck, apply_streamed,
+    encode_streamed_marker, finish_streamed_commit, staging_dir,
+};
 
 const META_FORMAT_EPOCH: &[u8] = b"format_epoch";
-const META_NEXT_NODE_ID: &[u8] = b"next_node_id";
+pub(crate) const META_NEXT_NODE_ID: &[u8] = b"next_node_id";
 const META_NEXT_LABEL_ID: &[u8] = b"next_label_id";
 const META_NEXT_REL_TYPE_ID: &[u8] = b"next_rel_type_id";
+const META_NEXT_PROP_KEY_ID: &[u8] = b"next_prop_key_id";
+/// Bumped by every commit that creates or tombstones nodes; see
+/// `node_liveness.rs`.
+const META_NODE_LIVENESS_SEQ: &[u8] = b"node_liveness_seq";
+/// Bumped by every commit that changes vectors; see `vector_index.rs`.
+const META_VECTOR_SEQ: &[u8] = b"vector_seq";
+/// Present once the per-label and per-rel counters in `meta` are maintained.
+const META_COUNTERS: &[u8] = b"counters";
+/// Present once every edge property has its `EDGE_PROP_INDEX` entry.
+const META_EDGE_PROP_INDEX: &[u8] = b"edge_prop_index";
+
+/// How far `WriteTxn::commit` persists a transaction before it returns.
+///
+/// Every mode keeps commits atomic and recovers to a consistent prefix of
+/// the commit order; the modes differ in how long that prefix is guaranteed
+/// to be after a crash.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Default)]
+pub enum Durability {
+    /// fsync the journal. Acknowledged commits survive power loss.
+    #[default]
+    SyncAll,
+    /// fdatasync the journal. Acknowledged commits survive power loss on
+    /// file systems that need no metadata sync to read back appended data.
+    SyncData,
+    /// Hand the journal to the OS without a sync. Acknowledged commits
+    /// survive a process crash, not an OS crash or power loss.
+    Buffered,
+    /// Return once the batch is written in memory. The background flusher
+    /// fsyncs every `DbOptions::flush_interval`, so a crash loses at most the
+    /// commits acknowledged in the last interval plus one sync.
+    Periodic,
+}
+
+impl Durability {
+    fn persist_mode(self) -> Option<PersistMode> {
+        match self {
+            Durability::SyncAll => Some(PersistMode::SyncAll),
+            Durability::SyncData => Some(PersistMode::SyncData),
+            Durability::Buffered => Some(PersistMode::Buffer),
+            Durability::Periodic => None,
+        }
+    }
+}
+
+/// Options for [`GraphEngine::open_with`].
+#[derive(Debug, Clone)]
+pub struct DbOptions {
+    /// Durability of transactions started with `begin_write`.
+    pub durability: Durability,
+    /// How often the background flusher syncs `Periodic` commits.
+    pub flush_interval: Duration,
+    /// Bytes of created edges and edge properties a write transaction stages
+    /// in memory before it spills them to sorted runs beside the directory.
+    /// `None` never spills. See `streamed_commit.rs`.
+    pub staging_budget: Option<usize>,
+}
+
+impl Default for DbOptions {
+    fn default() -> Self {
+        Self {
+            durability: Durability::SyncAll,
+            flush_interval: Duration::from_millis(100),
+            staging_budget: None,
+        }
+    }
+}
 
 #[derive(Clone)]
 pub(crate) struct Keyspaces {
@@ -23,6 +116,16 @@ pub(crate) struct Keyspaces {
     pub(crate) graph_data: Keyspace,
     pub(crate) adj_out: Keyspace,
     pub(crate) adj_in: Keyspace,
+    pub(crate) vectors: Keyspace,
+}
+
+impl Keyspaces {
+    pub(crate) fn adjacency(&self, dir: AdjDirection) -> &Keyspace {
+        match dir {
+            AdjDirection::Out => &self.adj_out,
+            AdjDirection::In => &self.adj_in,
+        }
+    }
 }
 
 impl std::fmt::Debug for Keyspaces {
@@ -36,6 +139,20 @@ pub struct GraphEngine {
     pub(crate) db: Database,
     pub(crate) keyspaces: Keyspaces,
     pub(crate) write_lock: Mutex<()>,
+    group_commit: Arc<GroupCommit>,
+    options: DbOptions,
+    /// Started by the first `Periodic` commit.
+    flusher: OnceLock<Flusher>,
+    /// Snapshot every reader gets while a streamed commit applies its runs.
+    /// Stays set when applying them fails, until a reopen finishes the commit.
+    fence: RwLock<Option<Snapshot>>,
+    pub(crate) adjacency_deltas: DeltaDirectory,
+    pub(crate) node_liveness: LivenessDirectory,
+    pub(crate) property_keys: Arc<PropertyKeys>,
+    pub(crate) composite_indexes: CompositeIndexes,
+    pub(crate) unique_constraints: UniqueConstraints,
+    pub(crate) fulltext_indexes: FulltextIndexes,
+    pub(crate) vectors: Arc<VectorIndex>,
 }
 
 impl std::fmt::Debug for GraphEngine {
@@ -48,6 +165,10 @@ impl std::fmt::Debug for GraphEngine {
 
 impl GraphEngine {
     pub fn open(path: impl AsRef<Path>) -> Result<Self> {
+        Self::open_with(path, DbOptions::default())
+    }
+
+    pub fn open_with(path: impl AsRef<Path>, options: DbOptions) -> Result<Self> {
         let started = profile::start();
         let path = path.as_ref().to_path_buf();
         std::fs::create_dir_all(&path)?;
@@ -57,19 +178,69 @@ impl GraphEngine {
         let keyspaces_started = profile::start();
         let meta = db.keyspace("meta", KeyspaceCreateOptions::default)?;
         ensure_meta(&db, &meta)?;
+        if meta.get(META_BULK_LOAD)?.is_some() {
+            return Err(Error::BulkLoad(format!(
+                "a bulk load into {} did not finish; delete the directory and load again",
+                path.display()
+            )));
+        }
         let keyspaces = open_keyspaces(&db, meta)?;
         profile::event_since(
             "GraphEngine::open.keyspaces",
             keyspaces_started,
-            &[("keyspaces", 4)],
+            &[("keyspaces", 5)],
         );
+        let adjacency_deltas = DeltaDirectory::load(&keyspaces.graph_data)?;
+        let liveness_started = profile::start();
+        let node_liveness = LivenessDirectory::load(
+            &keyspaces.graph_data,
+            read_meta_u64(&keyspaces.meta, META_NODE_LIVENESS_SEQ)?.unwrap_or(0),
+        )?;
+        profile::event_since("GraphEngine::open.node_liveness", liveness_started, &[]);
+        let property_keys = Arc::new(PropertyKeys::load(
+            &keyspaces.graph_data,
+            read_meta_u64(&keyspaces.meta, META_NEXT_PROP_KEY_ID)?.unwrap_or(0) as PropertyKeyId,
+        )?);
+        let composite_indexes = CompositeIndexes::load(&keyspaces.graph_data)?;
+        let unique_constraints = UniqueConstraints::load(&keyspaces.graph_data)?;
+        let fulltext_indexes = FulltextIndexes::load(&keyspaces.graph_data)?;
+        let vectors_started = profile::start();
+        let vectors = Arc::new(VectorIndex::load(
+            &keyspaces.vectors,
+            read_meta_u64(&keyspaces.meta, META_VECTOR_SEQ)?.unwrap_or(0),
+        )?);
+        profile::event_since("GraphEngine::open.vectors", vectors_started, &[]);
 
         let engine = Self {
             path,
             db,
             keyspaces,
             write_lock: Mutex::new(()),
+            group_commit: Arc::default(),
+            options,
+            flusher: OnceLock::new(),
+            fence: RwLock::new(None),
+            adjacency_deltas,
+            node_liveness,
+            property_keys,
+            composite_indexes,
+            unique_constraints,
+            fulltext_indexes,
+            vectors,
         };
+        match engine.keyspaces.meta.get(META_STREAMED_COMMIT)? {
+            Some(marker) => finish_streamed_commit(&engine, marker.as_ref())?,
+            // Runs of a transaction that never committed.
+            None => {
+                let _ = std::fs::remove_dir_all(staging_dir(&engine.path));
+            }
+        }
+        if read_meta_u64(&engine.keyspaces.meta, META_COUNTERS)?.is_none() {
+            engine.rebuild_counters()?;
+        }
+        if read_meta_u64(&engine.keyspaces.meta, META_EDGE_PROP_INDEX)?.is_none() {
+            engine.build_edge_property_index()?;
+        }
         profile::event_since("GraphEngine::open", started, &[]);
         Ok(engine)
     }
@@ -84,14 +255,61 @@ impl GraphEngine {
     }
 
     pub fn begin_read(&self) -> Snapshot {
-        Snapshot::new(self.db.snapshot(), self.keyspaces.clone())
+        if let Some(fenced) = self.fence.read().unwrap().as_ref() {
+            return fenced.clone();
+        }
+        loop {
+            let candidates = self.node_liveness.candidates();
+            let (inner, deltas) = self.adjacency_deltas.pin(|| self.db.snapshot());
+            let seq = inner
+                .get(&self.keyspaces.meta, META_NODE_LIVENESS_SEQ)
+                .ok()
+                .flatten()
+                .and_then(|value| <[u8; 8]>::try_from(value.as_ref()).ok())
+                .map_or(0, u64::from_be_bytes);
+            if let Some(liveness) = resolve_liveness(candidates, seq) {
+                let vector_seq = inner
+                    .get(&self.keyspaces.meta, META_VECTOR_SEQ)
+                    .ok()
+                    .flatten()
+                    .and_then(|value| <[u8; 8]>::try_from(value.as_ref()).ok())
+                    .map_or(0, u64::from_be_bytes);
+                return Snapshot::new(
+                    inner,
+                    self.keyspaces.clone(),
+                    deltas,
+                    liveness,
+                    self.property_keys.clone(),
+                    (self.vectors.clone(), vector_seq),
+                );
+            }
+        }
     }
 
     pub fn begin_write(&self) -> WriteTxn<'_> {
+        self.begin_write_with(self.options.durability)
+    }
+
+    /// Takes `write_lock` for a write outside a `WriteTxn`. Fails while a
+    /// streamed commit that could not apply its runs still fences readers:
+    /// anything written now would be hidden from them and later overwritten
+    /// when a reopen applies the runs. Also fails once a journal sync has
+    /// failed, so nothing builds on writes that may not be on disk.
+    pub(crate) fn lock_writes(&self) -> Result<MutexGuard<'_, ()>> {
+        let guard = self.write_lock.lock().unwrap();
+        if self.fence.read().unwrap().is_some() {
+            return Err(Error::StreamedCommitUnfinished);
+        }
+        self.group_commit.check()?;
+        Ok(guard)
+    }
+
+    pub fn begin_write_with(&self, durability: Durability) -> WriteTxn<'_> {
         let guard = self.write_lock.lock().unwrap();
         WriteTxn {
             engine: self,
             _guard: guard,
+            durability,
             created_nodes: Vec::new(),
             created_node_ids: HashSet::new(),
             pending_next_node_id: None,
@@ -105,6 +323,10 @@ impl GraphEngine {
             edge_props: HashMap::new(),
             removed_node_props: Vec::new(),
             removed_edge_props: Vec::new(),
+            merged_nodes: HashMap::new(),
+            node_vectors: BTreeMap::new(),
+            staged_edge_bytes: 0,
+            spill: None,
         }
     }
 
@@ -124,15 +346,192 @@ impl GraphEngine {
     }
 
     pub fn get_or_create_label(&self, name: &str) -> Result<LabelId> {
-        let _guard = self.write_lock.lock().unwrap();
+        let _guard = self.lock_writes()?;
         self.get_or_create_name(label_name_key, label_id_key, META_NEXT_LABEL_ID, name)
     }
 
     pub fn get_or_create_rel_type(&self, name: &str) -> Result<RelTypeId> {
-        let _guard = self.write_lock.lock().unwrap();
+        let _guard = self.lock_writes()?;
         self.get_or_create_name(rel_name_key, rel_id_key, META_NEXT_REL_TYPE_ID, name)
     }
 
+    /// Declares a composite index over `keys` of `label`, in order, and
+    /// builds its entries from the committed nodes in the same batch.
+    /// Declaring an index that already exists does nothing.
+    pub fn create_composite_index(&self, label: LabelId, keys: &[&str]) -> Result<()> {
+        let distinct: BTreeSet<&str> = keys.iter().copied().collect();
+        if keys.len() < 2 || keys.len() > usize::from(u8::MAX) || distinct.len() != keys.len() {
+            return Err(Error::InvalidIndexDefinition(format!(
+                "composite index needs 2 to 255 distinct keys, got {keys:?}"
+            )));
+        }
+        let _guard = self.lock_writes()?;
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        let created_prop_keys = self.property_keys.intern(keys.iter().copied());
+        for (keyspace, key, value) in self.property_key_writes(&created_prop_keys) {
+            batch.insert(keyspace, key, value);
+        }
+        let key_ids: Vec<PropertyKeyId> = keys
+            .iter()
+            .filter_map(|key| self.property_keys.id(key))
+            .collect();
+        if self.composite_indexes.contains(label, &key_ids) {
+            return Ok(());
+        }
+
+        let snapshot = self.begin_read();
+        let defs = BTreeMap::from([(label, vec![key_ids.clone()])]);
+        batch.insert(
+            &self.keyspaces.graph_data,
+            composite_index_def_key(label, &key_ids),
+            [],
+        );
+        for node in snapshot.nodes_with_label(label) {
+            let props = snapshot.node_property_ids(node).unwrap_or_default();
+            for key in composite_index_keys(node, [&label], &props, &defs) {
+                batch.insert(&self.keyspaces.graph_data, key, []);
+            }
+        }
+        if let Err(err) = batch.commit() {
+            self.property_keys.forget(&created_prop_keys);
+            return Err(err.into());
+        }
+        self.composite_indexes.insert(label, key_ids);
+        Ok(())
+    }
+
+    /// Declares `key` unique among the nodes of `label` and builds its index
+    /// from the committed nodes in the same batch. Declaring an existing
+    /// constraint does nothing.
+    ///
+    /// Fails with `UniqueConstraintViolation` and writes nothing when two
+    /// committed nodes already share a value.
+    pub fn create_unique_constraint(&self, label: LabelId, key: &str) -> Result<()> {
+        let _guard = self.lock_writes()?;
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        let created_prop_keys = self.property_keys.intern([key]);
+        for (keyspace, key, value) in self.property_key_writes(&created_prop_keys) {
+            batch.insert(keyspace, key, value);
+        }
+        let Some(key_id) = self.property_keys.id(key) else {
+            return Err(Error::InvalidIndexDefinition(format!(
+                "property key {key:?} could not be interned"
+            )));
+        };
+        if self.unique_constraints.contains(label, key_id) {
+            return Ok(());
+        }
+
+        let snapshot = self.begin_read();
+        let mut owners: HashMap<Vec<u8>, InternalNodeId> = HashMap::new();
+        for node in snapshot.nodes_with_label(label) {
+            let Some(value) = snapshot.node_property(node, key) else {
+                continue;
+            };
+            if !unique_value(&value) {
+                continue;
+            }
+            if let Some(owner) = owners.insert(unique_index_key(label, key_id, &value), node) {
+                self.property_keys.forget(&created_prop_keys);
+                return Err(Error::UniqueConstraintViolation {
+                    label,
+                    key: key.to_string(),
+                    node: owner,
+                });
+            }
+        }
+        batch.insert(
+            &self.keyspaces.graph_data,
+            unique_constraint_key(label, key_id),
+            [],
+        );
+        for (entry, node) in owners {
+            batch.insert(&self.keyspaces.graph_data, entry, key_u32(node));
+        }
+        if let Err(err) = batch.commit() {
+            self.property_keys.forget(&created_prop_keys);
+            return Err(err.into());
+        }
+        self.unique_constraints.insert(label, key_id);
+        Ok(())
+    }
+
+    /// Declares a full-text index over the string values of `key` on
+    /// `label` and builds its posting lists from the committed nodes in the
+    /// same batch. Declaring an existing index does nothing.
+    pub fn create_fulltext_index(&self, label: LabelId, key: &str) -> Result<()> {
+        let _guard = self.lock_writes()?;
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        let created_prop_keys = self.property_keys.intern([key]);
+        for (keyspace, key, value) in self.property_key_writes(&created_prop_keys) {
+            batch.insert(keyspace, key, value);
+        }
+        let Some(key_id) = self.property_keys.id(key) else {
+            return Err(Error::InvalidIndexDefinition(format!(
+                "property key {key:?} could not be interned"
+            )));
+        };
+        if self.fulltext_indexes.contains(label, key_id) {
+            return Ok(());
+        }
+
+        let snapshot = self.begin_read();
+        let defs = BTreeMap::from([(label, BTreeSet::from([key_id]))]);
+        batch.insert(
+            &self.keyspaces.graph_data,
+            fulltext_index_def_key(label, key_id),
+            [],
+        );
+        let postings = build_postings(snapshot.nodes_with_label(label).map(|node| {
+            let props = snapshot.node_property_ids(node).unwrap_or_default();
+            (node, fulltext_entries([&label], &props, &defs))
+        }));
+        for (posting_key, ids) in postings {
+            batch.insert(
+                &self.keyspaces.graph_data,
+                posting_key,
+                encode_posting(&ids),
+            );
+        }
+        if let Err(err) = batch.commit() {
+            self.property_keys.forget(&created_prop_keys);
+            return Err(err.into());
+        }
+        self.fulltext_indexes.insert(label, key_id);
+        Ok(())
+    }
+
+    /// Dictionary writes for the entries returned by `PropertyKeys::intern`,
+    /// as `(keyspace, key, value)`.
+    fn property_key_writes(
+        &self,
+        created: &[(PropertyKeyId, String)],
+    ) -> Vec<(&Keyspace, Vec<u8>, Vec<u8>)> {
+        let mut writes = Vec::with_capacity(created.len() * 2 + 1);
+        for (id, name) in created {
+            writes.push((
+                &self.keyspaces.graph_data,
+                prop_key_name_key(name),
+                key_u32(*id),
+            ));
+            writes.push((
+                &self.keyspaces.graph_data,
+                prop_key_id_key(*id),
+                name.as_bytes().to_vec(),
+            ));
+        }
+        if !created.is_empty() {
+            writes.push((
+                &self.keyspaces.meta,
+                META_NEXT_PROP_KEY_ID.to_vec(),
+                u64::from(self.property_keys.next_id())
+                    .to_be_bytes()
+                    .to_vec(),
+            ));
+        }
+        writes
+    }
+
     pub fn get_label_id(&self, name: &str) -> Option<LabelId> {
         self.get_name_id(label_name_key, name)
     }
@@ -154,13 +553,165 @@ impl GraphEngine {
         Ok(())
     }
 
+    /// Waits until a sync at `durability` covers commit `ticket`.
+    fn wait_durable(&self, ticket: u64, durability: Durability) -> Result<()> {
+        let Some(mode) = durability.persist_mode() else {
+            return self.start_flusher();
+        };
+        self.group_commit.wait_durable(ticket, durability, || {
+            self.db.persist(mode)?;
+            Ok(())
+        })
+    }
+
+    fn start_flusher(&self) -> Result<()> {
+        if self.flusher.get().is_some() {
+            return Ok(());
+        }
+        let db = self.db.clone();
+        let flusher = Flusher::spawn(
+            self.group_commit.clone(),
+            self.options.flush_interval.max(Duration::from_millis(1)),
+            move || {
+                db.persist(PersistMode::SyncAll)?;
+                Ok(())
+            },
+        )?;
+        // A racing commit may have started one first; dropping ours stops it.
+        let _ = self.flusher.set(flusher);
+        Ok(())
+    }
+
+    /// Recomputes the per-label and per-rel counters from the graph keyspaces
+    /// and replaces the stored ones. Runs on first open of a directory that
+    /// predates the counters.
+    pub(crate) fn rebuild_counters(&self) -> Result<()> {
+        let started = profile::start();
+        let _guard = self.lock_writes()?;
+        let snapshot = self.begin_read();
+        let labels = snapshot.scan_label_counts();
+        let rels = snapshot.scan_rel_counts();
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        for prefix in [META_LABEL_COUNT_PREFIX, META_REL_COUNT_PREFIX] {
+            for guard in self.keyspaces.meta.prefix(prefix) {
+                batch.remove(&self.keyspaces.meta, guard.key()?.as_ref());
+            }
+        }
+        for (label, count) in &labels {
+            batch.insert(
+                &self.keyspaces.meta,
+                label_count_key(*label),
+                count.to_be_bytes(),
+            );
+        }
+        for (rel, count) in &rels {
+            batch.insert(
+                &self.keyspaces.meta,
+                rel_count_key(*rel),
+                count.to_be_bytes(),
+            );
+        }
+        batch.insert(&self.keyspaces.meta, META_COUNTERS, 1u64.to_be_bytes());
+        batch.commit()?;
+        profile::event_since(
+            "GraphEngine::rebuild_counters",
+            started,
+            &[("labels", labels.len() as u64), ("rels", rels.len() as u64)],
+        );
+        Ok(())
+    }
+
+    /// Writes the edge property index entries of every live edge. Runs on
+    /// first open of a directory that predates the index.
+    pub(crate) fn build_edge_property_index(&self) -> Result<()> {
+        let started = profile::start();
+        let _guard = self.lock_writes()?;
+        let keys = self.begin_read().scan_edge_property_index_keys();
+        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        for key in &keys {
+            batch.insert(&self.keyspaces.graph_data, key, []);
+        }
+        batch.insert(
+            &self.keyspaces.meta,
+            META_EDGE_PROP_INDEX,
+            1u64.to_be_bytes(),
+        );
+        batch.commit()?;
+        profile::event_since(
+            "GraphEngine::build_edge_property_index",
+            started,
+            &[("entries", keys.len() as u64)],
+        );
+        Ok(())
+    }
+
+    /// Folds every pending adjacency delta record into its packed list.
+    pub fn merge_adjacency_deltas(&self) -> Result<()> {
+        let _guard = self.lock_writes()?;
+        let lists = self.adjacency_deltas.current().lists().collect::<Vec<_>>();
+        self.fold_adjacency_deltas(&lists)
+    }
+
+    /// Rewrites `lists` from their packed records plus delta records and drops
+    /// the deltas, all in one batch. Callers must hold `write_lock`.
+    fn fold_adjacency_deltas(&self, lists: &[AdjacencyList]) -> Result<()> {
+        if lists.is_empty() {
+            return Ok(());
+        }
+        let started = profile::start();
+        let snapshot = self.begin_read();
+        // No sync of its own: the journal is ordered, so the next sync makes
+        // it durable, and losing it only leaves the delta records in place.
+        let mut batch = self.db.batch().durability(None);
+        let mut deltas = 0u64;
+        let mut adj_records = 0u64;
+        for (dir, node, rel) in lists {
+            for key in snapshot.collect_adjacency_delta_keys(*dir, *node, Some(*rel)) {
+                deltas += 1;
+                batch.remove(&self.keyspaces.graph_data, key);
+            }
+            if !snapshot.node_is_live(*node) {
+                continue;
+            }
+            let mut list = StagedAdjacency::load(&snapshot, false, *dir, *node, *rel);
+            for (other, present) in snapshot.adjacency_delta_ops(*dir, *node, *rel) {
+                if present {
+                    list.insert(&snapshot, other);
+                } else {
+                    list.remove(&snapshot, other);
+                }
+            }
+            for (key, value) in list.finalize(&snapshot) {
+                adj_records += 1;
+                match value {
+                    Some(value) => batch.insert(self.keyspaces.adjacency(*dir), key, value),
+                    None => batch.remove(self.keyspaces.adjacency(*dir), key),
+                }
+            }
+        }
+        batch.commit()?;
+        self.adjacency_deltas.forget(lists);
+        profile::event_since(
+            "GraphEngine::fold_adjacency_deltas",
+            started,
+            &[
+                ("lists", lists.len() as u64),
+                ("deltas", deltas),
+                ("adj_records", adj_records),
+            ],
+        );
+        Ok(())
+    }
+
     pub fn close(self) -> Result<()> {
+        self.merge_adjacency_deltas()?;
         self.persist()?;
         let started = profile::start();
         self.keyspaces.meta.rotate_memtable_and_wait()?;
         self.keyspaces.graph_data.rotate_memtable_and_wait()?;
         self.keyspaces.adj_out.rotate_memtable_and_wait()?;
         self.keyspaces.adj_in.rotate_memtable_and_wait()?;
+        self.keyspaces.vectors.rotate_memtable_and_wait()?;
         profile::event_since("GraphEngine::close.flush_keyspaces", started, &[]);
 
         let path = self.path.clone();
@@ -197,8 +748,16 @@ impl GraphEngine {
             return Ok(id);
         }
 
+        // The counter bump and both name records go in one unsynced batch.
+        // The journal is ordered, so the sync of any commit that uses the id
+        // also makes the name durable.
         let id = self.next_counter(counter_key)?;
-        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
+        let mut batch = self.db.batch().durability(None);
+        batch.insert(
+            &self.keyspaces.meta,
+            counter_key,
+            (u64::from(id) + 1).to_be_bytes(),
+        );
         batch.insert(&self.keyspaces.graph_data, name_key(name), id.to_be_bytes());
         batch.insert(&self.keyspaces.graph_data, id_key(id), name.as_bytes());
         batch.commit()?;
@@ -213,10 +772,6 @@ impl GraphEngine {
                 String::from_utf8_lossy(key)
             )));
         }
-        let next = current + 1;
-        let mut batch = self.db.batch().durability(Some(PersistMode::SyncAll));
-        batch.insert(&self.keyspaces.meta, key, next.to_be_bytes());
-        batch.commit()?;
         Ok(current as u32)
     }
 }
@@ -240,6 +795,7 @@ struct CreatedNode {
 pub struct WriteTxn<'a> {
     engine: &'a GraphEngine,
     _guard: MutexGuard<'a, ()>,
+    durability: Durability,
     created_nodes: Vec<CreatedNode>,
     created_node_ids: HashSet<InternalNodeId>,
     pending_next_node_id: Option<u64>,
@@ -253,13 +809,20 @@ pub struct WriteTxn<'a> {
     edge_props: HashMap<(EdgeKey, String), PropertyValue>,
     removed_node_props: Vec<(InternalNodeId, String)>,
     removed_edge_props: Vec<(EdgeKey, String)>,
+    /// Nodes returned by `merge_node`, by label, key, and ordered value.
+    merged_nodes: HashMap<(LabelId, String, Vec<u8>), InternalNodeId>,
+    /// Unit-normalized vectors set in this transaction.
+    node_vectors: BTreeMap<InternalNodeId, Vec<f32>>,
+    /// Estimated bytes of `created_edges` and `edge_props`, charged against
+    /// `DbOptions::staging_budget`.
+    staged_edge_bytes: usize,
+    /// Created edges and edge properties moved out of memory.
+    spill: Option<EdgeSpill>,
 }
 
 #[derive(Debug, Default)]
 struct NodeCleanup {
     label_keys: Vec<Vec<u8>>,
-    label_node_keys: Vec<Vec<u8>>,
-    node_prop_keys: Vec<Vec<u8>>,
     node_prop_index_keys: Vec<Vec<u8>>,
     incident_edges: BTreeSet<EdgeKey>,
 }
@@ -298,16 +861,20 @@ fn final_node_properties(
     snapshot: &Snapshot,
     node_props: &HashMap<(InternalNodeId, String), PropertyValue>,
     removed_node_props: &[(InternalNodeId, String)],
-) -> BTreeMap<String, PropertyValue> {
-    let mut props = snapshot.node_properties(node).unwrap_or_default();
+) -> BTreeMap<PropertyKeyId, PropertyValue> {
+    let mut props = snapshot.node_property_ids(node).unwrap_or_default();
     for ((prop_node, key), value) in node_props {
-        if *prop_node == node {
-            props.insert(key.clone(), value.clone());
+        if *prop_node == node
+            && let Some(key) = snapshot.property_key_id(key)
+        {
+            props.insert(key, value.clone());
         }
     }
     for (prop_node, key) in removed_node_props {
-        if *prop_node == node {
-            props.remove(key);
+        if *prop_node == node
+            && let Some(key) = snapshot.property_key_id(key)
+        {
+            props.remove(&key);
         }
     }
     props
@@ -323,9 +890,19 @@ fn node_property_removed_in_txn(
         .any(|(removed_node, removed_key)| *removed_node == node && removed_key == key)
 }
 
+fn edge_property_removed_in_txn(
+    edge: EdgeKey,
+    key: &str,
+    removed_edge_props: &[(EdgeKey, String)],
+) -> bool {
+    removed_edge_props
+        .iter()
+        .any(|(removed_edge, removed_key)| *removed_edge == edge && removed_key == key)
+}
+
 fn snapshot_node_property_index_keys(node: InternalNodeId, snapshot: &Snapshot) -> Vec<Vec<u8>> {
     let labels = snapshot.node_labels(node);
-    let Some(props) = snapshot.node_properties(node) else {
+    let Some(props) = snapshot.node_property_ids(node) else {
         return Vec::new();
     };
     node_property_index_keys_for_props(node, &labels, &props)
@@ -334,13 +911,13 @@ fn snapshot_node_property_index_keys(node: InternalNodeId, snapshot: &Snapshot)
 fn node_property_index_keys_for_props(
     node: InternalNodeId,
     labels: &[LabelId],
-    props: &BTreeMap<String, PropertyValue>,
+    props: &BTreeMap<PropertyKeyId, PropertyValue>,
 ) -> Vec<Vec<u8>> {
     let mut keys = Vec::new();
     for label in labels {
         for (key, value) in props {
             if scalar_indexable_value(value) {
-                keys.push(node_prop_index_key(*label, key, value, node));
+                keys.push(node_prop_index_key(*label, *key, value, node));
             }
         }
     }
@@ -352,7 +929,7 @@ fn snapshot_node_property_index_keys_for_label(
     label: LabelId,
     snapshot: &Snapshot,
 ) -> Vec<Vec<u8>> {
-    let Some(props) = snapshot.node_properties(node) else {
+    let Some(props) = snapshot.node_property_ids(node) else {
         return Vec::new();
     };
     node_property_index_keys_for_props(node, &[label], &props)
@@ -363,7 +940,10 @@ fn snapshot_node_property_index_keys_for_property(
     key: &str,
     snapshot: &Snapshot,
 ) -> Vec<Vec<u8>> {
-    let Some(value) = snapshot.node_property(node, key) else {
+    let (Some(key_id), Some(value)) = (
+        snapshot.property_key_id(key),
+        snapshot.node_property(node, key),
+    ) else {
         return Vec::new();
     };
     if !scalar_indexable_value(&value) {
@@ -372,56 +952,103 @@ fn snapshot_node_property_index_keys_for_property(
     snapshot
         .node_labels(node)
         .into_iter()
-        .map(|label| node_prop_index_key(label, key, &value, node))
+        .map(|label| node_prop_index_key(label, key_id, &value, node))
         .collect()
 }
 
-fn insert_sorted_unique(nodes: &mut Vec<InternalNodeId>, node: InternalNodeId) {
-    match nodes.binary_search(&node) {
-        Ok(_) => {}
-        Err(idx) => nodes.insert(idx, node),
-    }
-}
-
-fn remove_sorted(nodes: &mut Vec<InternalNodeId>, node: InternalNodeId) {
-    if let Ok(idx) = nodes.binary_search(&node) {
-        nodes.remove(idx);
+impl<'a> WriteTxn<'a> {
+    /// Nodes whose labels or properties this transaction changes.
+    fn property_touched_nodes(&self) -> BTreeSet<InternalNodeId> {
+        self.created_node_ids
+            .iter()
+            .chain(&self.tombstoned_nodes)
+            .chain(self.label_additions.iter().map(|(node, _)| node))
+            .chain(self.label_removals.iter().map(|(node, _)| node))
+            .chain(self.node_props.keys().map(|(node, _)| node))
+            .chain(self.removed_node_props.iter().map(|(node, _)| node))
+            .copied()
+            .collect()
     }
-}
 
-fn adjacency_out_list<'a>(
-    staged: &'a mut HashMap<(InternalNodeId, RelTypeId), Vec<InternalNodeId>>,
-    snapshot: &Snapshot,
-    created_node_ids: &HashSet<InternalNodeId>,
-    src: InternalNodeId,
-    rel: RelTypeId,
-) -> &'a mut Vec<InternalNodeId> {
-    staged.entry((src, rel)).or_insert_with(|| {
-        if created_node_ids.contains(&src) {
-            Vec::new()
-        } else {
-            snapshot.adjacent_out_nodes(src, rel)
+    /// Unique entries to release and to claim, diffed per touched node
+    /// between the snapshot state and the final state. A value claimed by two
+    /// nodes of this transaction, or held by a committed node that keeps it,
+    /// fails the commit; the latter costs one point read per claim.
+    fn unique_index_changes(
+        &self,
+        snapshot: &Snapshot,
+        created_node_labels: &HashMap<InternalNodeId, BTreeSet<LabelId>>,
+    ) -> Result<(BTreeSet<Vec<u8>>, BTreeMap<Vec<u8>, InternalNodeId>)> {
+        let mut released = BTreeSet::new();
+        let mut claimed: BTreeMap<Vec<u8>, InternalNodeId> = BTreeMap::new();
+        let defs = self.engine.unique_constraints.read();
+        if defs.is_empty() {
+            return Ok((released, claimed));
         }
-    })
-}
-
-fn adjacency_in_list<'a>(
-    staged: &'a mut HashMap<(InternalNodeId, RelTypeId), Vec<InternalNodeId>>,
-    snapshot: &Snapshot,
-    created_node_ids: &HashSet<InternalNodeId>,
-    dst: InternalNodeId,
-    rel: RelTypeId,
-) -> &'a mut Vec<InternalNodeId> {
-    staged.entry((dst, rel)).or_insert_with(|| {
-        if created_node_ids.contains(&dst) {
-            Vec::new()
-        } else {
-            snapshot.adjacent_in_nodes(dst, rel)
+        let violation = |key: &[u8], node: InternalNodeId| {
+            let (label, key_id) = parse_unique_index_key(key).unwrap_or_default();
+            Error::UniqueConstraintViolation {
+                label,
+                key: self
+                    .engine
+                    .property_keys
+                    .names([key_id])
+                    .pop()
+                    .flatten()
+                    .unwrap_or_default(),
+                node,
+            }
+        };
+        for node in self.property_touched_nodes() {
+            let before = if self.created_node_ids.contains(&node) {
+                BTreeSet::new()
+            } else {
+                unique_index_keys(
+                    &snapshot.node_labels(node),
+                    &snapshot.node_property_ids(node).unwrap_or_default(),
+                    &defs,
+                )
+            };
+            let after = if self.tombstoned_nodes.contains(&node) {
+                BTreeSet::new()
+            } else {
+                unique_index_keys(
+                    &final_node_labels(
+                        node,
+                        snapshot,
+                        created_node_labels,
+                        &self.label_additions,
+                        &self.label_removals,
+                    ),
+                    &final_node_properties(
+                        node,
+                        snapshot,
+                        &self.node_props,
+                        &self.removed_node_props,
+                    ),
+                    &defs,
+                )
+            };
+            released.extend(before.difference(&after).cloned());
+            for key in after.difference(&before) {
+                if let Some(other) = claimed.insert(key.clone(), node) {
+                    return Err(violation(key, other));
+                }
+            }
         }
-    })
-}
+        for (key, node) in &claimed {
+            if released.remove(key) {
+                continue;
+            }
+            if let Some(owner) = snapshot.unique_index_owner(key)
+                && owner != *node
+            {
+                return Err(violation(key, owner));
+            }
+        }
+        Ok((released, claimed))
+    }
 
-impl<'a> WriteTxn<'a> {
     fn edge_not_found(edge: EdgeKey) -> Error {
         Error::EdgeNotFound {
             src: edge.src,
@@ -510,12 +1137,40 @@ impl<'a> WriteTxn<'a> {
         }
     }
 
-    fn ensure_edge_live(&self, edge: EdgeKey) -> Result<()> {
+    fn ensure_edge_live(&mut self, edge: EdgeKey) -> Result<()> {
         if self.edge_live_in_txn(edge) {
-            Ok(())
-        } else {
-            Err(Self::edge_not_found(edge))
+            return Ok(());
+        }
+        // Spilled edges cannot be looked up in their runs; commit checks
+        // them there instead.
+        if self.spill.is_some()
+            && !self.edge_deleted_in_txn(edge)
+            && self.node_live_in_txn(edge.src)
+            && self.node_live_in_txn(edge.dst)
+            && let Some(spill) = &mut self.spill
+        {
+            spill.deferred.insert(edge);
+            return Ok(());
+        }
+        Err(Self::edge_not_found(edge))
+    }
+
+    /// Moves created edges and edge properties to the spill once they
+    /// outgrow `DbOptions::staging_budget`.
+    fn spill_if_over_budget(&mut self) -> Result<()> {
+        let Some(budget) = self.engine.options.staging_budget else {
+            return Ok(());
+        };
+        if self.staged_edge_bytes <= budget {
+            return Ok(());
+        }
+        if self.spill.is_none() {
+            self.spill = Some(EdgeSpill::create(&self.engine.path)?);
         }
+        let spill = self.spill.as_mut().expect("created above");
+        spill.stage(self.created_edges.drain(..), self.edge_props.drain())?;
+        self.staged_edge_bytes = 0;
+        Ok(())
     }
 
     pub fn create_node(
@@ -586,7 +1241,8 @@ impl<'a> WriteTxn<'a> {
         self.ensure_node_live(src)?;
         self.ensure_node_live(dst)?;
         self.created_edges.push(EdgeKey { src, rel, dst });
-        Ok(())
+        self.staged_edge_bytes += STAGED_EDGE_BYTES;
+        self.spill_if_over_budget()
     }
 
     pub fn tombstone_node(&mut self, node: InternalNodeId) -> Result<()> {
@@ -618,6 +1274,30 @@ impl<'a> WriteTxn<'a> {
         Ok(())
     }
 
+    /// Stages `vector` as the node's embedding, replacing any previous one.
+    /// Every vector of a database has the dimension of the first one stored.
+    pub fn set_vector(&mut self, node: InternalNodeId, vector: &[f32]) -> Result<()> {
+        self.ensure_node_live(node)?;
+        let vector = normalize_vector(vector).ok_or_else(|| {
+            Error::InvalidVector("vectors must be non-empty, finite, and non-zero".to_string())
+        })?;
+        let dim = self
+            .engine
+            .vectors
+            .dim()
+            .or_else(|| self.node_vectors.values().next().map(Vec::len));
+        if let Some(dim) = dim
+            && dim != vector.len()
+        {
+            return Err(Error::InvalidVector(format!(
+                "expected {dim} dimensions, found {}",
+                vector.len()
+            )));
+        }
+        self.node_vectors.insert(node, vector);
+        Ok(())
+    }
+
     pub fn set_edge_property(
         &mut self,
         src: InternalNodeId,
@@ -628,8 +1308,9 @@ impl<'a> WriteTxn<'a> {
     ) -> Result<()> {
         let edge = EdgeKey { src, rel, dst };
         self.ensure_edge_live(edge)?;
+        self.staged_edge_bytes += STAGED_EDGE_BYTES + key.len();
         self.edge_props.insert((edge, key), value);
-        Ok(())
+        self.spill_if_over_budget()
     }
 
     pub fn remove_node_property(&mut self, node: InternalNodeId, key: &str) -> Result<()> {
@@ -651,6 +1332,42 @@ impl<'a> WriteTxn<'a> {
         Ok(())
     }
 
+    /// Returns the node of `label` whose `key` holds `value`, creating it
+    /// with `external_id` when there is none. A repeated call in the same
+    /// transaction returns the staged node without a read; otherwise the
+    /// committed node is found with one probe, a point read when `(label,
+    /// key)` is unique. The write lock held by the transaction keeps the
+    /// probe and the creation atomic.
+    pub fn merge_node(
+        &mut self,
+        external_id: ExternalId,
+        label_id: LabelId,
+        key: String,
+        value: PropertyValue,
+    ) -> Result<InternalNodeId> {
+        let mut encoded = Vec::new();
+        encode_ordered(&value, &mut encoded);
+        let staged = (label_id, key, encoded);
+        if let Some(node) = self.merged_nodes.get(&staged).copied()
+            && self.node_live_in_txn(node)
+        {
+            return Ok(node);
+        }
+        let (label_id, key, encoded) = staged;
+        if let Some(node) = self
+            .engine
+            .begin_read()
+            .node_by_unique_property(label_id, &key, &value)
+            && self.node_live_in_txn(node)
+        {
+            return Ok(node);
+        }
+        let node = self.create_node(external_id, label_id)?;
+        self.set_node_property(node, key.clone(), value)?;
+        self.merged_nodes.insert((label_id, key, encoded), node);
+        Ok(node)
+    }
+
     pub fn get_or_create_label(&mut self, name: &str) -> Result<LabelId> {
         self.engine
             .get_or_create_name(label_name_key, label_id_key, META_NEXT_LABEL_ID, name)
@@ -675,13 +1392,30 @@ impl<'a> WriteTxn<'a> {
             .collect()
     }
 
-    pub fn commit(self) -> Result<()> {
+    /// Writes the batch under `write_lock` without a sync, then releases the
+    /// lock and waits for a group sync at the transaction's `Durability`
+    /// (see `group_commit.rs`).
+    ///
+    /// A transaction that spilled also applies its runs before it releases
+    /// the lock and always waits for `SyncAll` (see `streamed_commit.rs`). If
+    /// applying them fails, readers keep the snapshot from before the commit,
+    /// every later commit fails with `StreamedCommitUnfinished`, and the next
+    /// open of the directory finishes it.
+    ///
+    /// An error from the sync means durability is unknown: the writes are
+    /// already visible and may persist. The failed sync poisons the engine,
+    /// so every later commit fails with `SyncFailed` until a reopen.
+    pub fn commit(mut self) -> Result<()> {
         let commit_started = profile::start();
-        let mut batch = self
-            .engine
-            .db
-            .batch()
-            .durability(Some(PersistMode::SyncAll));
+        if self.engine.fence.read().unwrap().is_some() {
+            return Err(Error::StreamedCommitUnfinished);
+        }
+        self.engine.group_commit.check()?;
+        let mut spill = self.spill.take();
+        if let Some(spill) = &mut spill {
+            spill.stage(self.created_edges.drain(..), self.edge_props.drain())?;
+        }
+        let mut batch = self.engine.db.batch().durability(None);
         let snapshot = self.engine.begin_read();
         let created_node_labels: HashMap<InternalNodeId, BTreeSet<LabelId>> = self
             .created_nodes
@@ -703,8 +1437,28 @@ impl<'a> WriteTxn<'a> {
             }
         }
 
+        // Spilled edges are checked in one pass over their runs, which are
+        // then made durable before the marker that names them is written.
+        let streamed = match &mut spill {
+            Some(spill) => {
+                let check = spill.check(
+                    &snapshot,
+                    |node| self.created_node_ids.contains(&node),
+                    |edge| self.edge_deleted_in_txn(edge),
+                    |node| self.node_live_for_commit(node, &snapshot),
+                )?;
+                spill.persist()?;
+                check
+            }
+            None => StreamCheck::default(),
+        };
+        let streamed_live =
+            |edge: &EdgeKey| streamed.seen.contains(edge) && !self.edge_deleted_in_txn(*edge);
+
         for edge in &self.tombstoned_edges {
-            if !self.edge_known_before_delete(*edge, &snapshot, &all_created_edges) {
+            if !self.edge_known_before_delete(*edge, &snapshot, &all_created_edges)
+                && !streamed.seen.contains(edge)
+            {
                 return Err(Self::edge_not_found(*edge));
             }
         }
@@ -729,13 +1483,19 @@ impl<'a> WriteTxn<'a> {
                 return Err(Error::NodeNotFound(*node));
             }
         }
+        for node in self.node_vectors.keys() {
+            if !self.node_live_for_commit(*node, &snapshot) {
+                return Err(Error::NodeNotFound(*node));
+            }
+        }
         for (edge, _) in self.edge_props.keys() {
             if !self.edge_live_for_commit(*edge, &snapshot, &created_edges) {
                 return Err(Self::edge_not_found(*edge));
             }
         }
         for (edge, _) in &self.removed_edge_props {
-            if !self.edge_live_for_commit(*edge, &snapshot, &created_edges) {
+            if !self.edge_live_for_commit(*edge, &snapshot, &created_edges) && !streamed_live(edge)
+            {
                 return Err(Self::edge_not_found(*edge));
             }
         }
@@ -744,6 +1504,7 @@ impl<'a> WriteTxn<'a> {
             validation_started,
             &[
                 ("created_edges", created_edges.len() as u64),
+                ("streamed_edges", streamed.edges),
                 ("tombstoned_edges", self.tombstoned_edges.len() as u64),
                 ("tombstoned_nodes", self.tombstoned_nodes.len() as u64),
                 ("node_props", self.node_props.len() as u64),
@@ -751,18 +1512,66 @@ impl<'a> WriteTxn<'a> {
             ],
         );
 
+        // New keys are interned in the same batch as the records that use
+        // them; they become visible now and are forgotten if the batch fails.
+        let created_prop_keys = self.engine.property_keys.intern(
+            self.node_props
+                .keys()
+                .map(|(_, key)| key.as_str())
+                .chain(self.edge_props.keys().map(|(_, key)| key.as_str()))
+                .chain(
+                    spill
+                        .iter()
+                        .flat_map(|spill| spill.prop_names.iter())
+                        .map(String::as_str),
+                ),
+        );
+        for (keyspace, key, value) in self.engine.property_key_writes(&created_prop_keys) {
+            batch.insert(keyspace, key, value);
+        }
+
+        let unique_started = profile::start();
+        let (released_unique, claimed_unique) =
+            match self.unique_index_changes(&snapshot, &created_node_labels) {
+                Ok(changes) => changes,
+                Err(err) => {
+                    self.engine.property_keys.forget(&created_prop_keys);
+                    return Err(err);
+                }
+            };
+        for key in &released_unique {
+            batch.remove(&self.engine.keyspaces.graph_data, key.clone());
+        }
+        for (key, node) in &claimed_unique {
+            batch.insert(
+                &self.engine.keyspaces.graph_data,
+                key.clone(),
+                key_u32(*node),
+            );
+        }
+        profile::event_since(
+            "WriteTxn::commit.unique_checks",
+            unique_started,
+            &[("claimed", claimed_unique.len() as u64)],
+        );
+
         let cleanup_started = profile::start();
         let mut node_cleanups: HashMap<InternalNodeId, NodeCleanup> = HashMap::new();
         let mut detached_edges: BTreeSet<EdgeKey> = BTreeSet::new();
+        let mut label_members: BTreeMap<(LabelId, u16), BTreeMap<u16, bool>> = BTreeMap::new();
+        let mut stage_member = |label: LabelId, node: InternalNodeId, present: bool| {
+            let (chunk, low) = split_node_id(node);
+            label_members
+                .entry((label, chunk))
+                .or_default()
+                .insert(low, present);
+        };
         for node in &self.tombstoned_nodes {
             let mut cleanup = NodeCleanup::default();
             for label in snapshot.node_labels(*node) {
                 cleanup.label_keys.push(node_label_key(*node, label));
-                cleanup.label_node_keys.push(label_node_key(label, *node));
+                stage_member(label, *node, false);
             }
-            cleanup
-                .node_prop_keys
-                .extend(snapshot.collect_node_property_keys(*node));
             cleanup
                 .node_prop_index_keys
                 .extend(snapshot_node_property_index_keys(*node, &snapshot));
@@ -820,11 +1629,7 @@ impl<'a> WriteTxn<'a> {
                     node_label_key(node.iid, *label),
                     [],
                 );
-                batch.insert(
-                    &self.engine.keyspaces.graph_data,
-                    label_node_key(*label, node.iid),
-                    [],
-                );
+                stage_member(*label, node.iid, true);
             }
         }
         profile::event_since(
@@ -854,18 +1659,14 @@ impl<'a> WriteTxn<'a> {
                 node_label_key(*node, *label),
                 [],
             );
-            batch.insert(
-                &self.engine.keyspaces.graph_data,
-                label_node_key(*label, *node),
-                [],
-            );
+            stage_member(*label, *node, true);
             let props =
                 final_node_properties(*node, &snapshot, &self.node_props, &self.removed_node_props);
             for (key, value) in props {
                 if scalar_indexable_value(&value) {
                     batch.insert(
                         &self.engine.keyspaces.graph_data,
-                        node_prop_index_key(*label, &key, &value, *node),
+                        node_prop_index_key(*label, key, &value, *node),
                         [],
                     );
                 }
@@ -880,80 +1681,70 @@ impl<'a> WriteTxn<'a> {
                 &self.engine.keyspaces.graph_data,
                 node_label_key(*node, *label),
             );
-            batch.remove(
-                &self.engine.keyspaces.graph_data,
-                label_node_key(*label, *node),
-            );
+            stage_member(*label, *node, false);
             for key in snapshot_node_property_index_keys_for_label(*node, *label, &snapshot) {
                 batch.remove(&self.engine.keyspaces.graph_data, key);
             }
         }
 
+        // Every touched chunk is rewritten whole; commits are serialized by
+        // `write_lock`, so the snapshot holds its latest version.
+        let label_chunks = label_members.len() as u64;
+        for ((label, chunk), ops) in label_members {
+            let mut members = snapshot.label_chunk(label, chunk).unwrap_or_default();
+            for (low, present) in ops {
+                if present {
+                    members.insert(low);
+                } else {
+                    members.remove(low);
+                }
+            }
+            let key = label_bitmap_key(label, chunk);
+            if members.is_empty() {
+                batch.remove(&self.engine.keyspaces.graph_data, key);
+            } else {
+                batch.insert(&self.engine.keyspaces.graph_data, key, members.encode());
+            }
+        }
+
         let edge_writes_started = profile::start();
-        let mut staged_adj_out: HashMap<(InternalNodeId, RelTypeId), Vec<InternalNodeId>> =
-            HashMap::new();
-        let mut staged_adj_in: HashMap<(InternalNodeId, RelTypeId), Vec<InternalNodeId>> =
+        let mut adjacency_ops: HashMap<AdjacencyList, BTreeMap<InternalNodeId, bool>> =
             HashMap::new();
+        let mut stage_edge = |edge: &EdgeKey, present: bool| {
+            for (dir, node, other) in [
+                (AdjDirection::Out, edge.src, edge.dst),
+                (AdjDirection::In, edge.dst, edge.src),
+            ] {
+                if self.tombstoned_nodes.contains(&node) {
+                    continue;
+                }
+                adjacency_ops
+                    .entry((dir, node, edge.rel))
+                    .or_default()
+                    .insert(other, present);
+            }
+        };
         for edge in &created_edges {
-            insert_sorted_unique(
-                adjacency_out_list(
-                    &mut staged_adj_out,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.src,
-                    edge.rel,
-                ),
-                edge.dst,
-            );
-            insert_sorted_unique(
-                adjacency_in_list(
-                    &mut staged_adj_in,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.dst,
-                    edge.rel,
-                ),
-                edge.src,
-            );
+            stage_edge(edge, true);
         }
 
         for edge in &self.tombstoned_edges {
-            remove_sorted(
-                adjacency_out_list(
-                    &mut staged_adj_out,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.src,
-                    edge.rel,
-                ),
-                edge.dst,
-            );
-            remove_sorted(
-                adjacency_in_list(
-                    &mut staged_adj_in,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.dst,
-                    edge.rel,
-                ),
-                edge.src,
-            );
+            stage_edge(edge, false);
+            for key in snapshot.collect_edge_property_index_keys(*edge) {
+                batch.remove(&self.engine.keyspaces.graph_data, key);
+            }
             for key in snapshot.collect_edge_property_keys(*edge) {
                 batch.remove(&self.engine.keyspaces.graph_data, key);
             }
         }
 
+        let mut tombstoned_records = Vec::new();
         for node in &self.tombstoned_nodes {
             if let Some(cleanup) = node_cleanups.get(node) {
                 for key in &cleanup.label_keys {
                     batch.remove(&self.engine.keyspaces.graph_data, key);
                 }
-                for key in &cleanup.label_node_keys {
-                    batch.remove(&self.engine.keyspaces.graph_data, key);
-                }
-                for key in &cleanup.node_prop_keys {
-                    batch.remove(&self.engine.keyspaces.graph_data, key);
-                }
+                batch.remove(&self.engine.keyspaces.graph_data, node_props_key(*node));
                 for key in &cleanup.node_prop_index_keys {
                     batch.remove(&self.engine.keyspaces.graph_data, key);
                 }
@@ -965,55 +1756,70 @@ impl<'a> WriteTxn<'a> {
                     node_key(*node),
                     encode_node_value(external_id, KEY_FLAG_TOMBSTONE),
                 );
+                tombstoned_records.push(*node);
             }
         }
 
         for edge in &detached_edges {
-            remove_sorted(
-                adjacency_out_list(
-                    &mut staged_adj_out,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.src,
-                    edge.rel,
-                ),
-                edge.dst,
-            );
-            remove_sorted(
-                adjacency_in_list(
-                    &mut staged_adj_in,
-                    &snapshot,
-                    &self.created_node_ids,
-                    edge.dst,
-                    edge.rel,
-                ),
-                edge.src,
-            );
+            stage_edge(edge, false);
+            for key in snapshot.collect_edge_property_index_keys(*edge) {
+                batch.remove(&self.engine.keyspaces.graph_data, key);
+            }
             for key in snapshot.collect_edge_property_keys(*edge) {
                 batch.remove(&self.engine.keyspaces.graph_data, key);
             }
         }
-        for ((src, rel), dsts) in &staged_adj_out {
-            let key = adj_out_key(*src, *rel);
-            if dsts.is_empty() {
-                batch.remove(&self.engine.keyspaces.adj_out, key);
-            } else {
-                batch.insert(
-                    &self.engine.keyspaces.adj_out,
-                    key,
-                    encode_adjacent_nodes(dsts),
-                );
+
+        // A tombstoned node drops its own lists wholesale; its neighbors only
+        // see removal deltas.
+        let mut adj_records = 0u64;
+        for node in &self.tombstoned_nodes {
+            if self.created_node_ids.contains(node) {
+                continue;
+            }
+            for dir in [AdjDirection::Out, AdjDirection::In] {
+                for key in snapshot.collect_adjacency_record_keys(dir, *node) {
+                    adj_records += 1;
+                    batch.remove(self.engine.keyspaces.adjacency(dir), key);
+                }
+                for key in snapshot.collect_adjacency_delta_keys(dir, *node, None) {
+                    batch.remove(&self.engine.keyspaces.graph_data, key);
+                }
             }
         }
-        for ((dst, rel), srcs) in &staged_adj_in {
-            let key = adj_in_key(*dst, *rel);
-            if srcs.is_empty() {
-                batch.remove(&self.engine.keyspaces.adj_in, key);
-            } else {
+
+        // Lists of nodes created in this transaction are written packed; they
+        // have no persisted state, so staging them reads nothing. Lists of
+        // existing nodes get one append-only delta record each.
+        let (created_lists, delta_lists): (Vec<_>, Vec<_>) = adjacency_ops
+            .into_iter()
+            .partition(|((_, node, _), _)| self.created_node_ids.contains(node));
+        let adj_created_lists = created_lists.len() as u64;
+        for ((dir, node, rel), ops) in created_lists {
+            let mut list = StagedAdjacency::load(&snapshot, true, dir, node, rel);
+            for (other, present) in ops {
+                if present {
+                    list.insert(&snapshot, other);
+                }
+            }
+            for (key, value) in list.finalize(&snapshot) {
+                adj_records += 1;
+                if let Some(value) = value {
+                    batch.insert(self.engine.keyspaces.adjacency(dir), key, value);
+                }
+            }
+        }
+        let adj_delta_lists = delta_lists.len() as u64;
+        if !delta_lists.is_empty() {
+            let seq = self
+                .engine
+                .adjacency_deltas
+                .record(delta_lists.iter().map(|(list, _)| *list));
+            for ((dir, node, rel), ops) in &delta_lists {
                 batch.insert(
-                    &self.engine.keyspaces.adj_in,
-                    key,
-                    encode_adjacent_nodes(srcs),
+                    &self.engine.keyspaces.graph_data,
+                    adj_delta_key(*dir, *node, *rel, seq),
+                    encode_adj_delta(ops),
                 );
             }
         }
@@ -1024,8 +1830,9 @@ impl<'a> WriteTxn<'a> {
                 ("created_edges", created_edges.len() as u64),
                 ("tombstoned_edges", self.tombstoned_edges.len() as u64),
                 ("detached_edges", detached_edges.len() as u64),
-                ("adj_out_lists", staged_adj_out.len() as u64),
-                ("adj_in_lists", staged_adj_in.len() as u64),
+                ("adj_created_lists", adj_created_lists),
+                ("adj_delta_lists", adj_delta_lists),
+                ("adj_records", adj_records),
             ],
         );
 
@@ -1042,11 +1849,9 @@ impl<'a> WriteTxn<'a> {
             if node_property_removed_in_txn(*node, key, &self.removed_node_props) {
                 continue;
             }
-            batch.insert(
-                &self.engine.keyspaces.graph_data,
-                node_prop_key(*node, key),
-                value.encode(),
-            );
+            let Some(key_id) = snapshot.property_key_id(key) else {
+                continue;
+            };
             if scalar_indexable_value(value) {
                 for label in final_node_labels(
                     *node,
@@ -1057,22 +1862,46 @@ impl<'a> WriteTxn<'a> {
                 ) {
                     batch.insert(
                         &self.engine.keyspaces.graph_data,
-                        node_prop_index_key(label, key, value, *node),
+                        node_prop_index_key(label, key_id, value, *node),
                         [],
                     );
                 }
             }
         }
 
+        // Edges with an endpoint created in this transaction have no stored
+        // properties, so only the others read the value being replaced.
         for ((edge, key), value) in &self.edge_props {
             if detached_edges.contains(edge) || self.tombstoned_edges.contains(edge) {
                 continue;
             }
+            let Some(key_id) = snapshot.property_key_id(key) else {
+                continue;
+            };
+            if !self.created_node_ids.contains(&edge.src)
+                && !self.created_node_ids.contains(&edge.dst)
+                && let Some(old) = snapshot.edge_property_by_id(*edge, key_id)
+                && scalar_indexable_value(&old)
+            {
+                batch.remove(
+                    &self.engine.keyspaces.graph_data,
+                    edge_prop_index_key(key_id, &old, *edge),
+                );
+            }
             batch.insert(
                 &self.engine.keyspaces.graph_data,
-                edge_prop_key(*edge, key),
+                edge_prop_key(*edge, key_id),
                 value.encode(),
             );
+            if scalar_indexable_value(value)
+                && !edge_property_removed_in_txn(*edge, key, &self.removed_edge_props)
+            {
+                batch.insert(
+                    &self.engine.keyspaces.graph_data,
+                    edge_prop_index_key(key_id, value, *edge),
+                    [],
+                );
+            }
         }
 
         for (node, key) in &self.removed_node_props {
@@ -1082,33 +1911,505 @@ impl<'a> WriteTxn<'a> {
             for old_key in snapshot_node_property_index_keys_for_property(*node, key, &snapshot) {
                 batch.remove(&self.engine.keyspaces.graph_data, old_key);
             }
-            batch.remove(&self.engine.keyspaces.graph_data, node_prop_key(*node, key));
+        }
+
+        // Each touched node gets its whole property record rewritten once;
+        // removals win over sets of the same key, as above. A removed key
+        // that was never interned cannot be in any record.
+        let mut row_changes: BTreeMap<
+            InternalNodeId,
+            Vec<(PropertyKeyId, Option<&PropertyValue>)>,
+        > = BTreeMap::new();
+        for ((node, key), value) in &self.node_props {
+            if let Some(key) = snapshot.property_key_id(key) {
+                row_changes
+                    .entry(*node)
+                    .or_default()
+                    .push((key, Some(value)));
+            }
+        }
+        for (node, key) in &self.removed_node_props {
+            if let Some(key) = snapshot.property_key_id(key) {
+                row_changes.entry(*node).or_default().push((key, None));
+            }
+        }
+        row_changes.retain(|node, _| !self.tombstoned_nodes.contains(node));
+        for changes in row_changes.values_mut() {
+            changes.sort_by_key(|(_, value)| value.is_none());
+        }
+        let node_prop_rows = row_changes.len() as u64;
+        for (node, changes) in row_changes {
+            let mut props = if self.created_node_ids.contains(&node) {
+                BTreeMap::new()
+            } else {
+                snapshot.node_property_ids(node).unwrap_or_default()
+            };
+            for (key, value) in changes {
+                match value {
+                    Some(value) => props.insert(key, value.clone()),
+                    None => props.remove(&key),
+                };
+            }
+            if props.is_empty() {
+                batch.remove(&self.engine.keyspaces.graph_data, node_props_key(node));
+            } else {
+                batch.insert(
+                    &self.engine.keyspaces.graph_data,
+                    node_props_key(node),
+                    encode_property_row(&props),
+                );
+            }
         }
 
         for (edge, key) in &self.removed_edge_props {
             if detached_edges.contains(edge) || self.tombstoned_edges.contains(edge) {
                 continue;
             }
+            let Some(key) = snapshot.property_key_id(key) else {
+                continue;
+            };
+            if let Some(old) = snapshot.edge_property_by_id(*edge, key)
+                && scalar_indexable_value(&old)
+            {
+                batch.remove(
+                    &self.engine.keyspaces.graph_data,
+                    edge_prop_index_key(key, &old, *edge),
+                );
+            }
             batch.remove(&self.engine.keyspaces.graph_data, edge_prop_key(*edge, key));
         }
+
+        // Composite entries are diffed per touched node between the snapshot
+        // state and the final state; `write_lock` keeps the declarations
+        // fixed for the whole commit.
+        let composite_defs = self.engine.composite_indexes.read();
+        if !composite_defs.is_empty() {
+            for node in self.property_touched_nodes() {
+                let before = if self.created_node_ids.contains(&node) {
+                    BTreeSet::new()
+                } else {
+                    composite_index_keys(
+                        node,
+                        &snapshot.node_labels(node),
+                        &snapshot.node_property_ids(node).unwrap_or_default(),
+                        &composite_defs,
+                    )
+                };
+                let after = if self.tombstoned_nodes.contains(&node) {
+                    BTreeSet::new()
+                } else {
+                    composite_index_keys(
+                        node,
+                        &final_node_labels(
+                            node,
+                            &snapshot,
+                            &created_node_labels,
+                            &self.label_additions,
+                            &self.label_removals,
+                        ),
+                        &final_node_properties(
+                            node,
+                            &snapshot,
+                            &self.node_props,
+                            &self.removed_node_props,
+                        ),
+                        &composite_defs,
+                    )
+                };
+                for key in before.difference(&after) {
+                    batch.remove(&self.engine.keyspaces.graph_data, key.clone());
+                }
+                for key in after.difference(&before) {
+                    batch.insert(&self.engine.keyspaces.graph_data, key.clone(), []);
+                }
+            }
+        }
+        drop(composite_defs);
+
+        // Posting chunks are diffed like composite entries, then every touched
+        // chunk is rewritten whole, as label bitmaps are.
+        let fulltext_defs = self.engine.fulltext_indexes.read();
+        let mut posting_ops: BTreeMap<Vec<u8>, BTreeMap<InternalNodeId, bool>> = BTreeMap::new();
+        if !fulltext_defs.is_empty() {
+            for node in self.property_touched_nodes() {
+                let before = if self.created_node_ids.contains(&node) {
+                    BTreeSet::new()
+                } else {
+                    fulltext_entries(
+                        &snapshot.node_labels(node),
+                        &snapshot.node_property_ids(node).unwrap_or_default(),
+                        &fulltext_defs,
+                    )
+                };
+                let after = if self.tombstoned_nodes.contains(&node) {
+                    BTreeSet::new()
+                } else {
+                    fulltext_entries(
+                        &final_node_labels(
+                            node,
+                            &snapshot,
+                            &created_node_labels,
+                            &self.label_additions,
+                            &self.label_removals,
+                        ),
+                        &final_node_properties(
+                            node,
+                            &snapshot,
+                            &self.node_props,
+                            &self.removed_node_props,
+                        ),
+                        &fulltext_defs,
+                    )
+                };
+                let (chunk, _) = split_node_id(node);
+                for (entries, present) in [
+                    (before.difference(&after), false),
+                    (after.difference(&before), true),
+                ] {
+                    for (label, key, term) in entries {
+                        posting_ops
+                            .entry(fulltext_posting_key(*label, *key, term, chunk))
+                            .or_default()
+                            .insert(node, present);
+                    }
+                }
+            }
+        }
+        drop(fulltext_defs);
+        let posting_chunks = posting_ops.len() as u64;
+        for (key, ops) in posting_ops {
+            let mut ids: BTreeSet<InternalNodeId> = snapshot
+                .fulltext_posting(&key)
+                .unwrap_or_default()
+                .into_iter()
+                .collect();
+            for (node, present) in ops {
+                if present {
+                    ids.insert(node);
+                } else {
+                    ids.remove(&node);
+                }
+            }
+            if ids.is_empty() {
+                batch.remove(&self.engine.keyspaces.graph_data, key);
+            } else {
+                let ids: Vec<InternalNodeId> = ids.into_iter().collect();
+                batch.insert(&self.engine.keyspaces.graph_data, key, encode_posting(&ids));
+            }
+        }
         profile::event_since(
             "WriteTxn::commit.property_index_writes",
             property_index_writes_started,
             &[
                 ("label_additions", self.label_additions.len() as u64),
                 ("label_removals", self.label_removals.len() as u64),
+                ("label_chunks", label_chunks),
+                ("posting_chunks", posting_chunks),
                 ("node_props", self.node_props.len() as u64),
                 ("removed_node_props", self.removed_node_props.len() as u64),
+                ("node_prop_rows", node_prop_rows),
                 ("edge_props", self.edge_props.len() as u64),
                 ("removed_edge_props", self.removed_edge_props.len() as u64),
             ],
         );
 
+        let counter_writes_started = profile::start();
+        let mut label_deltas: BTreeMap<LabelId, i64> = BTreeMap::new();
+        let touched_nodes = self
+            .created_node_ids
+            .iter()
+            .chain(&self.tombstoned_nodes)
+            .chain(self.label_additions.iter().map(|(node, _)| node))
+            .chain(self.label_removals.iter().map(|(node, _)| node))
+            .copied()
+            .collect::<BTreeSet<_>>();
+        for node in touched_nodes {
+            let before: BTreeSet<LabelId> = if self.created_node_ids.contains(&node) {
+                BTreeSet::new()
+            } else {
+                snapshot.node_labels(node).into_iter().collect()
+            };
+            let after = if self.tombstoned_nodes.contains(&node) {
+                BTreeSet::new()
+            } else {
+                final_node_labels(
+                    node,
+                    &snapshot,
+                    &created_node_labels,
+                    &self.label_additions,
+                    &self.label_removals,
+                )
+            };
+            for label in after.difference(&before) {
+                *label_deltas.entry(*label).or_insert(0) += 1;
+            }
+            for label in before.difference(&after) {
+                *label_deltas.entry(*label).or_insert(0) -= 1;
+            }
+        }
+
+        // Edge writes are blind and idempotent, so only edges that change
+        // presence relative to the snapshot move the counters.
+        let edge_existed = |edge: &EdgeKey| {
+            !self.created_node_ids.contains(&edge.src)
+                && !self.created_node_ids.contains(&edge.dst)
+                && snapshot.adjacency_contains(AdjDirection::Out, edge.src, edge.rel, edge.dst)
+        };
+        let mut rel_deltas: BTreeMap<RelTypeId, i64> = BTreeMap::new();
+        for edge in &created_edges {
+            if !edge_existed(edge) {
+                *rel_deltas.entry(edge.rel).or_insert(0) += 1;
+            }
+        }
+        for edge in self
+            .tombstoned_edges
+            .union(&detached_edges)
+            .filter(|edge| edge_existed(edge))
+        {
+            *rel_deltas.entry(edge.rel).or_insert(0) -= 1;
+        }
+        for (rel, delta) in &streamed.rel_deltas {
+            *rel_deltas.entry(*rel).or_insert(0) += delta;
+        }
+
+        let mut counter_writes = 0u64;
+        let counters = label_deltas
+            .into_iter()
+            .map(|(label, delta)| (label_count_key(label), delta))
+            .chain(
+                rel_deltas
+                    .into_iter()
+                    .map(|(rel, delta)| (rel_count_key(rel), delta)),
+            );
+        for (key, delta) in counters {
+            if delta == 0 {
+                continue;
+            }
+            counter_writes += 1;
+            let count = snapshot
+                .stored_count(key.clone())
+                .saturating_add_signed(delta);
+            if count == 0 {
+                batch.remove(&self.engine.keyspaces.meta, key);
+            } else {
+                batch.insert(&self.engine.keyspaces.meta, key, count.to_be_bytes());
+            }
+        }
+        profile::event_since(
+            "WriteTxn::commit.counter_writes",
+            counter_writes_started,
+            &[("counters", counter_writes)],
+        );
+
+        if snapshot.statistics_analyzed() {
+            let statistics_started = profile::start();
+            let labels_of = |node: InternalNodeId| {
+                if self.tombstoned_nodes.contains(&node) {
+                    snapshot.node_labels(node).into_iter().collect()
+                } else {
+                    final_node_labels(
+                        node,
+                        &snapshot,
+                        &created_node_labels,
+                        &self.label_additions,
+                        &self.label_removals,
+                    )
+                }
+            };
+            let mut delta = StatisticsDelta::default();
+            for edge in created_edges.iter().filter(|edge| !edge_existed(edge)) {
+                delta.edge(edge, 1);
+            }
+            for edge in self
+                .tombstoned_edges
+                .union(&detached_edges)
+                .filter(|edge| edge_existed(edge))
+            {
+                delta.edge(edge, -1);
+            }
+            for ((node, key), value) in &self.node_props {
+                if self.tombstoned_nodes.contains(node)
+                    || node_property_removed_in_txn(*node, key, &self.removed_node_props)
+                {
+                    continue;
+                }
+                if let Some(key_id) = snapshot.property_key_id(key) {
+                    delta.value(labels_of(*node), key_id, value);
+                }
+            }
+            // A node that gains a label brings its values along.
+            for (node, label) in &self.label_additions {
+                if self.tombstoned_nodes.contains(node) || !labels_of(*node).contains(label) {
+                    continue;
+                }
+                let props = final_node_properties(
+                    *node,
+                    &snapshot,
+                    &self.node_props,
+                    &self.removed_node_props,
+                );
+                for (key, value) in &props {
+                    delta.value([*label], *key, value);
+                }
+            }
+            let records = delta.records(&snapshot, |node| labels_of(node).into_iter().collect());
+            let statistics_writes = records.len() as u64;
+            for (key, record) in records {
+                match record {
+                    Some(record) => batch.insert(&self.engine.keyspaces.meta, key, record),
+                    None => batch.remove(&self.engine.keyspaces.meta, key),
+                }
+            }
+            profile::event_since(
+                "WriteTxn::commit.statistics_writes",
+                statistics_started,
+                &[("records", statistics_writes)],
+            );
+        }
+
+        let vector_writes_started = profile::start();
+        let mut vector_puts = self.node_vectors.clone();
+        vector_puts.retain(|node, _| !self.tombstoned_nodes.contains(node));
+        let vector_removals: BTreeSet<InternalNodeId> = self
+            .tombstoned_nodes
+            .iter()
+            .copied()
+            .filter(|node| self.engine.vectors.has_vector(*node))
+            .collect();
+        let vectors_changed = !vector_puts.is_empty() || !vector_removals.is_empty();
+        if vectors_changed {
+            let (seq, writes) = match self.engine.vectors.stage(&vector_puts, &vector_removals) {
+                Ok(staged) => staged,
+                Err(err) => {
+                    self.engine.property_keys.forget(&created_prop_keys);
+                    return Err(err);
+                }
+            };
+            for (key, value) in writes {
+                if let Some(value) = value {
+                    batch.insert(&self.engine.keyspaces.vectors, key, value);
+                } else {
+                    batch.remove(&self.engine.keyspaces.vectors, key);
+                }
+            }
+            batch.insert(
+                &self.engine.keyspaces.meta,
+                META_VECTOR_SEQ,
+                seq.to_be_bytes(),
+            );
+        }
+        profile::event_since(
+            "WriteTxn::commit.vector_writes",
+            vector_writes_started,
+            &[
+                ("vector_puts", vector_puts.len() as u64),
+                ("vector_removals", vector_removals.len() as u64),
+            ],
+        );
+
+        let created_records = self
+            .created_nodes
+            .iter()
+            .map(|node| node.iid)
+            .filter(|iid| !self.tombstoned_nodes.contains(iid));
+        let liveness_changed = created_node_writes > 0 || !tombstoned_records.is_empty();
+        if liveness_changed {
+            let seq = self
+                .engine
+                .node_liveness
+                .stage(created_records, tombstoned_records);
+            batch.insert(
+                &self.engine.keyspaces.meta,
+                META_NODE_LIVENESS_SEQ,
+                seq.to_be_bytes(),
+            );
+        }
+
+        if spill.is_some() {
+            batch.insert(
+                &self.engine.keyspaces.meta,
+                META_STREAMED_COMMIT,
+                encode_streamed_marker(&self.tombstoned_edges, &self.removed_edge_props),
+            );
+            *self.engine.fence.write().unwrap() = Some(snapshot.clone());
+        }
+
         let batch_commit_started = profile::start();
-        batch.commit()?;
+        if let Err(err) = batch.commit() {
+            self.engine.node_liveness.abort();
+            self.engine.vectors.abort();
+            self.engine.property_keys.forget(&created_prop_keys);
+            *self.engine.fence.write().unwrap() = None;
+            return Err(err.into());
+        }
+        if liveness_changed {
+            self.engine.node_liveness.publish();
+        }
+        if vectors_changed {
+            self.engine.vectors.publish();
+        }
+        if let Some(spill) = &mut spill {
+            let streamed_apply_started = profile::start();
+            let applied = apply_streamed(
+                self.engine,
+                &snapshot,
+                &spill.runs(),
+                |node| self.created_node_ids.contains(&node),
+                |edge| self.edge_deleted_in_txn(edge),
+                &self.removed_edge_props,
+            );
+            let edges = match applied {
+                Ok(edges) => edges,
+                Err(err) => {
+                    // The marker is committed, so the runs must outlive us
+                    // and the fence stays up until a reopen applies them.
+                    // Syncing makes that reopen finish the commit even
+                    // after a crash.
+                    spill.retain = true;
+                    let _ = self.engine.persist();
+                    return Err(err);
+                }
+            };
+            *self.engine.fence.write().unwrap() = None;
+            profile::event_since(
+                "WriteTxn::commit.streamed_apply",
+                streamed_apply_started,
+                &[("edges", edges)],
+            );
+        }
+        let ticket = self.engine.group_commit.ticket();
         profile::event_since("WriteTxn::commit.batch_commit", batch_commit_started, &[]);
+        if adj_delta_lists > 0 {
+            // The transaction is already written. A failed fold leaves valid
+            // delta records behind, and the next commit or checkpoint retries.
+            let _ = self
+                .engine
+                .fold_adjacency_deltas(&self.engine.adjacency_deltas.due());
+        }
+        drop(self._guard);
+
+        let durable_wait_started = profile::start();
+        // Runs are deleted on drop, so a streamed commit waits until
+        // recovery no longer needs them.
+        let durability = if spill.is_some() {
+            Durability::SyncAll
+        } else {
+            self.durability
+        };
+        let result = self.engine.wait_durable(ticket, durability);
+        if result.is_err()
+            && let Some(spill) = &mut spill
+        {
+            spill.retain = true;
+        }
+        drop(spill);
+        profile::event_since(
+            "WriteTxn::commit.durable_wait",
+            durable_wait_started,
+            &[("ticket", ticket)],
+        );
         profile::event_since("WriteTxn::commit", commit_started, &[]);
-        Ok(())
+        result
     }
 }
 
@@ -1118,6 +2419,7 @@ fn open_keyspaces(db: &Database, meta: Keyspace) -> Result<Keyspaces> {
         graph_data: db.keyspace("graph_data", KeyspaceCreateOptions::default)?,
         adj_out: db.keyspace("adj_out", KeyspaceCreateOptions::default)?,
         adj_in: db.keyspace("adj_in", KeyspaceCreateOptions::default)?,
+        vectors: db.keyspace("vectors", KeyspaceCreateOptions::default)?,
     })
 }
 
@@ -1200,6 +2502,8 @@ fn ensure_meta(db: &Database, meta: &Keyspace) -> Result<()> {
     batch.insert(meta, META_NEXT_NODE_ID, 0u64.to_be_bytes());
     batch.insert(meta, META_NEXT_LABEL_ID, 1u64.to_be_bytes());
     batch.insert(meta, META_NEXT_REL_TYPE_ID, 1u64.to_be_bytes());
+    batch.insert(meta, META_COUNTERS, 1u64.to_be_bytes());
+    batch.insert(meta, META_EDGE_PROP_INDEX, 1u64.to_be_bytes());
     batch.commit()?;
     profile::event_since("GraphEngine::open.meta", meta_started, &[]);
     Ok(())
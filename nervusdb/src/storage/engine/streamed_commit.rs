@@ -0,0 +1,504 @@
+//! Spill-to-disk staging for write transactions larger than memory.
+//!
+//! A `WriteTxn` whose staged edges and edge properties outgrow
+//! `DbOptions::staging_budget` moves them into an [`EdgeSpill`]: three
+//! external sorters holding the edges by `(src, rel, dst)`, by
+//! `(dst, rel, src)`, and the edge property sets. Later edges keep staging in
+//! memory and spill again at the next crossing. Everything else a
+//! transaction stages stays in memory.
+//!
+//! Commit checks the runs in one read-only pass, then persists them and
+//! writes the in-memory part of the transaction in one batch that also sets
+//! the `streamed_commit` meta marker. The runs are then applied in bounded
+//! unsynced batches: packed lists for nodes created by the transaction, delta
+//! records for existing nodes, and edge properties with their index entries.
+//! The last batch removes the marker. Every applied write is a blind put, so
+//! applying the runs again gives the same graph.
+//!
+//! Until the last batch lands, `GraphEngine::begin_read` hands out the
+//! snapshot the commit started from, so readers see the whole transaction or
+//! none of it. After a crash, `GraphEngine::open` finds the marker and
+//! applies the persisted runs again before it returns.
+
+use super::adjacency::packed_list_writes;
+use super::bulk_load::{BulkWriter, edge_run_key, parse_edge_run_key};
+use super::{GraphEngine, edge_property_removed_in_txn, scalar_indexable_value, sync_directory};
+use crate::api::{EdgeKey, InternalNodeId, PropertyValue, RelTypeId};
+use crate::storage::adjacency_delta::AdjacencyList;
+use crate::storage::external_sort::{ExternalSorter, SortedRecords, merge_runs, runs_in};
+use crate::storage::layout::*;
+use crate::storage::profile;
+use crate::storage::snapshot::Snapshot;
+use crate::storage::{Error, Result};
+use std::collections::{BTreeMap, BTreeSet, HashMap};
+use std::path::{Path, PathBuf};
+
+/// Present while a streamed commit is applying its runs. Holds the edges
+/// tombstoned and the edge properties removed by the transaction, which the
+/// runs must not bring back.
+pub(super) const META_STREAMED_COMMIT: &[u8] = b"streamed_commit";
+
+/// Bytes one staged edge or edge property is charged against
+/// `DbOptions::staging_budget`, beyond the property key itself.
+pub(super) const STAGED_EDGE_BYTES: usize = 64;
+
+const OUT_RUNS: &str = "out";
+const IN_RUNS: &str = "in";
+const PROP_RUNS: &str = "props";
+
+/// Staging runs live beside the directory, outside Fjall's file layout.
+pub(super) fn staging_dir(path: &Path) -> PathBuf {
+    let mut name = path.file_name().unwrap_or_default().to_os_string();
+    name.push(".staging");
+    path.with_file_name(name)
+}
+
+/// Spilled edges and edge properties of one write transaction.
+#[derive(Debug)]
+pub(super) struct EdgeSpill {
+    dir: PathBuf,
+    out: ExternalSorter,
+    incoming: ExternalSorter,
+    props: ExternalSorter,
+    /// Property keys of the spilled properties, interned at commit.
+    pub(super) prop_names: BTreeSet<String>,
+    /// Edges the transaction changed that neither memory nor the snapshot
+    /// holds; commit requires each to be in the runs.
+    pub(super) deferred: BTreeSet<EdgeKey>,
+    /// Keeps the runs on drop once recovery may need them.
+    pub(super) retain: bool,
+}
+
+/// What the read-only pass over the runs found.
+#[derive(Debug, Default)]
+pub(super) struct StreamCheck {
+    /// Deferred edges that the runs create.
+    pub(super) seen: BTreeSet<EdgeKey>,
+    pub(super) rel_deltas: BTreeMap<RelTypeId, i64>,
+    pub(super) edges: u64,
+}
+
+impl EdgeSpill {
+    /// Creates the staging directory of `path`, which only the transaction
+    /// holding `write_lock` uses. Open removes leftovers, so an existing
+    /// directory holds the runs of a commit that failed to finish.
+    pub(super) fn create(path: &Path) -> Result<Self> {
+        let dir = staging_dir(path);
+        if dir.exists() {
+            return Err(Error::Io(std::io::Error::new(
+                std::io::ErrorKind::AlreadyExists,
+                format!(
+                    "{} holds the runs of an unfinished commit; reopen the database",
+                    dir.display()
+                ),
+            )));
+        }
+        std::fs::create_dir_all(&dir)?;
+        Ok(Self {
+            out: ExternalSorter::new(&dir, OUT_RUNS, usize::MAX),
+            incoming: ExternalSorter::new(&dir, IN_RUNS, usize::MAX),
+            props: ExternalSorter::new(&dir, PROP_RUNS, usize::MAX),
+            dir,
+            prop_names: BTreeSet::new(),
+            deferred: BTreeSet::new(),
+            retain: false,
+        })
+    }
+
+    /// Writes `edges` and `props` as one new run per sorter. Runs merge in
+    /// write order, so a property set again later wins.
+    pub(super) fn stage(
+        &mut self,
+        edges: impl IntoIterator<Item = EdgeKey>,
+        props: impl IntoIterator<Item = ((EdgeKey, String), PropertyValue)>,
+    ) -> Result<()> {
+        for edge in edges {
+            self.out
+                .push(edge_run_key(edge.src, edge.rel, edge.dst), Vec::new())?;
+            self.incoming
+                .push(edge_run_key(edge.dst, edge.rel, edge.src), Vec::new())?;
+        }
+        for ((edge, key), value) in props {
+            let mut run_key = edge_run_key(edge.src, edge.rel, edge.dst);
+            run_key.extend_from_slice(key.as_bytes());
+            self.props.push(run_key, value.encode())?;
+            if !self.prop_names.contains(&key) {
+                self.prop_names.insert(key);
+            }
+        }
+        self.out.spill()?;
+        self.incoming.spill()?;
+        self.props.spill()
+    }
+
+    /// Makes every run durable before the marker that points at them.
+    pub(super) fn persist(&mut self) -> Result<()> {
+        self.out.persist()?;
+        self.incoming.persist()?;
+        self.props.persist()?;
+        sync_directory(&self.dir)
+    }
+
+    pub(super) fn runs(&self) -> StreamedRuns {
+        StreamedRuns {
+            out: self.out.runs().to_vec(),
+            incoming: self.incoming.runs().to_vec(),
+            props: self.props.runs().to_vec(),
+        }
+    }
+
+    /// Validates the spilled edges and properties the way commit validates
+    /// staged ones, and counts the edges that are new to the snapshot.
+    pub(super) fn check(
+        &self,
+        snapshot: &Snapshot,
+        created: impl Fn(InternalNodeId) -> bool,
+        deleted: impl Fn(EdgeKey) -> bool,
+        live: impl Fn(InternalNodeId) -> bool,
+    ) -> Result<StreamCheck> {
+        let mut check = StreamCheck::default();
+        let mut edges = merge_runs(self.out.runs())?;
+        while let Some((key, _)) = edges.next_record()? {
+            let edge = run_edge(&key)?;
+            if self.deferred.contains(&edge) {
+                check.seen.insert(edge);
+            }
+            if deleted(edge) {
+                continue;
+            }
+            if !live(edge.src) || !live(edge.dst) {
+                return Err(edge_not_found(edge));
+            }
+            check.edges += 1;
+            if created(edge.src)
+                || created(edge.dst)
+                || !snapshot.adjacency_contains(AdjDirection::Out, edge.src, edge.rel, edge.dst)
+            {
+                *check.rel_deltas.entry(edge.rel).or_insert(0) += 1;
+            }
+        }
+        if let Some(edge) = self.deferred.difference(&check.seen).next() {
+            return Err(edge_not_found(*edge));
+        }
+        let mut props = merge_runs(self.props.runs())?;
+        while let Some((key, _)) = props.next_record()? {
+            let edge = run_edge(&key)?;
+            if deleted(edge) || !live(edge.src) || !live(edge.dst) {
+                return Err(edge_not_found(edge));
+            }
+        }
+        Ok(check)
+    }
+}
+
+impl Drop for EdgeSpill {
+    fn drop(&mut self) {
+        if !self.retain {
+            let _ = std::fs::remove_dir_all(&self.dir);
+        }
+    }
+}
+
+/// Run files of one streamed commit, oldest first per sorter.
+#[derive(Debug, Default)]
+pub(super) struct StreamedRuns {
+    out: Vec<PathBuf>,
+    incoming: Vec<PathBuf>,
+    props: Vec<PathBuf>,
+}
+
+impl StreamedRuns {
+    fn load(dir: &Path) -> Result<Self> {
+        Ok(Self {
+            out: runs_in(dir, OUT_RUNS)?,
+            incoming: runs_in(dir, IN_RUNS)?,
+            props: runs_in(dir, PROP_RUNS)?,
+        })
+    }
+}
+
+/// Applies `runs` in unsynced batches and removes the marker in the last
+/// one. Lists of `created` nodes are written packed; other lists get delta
+/// records. Edges that `skip` accepts and properties in `removed_props` are
+/// left out. Returns the number of edges applied.
+pub(super) fn apply_streamed(
+    engine: &GraphEngine,
+    snapshot: &Snapshot,
+    runs: &StreamedRuns,
+    created: impl Fn(InternalNodeId) -> bool,
+    skip: impl Fn(EdgeKey) -> bool,
+    removed_props: &[(EdgeKey, String)],
+) -> Result<u64> {
+    let mut writer = BulkWriter::new(engine);
+    let mut deltas = DeltaWriter::default();
+    let edges = write_lists(
+        engine,
+        &mut writer,
+        &mut deltas,
+        merge_runs(&runs.out)?,
+        AdjDirection::Out,
+        &created,
+        &skip,
+    )?;
+    write_lists(
+        engine,
+        &mut writer,
+        &mut deltas,
+        merge_runs(&runs.incoming)?,
+        AdjDirection::In,
+        &created,
+        &skip,
+    )?;
+    deltas.flush(engine, &mut writer)?;
+
+    let mut props = merge_runs(&runs.props)?;
+    while let Some((key, value)) = props.next_record()? {
+        let edge = run_edge(&key)?;
+        let name = std::str::from_utf8(&key[12..])
+            .map_err(|_| Error::StorageCorrupted("invalid streamed property key".to_string()))?;
+        if skip(edge) || edge_property_removed_in_txn(edge, name, removed_props) {
+            continue;
+        }
+        let Some(key_id) = snapshot.property_key_id(name) else {
+            return Err(Error::StorageCorrupted(format!(
+                "streamed property key {name} is not interned"
+            )));
+        };
+        let decoded =
+            PropertyValue::decode(&value).map_err(|err| Error::PropertyDecode(err.to_string()))?;
+        let new_index_key =
+            scalar_indexable_value(&decoded).then(|| edge_prop_index_key(key_id, &decoded, edge));
+        if !created(edge.src)
+            && !created(edge.dst)
+            && let Some(old) = snapshot.edge_property_by_id(edge, key_id)
+            && scalar_indexable_value(&old)
+        {
+            let old_index_key = edge_prop_index_key(key_id, &old, edge);
+            if new_index_key.as_ref() != Some(&old_index_key) {
+                writer.remove(&engine.keyspaces.graph_data, old_index_key)?;
+            }
+        }
+        writer.insert(
+            &engine.keyspaces.graph_data,
+            edge_prop_key(edge, key_id),
+            value,
+        )?;
+        if let Some(index_key) = new_index_key {
+            writer.insert(&engine.keyspaces.graph_data, index_key, Vec::new())?;
+        }
+    }
+
+    writer.remove(&engine.keyspaces.meta, META_STREAMED_COMMIT.to_vec())?;
+    writer.flush()?;
+    Ok(edges)
+}
+
+/// Writes the lists of one direction from its sorted edge stream and returns
+/// the number of edges applied.
+fn write_lists<'e>(
+    engine: &'e GraphEngine,
+    writer: &mut BulkWriter<'e>,
+    deltas: &mut DeltaWriter,
+    mut edges: SortedRecords,
+    dir: AdjDirection,
+    created: impl Fn(InternalNodeId) -> bool,
+    skip: impl Fn(EdgeKey) -> bool,
+) -> Result<u64> {
+    let keyspace = engine.keyspaces.adjacency(dir);
+    let mut total = 0u64;
+    let mut list: Option<(InternalNodeId, RelTypeId)> = None;
+    let mut others: Vec<InternalNodeId> = Vec::new();
+    loop {
+        let next = edges
+            .next_record()?
+            .map(|(key, _)| parse_edge_run_key(&key).ok_or_else(invalid_run))
+            .transpose()?;
+        if let Some((node, rel)) = list
+            && next.is_none_or(|(next_node, next_rel, _)| (next_node, next_rel) != (node, rel))
+            && !others.is_empty()
+        {
+            for (key, value) in packed_list_writes(dir, node, rel, &others) {
+                if let Some(value) = value {
+                    writer.insert(keyspace, key, value)?;
+                }
+            }
+            others.clear();
+        }
+        let Some((node, rel, other)) = next else {
+            return Ok(total);
+        };
+        list = Some((node, rel));
+        let edge = match dir {
+            AdjDirection::Out => EdgeKey {
+                src: node,
+                rel,
+                dst: other,
+            },
+            AdjDirection::In => EdgeKey {
+                src: other,
+                rel,
+                dst: node,
+            },
+        };
+        if skip(edge) {
+            continue;
+        }
+        total += 1;
+        if created(node) {
+            others.push(other);
+        } else {
+            deltas.add(engine, writer, (dir, node, rel), other)?;
+        }
+    }
+}
+
+/// Delta records of existing lists, cut into one sequence number per
+/// `DELTA_OPS` additions so no single record grows with the transaction.
+#[derive(Debug, Default)]
+struct DeltaWriter {
+    lists: HashMap<AdjacencyList, BTreeMap<InternalNodeId, bool>>,
+    ops: usize,
+}
+
+const DELTA_OPS: usize = 64 * 1024;
+
+impl DeltaWriter {
+    fn add<'e>(
+        &mut self,
+        engine: &'e GraphEngine,
+        writer: &mut BulkWriter<'e>,
+        list: AdjacencyList,
+        other: InternalNodeId,
+    ) -> Result<()> {
+        self.lists.entry(list).or_default().insert(other, true);
+        self.ops += 1;
+        if self.ops >= DELTA_OPS {
+            self.flush(engine, writer)?;
+        }
+        Ok(())
+    }
+
+    fn flush<'e>(&mut self, engine: &'e GraphEngine, writer: &mut BulkWriter<'e>) -> Result<()> {
+        if self.lists.is_empty() {
+            return Ok(());
+        }
+        let seq = engine.adjacency_deltas.record(self.lists.keys().copied());
+        for ((dir, node, rel), ops) in std::mem::take(&mut self.lists) {
+            writer.insert(
+                &engine.keyspaces.graph_data,
+                adj_delta_key(dir, node, rel, seq),
+                encode_adj_delta(&ops),
+            )?;
+        }
+        self.ops = 0;
+        Ok(())
+    }
+}
+
+/// Finishes a streamed commit interrupted by a crash. The transaction's
+/// in-memory part is already committed, so its tombstones decide which
+/// spilled edges to leave out. Every list gets delta records, which are
+/// correct whatever part of the runs was applied before the crash.
+pub(super) fn finish_streamed_commit(engine: &GraphEngine, marker: &[u8]) -> Result<()> {
+    let started = profile::start();
+    let (tombstoned, removed_props) = decode_streamed_marker(marker)?;
+    let dir = staging_dir(&engine.path);
+    if !dir.is_dir() {
+        return Err(Error::StorageCorrupted(format!(
+            "streamed commit runs are missing from {}",
+            dir.display()
+        )));
+    }
+    let runs = StreamedRuns::load(&dir)?;
+    let snapshot = engine.begin_read();
+    let edges = apply_streamed(
+        engine,
+        &snapshot,
+        &runs,
+        |_| false,
+        |edge| {
+            tombstoned.contains(&edge)
+                || !snapshot.node_is_live(edge.src)
+                || !snapshot.node_is_live(edge.dst)
+        },
+        &removed_props,
+    )?;
+    engine.persist()?;
+    std::fs::remove_dir_all(&dir)?;
+    profile::event_since(
+        "GraphEngine::open.finish_streamed_commit",
+        started,
+        &[("edges", edges)],
+    );
+    Ok(())
+}
+
+pub(super) fn encode_streamed_marker(
+    tombstoned: &BTreeSet<EdgeKey>,
+    removed_props: &[(EdgeKey, String)],
+) -> Vec<u8> {
+    let mut out = Vec::new();
+    out.extend_from_slice(&(tombstoned.len() as u32).to_be_bytes());
+    for edge in tombstoned {
+        out.extend_from_slice(&edge_run_key(edge.src, edge.rel, edge.dst));
+    }
+    out.extend_from_slice(&(removed_props.len() as u32).to_be_bytes());
+    for (edge, key) in removed_props {
+        out.extend_from_slice(&edge_run_key(edge.src, edge.rel, edge.dst));
+        out.extend_from_slice(&(key.len() as u32).to_be_bytes());
+        out.extend_from_slice(key.as_bytes());
+    }
+    out
+}
+
+type StreamedMarker = (BTreeSet<EdgeKey>, Vec<(EdgeKey, String)>);
+
+fn decode_streamed_marker(bytes: &[u8]) -> Result<StreamedMarker> {
+    let mut at = 0usize;
+    let mut tombstoned = BTreeSet::new();
+    for _ in 0..marker_u32(bytes, &mut at)? {
+        tombstoned.insert(run_edge(marker_bytes(bytes, &mut at, 12)?)?);
+    }
+    let mut removed_props = Vec::new();
+    for _ in 0..marker_u32(bytes, &mut at)? {
+        let edge = run_edge(marker_bytes(bytes, &mut at, 12)?)?;
+        let len = marker_u32(bytes, &mut at)? as usize;
+        let key = std::str::from_utf8(marker_bytes(bytes, &mut at, len)?)
+            .map_err(|_| invalid_marker())?;
+        removed_props.push((edge, key.to_string()));
+    }
+    Ok((tombstoned, removed_props))
+}
+
+fn marker_bytes<'b>(bytes: &'b [u8], at: &mut usize, len: usize) -> Result<&'b [u8]> {
+    let slice = bytes.get(*at..*at + len).ok_or_else(invalid_marker)?;
+    *at += len;
+    Ok(slice)
+}
+
+fn marker_u32(bytes: &[u8], at: &mut usize) -> Result<u32> {
+    let slice = marker_bytes(bytes, at, 4)?;
+    Ok(u32::from_be_bytes(slice.try_into().expect("4 bytes")))
+}
+
+fn invalid_marker() -> Error {
+    Error::StorageCorrupted("invalid streamed commit marker".to_string())
+}
+
+/// Edge of an out-direction run key, which may carry a property key suffix.
+fn run_edge(key: &[u8]) -> Result<EdgeKey> {
+    let (src, rel, dst) = parse_edge_run_key(key).ok_or_else(invalid_run)?;
+    Ok(EdgeKey { src, rel, dst })
+}
+
+fn invalid_run() -> Error {
+    Error::StorageCorrupted("invalid streamed commit run".to_string())
+}
+
+fn edge_not_found(edge: EdgeKey) -> Error {
+    Error::EdgeNotFound {
+        src: edge.src,
+        rel: edge.rel,
+        dst: edge.dst,
+    }
+}
@@ -27,4 +27,22 @@ pub enum Error {
 
     #[error("property decode error: {0}")]
     PropertyDecode(String),
+
+    #[error("invalid index definition: {0}")]
+    InvalidIndexDefinition(String),
+
+    #[error("invalid vector: {0}")]
+    InvalidVector(String),
+
+    #[error("bulk load error: {0}")]
+    BulkLoad(String),
+
+    #[error("unique constraint violated: label {label} key {key} is already held by node {node}")]
+    UniqueConstraintViolation { label: u32, key: String, node: u32 },
+
+    #[error("a streamed commit did not finish applying; reopen the database to finish it")]
+    StreamedCommitUnfinished,
+
+    #[error("a journal sync failed ({0}); reopen the database to write again")]
+    SyncFailed(String),
 }
@@ -0,0 +1,285 @@
+//! Sorted spill runs for record streams larger than memory.
+//!
+//! An [`ExternalSorter`] buffers `(key, value)` records until their size
+//! crosses its byte budget, then sorts the buffer and writes it to a run file.
+//! [`ExternalSorter::finish`] merges the runs and the last buffer into one
+//! ascending stream. Records with equal keys collapse to the one pushed last,
+//! which gives loaders the same last-write-wins rule as a write batch.
+//!
+//! Run files hold `[key_len u32][value_len u32][key][value]` records and are
+//! deleted when the merged stream is dropped. Runs made durable with
+//! [`ExternalSorter::persist`] can instead be merged any number of times with
+//! [`merge_runs`], which leaves them on disk.
+
+use crate::storage::{Error, Result};
+use std::cmp::Reverse;
+use std::collections::BinaryHeap;
+use std::fs::File;
+use std::io::{BufReader, BufWriter, Read, Write};
+use std::path::{Path, PathBuf};
+
+/// Bytes a buffered record costs beyond its key and value.
+const RECORD_OVERHEAD: usize = 48;
+
+type Record = (Vec<u8>, Vec<u8>);
+
+#[derive(Debug)]
+pub(crate) struct ExternalSorter {
+    dir: PathBuf,
+    name: &'static str,
+    budget: usize,
+    buffer: Vec<Record>,
+    buffered: usize,
+    runs: Vec<PathBuf>,
+}
+
+impl ExternalSorter {
+    /// Spills into `dir`, which must exist, once the buffer exceeds `budget`
+    /// bytes. `name` keeps the run files of sorters sharing `dir` apart.
+    pub(crate) fn new(dir: &Path, name: &'static str, budget: usize) -> Self {
+        Self {
+            dir: dir.to_path_buf(),
+            name,
+            budget,
+            buffer: Vec::new(),
+            buffered: 0,
+            runs: Vec::new(),
+        }
+    }
+
+    pub(crate) fn push(&mut self, key: Vec<u8>, value: Vec<u8>) -> Result<()> {
+        self.buffered += key.len() + value.len() + RECORD_OVERHEAD;
+        self.buffer.push((key, value));
+        if self.buffered > self.budget {
+            self.spill()?;
+        }
+        Ok(())
+    }
+
+    /// Run files written so far.
+    pub(crate) fn spilled_runs(&self) -> usize {
+        self.runs.len()
+    }
+
+    /// Run files written so far, oldest first.
+    pub(crate) fn runs(&self) -> &[PathBuf] {
+        &self.runs
+    }
+
+    /// Spills the buffer, if any, and fsyncs every run file. The caller
+    /// syncs the directory.
+    pub(crate) fn persist(&mut self) -> Result<()> {
+        if !self.buffer.is_empty() {
+            self.spill()?;
+        }
+        for path in &self.runs {
+            File::open(path)?.sync_all()?;
+        }
+        Ok(())
+    }
+
+    /// Writes the buffer as one run, whatever its size.
+    pub(crate) fn spill(&mut self) -> Result<()> {
+        if self.buffer.is_empty() {
+            return Ok(());
+        }
+        // Stable, so equal keys keep push order inside the run.
+        self.buffer.sort_by(|a, b| a.0.cmp(&b.0));
+        let path = self
+            .dir
+            .join(format!("{}-{:06}.run", self.name, self.runs.len()));
+        let mut out = BufWriter::new(File::create(&path)?);
+        for (key, value) in self.buffer.drain(..) {
+            out.write_all(&(key.len() as u32).to_be_bytes())?;
+            out.write_all(&(value.len() as u32).to_be_bytes())?;
+            out.write_all(&key)?;
+            out.write_all(&value)?;
+        }
+        out.flush()?;
+        self.runs.push(path);
+        self.buffered = 0;
+        Ok(())
+    }
+
+    /// Merges every run and the remaining buffer into one sorted stream.
+    pub(crate) fn finish(mut self) -> Result<SortedRecords> {
+        self.buffer.sort_by(|a, b| a.0.cmp(&b.0));
+        let mut sources = Vec::with_capacity(self.runs.len() + 1);
+        for path in &self.runs {
+            sources.push(Source::Run(BufReader::new(File::open(path)?)));
+        }
+        // The buffer holds the newest records, so it merges last.
+        sources.push(Source::Memory(std::mem::take(&mut self.buffer).into_iter()));
+        let mut merged = SortedRecords {
+            sources,
+            heap: BinaryHeap::new(),
+            runs: std::mem::take(&mut self.runs),
+        };
+        for index in 0..merged.sources.len() {
+            merged.refill(index)?;
+        }
+        Ok(merged)
+    }
+}
+
+/// Run files of sorter `name` in `dir`, oldest first.
+pub(crate) fn runs_in(dir: &Path, name: &str) -> Result<Vec<PathBuf>> {
+    let prefix = format!("{name}-");
+    let mut runs = Vec::new();
+    for entry in std::fs::read_dir(dir)? {
+        let path = entry?.path();
+        if path
+            .file_name()
+            .and_then(|name| name.to_str())
+            .is_some_and(|file| file.starts_with(&prefix) && file.ends_with(".run"))
+        {
+            runs.push(path);
+        }
+    }
+    // Run numbers are zero-padded, so name order is write order.
+    runs.sort();
+    Ok(runs)
+}
+
+/// Merges `runs`, oldest first, without deleting them.
+pub(crate) fn merge_runs(runs: &[PathBuf]) -> Result<SortedRecords> {
+    let mut merged = SortedRecords {
+        sources: Vec::with_capacity(runs.len()),
+        heap: BinaryHeap::new(),
+        runs: Vec::new(),
+    };
+    for path in runs {
+        merged
+            .sources
+            .push(Source::Run(BufReader::new(File::open(path)?)));
+    }
+    for index in 0..merged.sources.len() {
+        merged.refill(index)?;
+    }
+    Ok(merged)
+}
+
+#[derive(Debug)]
+enum Source {
+    Run(BufReader<File>),
+    Memory(std::vec::IntoIter<Record>),
+}
+
+impl Source {
+    fn next_record(&mut self) -> Result<Option<Record>> {
+        let reader = match self {
+            Source::Memory(records) => return Ok(records.next()),
+            Source::Run(reader) => reader,
+        };
+        let mut lens = [0u8; 8];
+        match reader.read_exact(&mut lens) {
+            Ok(()) => {}
+            Err(err) if err.kind() == std::io::ErrorKind::UnexpectedEof => return Ok(None),
+            Err(err) => return Err(err.into()),
+        }
+        let key_len = u32::from_be_bytes(lens[..4].try_into().expect("4 bytes")) as usize;
+        let value_len = u32::from_be_bytes(lens[4..].try_into().expect("4 bytes")) as usize;
+        let mut key = vec![0u8; key_len];
+        let mut value = vec![0u8; value_len];
+        reader
+            .read_exact(&mut key)
+            .and_then(|()| reader.read_exact(&mut value))
+            .map_err(|err| Error::StorageCorrupted(format!("truncated sort run: {err}")))?;
+        Ok(Some((key, value)))
+    }
+}
+
+/// Ascending, key-distinct record stream produced by
+/// [`ExternalSorter::finish`].
+#[derive(Debug)]
+pub(crate) struct SortedRecords {
+    sources: Vec<Source>,
+    /// Head record of every unfinished source; ties pop the older source
+    /// first.
+    heap: BinaryHeap<Reverse<(Vec<u8>, usize, Vec<u8>)>>,
+    runs: Vec<PathBuf>,
+}
+
+impl SortedRecords {
+    fn refill(&mut self, index: usize) -> Result<()> {
+        if let Some((key, value)) = self.sources[index].next_record()? {
+            self.heap.push(Reverse((key, index, value)));
+        }
+        Ok(())
+    }
+
+    pub(crate) fn next_record(&mut self) -> Result<Option<Record>> {
+        let Some(Reverse((key, index, mut value))) = self.heap.pop() else {
+            return Ok(None);
+        };
+        self.refill(index)?;
+        while let Some(Reverse((next, _, _))) = self.heap.peek()
+            && *next == key
+        {
+            let Reverse((_, index, newer)) = self.heap.pop().expect("peeked");
+            value = newer;
+            self.refill(index)?;
+        }
+        Ok(Some((key, value)))
+    }
+}
+
+impl Drop for SortedRecords {
+    fn drop(&mut self) {
+        self.sources.clear();
+        for path in &self.runs {
+            let _ = std::fs::remove_file(path);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{ExternalSorter, merge_runs, runs_in};
+    use tempfile::tempdir;
+
+    #[test]
+    fn merges_spilled_runs_in_key_order_with_last_write_winning() {
+        let dir = tempdir().unwrap();
+        let mut sorter = ExternalSorter::new(dir.path(), "test", 256);
+        for round in 0..3u8 {
+            for key in (0..40u32).rev() {
+                sorter
+                    .push(key.to_be_bytes().to_vec(), vec![round])
+                    .unwrap();
+            }
+        }
+        assert!(sorter.spilled_runs() > 1);
+
+        let mut merged = sorter.finish().unwrap();
+        let mut seen = Vec::new();
+        while let Some((key, value)) = merged.next_record().unwrap() {
+            assert_eq!(value, vec![2]);
+            seen.push(u32::from_be_bytes(key.try_into().unwrap()));
+        }
+        assert_eq!(seen, (0..40).collect::<Vec<_>>());
+        drop(merged);
+        assert_eq!(std::fs::read_dir(dir.path()).unwrap().count(), 0);
+    }
+
+    #[test]
+    fn persisted_runs_merge_repeatedly_and_stay_on_disk() {
+        let dir = tempdir().unwrap();
+        let mut sorter = ExternalSorter::new(dir.path(), "edges", usize::MAX);
+        sorter.push(vec![2], vec![0]).unwrap();
+        sorter.push(vec![1], vec![0]).unwrap();
+        sorter.spill().unwrap();
+        sorter.push(vec![2], vec![1]).unwrap();
+        sorter.persist().unwrap();
+
+        let runs = runs_in(dir.path(), "edges").unwrap();
+        assert_eq!(runs, sorter.runs());
+        for _ in 0..2 {
+            let mut merged = merge_runs(&runs).unwrap();
+            assert_eq!(merged.next_record().unwrap(), Some((vec![1], vec![0])));
+            assert_eq!(merged.next_record().unwrap(), Some((vec![2], vec![1])));
+            assert_eq!(merged.next_record().unwrap(), None);
+        }
+        assert!(runs.iter().all(|run| run.exists()));
+    }
+}
@@ -0,0 +1,197 @@
+//! Declared full-text indexes over string properties of `(label, key)`.
+//!
+//! Each term of an indexed value (see `api::text_terms`) has a posting list
+//! of the nodes holding it, split per 2^16-id chunk like label bitmaps so a
+//! commit rewrites only the chunks it touches:
+//!
+//! ```text
+//! 0x57 FULLTEXT_INDEX_DEF [tag][label][key_id] -> empty
+//! 0x58 FULLTEXT_POSTING   [tag][label][key_id][term_len:u8][term][chunk:u16] -> ids
+//! ```
+//!
+//! Posting values use the adjacency codec, which stores sorted ids as
+//! bit-packed gaps. Multi-term queries intersect the lists shortest first,
+//! galloping through the longer ones.
+
+use crate::api::{InternalNodeId, LabelId, PropertyValue, text_terms};
+use crate::storage::Result;
+use crate::storage::adjacency_codec;
+use crate::storage::label_bitmap::split_node_id;
+use crate::storage::layout::{
+    fulltext_index_def_scan_prefix, fulltext_posting_key, parse_fulltext_index_def_key,
+};
+use crate::storage::property_keys::PropertyKeyId;
+use fjall::Keyspace;
+use std::collections::{BTreeMap, BTreeSet};
+use std::sync::{RwLock, RwLockReadGuard};
+
+/// Indexed keys per label.
+pub(crate) type FulltextDefs = BTreeMap<LabelId, BTreeSet<PropertyKeyId>>;
+
+/// One indexed term of a node: `(label, key, term)`.
+pub(crate) type FulltextEntry = (LabelId, PropertyKeyId, String);
+
+/// Resident copy of the declarations, used by commits to maintain postings.
+#[derive(Debug, Default)]
+pub(crate) struct FulltextIndexes {
+    defs: RwLock<FulltextDefs>,
+}
+
+impl FulltextIndexes {
+    pub(crate) fn load(graph_data: &Keyspace) -> Result<Self> {
+        let mut defs = FulltextDefs::new();
+        for guard in graph_data.prefix(fulltext_index_def_scan_prefix()) {
+            let key = guard.key()?;
+            if let Some((label, key)) = parse_fulltext_index_def_key(key.as_ref()) {
+                defs.entry(label).or_default().insert(key);
+            }
+        }
+        Ok(Self {
+            defs: RwLock::new(defs),
+        })
+    }
+
+    pub(crate) fn read(&self) -> RwLockReadGuard<'_, FulltextDefs> {
+        self.defs.read().unwrap()
+    }
+
+    pub(crate) fn contains(&self, label: LabelId, key: PropertyKeyId) -> bool {
+        self.read()
+            .get(&label)
+            .is_some_and(|keys| keys.contains(&key))
+    }
+
+    /// Publishes an index whose postings are committed. Callers must hold
+    /// `write_lock`.
+    pub(crate) fn insert(&self, label: LabelId, key: PropertyKeyId) {
+        self.defs
+            .write()
+            .unwrap()
+            .entry(label)
+            .or_default()
+            .insert(key);
+    }
+}
+
+/// Terms a node with `labels` and `props` is listed under.
+pub(crate) fn fulltext_entries<'l>(
+    labels: impl IntoIterator<Item = &'l LabelId>,
+    props: &BTreeMap<PropertyKeyId, PropertyValue>,
+    defs: &FulltextDefs,
+) -> BTreeSet<FulltextEntry> {
+    let mut out = BTreeSet::new();
+    for label in labels {
+        for key in defs.get(label).into_iter().flatten() {
+            if let Some(PropertyValue::String(text)) = props.get(key) {
+                out.extend(
+                    text_terms(text)
+                        .into_iter()
+                        .map(|term| (*label, *key, term)),
+                );
+            }
+        }
+    }
+    out
+}
+
+/// Posting records of `nodes`, visited in ascending id order, keyed by
+/// their full `FULLTEXT_POSTING` key.
+pub(crate) fn build_postings(
+    nodes: impl IntoIterator<Item = (InternalNodeId, BTreeSet<FulltextEntry>)>,
+) -> BTreeMap<Vec<u8>, Vec<InternalNodeId>> {
+    let mut postings: BTreeMap<Vec<u8>, Vec<InternalNodeId>> = BTreeMap::new();
+    for (node, entries) in nodes {
+        let (chunk, _) = split_node_id(node);
+        for (label, key, term) in entries {
+            postings
+                .entry(fulltext_posting_key(label, key, &term, chunk))
+                .or_default()
+                .push(node);
+        }
+    }
+    postings
+}
+
+pub(crate) fn encode_posting(ids: &[InternalNodeId]) -> Vec<u8> {
+    adjacency_codec::encode(0, ids)
+}
+
+/// Sorted ids of one posting record; `None` when malformed.
+pub(crate) fn decode_posting(bytes: &[u8]) -> Option<Vec<InternalNodeId>> {
+    let (flags, ids) = adjacency_codec::decode(bytes)?;
+    (flags == 0 && ids.windows(2).all(|pair| pair[0] < pair[1])).then_some(ids)
+}
+
+/// Ids present in every sorted list. Lists are intersected shortest first,
+/// so the running result only shrinks.
+pub(crate) fn intersect_postings(mut lists: Vec<Vec<InternalNodeId>>) -> Vec<InternalNodeId> {
+    lists.sort_by_key(Vec::len);
+    let mut lists = lists.into_iter();
+    let Some(mut out) = lists.next() else {
+        return Vec::new();
+    };
+    for list in lists {
+        if out.is_empty() {
+            break;
+        }
+        out = gallop_intersect(&out, &list);
+    }
+    out
+}
+
+/// Intersects sorted `small` with sorted `large`. For each id of `small`,
+/// the probe into `large` doubles its stride from the last position until it
+/// passes the id, then binary-searches the bracketed window:
+/// O(small * log(large / small)) comparisons.
+fn gallop_intersect(small: &[InternalNodeId], large: &[InternalNodeId]) -> Vec<InternalNodeId> {
+    let mut out = Vec::with_capacity(small.len());
+    // Every id of `large` before `lo` is smaller than the current id.
+    let mut lo = 0;
+    for &id in small {
+        let mut hi = lo;
+        let mut step = 1;
+        while hi < large.len() && large[hi] < id {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        let end = (hi + 1).min(large.len());
+        match large[lo..end].binary_search(&id) {
+            Ok(pos) => {
+                out.push(id);
+                lo += pos + 1;
+            }
+            Err(pos) => lo += pos,
+        }
+        if lo >= large.len() {
+            break;
+        }
+    }
+    out
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{decode_posting, encode_posting, intersect_postings};
+
+    #[test]
+    fn intersect_postings_gallops_over_long_lists() {
+        let long: Vec<u32> = (0..10_000).map(|id| id * 3).collect();
+        let short = vec![0, 7, 9, 300, 29_997, 40_000];
+        let evens: Vec<u32> = (0..20_000).map(|id| id * 2).collect();
+        assert_eq!(
+            intersect_postings(vec![long.clone(), short.clone()]),
+            vec![0, 9, 300, 29_997]
+        );
+        assert_eq!(intersect_postings(vec![long, evens, short]), vec![0, 300]);
+        assert!(intersect_postings(vec![vec![1, 2], Vec::new()]).is_empty());
+        assert!(intersect_postings(Vec::new()).is_empty());
+    }
+
+    #[test]
+    fn posting_roundtrips_and_rejects_unsorted_ids() {
+        let ids: Vec<u32> = (0..500).map(|id| id * 5 + 1).collect();
+        assert_eq!(decode_posting(&encode_posting(&ids)), Some(ids));
+        assert_eq!(decode_posting(&encode_posting(&[4, 2])), None);
+    }
+}
@@ -0,0 +1,324 @@
+//! Group commit: one journal fsync for every transaction waiting on it.
+//!
+//! A commit writes its batch to Fjall without a sync while it holds
+//! `write_lock`, takes a ticket, releases the lock, and waits until a sync
+//! covers the ticket. The first waiter that finds no sync in flight leads: it
+//! syncs the journal once for every batch written so far, then wakes the
+//! others. Commits that arrive during that sync queue behind it and share the
+//! next one, so under load one fsync covers many commits.
+//!
+//! A commit returns once a sync of its `Durability` covers it. Syncs are
+//! ranked, and a stronger one also satisfies weaker waiters. `Periodic`
+//! commits do not wait; the [`Flusher`] thread syncs them on an interval.
+//! Writes become visible to snapshots as soon as the batch is written, which
+//! can be before the sync.
+//!
+//! A failed sync poisons the group: after it, no sync can vouch for the
+//! batches it covered, so every waiter fails, including ones a later sync
+//! would cover, and the engine refuses new writes until it is reopened.
+
+use crate::storage::engine::Durability;
+use crate::storage::{Error, Result};
+use std::sync::{Arc, Condvar, Mutex};
+use std::thread::JoinHandle;
+use std::time::Duration;
+
+fn rank(durability: Durability) -> usize {
+    match durability {
+        Durability::Periodic => 0,
+        Durability::Buffered => 1,
+        Durability::SyncData => 2,
+        Durability::SyncAll => 3,
+    }
+}
+
+#[derive(Debug, Default)]
+struct SyncState {
+    /// Tickets handed out; ticket `n` is the `n`th batch written.
+    written: u64,
+    /// Per rank, every ticket up to this one is persisted at least that far.
+    durable: [u64; 4],
+    syncing: bool,
+    /// Error of the first failed sync; set once, never cleared.
+    failed: Option<String>,
+}
+
+#[derive(Debug, Default)]
+pub(crate) struct GroupCommit {
+    state: Mutex<SyncState>,
+    synced: Condvar,
+}
+
+impl GroupCommit {
+    /// Fails once a sync has failed. Writers check it under `write_lock`
+    /// before they build on the journal.
+    pub(crate) fn check(&self) -> Result<()> {
+        match &self.state.lock().unwrap().failed {
+            Some(message) => Err(Error::SyncFailed(message.clone())),
+            None => Ok(()),
+        }
+    }
+
+    /// Ticket of a batch just written. Callers must hold `write_lock`, so
+    /// tickets follow journal order.
+    pub(crate) fn ticket(&self) -> u64 {
+        let mut state = self.state.lock().unwrap();
+        state.written += 1;
+        state.written
+    }
+
+    /// Blocks until `ticket` is persisted to `level`. Runs `sync`, which must
+    /// persist to `level`, as the leader when no sync is in flight; a sync
+    /// covers every batch written before it starts.
+    pub(crate) fn wait_durable(
+        &self,
+        ticket: u64,
+        level: Durability,
+        sync: impl FnOnce() -> Result<()>,
+    ) -> Result<()> {
+        let level = rank(level);
+        let mut sync = Some(sync);
+        let mut state = self.state.lock().unwrap();
+        loop {
+            // Checked first: a sync that succeeds after a failed one does
+            // not make the earlier batches durable.
+            if let Some(message) = &state.failed {
+                return Err(Error::SyncFailed(message.clone()));
+            }
+            if state.durable[level] >= ticket {
+                return Ok(());
+            }
+            if !state.syncing
+                && let Some(sync) = sync.take()
+            {
+                state.syncing = true;
+                let target = state.written;
+                drop(state);
+                let result = sync();
+                state = self.state.lock().unwrap();
+                state.syncing = false;
+                match &result {
+                    Ok(()) => {
+                        for durable in &mut state.durable[..=level] {
+                            *durable = (*durable).max(target);
+                        }
+                    }
+                    Err(err) => {
+                        state.failed.get_or_insert_with(|| err.to_string());
+                    }
+                }
+                self.synced.notify_all();
+                // `target` covers this ticket, so the leader is done.
+                return result;
+            }
+            state = self.synced.wait(state).unwrap();
+        }
+    }
+
+    /// Persists every batch written so far to `level`, unless already done.
+    pub(crate) fn sync_written(
+        &self,
+        level: Durability,
+        sync: impl FnOnce() -> Result<()>,
+    ) -> Result<()> {
+        let written = self.state.lock().unwrap().written;
+        if written == 0 {
+            return Ok(());
+        }
+        self.wait_durable(written, level, sync)
+    }
+}
+
+/// Background thread that persists `Periodic` commits every `interval` and
+/// once more when dropped.
+#[derive(Debug)]
+pub(crate) struct Flusher {
+    stop: Arc<(Mutex<bool>, Condvar)>,
+    handle: Option<JoinHandle<()>>,
+}
+
+impl Flusher {
+    pub(crate) fn spawn(
+        group: Arc<GroupCommit>,
+        interval: Duration,
+        sync: impl Fn() -> Result<()> + Send + 'static,
+    ) -> std::io::Result<Self> {
+        let stop = Arc::new((Mutex::new(false), Condvar::new()));
+        let signal = stop.clone();
+        let handle = std::thread::Builder::new()
+            .name("nervusdb-flusher".to_string())
+            .spawn(move || {
+                let (stopped, wake) = &*signal;
+                loop {
+                    let guard = stopped.lock().unwrap();
+                    let (guard, _) = wake
+                        .wait_timeout_while(guard, interval, |stopped| !*stopped)
+                        .unwrap();
+                    let last = *guard;
+                    drop(guard);
+                    // A failed sync poisons the group and fails waiting
+                    // commits; later ticks then return at once.
+                    let _ = group.sync_written(Durability::SyncAll, &sync);
+                    if last {
+                        return;
+                    }
+                }
+            })?;
+        Ok(Self {
+            stop,
+            handle: Some(handle),
+        })
+    }
+}
+
+impl Drop for Flusher {
+    fn drop(&mut self) {
+        let (stopped, wake) = &*self.stop;
+        *stopped.lock().unwrap() = true;
+        wake.notify_all();
+        if let Some(handle) = self.handle.take() {
+            let _ = handle.join();
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::GroupCommit;
+    use crate::storage::Error;
+    use crate::storage::engine::Durability;
+    use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+    use std::sync::{Barrier, Mutex};
+    use std::time::Duration;
+
+    #[test]
+    fn concurrent_commits_share_syncs() {
+        let group = GroupCommit::default();
+        let write_lock = Mutex::new(());
+        let syncs = AtomicUsize::new(0);
+        let (threads, commits) = (8, 20);
+        let start = Barrier::new(threads);
+        std::thread::scope(|scope| {
+            for _ in 0..threads {
+                scope.spawn(|| {
+                    start.wait();
+                    for _ in 0..commits {
+                        let ticket = {
+                            let _guard = write_lock.lock().unwrap();
+                            group.ticket()
+                        };
+                        group
+                            .wait_durable(ticket, Durability::SyncAll, || {
+                                syncs.fetch_add(1, Ordering::SeqCst);
+                                std::thread::sleep(Duration::from_millis(2));
+                                Ok(())
+                            })
+                            .unwrap();
+                    }
+                });
+            }
+        });
+        let syncs = syncs.load(Ordering::SeqCst);
+        assert!(syncs < threads * commits / 2, "{syncs} syncs");
+        assert_eq!(
+            group.state.lock().unwrap().durable,
+            [(threads * commits) as u64; 4]
+        );
+    }
+
+    #[test]
+    fn failed_sync_poisons_every_later_wait() {
+        let group = GroupCommit::default();
+        let first = group.ticket();
+        let second = group.ticket();
+        let err = group.wait_durable(first, Durability::SyncAll, || {
+            Err(Error::Io(std::io::Error::other("disk gone")))
+        });
+        assert!(err.is_err());
+        assert!(matches!(group.check(), Err(Error::SyncFailed(_))));
+        assert!(
+            group
+                .wait_durable(second, Durability::SyncAll, || Ok(()))
+                .is_err()
+        );
+
+        let third = group.ticket();
+        assert!(
+            group
+                .wait_durable(third, Durability::SyncAll, || unreachable!())
+                .is_err()
+        );
+        assert!(
+            group
+                .sync_written(Durability::Buffered, || unreachable!())
+                .is_err()
+        );
+    }
+
+    #[test]
+    fn success_after_a_failed_sync_does_not_cover_its_waiters() {
+        let group = GroupCommit::default();
+        let failed_once = AtomicBool::new(false);
+        // Fails the first time it runs, succeeds after.
+        let sync = || {
+            std::thread::sleep(Duration::from_millis(20));
+            if failed_once.swap(true, Ordering::SeqCst) {
+                Ok(())
+            } else {
+                Err(Error::Io(std::io::Error::other("disk gone")))
+            }
+        };
+        let leader_ticket = group.ticket();
+        let waiter_ticket = group.ticket();
+        let leading = Barrier::new(2);
+        let (leader, waiter, later) = std::thread::scope(|scope| {
+            let leader = scope.spawn(|| {
+                group.wait_durable(leader_ticket, Durability::SyncAll, || {
+                    leading.wait();
+                    sync()
+                })
+            });
+            // The leader's sync has started and covers both tickets.
+            leading.wait();
+            let waiter =
+                scope.spawn(|| group.wait_durable(waiter_ticket, Durability::SyncAll, sync));
+            let later = scope.spawn(|| {
+                let ticket = group.ticket();
+                group.wait_durable(ticket, Durability::SyncAll, sync)
+            });
+            (
+                leader.join().unwrap(),
+                waiter.join().unwrap(),
+                later.join().unwrap(),
+            )
+        });
+        assert!(leader.is_err());
+        assert!(matches!(waiter, Err(Error::SyncFailed(_))));
+        assert!(matches!(later, Err(Error::SyncFailed(_))));
+        assert_eq!(group.state.lock().unwrap().durable, [0; 4]);
+    }
+
+    #[test]
+    fn stronger_syncs_satisfy_weaker_waiters_only() {
+        let group = GroupCommit::default();
+        let ticket = group.ticket();
+        group
+            .wait_durable(ticket, Durability::SyncData, || Ok(()))
+            .unwrap();
+        // Already covered: the closure must not run.
+        group
+            .wait_durable(ticket, Durability::Buffered, || unreachable!())
+            .unwrap();
+        let mut full_sync = false;
+        group
+            .wait_durable(ticket, Durability::SyncAll, || {
+                full_sync = true;
+                Ok(())
+            })
+            .unwrap();
+        assert!(full_sync);
+        group
+            .sync_written(Durability::SyncAll, || unreachable!())
+            .unwrap();
+    }
+}
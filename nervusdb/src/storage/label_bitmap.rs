@@ -0,0 +1,225 @@
+//! Roaring-style containers for label membership.
+//!
+//! Label membership is stored as one `LABEL_BITMAP` record per
+//! `(label, chunk)`, where a chunk covers 2^16 consecutive internal ids. A
+//! sparse chunk is a sorted array of the low 16 bits; once it holds more than
+//! 4096 ids an 8 KiB bitmap is smaller, and the container switches. Label scans
+//! decode one record per chunk instead of reading one key per node.
+
+use crate::api::InternalNodeId;
+
+const CONTAINER_ARRAY: u8 = 0x00;
+const CONTAINER_BITMAP: u8 = 0x01;
+/// Largest cardinality stored as an array; matches the bitmap's byte size.
+const ARRAY_MAX: usize = 4096;
+const BITMAP_WORDS: usize = 1 << 10;
+
+/// Chunk number and low bits of an internal id.
+#[inline]
+pub(crate) fn split_node_id(iid: InternalNodeId) -> (u16, u16) {
+    ((iid >> 16) as u16, iid as u16)
+}
+
+#[inline]
+pub(crate) fn join_node_id(chunk: u16, low: u16) -> InternalNodeId {
+    (u32::from(chunk) << 16) | u32::from(low)
+}
+
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) enum LabelChunk {
+    Array(Vec<u16>),
+    Bitmap(Box<[u64; BITMAP_WORDS]>),
+}
+
+impl Default for LabelChunk {
+    fn default() -> Self {
+        Self::Array(Vec::new())
+    }
+}
+
+impl LabelChunk {
+    /// Decodes a stored container; `None` for unknown or truncated records.
+    pub(crate) fn decode(bytes: &[u8]) -> Option<Self> {
+        let (&kind, body) = bytes.split_first()?;
+        match kind {
+            CONTAINER_ARRAY => {
+                if body.len() % 2 != 0 || body.len() / 2 > ARRAY_MAX {
+                    return None;
+                }
+                let lows = body
+                    .chunks_exact(2)
+                    .map(|raw| u16::from_be_bytes([raw[0], raw[1]]))
+                    .collect::<Vec<_>>();
+                lows.windows(2)
+                    .all(|pair| pair[0] < pair[1])
+                    .then_some(Self::Array(lows))
+            }
+            CONTAINER_BITMAP => {
+                if body.len() != BITMAP_WORDS * 8 {
+                    return None;
+                }
+                let mut words = Box::new([0u64; BITMAP_WORDS]);
+                for (word, raw) in words.iter_mut().zip(body.chunks_exact(8)) {
+                    *word = u64::from_le_bytes(raw.try_into().ok()?);
+                }
+                Some(Self::Bitmap(words))
+            }
+            _ => None,
+        }
+    }
+
+    pub(crate) fn encode(&self) -> Vec<u8> {
+        match self {
+            Self::Array(lows) => {
+                let mut out = Vec::with_capacity(1 + lows.len() * 2);
+                out.push(CONTAINER_ARRAY);
+                for low in lows {
+                    out.extend_from_slice(&low.to_be_bytes());
+                }
+                out
+            }
+            Self::Bitmap(words) => {
+                let mut out = Vec::with_capacity(1 + BITMAP_WORDS * 8);
+                out.push(CONTAINER_BITMAP);
+                for word in words.iter() {
+                    out.extend_from_slice(&word.to_le_bytes());
+                }
+                out
+            }
+        }
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        match self {
+            Self::Array(lows) => lows.len(),
+            Self::Bitmap(words) => words.iter().map(|word| word.count_ones() as usize).sum(),
+        }
+    }
+
+    pub(crate) fn is_empty(&self) -> bool {
+        match self {
+            Self::Array(lows) => lows.is_empty(),
+            Self::Bitmap(words) => words.iter().all(|word| *word == 0),
+        }
+    }
+
+    pub(crate) fn contains(&self, low: u16) -> bool {
+        match self {
+            Self::Array(lows) => lows.binary_search(&low).is_ok(),
+            Self::Bitmap(words) => words[usize::from(low) / 64] & (1 << (low % 64)) != 0,
+        }
+    }
+
+    pub(crate) fn insert(&mut self, low: u16) {
+        match self {
+            Self::Array(lows) => {
+                if let Err(pos) = lows.binary_search(&low) {
+                    lows.insert(pos, low);
+                }
+            }
+            Self::Bitmap(words) => words[usize::from(low) / 64] |= 1 << (low % 64),
+        }
+        self.normalize();
+    }
+
+    pub(crate) fn remove(&mut self, low: u16) {
+        match self {
+            Self::Array(lows) => {
+                if let Ok(pos) = lows.binary_search(&low) {
+                    lows.remove(pos);
+                }
+            }
+            Self::Bitmap(words) => words[usize::from(low) / 64] &= !(1 << (low % 64)),
+        }
+        self.normalize();
+    }
+
+    /// Members of both containers.
+    pub(crate) fn intersect(&self, other: &Self) -> Self {
+        let mut out = match (self, other) {
+            (Self::Bitmap(left), Self::Bitmap(right)) => {
+                let mut words = Box::new([0u64; BITMAP_WORDS]);
+                for (word, (l, r)) in words.iter_mut().zip(left.iter().zip(right.iter())) {
+                    *word = l & r;
+                }
+                Self::Bitmap(words)
+            }
+            (Self::Array(lows), other) | (other, Self::Array(lows)) => Self::Array(
+                lows.iter()
+                    .copied()
+                    .filter(|low| other.contains(*low))
+                    .collect(),
+            ),
+        };
+        out.normalize();
+        out
+    }
+
+    /// Ascending low bits of the members.
+    pub(crate) fn lows(&self) -> Vec<u16> {
+        match self {
+            Self::Array(lows) => lows.clone(),
+            Self::Bitmap(words) => {
+                let mut lows = Vec::with_capacity(self.len());
+                for (index, word) in words.iter().enumerate() {
+                    let mut bits = *word;
+                    while bits != 0 {
+                        lows.push((index * 64) as u16 + bits.trailing_zeros() as u16);
+                        bits &= bits - 1;
+                    }
+                }
+                lows
+            }
+        }
+    }
+
+    fn normalize(&mut self) {
+        let len = self.len();
+        match self {
+            Self::Array(lows) if len > ARRAY_MAX => {
+                let mut words = Box::new([0u64; BITMAP_WORDS]);
+                for low in lows.iter() {
+                    words[usize::from(*low) / 64] |= 1 << (low % 64);
+                }
+                *self = Self::Bitmap(words);
+            }
+            Self::Bitmap(_) if len <= ARRAY_MAX => *self = Self::Array(self.lows()),
+            _ => {}
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn chunk_switches_container_at_array_limit_and_round_trips() {
+        let mut chunk = LabelChunk::default();
+        for low in (0..=ARRAY_MAX as u16).map(|i| i * 3) {
+            chunk.insert(low);
+        }
+        assert!(matches!(chunk, LabelChunk::Bitmap(_)));
+        assert_eq!(chunk.len(), ARRAY_MAX + 1);
+        assert_eq!(LabelChunk::decode(&chunk.encode()), Some(chunk.clone()));
+
+        chunk.remove(3);
+        assert!(matches!(chunk, LabelChunk::Array(_)));
+        assert!(!chunk.contains(3) && chunk.contains(6));
+        assert_eq!(LabelChunk::decode(&chunk.encode()), Some(chunk.clone()));
+
+        let mut evens = LabelChunk::default();
+        for low in (0..20u16).map(|i| i * 2) {
+            evens.insert(low);
+        }
+        assert_eq!(
+            chunk.intersect(&evens).lows(),
+            vec![0, 6, 12, 18, 24, 30, 36]
+        );
+        assert_eq!(join_node_id(2, 7), 0x0002_0007);
+        assert_eq!(split_node_id(0x0002_0007), (2, 7));
+
+        assert_eq!(LabelChunk::decode(&[CONTAINER_ARRAY, 0, 2, 0, 1]), None);
+        assert_eq!(LabelChunk::decode(&[0x7F]), None);
+    }
+}
@@ -1,29 +1,74 @@
 use crate::api::{EdgeKey, ExternalId, InternalNodeId, LabelId, PropertyValue, RelTypeId};
+use crate::storage::adjacency_codec;
+use crate::storage::ordered_value::{TypedRange, encode_ordered};
+use crate::storage::property_keys::PropertyKeyId;
 use crate::storage::{Error, Result};
+use std::collections::BTreeMap;
+use std::ops::Bound;
 
 pub(crate) const KEY_FLAG_TOMBSTONE: u8 = 0b0000_0001;
 
+/// Set on a base adjacency record when overflow buckets follow it.
+pub(crate) const ADJ_FLAG_CONTINUED: u8 = 0b0000_0001;
+/// Split threshold for one adjacency bucket, in neighbor ids.
+pub(crate) const ADJ_BUCKET_CAPACITY: usize = 1024;
+/// Buckets below this size try to absorb their right neighbor on commit.
+pub(crate) const ADJ_BUCKET_MIN: usize = ADJ_BUCKET_CAPACITY / 4;
+
 const TAG_NODE: u8 = 0x01;
 const TAG_EXT2NODE: u8 = 0x02;
 const TAG_LABEL_NAME: u8 = 0x10;
 const TAG_LABEL_ID: u8 = 0x11;
 const TAG_REL_NAME: u8 = 0x12;
 const TAG_REL_ID: u8 = 0x13;
+const TAG_PROP_KEY_NAME: u8 = 0x14;
+const TAG_PROP_KEY_ID: u8 = 0x15;
 const TAG_NODE_LABEL: u8 = 0x20;
-const TAG_LABEL_NODE: u8 = 0x21;
-const TAG_NODE_PROP: u8 = 0x40;
+/// One membership container per `(label, chunk of 2^16 ids)`. Replaced the
+/// per-member `0x21 LABEL_NODE` keys in epoch 6.
+const TAG_LABEL_BITMAP: u8 = 0x22;
+const TAG_ADJ_DELTA: u8 = 0x30;
 const TAG_EDGE_PROP: u8 = 0x41;
-const TAG_NODE_PROP_INDEX: u8 = 0x50;
+/// One packed property record per node (see `property_row.rs`). Replaced the
+/// per-property `0x40 NODE_PROP` keys in epoch 7.
+const TAG_NODE_PROPS: u8 = 0x42;
+/// Index keys with an order-preserving value (see `ordered_value.rs`).
+/// Replaced the exact-match-only `0x50` encoding in epoch 9.
+const TAG_NODE_PROP_INDEX: u8 = 0x51;
+/// Declared composite index: `[tag][label][key_count:u8][key_id]*`.
+const TAG_COMPOSITE_INDEX_DEF: u8 = 0x52;
+/// Composite index entries, one per node and declared key list.
+const TAG_COMPOSITE_INDEX: u8 = 0x53;
+/// Edge property index: `[tag][rel][key_id][ordered value][src][dst]`.
+const TAG_EDGE_PROP_INDEX: u8 = 0x54;
+/// Declared unique constraint: `[tag][label][key_id]`.
+const TAG_UNIQUE_CONSTRAINT: u8 = 0x55;
+/// Unique index: `[tag][label][key_id][ordered value]`, valued by the one
+/// node holding the value.
+const TAG_UNIQUE_INDEX: u8 = 0x56;
+/// Declared full-text index: `[tag][label][key_id]`.
+const TAG_FULLTEXT_INDEX_DEF: u8 = 0x57;
+/// Full-text posting list: `[tag][label][key_id][term_len:u8][term][chunk:u16]`,
+/// valued by the ids of one 2^16-id chunk in the adjacency codec.
+const TAG_FULLTEXT_POSTING: u8 = 0x58;
 
 #[cfg(feature = "unstable-admin")]
 #[derive(Debug)]
 pub(crate) struct NodePropIndexEntry {
     pub(crate) label: LabelId,
-    pub(crate) property_key: String,
+    pub(crate) property_key: PropertyKeyId,
     pub(crate) value: PropertyValue,
     pub(crate) node: InternalNodeId,
 }
 
+#[cfg(feature = "unstable-admin")]
+#[derive(Debug)]
+pub(crate) struct EdgePropIndexEntry {
+    pub(crate) property_key: PropertyKeyId,
+    pub(crate) value: PropertyValue,
+    pub(crate) edge: EdgeKey,
+}
+
 #[inline]
 pub(crate) fn key_u32(value: u32) -> Vec<u8> {
     value.to_be_bytes().to_vec()
@@ -98,6 +143,25 @@ pub(crate) fn rel_id_key(id: RelTypeId) -> Vec<u8> {
     tagged_u32_key(TAG_REL_ID, id)
 }
 
+pub(crate) fn prop_key_name_key(name: &str) -> Vec<u8> {
+    tagged_name_key(TAG_PROP_KEY_NAME, name)
+}
+
+pub(crate) fn prop_key_id_key(id: PropertyKeyId) -> Vec<u8> {
+    tagged_u32_key(TAG_PROP_KEY_ID, id)
+}
+
+pub(crate) fn prop_key_id_scan_prefix() -> Vec<u8> {
+    vec![TAG_PROP_KEY_ID]
+}
+
+pub(crate) fn parse_prop_key_id_key(key: &[u8]) -> Option<PropertyKeyId> {
+    if key.len() != 5 || key[0] != TAG_PROP_KEY_ID {
+        return None;
+    }
+    decode_u32(&key[1..5])
+}
+
 #[cfg(feature = "unstable-admin")]
 pub(crate) fn node_label_scan_prefix() -> Vec<u8> {
     vec![TAG_NODE_LABEL]
@@ -122,28 +186,46 @@ pub(crate) fn parse_node_label_key(key: &[u8]) -> Option<(InternalNodeId, LabelI
     Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
 }
 
-#[cfg(feature = "unstable-admin")]
-pub(crate) fn label_node_scan_prefix() -> Vec<u8> {
-    vec![TAG_LABEL_NODE]
+pub(crate) fn label_bitmap_scan_prefix() -> Vec<u8> {
+    vec![TAG_LABEL_BITMAP]
 }
 
-pub(crate) fn label_node_prefix(label: LabelId) -> Vec<u8> {
-    tagged_u32_key(TAG_LABEL_NODE, label)
+pub(crate) fn label_bitmap_prefix(label: LabelId) -> Vec<u8> {
+    tagged_u32_key(TAG_LABEL_BITMAP, label)
 }
 
-pub(crate) fn label_node_key(label: LabelId, node: InternalNodeId) -> Vec<u8> {
-    let mut out = Vec::with_capacity(9);
-    out.push(TAG_LABEL_NODE);
+pub(crate) fn label_bitmap_key(label: LabelId, chunk: u16) -> Vec<u8> {
+    let mut out = Vec::with_capacity(7);
+    out.push(TAG_LABEL_BITMAP);
     out.extend_from_slice(&label.to_be_bytes());
-    out.extend_from_slice(&node.to_be_bytes());
+    out.extend_from_slice(&chunk.to_be_bytes());
     out
 }
 
-pub(crate) fn parse_label_node_key(key: &[u8]) -> Option<(LabelId, InternalNodeId)> {
-    if key.len() != 9 || key[0] != TAG_LABEL_NODE {
+pub(crate) fn parse_label_bitmap_key(key: &[u8]) -> Option<(LabelId, u16)> {
+    if key.len() != 7 || key[0] != TAG_LABEL_BITMAP {
         return None;
     }
-    Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
+    Some((
+        decode_u32(&key[1..5])?,
+        u16::from_be_bytes([key[5], key[6]]),
+    ))
+}
+
+/// Which packed adjacency keyspace a list lives in.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Hash)]
+pub(crate) enum AdjDirection {
+    Out,
+    In,
+}
+
+impl AdjDirection {
+    pub(crate) fn base_key(self, node: InternalNodeId, rel: RelTypeId) -> Vec<u8> {
+        match self {
+            AdjDirection::Out => adj_out_key(node, rel),
+            AdjDirection::In => adj_in_key(node, rel),
+        }
+    }
 }
 
 pub(crate) fn adj_out_scan_prefix() -> Vec<u8> {
@@ -165,13 +247,6 @@ pub(crate) fn adj_out_key(src: InternalNodeId, rel: RelTypeId) -> Vec<u8> {
     out
 }
 
-pub(crate) fn parse_adj_out_key(key: &[u8]) -> Option<(InternalNodeId, RelTypeId)> {
-    if key.len() != 8 {
-        return None;
-    }
-    Some((decode_u32(&key[0..4])?, decode_u32(&key[4..8])?))
-}
-
 #[cfg(feature = "unstable-admin")]
 pub(crate) fn adj_in_scan_prefix() -> Vec<u8> {
     Vec::new()
@@ -192,71 +267,169 @@ pub(crate) fn adj_in_key(dst: InternalNodeId, rel: RelTypeId) -> Vec<u8> {
     out
 }
 
-pub(crate) fn parse_adj_in_key(key: &[u8]) -> Option<(InternalNodeId, RelTypeId)> {
-    if key.len() != 8 {
-        return None;
-    }
-    Some((decode_u32(&key[0..4])?, decode_u32(&key[4..8])?))
+/// Overflow bucket key for one `(node, rel)` adjacency list.
+///
+/// The base record keeps the 8-byte `[node][rel]` key. Once a list outgrows
+/// `ADJ_BUCKET_CAPACITY`, later buckets live at `[node][rel][fence]`, where
+/// `fence` is the smallest neighbor id the bucket may hold. Bucket keys sort
+/// directly after their base record, so a `[node][rel]` prefix scan yields the
+/// whole list in neighbor order.
+pub(crate) fn adj_bucket_key(node: InternalNodeId, rel: RelTypeId, fence: u32) -> Vec<u8> {
+    let mut out = Vec::with_capacity(12);
+    out.extend_from_slice(&node.to_be_bytes());
+    out.extend_from_slice(&rel.to_be_bytes());
+    out.extend_from_slice(&fence.to_be_bytes());
+    out
 }
 
-pub(crate) fn encode_adjacent_nodes(nodes: &[InternalNodeId]) -> Vec<u8> {
-    let mut out = Vec::with_capacity(nodes.len() * 4);
-    for node in nodes {
-        out.extend_from_slice(&node.to_be_bytes());
+/// Parses either adjacency key shape. Base records return `fence = None`.
+pub(crate) fn parse_adj_record_key(key: &[u8]) -> Option<(InternalNodeId, RelTypeId, Option<u32>)> {
+    match key.len() {
+        8 => Some((decode_u32(&key[0..4])?, decode_u32(&key[4..8])?, None)),
+        12 => Some((
+            decode_u32(&key[0..4])?,
+            decode_u32(&key[4..8])?,
+            Some(decode_u32(&key[8..12])?),
+        )),
+        _ => None,
     }
-    out
 }
 
-pub(crate) fn decode_adjacent_nodes(bytes: &[u8]) -> Option<Vec<InternalNodeId>> {
-    let chunks = bytes.chunks_exact(4);
-    if !chunks.remainder().is_empty() {
-        return None;
+/// Delta operation that adds a neighbor to an adjacency list.
+pub(crate) const ADJ_DELTA_ADD: u8 = 0x01;
+/// Delta operation that removes a neighbor from an adjacency list.
+pub(crate) const ADJ_DELTA_REMOVE: u8 = 0x00;
+
+impl AdjDirection {
+    fn tag(self) -> u8 {
+        match self {
+            AdjDirection::Out => 0,
+            AdjDirection::In => 1,
+        }
     }
-    chunks.map(decode_u32).collect()
-}
 
-#[cfg(feature = "unstable-admin")]
-pub(crate) fn node_prop_scan_prefix() -> Vec<u8> {
-    vec![TAG_NODE_PROP]
+    fn from_tag(tag: u8) -> Option<Self> {
+        match tag {
+            0 => Some(AdjDirection::Out),
+            1 => Some(AdjDirection::In),
+            _ => None,
+        }
+    }
 }
 
-pub(crate) fn node_prop_prefix(node: InternalNodeId) -> Vec<u8> {
-    tagged_u32_key(TAG_NODE_PROP, node)
+pub(crate) fn adj_delta_scan_prefix() -> Vec<u8> {
+    vec![TAG_ADJ_DELTA]
 }
 
-pub(crate) fn node_prop_key(node: InternalNodeId, key: &str) -> Vec<u8> {
-    let len = u32::try_from(key.len()).expect("property key length should fit in u32");
-    let mut out = Vec::with_capacity(9 + key.len());
-    out.push(TAG_NODE_PROP);
+pub(crate) fn adj_delta_node_prefix(dir: AdjDirection, node: InternalNodeId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(6);
+    out.push(TAG_ADJ_DELTA);
+    out.push(dir.tag());
     out.extend_from_slice(&node.to_be_bytes());
-    out.extend_from_slice(&len.to_be_bytes());
-    out.extend_from_slice(key.as_bytes());
     out
 }
 
-pub(crate) fn parse_node_prop_key(key: &[u8]) -> Option<(InternalNodeId, String)> {
-    if key.len() < 9 || key[0] != TAG_NODE_PROP {
+pub(crate) fn adj_delta_list_prefix(
+    dir: AdjDirection,
+    node: InternalNodeId,
+    rel: RelTypeId,
+) -> Vec<u8> {
+    let mut out = adj_delta_node_prefix(dir, node);
+    out.extend_from_slice(&rel.to_be_bytes());
+    out
+}
+
+/// Append-only delta record for one `(node, rel)` adjacency list.
+///
+/// Deltas live in `graph_data`, not the adjacency keyspaces, so base and bucket
+/// scans never see them. `seq` orders the records of one list; readers apply
+/// them oldest first on top of the packed buckets.
+pub(crate) fn adj_delta_key(
+    dir: AdjDirection,
+    node: InternalNodeId,
+    rel: RelTypeId,
+    seq: u64,
+) -> Vec<u8> {
+    let mut out = adj_delta_list_prefix(dir, node, rel);
+    out.extend_from_slice(&seq.to_be_bytes());
+    out
+}
+
+pub(crate) fn parse_adj_delta_key(
+    key: &[u8],
+) -> Option<(AdjDirection, InternalNodeId, RelTypeId, u64)> {
+    if key.len() != 18 || key[0] != TAG_ADJ_DELTA {
         return None;
     }
-    let node = decode_u32(&key[1..5])?;
-    let len = u32::from_be_bytes(key[5..9].try_into().ok()?) as usize;
-    if key.len() != 9 + len {
-        return None;
+    Some((
+        AdjDirection::from_tag(key[1])?,
+        decode_u32(&key[2..6])?,
+        decode_u32(&key[6..10])?,
+        decode_u64(&key[10..18])?,
+    ))
+}
+
+/// Encodes `(op, neighbor)` pairs as repeated `[op:u8][neighbor:u32 BE]`.
+pub(crate) fn encode_adj_delta(ops: &BTreeMap<InternalNodeId, bool>) -> Vec<u8> {
+    let mut out = Vec::with_capacity(ops.len() * 5);
+    for (other, add) in ops {
+        out.push(if *add {
+            ADJ_DELTA_ADD
+        } else {
+            ADJ_DELTA_REMOVE
+        });
+        out.extend_from_slice(&other.to_be_bytes());
     }
-    let property_key = String::from_utf8(key[9..].to_vec()).ok()?;
-    Some((node, property_key))
+    out
 }
 
-pub(crate) fn parse_node_prop_key_for_node(key: &[u8], node: InternalNodeId) -> Option<String> {
-    let (found, property_key) = parse_node_prop_key(key)?;
-    if found == node {
-        Some(property_key)
-    } else {
-        None
+/// Applies one encoded delta record to `ops`, where `true` means present.
+///
+/// Returns `false` and leaves `ops` untouched when the record is malformed.
+pub(crate) fn apply_adj_delta(bytes: &[u8], ops: &mut BTreeMap<InternalNodeId, bool>) -> bool {
+    if bytes.len() % 5 != 0
+        || bytes
+            .chunks_exact(5)
+            .any(|chunk| !matches!(chunk[0], ADJ_DELTA_ADD | ADJ_DELTA_REMOVE))
+    {
+        return false;
     }
+    for chunk in bytes.chunks_exact(5) {
+        let other = u32::from_be_bytes([chunk[1], chunk[2], chunk[3], chunk[4]]);
+        ops.insert(other, chunk[0] == ADJ_DELTA_ADD);
+    }
+    true
+}
+
+/// Encodes one adjacency record with the smallest codec in `adjacency_codec`.
+pub(crate) fn encode_adjacent_nodes(flags: u8, nodes: &[InternalNodeId]) -> Vec<u8> {
+    adjacency_codec::encode(flags, nodes)
+}
+
+pub(crate) fn decode_adjacent_nodes(bytes: &[u8]) -> Option<(u8, Vec<InternalNodeId>)> {
+    adjacency_codec::decode(bytes)
+}
+
+pub(crate) fn count_adjacent_nodes(bytes: &[u8]) -> Option<usize> {
+    adjacency_codec::count(bytes)
 }
 
 #[cfg(feature = "unstable-admin")]
+pub(crate) fn node_props_scan_prefix() -> Vec<u8> {
+    vec![TAG_NODE_PROPS]
+}
+
+pub(crate) fn node_props_key(node: InternalNodeId) -> Vec<u8> {
+    tagged_u32_key(TAG_NODE_PROPS, node)
+}
+
+pub(crate) fn parse_node_props_key(key: &[u8]) -> Option<InternalNodeId> {
+    if key.len() != 5 || key[0] != TAG_NODE_PROPS {
+        return None;
+    }
+    decode_u32(&key[1..5])
+}
+
 pub(crate) fn edge_prop_scan_prefix() -> Vec<u8> {
     vec![TAG_EDGE_PROP]
 }
@@ -270,17 +443,14 @@ pub(crate) fn edge_prop_prefix(edge: EdgeKey) -> Vec<u8> {
     out
 }
 
-pub(crate) fn edge_prop_key(edge: EdgeKey, key: &str) -> Vec<u8> {
-    let len = u32::try_from(key.len()).expect("property key length should fit in u32");
+pub(crate) fn edge_prop_key(edge: EdgeKey, key: PropertyKeyId) -> Vec<u8> {
     let mut out = edge_prop_prefix(edge);
-    out.reserve(4 + key.len());
-    out.extend_from_slice(&len.to_be_bytes());
-    out.extend_from_slice(key.as_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
     out
 }
 
-pub(crate) fn parse_edge_prop_key(key: &[u8]) -> Option<(EdgeKey, String)> {
-    if key.len() < 17 || key[0] != TAG_EDGE_PROP {
+pub(crate) fn parse_edge_prop_key(key: &[u8]) -> Option<(EdgeKey, PropertyKeyId)> {
+    if key.len() != 17 || key[0] != TAG_EDGE_PROP {
         return None;
     }
     let edge = EdgeKey {
@@ -288,15 +458,10 @@ pub(crate) fn parse_edge_prop_key(key: &[u8]) -> Option<(EdgeKey, String)> {
         rel: decode_u32(&key[5..9])?,
         dst: decode_u32(&key[9..13])?,
     };
-    let len = u32::from_be_bytes(key[13..17].try_into().ok()?) as usize;
-    if key.len() != 17 + len {
-        return None;
-    }
-    let property_key = String::from_utf8(key[17..].to_vec()).ok()?;
-    Some((edge, property_key))
+    Some((edge, decode_u32(&key[13..17])?))
 }
 
-pub(crate) fn parse_edge_prop_key_for_edge(key: &[u8], edge: EdgeKey) -> Option<String> {
+pub(crate) fn parse_edge_prop_key_for_edge(key: &[u8], edge: EdgeKey) -> Option<PropertyKeyId> {
     let (found, property_key) = parse_edge_prop_key(key)?;
     if found == edge {
         Some(property_key)
@@ -312,93 +477,470 @@ pub(crate) fn node_prop_index_scan_prefix() -> Vec<u8> {
 
 pub(crate) fn node_prop_index_key(
     label: LabelId,
-    key: &str,
+    key: PropertyKeyId,
     value: &PropertyValue,
     node: InternalNodeId,
 ) -> Vec<u8> {
-    let encoded_value = value.encode();
-    let key_len = u16::try_from(key.len()).expect("property key length should fit in u16");
-    let value_len =
-        u32::try_from(encoded_value.len()).expect("property value length should fit in u32");
-    let mut out = Vec::with_capacity(15 + key.len() + encoded_value.len());
-    out.push(TAG_NODE_PROP_INDEX);
-    out.extend_from_slice(&label.to_be_bytes());
-    out.extend_from_slice(&key_len.to_be_bytes());
-    out.extend_from_slice(key.as_bytes());
-    out.extend_from_slice(&value_len.to_be_bytes());
-    out.extend_from_slice(&encoded_value);
+    let mut out = node_prop_index_prefix(label, key, value);
     out.extend_from_slice(&node.to_be_bytes());
     out
 }
 
-pub(crate) fn node_prop_index_prefix(label: LabelId, key: &str, value: &PropertyValue) -> Vec<u8> {
-    let encoded_value = value.encode();
-    let key_len = u16::try_from(key.len()).expect("property key length should fit in u16");
-    let value_len =
-        u32::try_from(encoded_value.len()).expect("property value length should fit in u32");
-    let mut out = Vec::with_capacity(11 + key.len() + encoded_value.len());
+pub(crate) fn node_prop_index_prefix(
+    label: LabelId,
+    key: PropertyKeyId,
+    value: &PropertyValue,
+) -> Vec<u8> {
+    let mut out = node_prop_index_key_prefix(label, key);
+    encode_ordered(value, &mut out);
+    out
+}
+
+fn node_prop_index_key_prefix(label: LabelId, key: PropertyKeyId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(32);
     out.push(TAG_NODE_PROP_INDEX);
     out.extend_from_slice(&label.to_be_bytes());
-    out.extend_from_slice(&key_len.to_be_bytes());
-    out.extend_from_slice(key.as_bytes());
-    out.extend_from_slice(&value_len.to_be_bytes());
-    out.extend_from_slice(&encoded_value);
+    out.extend_from_slice(&key.to_be_bytes());
     out
 }
 
+/// Key range holding the index entries of `label.key` whose value lies in
+/// `range`.
+pub(crate) fn node_prop_index_range(
+    label: LabelId,
+    key: PropertyKeyId,
+    range: &TypedRange,
+) -> (Bound<Vec<u8>>, Bound<Vec<u8>>) {
+    let mut type_prefix = node_prop_index_key_prefix(label, key);
+    type_prefix.push(range.tag);
+    let start = match &range.lower {
+        Bound::Included(value) => Bound::Included(node_prop_index_prefix(label, key, value)),
+        Bound::Excluded(value) => {
+            Bound::Included(prefix_successor(node_prop_index_prefix(label, key, value)))
+        }
+        Bound::Unbounded => Bound::Included(type_prefix.clone()),
+    };
+    let end = match &range.upper {
+        Bound::Included(value) => {
+            Bound::Excluded(prefix_successor(node_prop_index_prefix(label, key, value)))
+        }
+        Bound::Excluded(value) => Bound::Excluded(node_prop_index_prefix(label, key, value)),
+        Bound::Unbounded => Bound::Excluded(prefix_successor(type_prefix)),
+    };
+    (start, end)
+}
+
+/// Smallest key greater than every key starting with `prefix`. Index
+/// prefixes start with a tag below `0xFF`, so one always exists.
+fn prefix_successor(mut prefix: Vec<u8>) -> Vec<u8> {
+    while let Some(last) = prefix.pop() {
+        if last < 0xFF {
+            prefix.push(last + 1);
+            break;
+        }
+    }
+    prefix
+}
+
 pub(crate) fn parse_node_prop_index_node(key: &[u8]) -> Option<InternalNodeId> {
-    if key.len() < 15 || key[0] != TAG_NODE_PROP_INDEX {
+    if key.len() < 14 || key[0] != TAG_NODE_PROP_INDEX {
         return None;
     }
-    let key_len = u16::from_be_bytes(key[5..7].try_into().ok()?) as usize;
-    let value_len_offset = 7 + key_len;
-    if key.len() < value_len_offset + 8 {
+    decode_u32(&key[key.len() - 4..])
+}
+
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn parse_node_prop_index_key(key: &[u8]) -> Option<NodePropIndexEntry> {
+    if key.len() < 14 || key[0] != TAG_NODE_PROP_INDEX {
         return None;
     }
-    let value_len = u32::from_be_bytes(
-        key[value_len_offset..value_len_offset + 4]
-            .try_into()
-            .ok()?,
-    ) as usize;
-    let node_offset = value_len_offset + 4 + value_len;
-    if key.len() != node_offset + 4 {
+    let (value, used) = crate::storage::ordered_value::decode_ordered(&key[9..])?;
+    if key.len() != 9 + used + 4 {
         return None;
     }
-    decode_u32(&key[node_offset..node_offset + 4])
+    Some(NodePropIndexEntry {
+        label: decode_u32(&key[1..5])?,
+        property_key: decode_u32(&key[5..9])?,
+        value,
+        node: decode_u32(&key[key.len() - 4..])?,
+    })
+}
+
+fn composite_index_head(tag: u8, label: LabelId, keys: &[PropertyKeyId]) -> Vec<u8> {
+    let count = u8::try_from(keys.len()).expect("composite index key count should fit in u8");
+    let mut out = Vec::with_capacity(6 + keys.len() * 4 + 32);
+    out.push(tag);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.push(count);
+    for key in keys {
+        out.extend_from_slice(&key.to_be_bytes());
+    }
+    out
+}
+
+pub(crate) fn composite_index_def_key(label: LabelId, keys: &[PropertyKeyId]) -> Vec<u8> {
+    composite_index_head(TAG_COMPOSITE_INDEX_DEF, label, keys)
+}
+
+pub(crate) fn composite_index_def_scan_prefix() -> Vec<u8> {
+    vec![TAG_COMPOSITE_INDEX_DEF]
+}
+
+pub(crate) fn composite_index_def_label_prefix(label: LabelId) -> Vec<u8> {
+    let mut out = composite_index_def_scan_prefix();
+    out.extend_from_slice(&label.to_be_bytes());
+    out
+}
+
+pub(crate) fn parse_composite_index_def_key(key: &[u8]) -> Option<(LabelId, Vec<PropertyKeyId>)> {
+    if key.len() < 6 || key[0] != TAG_COMPOSITE_INDEX_DEF {
+        return None;
+    }
+    let count = usize::from(key[5]);
+    if key.len() != 6 + count * 4 {
+        return None;
+    }
+    let keys = key[6..]
+        .chunks_exact(4)
+        .map(decode_u32)
+        .collect::<Option<Vec<_>>>()?;
+    Some((decode_u32(&key[1..5])?, keys))
+}
+
+/// Prefix of the entries of one composite index whose leading keys hold
+/// `values`; `values` may be shorter than `keys`.
+pub(crate) fn composite_index_prefix(
+    label: LabelId,
+    keys: &[PropertyKeyId],
+    values: &[&PropertyValue],
+) -> Vec<u8> {
+    let mut out = composite_index_head(TAG_COMPOSITE_INDEX, label, keys);
+    for value in values {
+        encode_ordered(value, &mut out);
+    }
+    out
+}
+
+pub(crate) fn composite_index_key(
+    label: LabelId,
+    keys: &[PropertyKeyId],
+    values: &[&PropertyValue],
+    node: InternalNodeId,
+) -> Vec<u8> {
+    let mut out = composite_index_prefix(label, keys, values);
+    out.extend_from_slice(&node.to_be_bytes());
+    out
+}
+
+pub(crate) fn parse_composite_index_node(key: &[u8]) -> Option<InternalNodeId> {
+    if key.len() < 10 || key[0] != TAG_COMPOSITE_INDEX {
+        return None;
+    }
+    decode_u32(&key[key.len() - 4..])
 }
 
 #[cfg(feature = "unstable-admin")]
-pub(crate) fn parse_node_prop_index_key(key: &[u8]) -> Option<NodePropIndexEntry> {
-    if key.len() < 15 || key[0] != TAG_NODE_PROP_INDEX {
+pub(crate) fn composite_index_scan_prefix() -> Vec<u8> {
+    vec![TAG_COMPOSITE_INDEX]
+}
+
+/// Label and node of a composite index entry.
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn parse_composite_index_key(key: &[u8]) -> Option<(LabelId, InternalNodeId)> {
+    Some((
+        decode_u32(key.get(1..5)?)?,
+        parse_composite_index_node(key)?,
+    ))
+}
+
+pub(crate) fn edge_prop_index_key(
+    key: PropertyKeyId,
+    value: &PropertyValue,
+    edge: EdgeKey,
+) -> Vec<u8> {
+    let mut out = edge_prop_index_prefix(edge.rel, key, value);
+    out.extend_from_slice(&edge.src.to_be_bytes());
+    out.extend_from_slice(&edge.dst.to_be_bytes());
+    out
+}
+
+pub(crate) fn edge_prop_index_prefix(
+    rel: RelTypeId,
+    key: PropertyKeyId,
+    value: &PropertyValue,
+) -> Vec<u8> {
+    let mut out = Vec::with_capacity(40);
+    out.push(TAG_EDGE_PROP_INDEX);
+    out.extend_from_slice(&rel.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    encode_ordered(value, &mut out);
+    out
+}
+
+/// Edge of an index entry found under an `edge_prop_index_prefix` probe.
+pub(crate) fn parse_edge_prop_index_edge(key: &[u8]) -> Option<EdgeKey> {
+    if key.len() < 18 || key[0] != TAG_EDGE_PROP_INDEX {
         return None;
     }
-    let label = decode_u32(&key[1..5])?;
-    let key_len = u16::from_be_bytes(key[5..7].try_into().ok()?) as usize;
-    let value_len_offset = 7 + key_len;
-    if key.len() < value_len_offset + 8 {
+    Some(EdgeKey {
+        src: decode_u32(&key[key.len() - 8..key.len() - 4])?,
+        rel: decode_u32(&key[1..5])?,
+        dst: decode_u32(&key[key.len() - 4..])?,
+    })
+}
+
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn edge_prop_index_scan_prefix() -> Vec<u8> {
+    vec![TAG_EDGE_PROP_INDEX]
+}
+
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn parse_edge_prop_index_key(key: &[u8]) -> Option<EdgePropIndexEntry> {
+    if key.len() < 18 || key[0] != TAG_EDGE_PROP_INDEX {
         return None;
     }
-    let property_key = String::from_utf8(key[7..7 + key_len].to_vec()).ok()?;
-    let value_len = u32::from_be_bytes(
-        key[value_len_offset..value_len_offset + 4]
-            .try_into()
-            .ok()?,
-    ) as usize;
-    let value_offset = value_len_offset + 4;
-    let node_offset = value_offset + value_len;
-    if key.len() != node_offset + 4 {
+    let (value, used) = crate::storage::ordered_value::decode_ordered(&key[9..])?;
+    if key.len() != 9 + used + 8 {
         return None;
     }
-    let value = PropertyValue::decode(&key[value_offset..node_offset]).ok()?;
-    let node = decode_u32(&key[node_offset..node_offset + 4])?;
-    Some(NodePropIndexEntry {
-        label,
-        property_key,
+    Some(EdgePropIndexEntry {
+        property_key: decode_u32(&key[5..9])?,
         value,
-        node,
+        edge: parse_edge_prop_index_edge(key)?,
     })
 }
 
+pub(crate) fn unique_constraint_key(label: LabelId, key: PropertyKeyId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(9);
+    out.push(TAG_UNIQUE_CONSTRAINT);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    out
+}
+
+pub(crate) fn unique_constraint_scan_prefix() -> Vec<u8> {
+    vec![TAG_UNIQUE_CONSTRAINT]
+}
+
+pub(crate) fn parse_unique_constraint_key(key: &[u8]) -> Option<(LabelId, PropertyKeyId)> {
+    if key.len() != 9 || key[0] != TAG_UNIQUE_CONSTRAINT {
+        return None;
+    }
+    Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
+}
+
+pub(crate) fn unique_index_key(
+    label: LabelId,
+    key: PropertyKeyId,
+    value: &PropertyValue,
+) -> Vec<u8> {
+    let mut out = Vec::with_capacity(32);
+    out.push(TAG_UNIQUE_INDEX);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    encode_ordered(value, &mut out);
+    out
+}
+
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn unique_index_scan_prefix() -> Vec<u8> {
+    vec![TAG_UNIQUE_INDEX]
+}
+
+/// Label and property key of a unique index entry.
+pub(crate) fn parse_unique_index_key(key: &[u8]) -> Option<(LabelId, PropertyKeyId)> {
+    if key.len() < 10 || key[0] != TAG_UNIQUE_INDEX {
+        return None;
+    }
+    Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
+}
+
+pub(crate) fn fulltext_index_def_key(label: LabelId, key: PropertyKeyId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(9);
+    out.push(TAG_FULLTEXT_INDEX_DEF);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    out
+}
+
+pub(crate) fn fulltext_index_def_scan_prefix() -> Vec<u8> {
+    vec![TAG_FULLTEXT_INDEX_DEF]
+}
+
+pub(crate) fn parse_fulltext_index_def_key(key: &[u8]) -> Option<(LabelId, PropertyKeyId)> {
+    if key.len() != 9 || key[0] != TAG_FULLTEXT_INDEX_DEF {
+        return None;
+    }
+    Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
+}
+
+/// Prefix of every chunk of one term's posting list. Terms are capped at
+/// `MAX_TEXT_TERM_BYTES`, so the length fits one byte.
+pub(crate) fn fulltext_posting_prefix(label: LabelId, key: PropertyKeyId, term: &str) -> Vec<u8> {
+    debug_assert!(term.len() <= usize::from(u8::MAX));
+    let mut out = Vec::with_capacity(12 + term.len());
+    out.push(TAG_FULLTEXT_POSTING);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    out.push(term.len() as u8);
+    out.extend_from_slice(term.as_bytes());
+    out
+}
+
+pub(crate) fn fulltext_posting_key(
+    label: LabelId,
+    key: PropertyKeyId,
+    term: &str,
+    chunk: u16,
+) -> Vec<u8> {
+    let mut out = fulltext_posting_prefix(label, key, term);
+    out.extend_from_slice(&chunk.to_be_bytes());
+    out
+}
+
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn fulltext_posting_scan_prefix() -> Vec<u8> {
+    vec![TAG_FULLTEXT_POSTING]
+}
+
+/// Label and property key of a posting record whose term and chunk are
+/// well-formed.
+#[cfg(feature = "unstable-admin")]
+pub(crate) fn parse_fulltext_posting_key(key: &[u8]) -> Option<(LabelId, PropertyKeyId)> {
+    if key.len() < 12 || key[0] != TAG_FULLTEXT_POSTING {
+        return None;
+    }
+    let term_len = usize::from(key[9]);
+    if key.len() != 12 + term_len || std::str::from_utf8(&key[10..10 + term_len]).is_err() {
+        return None;
+    }
+    Some((decode_u32(&key[1..5])?, decode_u32(&key[5..9])?))
+}
+
+// Tags of the `vectors` keyspace (see `vector_index.rs`).
+
+/// Dimension shared by every stored vector: `[tag] -> dim:u32`.
+const TAG_VECTOR_CONFIG: u8 = 0x01;
+/// One unit-normalized embedding per node: `[tag][iid] -> [level:u8][f32 le]*`.
+const TAG_VECTOR: u8 = 0x02;
+/// HNSW neighbors of one node on one layer: `[tag][iid][layer:u8] -> ids`.
+const TAG_VECTOR_LINKS: u8 = 0x03;
+
+pub(crate) fn vector_config_key() -> Vec<u8> {
+    vec![TAG_VECTOR_CONFIG]
+}
+
+pub(crate) fn vector_key(node: InternalNodeId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(5);
+    out.push(TAG_VECTOR);
+    out.extend_from_slice(&node.to_be_bytes());
+    out
+}
+
+pub(crate) fn vector_scan_prefix() -> Vec<u8> {
+    vec![TAG_VECTOR]
+}
+
+pub(crate) fn parse_vector_key(key: &[u8]) -> Option<InternalNodeId> {
+    if key.len() != 5 || key[0] != TAG_VECTOR {
+        return None;
+    }
+    decode_u32(&key[1..5])
+}
+
+pub(crate) fn vector_links_key(node: InternalNodeId, layer: u8) -> Vec<u8> {
+    let mut out = Vec::with_capacity(6);
+    out.push(TAG_VECTOR_LINKS);
+    out.extend_from_slice(&node.to_be_bytes());
+    out.push(layer);
+    out
+}
+
+pub(crate) fn vector_links_scan_prefix() -> Vec<u8> {
+    vec![TAG_VECTOR_LINKS]
+}
+
+pub(crate) fn parse_vector_links_key(key: &[u8]) -> Option<(InternalNodeId, u8)> {
+    if key.len() != 6 || key[0] != TAG_VECTOR_LINKS {
+        return None;
+    }
+    Some((decode_u32(&key[1..5])?, key[5]))
+}
+
+/// Live-node count of one label, stored in `meta`.
+pub(crate) const META_LABEL_COUNT_PREFIX: &[u8] = b"count/label/";
+/// Edge count of one relationship type, stored in `meta`.
+pub(crate) const META_REL_COUNT_PREFIX: &[u8] = b"count/rel/";
+
+fn meta_counter_key(prefix: &[u8], id: u32) -> Vec<u8> {
+    let mut out = Vec::with_capacity(prefix.len() + 4);
+    out.extend_from_slice(prefix);
+    out.extend_from_slice(&id.to_be_bytes());
+    out
+}
+
+pub(crate) fn label_count_key(label: LabelId) -> Vec<u8> {
+    meta_counter_key(META_LABEL_COUNT_PREFIX, label)
+}
+
+pub(crate) fn rel_count_key(rel: RelTypeId) -> Vec<u8> {
+    meta_counter_key(META_REL_COUNT_PREFIX, rel)
+}
+
+/// Id of a counter key under `prefix`.
+pub(crate) fn parse_counter_key(prefix: &[u8], key: &[u8]) -> Option<u32> {
+    decode_u32(key.strip_prefix(prefix)?)
+}
+
+pub(crate) fn decode_counter(bytes: &[u8]) -> Option<u64> {
+    decode_u64(bytes)
+}
+
+/// Seconds since the Unix epoch of the last ANALYZE, stored in `meta`.
+/// Commits refresh the statistics below only while it is present.
+pub(crate) const META_STATS_ANALYZED: &[u8] = b"stats/analyzed";
+/// Degree histogram of one `(direction, label, rel)`, stored in `meta`.
+pub(crate) const META_STATS_DEGREE_PREFIX: &[u8] = b"stats/degree/";
+/// Value sketch of one `(label, property key)`, stored in `meta`.
+pub(crate) const META_STATS_PROPERTY_PREFIX: &[u8] = b"stats/property/";
+
+pub(crate) fn degree_stats_key(dir: AdjDirection, label: LabelId, rel: RelTypeId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(META_STATS_DEGREE_PREFIX.len() + 9);
+    out.extend_from_slice(META_STATS_DEGREE_PREFIX);
+    out.push(dir.tag());
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&rel.to_be_bytes());
+    out
+}
+
+pub(crate) fn parse_degree_stats_key(key: &[u8]) -> Option<(AdjDirection, LabelId, RelTypeId)> {
+    let body = key.strip_prefix(META_STATS_DEGREE_PREFIX)?;
+    if body.len() != 9 {
+        return None;
+    }
+    Some((
+        AdjDirection::from_tag(body[0])?,
+        decode_u32(&body[1..5])?,
+        decode_u32(&body[5..9])?,
+    ))
+}
+
+pub(crate) fn property_stats_key(label: LabelId, key: PropertyKeyId) -> Vec<u8> {
+    let mut out = Vec::with_capacity(META_STATS_PROPERTY_PREFIX.len() + 8);
+    out.extend_from_slice(META_STATS_PROPERTY_PREFIX);
+    out.extend_from_slice(&label.to_be_bytes());
+    out.extend_from_slice(&key.to_be_bytes());
+    out
+}
+
+pub(crate) fn parse_property_stats_key(key: &[u8]) -> Option<(LabelId, PropertyKeyId)> {
+    let body = key.strip_prefix(META_STATS_PROPERTY_PREFIX)?;
+    if body.len() != 8 {
+        return None;
+    }
+    Some((decode_u32(&body[..4])?, decode_u32(&body[4..])?))
+}
+
 pub(crate) fn encode_node_value(external_id: ExternalId, flags: u8) -> Vec<u8> {
     let mut out = Vec::with_capacity(9);
     out.extend_from_slice(&external_id.to_be_bytes());
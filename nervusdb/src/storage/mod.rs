@@ -1,10 +1,25 @@
+mod adjacency_codec;
+mod adjacency_delta;
 pub mod api;
+pub(crate) mod composite_index;
+pub mod csr;
 pub mod engine;
 mod error;
+pub(crate) mod external_sort;
+pub(crate) mod fulltext_index;
+mod group_commit;
+pub(crate) mod label_bitmap;
 pub(crate) mod layout;
+mod node_liveness;
+pub(crate) mod ordered_value;
 mod profile;
 pub mod property;
+pub(crate) mod property_keys;
+pub(crate) mod property_row;
 pub mod snapshot;
+pub mod statistics;
+pub(crate) mod unique_constraint;
+pub(crate) mod vector_index;
 
 pub use crate::storage::error::{Error, Result};
 
@@ -13,4 +28,4 @@ pub const PAGE_SIZE: usize = 8192;
 pub const FILE_MAGIC: [u8; 16] = *b"NERVUSDBFJALL\x00\x00\x00";
 pub const VERSION_MAJOR: u32 = 4;
 pub const VERSION_MINOR: u32 = 0;
-pub const STORAGE_FORMAT_EPOCH: u64 = 4;
+pub const STORAGE_FORMAT_EPOCH: u64 = 9;
@@ -0,0 +1,267 @@
+//! Resident liveness bitmap of every node record.
+//!
+//! Scans and traversals ask "is this node live?" for almost every row. Answering
+//! that with a `graph_data` point read per node costs more than the scan that
+//! produced the id. The engine instead keeps two bits per internal id in memory
+//! (live, tombstoned), rebuilds them from the `NODE` prefix on open, and
+//! publishes a new copy-on-write version with every commit that creates or
+//! tombstones nodes.
+
+use crate::api::InternalNodeId;
+use crate::storage::Result;
+use crate::storage::layout::{
+    KEY_FLAG_TOMBSTONE, node_scan_prefix, parse_node_key, parse_node_value,
+};
+use fjall::Keyspace;
+use std::sync::{Arc, Mutex};
+
+/// Internal ids per page. A commit copies only the pages it touches.
+const LIVENESS_PAGE_NODES: usize = 1 << 14;
+const LIVENESS_PAGE_WORDS: usize = LIVENESS_PAGE_NODES / 64;
+
+#[derive(Debug, Clone)]
+struct LivenessPage {
+    live: [u64; LIVENESS_PAGE_WORDS],
+    tombstoned: [u64; LIVENESS_PAGE_WORDS],
+}
+
+impl Default for LivenessPage {
+    fn default() -> Self {
+        Self {
+            live: [0; LIVENESS_PAGE_WORDS],
+            tombstoned: [0; LIVENESS_PAGE_WORDS],
+        }
+    }
+}
+
+#[inline]
+fn locate(iid: InternalNodeId) -> (usize, usize, u64) {
+    let iid = iid as usize;
+    let page = iid / LIVENESS_PAGE_NODES;
+    let bit = iid % LIVENESS_PAGE_NODES;
+    (page, bit / 64, 1u64 << (bit % 64))
+}
+
+/// One immutable version of the bitmap.
+///
+/// `seq` matches the `node_liveness_seq` meta value written by the commit that
+/// produced this version, which is how a storage snapshot finds its version.
+#[derive(Debug, Clone, Default)]
+pub(crate) struct NodeLiveness {
+    seq: u64,
+    pages: Vec<Arc<LivenessPage>>,
+    live_count: u64,
+}
+
+impl NodeLiveness {
+    #[inline]
+    pub(crate) fn is_live(&self, iid: InternalNodeId) -> bool {
+        let (page, word, mask) = locate(iid);
+        self.pages
+            .get(page)
+            .is_some_and(|page| page.live[word] & mask != 0)
+    }
+
+    #[inline]
+    pub(crate) fn is_tombstoned(&self, iid: InternalNodeId) -> bool {
+        let (page, word, mask) = locate(iid);
+        self.pages
+            .get(page)
+            .is_some_and(|page| page.tombstoned[word] & mask != 0)
+    }
+
+    pub(crate) fn live_count(&self) -> u64 {
+        self.live_count
+    }
+
+    /// Live ids in ascending order, the same order as the `NODE` prefix scan.
+    pub(crate) fn live_nodes(&self) -> LiveNodes<'_> {
+        LiveNodes {
+            pages: &self.pages,
+            page: 0,
+            word: 0,
+            bits: self.pages.first().map_or(0, |page| page.live[0]),
+        }
+    }
+
+    fn page_mut(&mut self, page: usize) -> &mut LivenessPage {
+        if self.pages.len() <= page {
+            self.pages.resize_with(page + 1, Arc::default);
+        }
+        Arc::make_mut(&mut self.pages[page])
+    }
+
+    fn mark_live(&mut self, iid: InternalNodeId) {
+        let (page, word, mask) = locate(iid);
+        let page = self.page_mut(page);
+        let was_live = page.live[word] & mask != 0;
+        page.live[word] |= mask;
+        page.tombstoned[word] &= !mask;
+        if !was_live {
+            self.live_count += 1;
+        }
+    }
+
+    fn mark_tombstoned(&mut self, iid: InternalNodeId) {
+        let (page, word, mask) = locate(iid);
+        let page = self.page_mut(page);
+        let was_live = page.live[word] & mask != 0;
+        page.live[word] &= !mask;
+        page.tombstoned[word] |= mask;
+        if was_live {
+            self.live_count -= 1;
+        }
+    }
+}
+
+/// Iterator over the set live bits of a [`NodeLiveness`].
+#[derive(Debug, Clone)]
+pub(crate) struct LiveNodes<'a> {
+    pages: &'a [Arc<LivenessPage>],
+    page: usize,
+    word: usize,
+    bits: u64,
+}
+
+impl Iterator for LiveNodes<'_> {
+    type Item = InternalNodeId;
+
+    fn next(&mut self) -> Option<Self::Item> {
+        loop {
+            if self.bits != 0 {
+                let bit = self.bits.trailing_zeros() as usize;
+                self.bits &= self.bits - 1;
+                let iid = self.page * LIVENESS_PAGE_NODES + self.word * 64 + bit;
+                return Some(iid as InternalNodeId);
+            }
+            self.word += 1;
+            if self.word == LIVENESS_PAGE_WORDS {
+                self.word = 0;
+                self.page += 1;
+            }
+            self.bits = self.pages.get(self.page)?.live[self.word];
+        }
+    }
+}
+
+#[derive(Debug)]
+struct LivenessVersions {
+    committed: Arc<NodeLiveness>,
+    /// Version of the commit whose batch is being written, if any.
+    staged: Option<Arc<NodeLiveness>>,
+}
+
+#[derive(Debug)]
+pub(crate) struct LivenessDirectory {
+    versions: Mutex<LivenessVersions>,
+}
+
+impl LivenessDirectory {
+    /// Rebuilds the bitmap from the node records persisted in `graph_data`.
+    pub(crate) fn load(graph_data: &Keyspace, seq: u64) -> Result<Self> {
+        let mut liveness = NodeLiveness {
+            seq,
+            ..NodeLiveness::default()
+        };
+        for guard in graph_data.prefix(node_scan_prefix()) {
+            let (key, value) = guard.into_inner()?;
+            let Some(iid) = parse_node_key(key.as_ref()) else {
+                continue;
+            };
+            let Some((_, flags)) = parse_node_value(value.as_ref()) else {
+                continue;
+            };
+            if flags & KEY_FLAG_TOMBSTONE == 0 {
+                liveness.mark_live(iid);
+            } else {
+                liveness.mark_tombstoned(iid);
+            }
+        }
+        Ok(Self {
+            versions: Mutex::new(LivenessVersions {
+                committed: Arc::new(liveness),
+                staged: None,
+            }),
+        })
+    }
+
+    /// Versions a snapshot opened after this call can observe.
+    pub(crate) fn candidates(&self) -> (Arc<NodeLiveness>, Option<Arc<NodeLiveness>>) {
+        let versions = self.versions.lock().unwrap();
+        (versions.committed.clone(), versions.staged.clone())
+    }
+
+    /// Stages the version a commit will publish and returns the `seq` the
+    /// commit must persist in meta. Callers must hold `write_lock` and call
+    /// [`Self::publish`] or [`Self::abort`] once the batch is settled.
+    pub(crate) fn stage(
+        &self,
+        created: impl IntoIterator<Item = InternalNodeId>,
+        tombstoned: impl IntoIterator<Item = InternalNodeId>,
+    ) -> u64 {
+        let mut versions = self.versions.lock().unwrap();
+        let mut next = NodeLiveness::clone(&versions.committed);
+        next.seq += 1;
+        for iid in created {
+            next.mark_live(iid);
+        }
+        for iid in tombstoned {
+            next.mark_tombstoned(iid);
+        }
+        let seq = next.seq;
+        versions.staged = Some(Arc::new(next));
+        seq
+    }
+
+    pub(crate) fn publish(&self) {
+        let mut versions = self.versions.lock().unwrap();
+        if let Some(staged) = versions.staged.take() {
+            versions.committed = staged;
+        }
+    }
+
+    pub(crate) fn abort(&self) {
+        self.versions.lock().unwrap().staged = None;
+    }
+}
+
+/// Picks the version a storage snapshot with liveness `seq` must use.
+///
+/// `committed` is published only after its batch commits, so a snapshot opened
+/// after [`LivenessDirectory::candidates`] sees at least its `seq`. `None`
+/// means more commits landed in between and the caller should retry.
+pub(crate) fn resolve_liveness(
+    (committed, staged): (Arc<NodeLiveness>, Option<Arc<NodeLiveness>>),
+    seq: u64,
+) -> Option<Arc<NodeLiveness>> {
+    if committed.seq == seq {
+        return Some(committed);
+    }
+    staged.filter(|staged| staged.seq == seq)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn live_nodes_walk_pages_in_id_order() {
+        let mut liveness = NodeLiveness::default();
+        let ids = [0, 63, 64, 1000, LIVENESS_PAGE_NODES as u32 * 3 + 5];
+        for iid in ids {
+            liveness.mark_live(iid);
+        }
+        liveness.mark_tombstoned(63);
+        liveness.mark_tombstoned(7);
+
+        assert_eq!(
+            liveness.live_nodes().collect::<Vec<_>>(),
+            vec![0, 64, 1000, LIVENESS_PAGE_NODES as u32 * 3 + 5]
+        );
+        assert_eq!(liveness.live_count(), 4);
+        assert!(liveness.is_tombstoned(63) && !liveness.is_live(63));
+        assert!(liveness.is_tombstoned(7));
+        assert!(!liveness.is_live(u32::MAX) && !liveness.is_tombstoned(u32::MAX));
+        assert_eq!(NodeLiveness::default().live_nodes().next(), None);
+    }
+}
@@ -0,0 +1,328 @@
+//! Order-preserving encoding of scalar property values for index keys.
+//!
+//! `PropertyValue::encode` is little-endian and length-prefixed, so its bytes
+//! only support exact matches. Index keys use this encoding instead, where
+//! byte order equals value order within each type:
+//!
+//! ```text
+//! 0x00 NULL
+//! 0x01 BOOL      [0 | 1]
+//! 0x02 INT       [i64 BE with the sign bit flipped]
+//! 0x03 FLOAT     [f64 bits BE; negatives inverted, positives sign-flipped]
+//! 0x04 STRING    [bytes with 0x00 -> 0x00 0xFF][0x00 0x01]
+//! 0x05 DATETIME  [i64 BE with the sign bit flipped]
+//! 0x06 BLOB      [bytes with 0x00 -> 0x00 0xFF][0x00 0x01]
+//! ```
+//!
+//! Every encoding is self-delimiting, so a key can carry more parts after the
+//! value. `-0.0` is stored as `0.0`. Lists and maps are not indexed; they get
+//! a tag above the scalar range followed by `PropertyValue::encode`, which no
+//! range ever covers.
+
+use crate::api::PropertyValue;
+use std::ops::Bound;
+
+const TAG_NULL: u8 = 0x00;
+const TAG_BOOL: u8 = 0x01;
+const TAG_INT: u8 = 0x02;
+const TAG_FLOAT: u8 = 0x03;
+const TAG_STRING: u8 = 0x04;
+const TAG_DATETIME: u8 = 0x05;
+const TAG_BLOB: u8 = 0x06;
+const TAG_COMPOSITE: u8 = 0x07;
+
+const SIGN_BIT: u64 = 1 << 63;
+/// Integers below this magnitude convert to `f64` exactly.
+const EXACT_F64_INT: f64 = (1u64 << 53) as f64;
+
+pub(crate) fn encode_ordered(value: &PropertyValue, out: &mut Vec<u8>) {
+    match value {
+        PropertyValue::Null => out.push(TAG_NULL),
+        PropertyValue::Bool(value) => out.extend_from_slice(&[TAG_BOOL, u8::from(*value)]),
+        PropertyValue::Int(value) => {
+            out.push(TAG_INT);
+            out.extend_from_slice(&(*value as u64 ^ SIGN_BIT).to_be_bytes());
+        }
+        PropertyValue::Float(value) => {
+            out.push(TAG_FLOAT);
+            let bits = if *value == 0.0 { 0 } else { value.to_bits() };
+            let bits = if bits & SIGN_BIT != 0 {
+                !bits
+            } else {
+                bits ^ SIGN_BIT
+            };
+            out.extend_from_slice(&bits.to_be_bytes());
+        }
+        PropertyValue::String(value) => {
+            out.push(TAG_STRING);
+            escape_bytes(value.as_bytes(), out);
+        }
+        PropertyValue::DateTime(value) => {
+            out.push(TAG_DATETIME);
+            out.extend_from_slice(&(*value as u64 ^ SIGN_BIT).to_be_bytes());
+        }
+        PropertyValue::Blob(value) => {
+            out.push(TAG_BLOB);
+            escape_bytes(value, out);
+        }
+        PropertyValue::List(_) | PropertyValue::Map(_) => {
+            out.push(TAG_COMPOSITE);
+            out.extend_from_slice(&value.encode());
+        }
+    }
+}
+
+/// Decodes one scalar value and returns it with the number of bytes read.
+pub(crate) fn decode_ordered(bytes: &[u8]) -> Option<(PropertyValue, usize)> {
+    let (&tag, body) = bytes.split_first()?;
+    let fixed =
+        |body: &[u8]| -> Option<u64> { Some(u64::from_be_bytes(body.get(..8)?.try_into().ok()?)) };
+    match tag {
+        TAG_NULL => Some((PropertyValue::Null, 1)),
+        TAG_BOOL => match body.first()? {
+            0 => Some((PropertyValue::Bool(false), 2)),
+            1 => Some((PropertyValue::Bool(true), 2)),
+            _ => None,
+        },
+        TAG_INT => Some((PropertyValue::Int((fixed(body)? ^ SIGN_BIT) as i64), 9)),
+        TAG_FLOAT => {
+            let bits = fixed(body)?;
+            let bits = if bits & SIGN_BIT != 0 {
+                bits ^ SIGN_BIT
+            } else {
+                !bits
+            };
+            Some((PropertyValue::Float(f64::from_bits(bits)), 9))
+        }
+        TAG_STRING => {
+            let (raw, used) = unescape_bytes(body)?;
+            Some((
+                PropertyValue::String(String::from_utf8(raw).ok()?),
+                1 + used,
+            ))
+        }
+        TAG_DATETIME => Some((PropertyValue::DateTime((fixed(body)? ^ SIGN_BIT) as i64), 9)),
+        TAG_BLOB => {
+            let (raw, used) = unescape_bytes(body)?;
+            Some((PropertyValue::Blob(raw), 1 + used))
+        }
+        _ => None,
+    }
+}
+
+fn escape_bytes(raw: &[u8], out: &mut Vec<u8>) {
+    for &byte in raw {
+        out.push(byte);
+        if byte == 0x00 {
+            out.push(0xFF);
+        }
+    }
+    out.extend_from_slice(&[0x00, 0x01]);
+}
+
+fn unescape_bytes(body: &[u8]) -> Option<(Vec<u8>, usize)> {
+    let mut raw = Vec::new();
+    let mut pos = 0;
+    loop {
+        match *body.get(pos)? {
+            0x00 => match *body.get(pos + 1)? {
+                0xFF => raw.push(0x00),
+                0x01 => return Some((raw, pos + 2)),
+                _ => return None,
+            },
+            byte => {
+                raw.push(byte);
+                pos += 1;
+                continue;
+            }
+        }
+        pos += 2;
+    }
+}
+
+/// The part of a value range that falls inside one encoded type.
+#[derive(Debug, Clone, PartialEq)]
+pub(crate) struct TypedRange {
+    pub(crate) tag: u8,
+    pub(crate) lower: Bound<PropertyValue>,
+    pub(crate) upper: Bound<PropertyValue>,
+}
+
+/// Splits `lower..upper` into one range per encoded type it can match.
+///
+/// Numeric bounds cover both `Int` and `Float`, which Cypher compares as
+/// `f64`. A float bound is rounded outward onto the integers, and dropped when
+/// the integers near it are not exact in `f64`, so the ranges may hold extra
+/// values; callers must re-check the predicate. Null, NaN, list and map
+/// bounds, and bounds of two different types, match nothing.
+pub(crate) fn typed_ranges(
+    lower: Bound<&PropertyValue>,
+    upper: Bound<&PropertyValue>,
+) -> Vec<TypedRange> {
+    let tags: Vec<u8> = match (bound_value(lower), bound_value(upper)) {
+        (None, None) => (TAG_NULL..=TAG_BLOB).collect(),
+        (Some(value), None) | (None, Some(value)) => range_tags(value),
+        (Some(low), Some(high)) => {
+            let (low, high) = (range_tags(low), range_tags(high));
+            if low != high {
+                return Vec::new();
+            }
+            low
+        }
+    };
+    tags.into_iter()
+        .map(|tag| TypedRange {
+            tag,
+            lower: convert_bound(lower, tag, f64::ceil),
+            upper: convert_bound(upper, tag, f64::floor),
+        })
+        .collect()
+}
+
+fn bound_value(bound: Bound<&PropertyValue>) -> Option<&PropertyValue> {
+    match bound {
+        Bound::Included(value) | Bound::Excluded(value) => Some(value),
+        Bound::Unbounded => None,
+    }
+}
+
+/// Encoded types a bound of this value compares against.
+fn range_tags(value: &PropertyValue) -> Vec<u8> {
+    match value {
+        PropertyValue::Int(_) => vec![TAG_INT, TAG_FLOAT],
+        PropertyValue::Float(value) if !value.is_nan() => vec![TAG_INT, TAG_FLOAT],
+        PropertyValue::Bool(_) => vec![TAG_BOOL],
+        PropertyValue::String(_) => vec![TAG_STRING],
+        PropertyValue::DateTime(_) => vec![TAG_DATETIME],
+        PropertyValue::Blob(_) => vec![TAG_BLOB],
+        PropertyValue::Null
+        | PropertyValue::Float(_)
+        | PropertyValue::List(_)
+        | PropertyValue::Map(_) => Vec::new(),
+    }
+}
+
+/// Restates `bound` in the encoded type `tag`; `round` picks the integer side
+/// of a float bound.
+fn convert_bound(
+    bound: Bound<&PropertyValue>,
+    tag: u8,
+    round: fn(f64) -> f64,
+) -> Bound<PropertyValue> {
+    let wrap = |value: PropertyValue| match bound {
+        Bound::Included(_) => Bound::Included(value),
+        _ => Bound::Excluded(value),
+    };
+    match (bound_value(bound), tag) {
+        (None, _) => Bound::Unbounded,
+        (Some(PropertyValue::Int(value)), TAG_FLOAT) => wrap(PropertyValue::Float(*value as f64)),
+        (Some(PropertyValue::Float(value)), TAG_INT) if value.abs() >= EXACT_F64_INT => {
+            Bound::Unbounded
+        }
+        (Some(PropertyValue::Float(value)), TAG_INT) => {
+            Bound::Included(PropertyValue::Int(round(*value) as i64))
+        }
+        (Some(value), _) => wrap(value.clone()),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn encoded(value: PropertyValue) -> Vec<u8> {
+        let mut out = Vec::new();
+        encode_ordered(&value, &mut out);
+        out
+    }
+
+    #[test]
+    fn byte_order_matches_value_order_within_each_type() {
+        let ints = [i64::MIN, -300, -1, 0, 1, 255, 256, i64::MAX];
+        let floats = [
+            f64::NEG_INFINITY,
+            -2.5,
+            -1e-300,
+            0.0,
+            1e-300,
+            2.5,
+            f64::INFINITY,
+        ];
+        let strings = ["", "\0", "\0\0", "a", "a\0", "a\u{1}", "ab", "b"];
+        for pair in ints.windows(2) {
+            assert!(
+                encoded(pair[0].into()) < encoded(pair[1].into()),
+                "{pair:?}"
+            );
+        }
+        for pair in floats.windows(2) {
+            assert!(
+                encoded(pair[0].into()) < encoded(pair[1].into()),
+                "{pair:?}"
+            );
+        }
+        for pair in strings.windows(2) {
+            assert!(
+                encoded(pair[0].into()) < encoded(pair[1].into()),
+                "{pair:?}"
+            );
+        }
+        assert_eq!(encoded((-0.0).into()), encoded(0.0.into()));
+    }
+
+    #[test]
+    fn decode_round_trips_and_reports_length() {
+        for value in [
+            PropertyValue::Null,
+            PropertyValue::Bool(true),
+            PropertyValue::Int(-42),
+            PropertyValue::Float(-2.5),
+            PropertyValue::String("a\0b".into()),
+            PropertyValue::DateTime(1_700_000_000_000),
+            PropertyValue::Blob(vec![0, 0xFF, 0]),
+        ] {
+            let mut bytes = encoded(value.clone());
+            let len = bytes.len();
+            bytes.extend_from_slice(&[9, 9, 9, 9]);
+            assert_eq!(decode_ordered(&bytes), Some((value, len)));
+        }
+        assert_eq!(decode_ordered(&[TAG_STRING, b'a', 0x00]), None);
+    }
+
+    #[test]
+    fn numeric_bounds_cover_ints_and_floats() {
+        let ranges = typed_ranges(
+            Bound::Excluded(&PropertyValue::Float(30.5)),
+            Bound::Included(&PropertyValue::Int(40)),
+        );
+        assert_eq!(
+            ranges,
+            vec![
+                TypedRange {
+                    tag: TAG_INT,
+                    lower: Bound::Included(PropertyValue::Int(31)),
+                    upper: Bound::Included(PropertyValue::Int(40)),
+                },
+                TypedRange {
+                    tag: TAG_FLOAT,
+                    lower: Bound::Excluded(PropertyValue::Float(30.5)),
+                    upper: Bound::Included(PropertyValue::Float(40.0)),
+                },
+            ]
+        );
+        assert!(
+            typed_ranges(
+                Bound::Included(&PropertyValue::Int(1)),
+                Bound::Included(&PropertyValue::String("z".into())),
+            )
+            .is_empty()
+        );
+        assert!(
+            typed_ranges(
+                Bound::Included(&PropertyValue::Float(f64::NAN)),
+                Bound::Unbounded
+            )
+            .is_empty()
+        );
+    }
+}
@@ -0,0 +1,157 @@
+//! Resident dictionary of interned property keys.
+//!
+//! Property records, edge property keys, and index keys carry a `u32` key id
+//! instead of the key string, the same way labels and relationship types are
+//! stored. The dictionary is persisted as `PROP_KEY_NAME`/`PROP_KEY_ID` pairs in
+//! `graph_data`, loaded whole on open, and kept in memory so that translating
+//! between names and ids never reads storage.
+
+use crate::storage::Result;
+use crate::storage::layout::{parse_prop_key_id_key, prop_key_id_scan_prefix};
+use fjall::Keyspace;
+use std::collections::HashMap;
+use std::sync::RwLock;
+
+pub(crate) type PropertyKeyId = u32;
+
+#[derive(Debug, Default)]
+struct Names {
+    by_name: HashMap<String, PropertyKeyId>,
+    by_id: Vec<Option<String>>,
+    next_id: PropertyKeyId,
+}
+
+/// Append-only name/id map shared by the engine and its snapshots.
+///
+/// Ids are never reused. A snapshot may see ids interned after it was opened;
+/// no record it can read refers to them, so the extra entries are harmless.
+#[derive(Debug, Default)]
+pub(crate) struct PropertyKeys {
+    names: RwLock<Names>,
+}
+
+impl PropertyKeys {
+    pub(crate) fn load(graph_data: &Keyspace, next_id: PropertyKeyId) -> Result<Self> {
+        let mut names = Names {
+            next_id,
+            ..Names::default()
+        };
+        for guard in graph_data.prefix(prop_key_id_scan_prefix()) {
+            let (key, value) = guard.into_inner()?;
+            let Some(id) = parse_prop_key_id_key(key.as_ref()) else {
+                continue;
+            };
+            let Ok(name) = String::from_utf8(value.as_ref().to_vec()) else {
+                continue;
+            };
+            names.insert(id, name);
+        }
+        Ok(Self {
+            names: RwLock::new(names),
+        })
+    }
+
+    pub(crate) fn id(&self, name: &str) -> Option<PropertyKeyId> {
+        self.names.read().unwrap().by_name.get(name).copied()
+    }
+
+    /// Translates many ids under one lock; unknown ids map to `None`.
+    pub(crate) fn names<I>(&self, ids: I) -> Vec<Option<String>>
+    where
+        I: IntoIterator<Item = PropertyKeyId>,
+    {
+        let names = self.names.read().unwrap();
+        ids.into_iter()
+            .map(|id| names.name(id).map(str::to_string))
+            .collect()
+    }
+
+    /// Assigns ids to the names that have none and returns the new entries,
+    /// which the caller must persist in the same batch as the records using
+    /// them. Entries are visible immediately, so a snapshot opened after that
+    /// batch commits can decode it. Callers must hold `write_lock` and call
+    /// [`Self::forget`] if the batch fails.
+    pub(crate) fn intern<'n, I>(&self, candidates: I) -> Vec<(PropertyKeyId, String)>
+    where
+        I: IntoIterator<Item = &'n str>,
+    {
+        let mut names = self.names.write().unwrap();
+        let mut created = Vec::new();
+        for name in candidates {
+            if names.by_name.contains_key(name) {
+                continue;
+            }
+            let id = names.next_id;
+            names.next_id += 1;
+            names.insert(id, name.to_string());
+            created.push((id, name.to_string()));
+        }
+        created
+    }
+
+    /// Drops entries returned by [`Self::intern`] whose batch did not commit.
+    pub(crate) fn forget(&self, created: &[(PropertyKeyId, String)]) {
+        if created.is_empty() {
+            return;
+        }
+        let mut names = self.names.write().unwrap();
+        for (id, name) in created {
+            names.by_name.remove(name);
+            if let Some(slot) = names.by_id.get_mut(*id as usize) {
+                *slot = None;
+            }
+        }
+        names.next_id = created
+            .iter()
+            .map(|(id, _)| *id)
+            .min()
+            .unwrap_or(names.next_id);
+    }
+
+    pub(crate) fn next_id(&self) -> PropertyKeyId {
+        self.names.read().unwrap().next_id
+    }
+}
+
+impl Names {
+    fn insert(&mut self, id: PropertyKeyId, name: String) {
+        let slot = id as usize;
+        if self.by_id.len() <= slot {
+            self.by_id.resize(slot + 1, None);
+        }
+        self.by_id[slot] = Some(name.clone());
+        self.by_name.insert(name, id);
+        self.next_id = self.next_id.max(id + 1);
+    }
+
+    fn name(&self, id: PropertyKeyId) -> Option<&str> {
+        self.by_id.get(id as usize)?.as_deref()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn intern_is_idempotent_and_forget_releases_ids() {
+        let keys = PropertyKeys::default();
+        let created = keys.intern(["name", "age", "name"]);
+        assert_eq!(
+            created,
+            vec![(0, "name".to_string()), (1, "age".to_string())]
+        );
+        assert!(keys.intern(["age"]).is_empty());
+        assert_eq!(keys.id("age"), Some(1));
+        assert_eq!(
+            keys.names([1, 0, 7]),
+            vec![Some("age".into()), Some("name".into()), None]
+        );
+
+        let failed = keys.intern(["created_at_timestamp"]);
+        keys.forget(&failed);
+        assert_eq!(keys.id("created_at_timestamp"), None);
+        assert_eq!(keys.names([2]), vec![None]);
+        assert_eq!(keys.next_id(), 2);
+    }
+}
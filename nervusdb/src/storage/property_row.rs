@@ -0,0 +1,176 @@
+//! Packed per-node property records.
+//!
+//! All properties of a node live in one `NODE_PROPS` value, so hydrating a node
+//! is one point read. The value starts with an offset table sorted by property
+//! key id (see `property_keys.rs`), so a single property is found by binary
+//! search and decoded without touching the others:
+//!
+//! ```text
+//! [count:u32 BE]
+//! count x [key_id:u32 BE][value_end:u32 BE]
+//! data: value_0 value_1 ...
+//! ```
+//!
+//! Offsets are relative to the start of `data`. Entry `i` owns
+//! `data[value_end(i - 1)..value_end(i)]` as its encoded `PropertyValue`.
+
+use crate::api::PropertyValue;
+use crate::storage::property_keys::PropertyKeyId;
+use std::collections::BTreeMap;
+
+const COUNT_BYTES: usize = 4;
+const ENTRY_BYTES: usize = 8;
+
+/// Borrowed view over an encoded property record.
+///
+/// `parse` checks only the header; each entry is bounds-checked when it is
+/// read, so a point lookup stays `O(log n)`. Use [`Self::validate`] to check
+/// the whole record.
+#[derive(Debug, Clone, Copy)]
+pub(crate) struct PropertyRow<'a> {
+    table: &'a [u8],
+    data: &'a [u8],
+}
+
+impl<'a> PropertyRow<'a> {
+    pub(crate) fn parse(bytes: &'a [u8]) -> Option<Self> {
+        let count = u32::from_be_bytes(bytes.get(..COUNT_BYTES)?.try_into().ok()?) as usize;
+        let table_end = COUNT_BYTES.checked_add(count.checked_mul(ENTRY_BYTES)?)?;
+        if bytes.len() < table_end {
+            return None;
+        }
+        Some(Self {
+            table: &bytes[COUNT_BYTES..table_end],
+            data: &bytes[table_end..],
+        })
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        self.table.len() / ENTRY_BYTES
+    }
+
+    fn slot(&self, index: usize) -> Option<(PropertyKeyId, usize)> {
+        let raw = self
+            .table
+            .get(index * ENTRY_BYTES..(index + 1) * ENTRY_BYTES)?;
+        Some((
+            u32::from_be_bytes(raw[..4].try_into().ok()?),
+            u32::from_be_bytes(raw[4..].try_into().ok()?) as usize,
+        ))
+    }
+
+    /// Key id and encoded value of entry `index`; `None` if out of bounds.
+    fn entry(&self, index: usize) -> Option<(PropertyKeyId, &'a [u8])> {
+        let start = match index {
+            0 => 0,
+            _ => self.slot(index - 1)?.1,
+        };
+        let (key, end) = self.slot(index)?;
+        let data: &'a [u8] = self.data;
+        Some((key, data.get(start..end)?))
+    }
+
+    /// Encoded value of `key`, found by binary search over the offset table.
+    pub(crate) fn get(&self, key: PropertyKeyId) -> Option<&'a [u8]> {
+        let (mut lo, mut hi) = (0, self.len());
+        while lo < hi {
+            let mid = lo + (hi - lo) / 2;
+            let (found, _) = self.slot(mid)?;
+            match found.cmp(&key) {
+                std::cmp::Ordering::Less => lo = mid + 1,
+                std::cmp::Ordering::Greater => hi = mid,
+                std::cmp::Ordering::Equal => return self.entry(mid).map(|(_, value)| value),
+            }
+        }
+        None
+    }
+
+    /// Entries in key id order; stops at the first out-of-bounds entry.
+    pub(crate) fn entries(&self) -> impl Iterator<Item = (PropertyKeyId, &'a [u8])> + '_ {
+        (0..self.len()).map_while(|index| self.entry(index))
+    }
+
+    /// Whether every entry is in bounds, the key ids are strictly ascending,
+    /// and the data area has no trailing bytes.
+    #[cfg(feature = "unstable-admin")]
+    pub(crate) fn validate(&self) -> bool {
+        let mut previous: Option<PropertyKeyId> = None;
+        for index in 0..self.len() {
+            let Some((key, _)) = self.entry(index) else {
+                return false;
+            };
+            if previous.is_some_and(|prev| prev >= key) {
+                return false;
+            }
+            previous = Some(key);
+        }
+        let used = match self.len() {
+            0 => 0,
+            len => self.slot(len - 1).map_or(usize::MAX, |(_, end)| end),
+        };
+        used == self.data.len()
+    }
+}
+
+/// Encodes `props` as one record; `BTreeMap` order is the key id order
+/// readers binary-search.
+pub(crate) fn encode_property_row(props: &BTreeMap<PropertyKeyId, PropertyValue>) -> Vec<u8> {
+    let values: Vec<Vec<u8>> = props.values().map(PropertyValue::encode).collect();
+    let data_len: usize = values.iter().map(Vec::len).sum();
+    let mut out = Vec::with_capacity(COUNT_BYTES + props.len() * ENTRY_BYTES + data_len);
+    let count = u32::try_from(props.len()).expect("property count should fit in u32");
+    out.extend_from_slice(&count.to_be_bytes());
+    let mut end = 0usize;
+    for (key, value) in props.keys().zip(&values) {
+        end += value.len();
+        let end = u32::try_from(end).expect("property record should fit in u32 offsets");
+        out.extend_from_slice(&key.to_be_bytes());
+        out.extend_from_slice(&end.to_be_bytes());
+    }
+    for value in &values {
+        out.extend_from_slice(value);
+    }
+    out
+}
+
+/// Decodes every property of a record, skipping entries that do not decode.
+pub(crate) fn decode_property_row(bytes: &[u8]) -> Option<BTreeMap<PropertyKeyId, PropertyValue>> {
+    let row = PropertyRow::parse(bytes)?;
+    Some(
+        row.entries()
+            .filter_map(|(key, value)| Some((key, PropertyValue::decode(value).ok()?)))
+            .collect(),
+    )
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn property_row_point_lookup_matches_full_decode() {
+        let mut props = BTreeMap::new();
+        props.insert(0, PropertyValue::Int(30));
+        props.insert(3, PropertyValue::String("Alice".into()));
+        props.insert(4, PropertyValue::Null);
+        props.insert(9, PropertyValue::List(vec![PropertyValue::Bool(true)]));
+        let bytes = encode_property_row(&props);
+        let row = PropertyRow::parse(&bytes).unwrap();
+
+        assert_eq!(row.len(), 4);
+        for (key, value) in &props {
+            assert_eq!(
+                row.get(*key).map(|raw| PropertyValue::decode(raw).unwrap()),
+                Some(value.clone())
+            );
+        }
+        assert_eq!(row.get(1), None);
+        assert_eq!(row.get(10), None);
+        assert_eq!(decode_property_row(&bytes), Some(props));
+
+        let empty = encode_property_row(&BTreeMap::new());
+        assert_eq!(PropertyRow::parse(&empty).unwrap().get(0), None);
+        assert!(PropertyRow::parse(&bytes[..bytes.len() - 1]).is_some());
+        assert!(PropertyRow::parse(&[0, 0, 0, 9, 0]).is_none());
+    }
+}
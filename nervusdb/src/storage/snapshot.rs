@@ -1,17 +1,40 @@
 use crate::api::{
     EdgeKey, ExternalId, GraphSnapshot, InternalNodeId, LabelId, PropertyValue, RelTypeId,
+    normalize_vector, text_matches, text_phrase_matches, text_terms,
 };
-use crate::storage::engine::Keyspaces;
+use crate::storage::adjacency_codec::AdjacencyCursor;
+use crate::storage::adjacency_delta::PendingDeltas;
+use crate::storage::engine::{Keyspaces, META_NEXT_NODE_ID, scalar_indexable_value};
+use crate::storage::fulltext_index::{decode_posting, intersect_postings};
+use crate::storage::label_bitmap::{LabelChunk, join_node_id, split_node_id};
 use crate::storage::layout::*;
+use crate::storage::node_liveness::NodeLiveness;
+use crate::storage::ordered_value::typed_ranges;
 use crate::storage::profile;
+use crate::storage::property_keys::{PropertyKeyId, PropertyKeys};
+use crate::storage::property_row::{PropertyRow, decode_property_row};
+use crate::storage::statistics::{
+    DegreeDirection, DegreeHistogram, DegreeStatistics, GraphStatistics, LabelStatistics,
+    PropertySketch, PropertyStatistics, RelTypeStatistics, stored_distinct,
+};
+use crate::storage::unique_constraint::unique_value;
+use crate::storage::vector_index::{VECTOR_EXACT_SCAN_NODES, VectorIndex};
 use fjall::Readable;
-use std::collections::BTreeMap;
+use std::collections::{BTreeMap, BTreeSet, HashMap};
+use std::ops::Bound;
+use std::sync::Arc;
 use std::time::Instant;
 
 #[derive(Clone)]
 pub struct Snapshot {
     inner: fjall::Snapshot,
     keyspaces: Keyspaces,
+    deltas: Arc<PendingDeltas>,
+    liveness: Arc<NodeLiveness>,
+    property_keys: Arc<PropertyKeys>,
+    vectors: Arc<VectorIndex>,
+    /// `vector_seq` in `meta` as of this snapshot.
+    vector_seq: u64,
 }
 
 pub type StorageSnapshot = Snapshot;
@@ -23,22 +46,136 @@ impl std::fmt::Debug for Snapshot {
 }
 
 impl Snapshot {
-    pub(crate) fn new(inner: fjall::Snapshot, keyspaces: Keyspaces) -> Self {
-        Self { inner, keyspaces }
+    pub(crate) fn new(
+        inner: fjall::Snapshot,
+        keyspaces: Keyspaces,
+        deltas: Arc<PendingDeltas>,
+        liveness: Arc<NodeLiveness>,
+        property_keys: Arc<PropertyKeys>,
+        (vectors, vector_seq): (Arc<VectorIndex>, u64),
+    ) -> Self {
+        Self {
+            inner,
+            keyspaces,
+            deltas,
+            liveness,
+            property_keys,
+            vectors,
+            vector_seq,
+        }
+    }
+
+    /// Id of an interned property key; `None` means no record uses `name`.
+    #[inline]
+    pub(crate) fn property_key_id(&self, name: &str) -> Option<PropertyKeyId> {
+        self.property_keys.id(name)
+    }
+
+    /// Replaces interned key ids with their names, dropping unknown ids.
+    fn named_properties(
+        &self,
+        props: BTreeMap<PropertyKeyId, PropertyValue>,
+    ) -> BTreeMap<String, PropertyValue> {
+        let names = self.property_keys.names(props.keys().copied());
+        names
+            .into_iter()
+            .zip(props.into_values())
+            .filter_map(|(name, value)| Some((name?, value)))
+            .collect()
     }
 
     fn get(&self, keyspace: &fjall::Keyspace, key: impl AsRef<[u8]>) -> Option<Vec<u8>> {
-        self.inner
-            .get(keyspace, key)
-            .ok()
-            .flatten()
+        self.get_value(keyspace, key)
             .map(|value| value.as_ref().to_vec())
     }
 
+    /// Point read that keeps Fjall's reference-counted value slice.
+    fn get_value(&self, keyspace: &fjall::Keyspace, key: impl AsRef<[u8]>) -> Option<fjall::Slice> {
+        self.inner.get(keyspace, key).ok().flatten()
+    }
+
+    /// Answered from the resident liveness bitmap; no storage read.
+    #[inline]
     pub(crate) fn node_is_live(&self, iid: InternalNodeId) -> bool {
-        self.get(&self.keyspaces.graph_data, node_key(iid))
-            .and_then(|value| parse_node_value(&value))
-            .is_some_and(|(_, flags)| flags & KEY_FLAG_TOMBSTONE == 0)
+        self.liveness.is_live(iid)
+    }
+
+    /// Node holding a unique index entry as of this snapshot.
+    pub(crate) fn unique_index_owner(&self, key: &[u8]) -> Option<InternalNodeId> {
+        self.get_value(&self.keyspaces.graph_data, key)
+            .and_then(|value| decode_u32(value.as_ref()))
+    }
+
+    /// One posting chunk, by its full key; `None` when absent or malformed.
+    pub(crate) fn fulltext_posting(&self, key: &[u8]) -> Option<Vec<InternalNodeId>> {
+        self.get_value(&self.keyspaces.graph_data, key)
+            .and_then(|value| decode_posting(value.as_ref()))
+    }
+
+    /// Live nodes listed under every term of `query` in the full-text index
+    /// on `(label, key)`, or `None` when no such index is declared as of this
+    /// snapshot.
+    fn fulltext_candidates(
+        &self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+    ) -> Option<Vec<InternalNodeId>> {
+        let key_id = self.property_key_id(key)?;
+        self.get_value(
+            &self.keyspaces.graph_data,
+            fulltext_index_def_key(label, key_id),
+        )?;
+        let terms: BTreeSet<String> = text_terms(query).into_iter().collect();
+        let lists = terms
+            .iter()
+            .map(|term| {
+                self.inner
+                    .prefix(
+                        &self.keyspaces.graph_data,
+                        fulltext_posting_prefix(label, key_id, term),
+                    )
+                    .filter_map(|guard| guard.into_inner().ok())
+                    .filter_map(|(_, value)| decode_posting(value.as_ref()))
+                    .flatten()
+                    .collect()
+            })
+            .collect();
+        let mut nodes = intersect_postings(lists);
+        nodes.retain(|iid| self.node_is_live(*iid));
+        Some(nodes)
+    }
+
+    /// Nodes of `label` whose string `key` satisfies `accept`, found by
+    /// scanning the label.
+    fn text_scan<'s>(
+        &'s self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+        accept: fn(&str, &str) -> bool,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + 's> {
+        let key = key.to_string();
+        let query = query.to_string();
+        Box::new(
+            GraphSnapshot::nodes_with_label(self, label).filter(move |iid| {
+                matches!(self.node_property(*iid, &key),
+                    Some(PropertyValue::String(text)) if accept(&text, &query))
+            }),
+        )
+    }
+
+    /// Composite indexes declared on `label` as of this snapshot.
+    fn composite_index_defs(&self, label: LabelId) -> Vec<Vec<PropertyKeyId>> {
+        self.inner
+            .prefix(
+                &self.keyspaces.graph_data,
+                composite_index_def_label_prefix(label),
+            )
+            .filter_map(|guard| guard.key().ok())
+            .filter_map(|key| parse_composite_index_def_key(key.as_ref()))
+            .map(|(_, keys)| keys)
+            .collect()
     }
 
     fn collect_prefix_keys(&self, keyspace: &fjall::Keyspace, prefix: Vec<u8>) -> Vec<Vec<u8>> {
@@ -48,22 +185,16 @@ impl Snapshot {
             .collect()
     }
 
-    pub fn neighbors(
-        &self,
-        src: InternalNodeId,
-        rel: Option<RelTypeId>,
-    ) -> impl Iterator<Item = EdgeKey> + '_ {
-        let (edges, records) = self.outgoing_edges(src, rel);
-        EdgeScan::new("neighbors", edges, records)
+    pub fn neighbors(&self, src: InternalNodeId, rel: Option<RelTypeId>) -> NeighborCursor<'_> {
+        self.adjacency_cursor("neighbors", AdjDirection::Out, src, rel)
     }
 
     pub fn incoming_neighbors(
         &self,
         dst: InternalNodeId,
         rel: Option<RelTypeId>,
-    ) -> impl Iterator<Item = EdgeKey> + '_ {
-        let (edges, records) = self.incoming_edges(dst, rel);
-        EdgeScan::new("incoming_neighbors", edges, records)
+    ) -> NeighborCursor<'_> {
+        self.adjacency_cursor("incoming_neighbors", AdjDirection::In, dst, rel)
     }
 
     pub fn resolve_label_id(&self, name: &str) -> Option<LabelId> {
@@ -97,44 +228,44 @@ impl Snapshot {
             .collect()
     }
 
+    /// Decodes only `key` out of the node's property record.
     pub fn node_property(&self, node: InternalNodeId, key: &str) -> Option<PropertyValue> {
-        self.get(&self.keyspaces.graph_data, node_prop_key(node, key))
-            .and_then(|value| parse_prop_value(&value).ok())
+        self.node_property_by_id(node, self.property_key_id(key)?)
+    }
+
+    fn node_property_by_id(
+        &self,
+        node: InternalNodeId,
+        key: PropertyKeyId,
+    ) -> Option<PropertyValue> {
+        let record = self.get_value(&self.keyspaces.graph_data, node_props_key(node))?;
+        let raw = PropertyRow::parse(record.as_ref())?.get(key)?;
+        parse_prop_value(raw).ok()
     }
 
     pub fn edge_property(&self, edge: EdgeKey, key: &str) -> Option<PropertyValue> {
-        self.get(&self.keyspaces.graph_data, edge_prop_key(edge, key))
-            .and_then(|value| parse_prop_value(&value).ok())
+        self.edge_property_by_id(edge, self.property_key_id(key)?)
     }
 
     pub(crate) fn edge_is_live(&self, edge: EdgeKey) -> bool {
         if !self.node_is_live(edge.src) || !self.node_is_live(edge.dst) {
             return false;
         }
-        self.adjacent_out_nodes(edge.src, edge.rel)
-            .binary_search(&edge.dst)
-            .is_ok()
+        self.adjacency_contains(AdjDirection::Out, edge.src, edge.rel, edge.dst)
     }
 
     pub fn node_properties(&self, iid: InternalNodeId) -> Option<BTreeMap<String, PropertyValue>> {
-        let mut props = BTreeMap::new();
-        for guard in self
-            .inner
-            .prefix(&self.keyspaces.graph_data, node_prop_prefix(iid))
-        {
-            let Ok((key, value)) = guard.into_inner() else {
-                continue;
-            };
-            let Some(prop_key) = parse_node_prop_key_for_node(key.as_ref(), iid) else {
-                continue;
-            };
-            let Ok(prop_value) = parse_prop_value(value.as_ref()) else {
-                continue;
-            };
-            props.insert(prop_key, prop_value);
-        }
+        let props = self.node_property_ids(iid)?;
+        Some(self.named_properties(props)).filter(|props| !props.is_empty())
+    }
 
-        if props.is_empty() { None } else { Some(props) }
+    /// Properties of `iid` keyed by interned id, as stored.
+    pub(crate) fn node_property_ids(
+        &self,
+        iid: InternalNodeId,
+    ) -> Option<BTreeMap<PropertyKeyId, PropertyValue>> {
+        let record = self.get_value(&self.keyspaces.graph_data, node_props_key(iid))?;
+        decode_property_row(record.as_ref()).filter(|props| !props.is_empty())
     }
 
     pub fn edge_properties(&self, edge: EdgeKey) -> Option<BTreeMap<String, PropertyValue>> {
@@ -153,6 +284,7 @@ impl Snapshot {
             props.insert(prop_key, prop_value);
         }
 
+        let props = self.named_properties(props);
         if props.is_empty() { None } else { Some(props) }
     }
 
@@ -160,43 +292,69 @@ impl Snapshot {
         self.collect_prefix_keys(&self.keyspaces.graph_data, edge_prop_prefix(edge))
     }
 
-    pub(crate) fn collect_node_property_keys(&self, node: InternalNodeId) -> Vec<Vec<u8>> {
-        self.collect_prefix_keys(&self.keyspaces.graph_data, node_prop_prefix(node))
+    pub(crate) fn edge_property_by_id(
+        &self,
+        edge: EdgeKey,
+        key: PropertyKeyId,
+    ) -> Option<PropertyValue> {
+        self.get_value(&self.keyspaces.graph_data, edge_prop_key(edge, key))
+            .and_then(|value| parse_prop_value(value.as_ref()).ok())
+    }
+
+    /// Edge property index entries derived from the stored properties of
+    /// `edge`.
+    pub(crate) fn collect_edge_property_index_keys(&self, edge: EdgeKey) -> Vec<Vec<u8>> {
+        self.inner
+            .prefix(&self.keyspaces.graph_data, edge_prop_prefix(edge))
+            .filter_map(|guard| guard.into_inner().ok())
+            .filter_map(|(key, value)| {
+                let key = parse_edge_prop_key_for_edge(key.as_ref(), edge)?;
+                let value = parse_prop_value(value.as_ref()).ok()?;
+                scalar_indexable_value(&value).then(|| edge_prop_index_key(key, &value, edge))
+            })
+            .collect()
+    }
+
+    /// Index entries of every stored property of a live edge. O(edge
+    /// properties); used to build the index for directories that predate it.
+    pub(crate) fn scan_edge_property_index_keys(&self) -> Vec<Vec<u8>> {
+        self.inner
+            .prefix(&self.keyspaces.graph_data, edge_prop_scan_prefix())
+            .filter_map(|guard| guard.into_inner().ok())
+            .filter_map(|(key, value)| {
+                let (edge, key) = parse_edge_prop_key(key.as_ref())?;
+                let value = parse_prop_value(value.as_ref()).ok()?;
+                (scalar_indexable_value(&value) && self.edge_is_live(edge))
+                    .then(|| edge_prop_index_key(key, &value, edge))
+            })
+            .collect()
     }
 
     pub(crate) fn collect_raw_outgoing_edges(&self, node: InternalNodeId) -> Vec<EdgeKey> {
-        self.outgoing_edges(node, None).0
+        self.neighbors(node, None).collect()
     }
 
     pub(crate) fn collect_raw_incoming_edges(&self, node: InternalNodeId) -> Vec<EdgeKey> {
-        self.incoming_edges(node, None).0
+        self.incoming_neighbors(node, None).collect()
     }
 
     pub fn nodes(&self) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
-        Box::new(
-            self.inner
-                .prefix(&self.keyspaces.graph_data, node_scan_prefix())
-                .filter_map(|guard| guard.key().ok())
-                .filter_map(|key| parse_node_key(key.as_ref()))
-                .filter(|iid| self.node_is_live(*iid)),
-        )
+        Box::new(self.liveness.live_nodes())
     }
 
     pub fn is_tombstoned_node(&self, iid: InternalNodeId) -> bool {
-        self.get(&self.keyspaces.graph_data, node_key(iid))
-            .and_then(|value| parse_node_value(&value))
-            .is_some_and(|(_, flags)| flags & KEY_FLAG_TOMBSTONE != 0)
+        self.liveness.is_tombstoned(iid)
     }
 }
 
 impl GraphSnapshot for Snapshot {
     type Neighbors<'a>
-        = Box<dyn Iterator<Item = EdgeKey> + 'a>
+        = NeighborCursor<'a>
     where
         Self: 'a;
 
     fn neighbors(&self, src: InternalNodeId, rel: Option<RelTypeId>) -> Self::Neighbors<'_> {
-        Box::new(self.neighbors(src, rel))
+        self.neighbors(src, rel)
     }
 
     fn incoming_neighbors(
@@ -204,7 +362,7 @@ impl GraphSnapshot for Snapshot {
         dst: InternalNodeId,
         rel: Option<RelTypeId>,
     ) -> Self::Neighbors<'_> {
-        Box::new(self.incoming_neighbors(dst, rel))
+        self.incoming_neighbors(dst, rel)
     }
 
     fn nodes(&self) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
@@ -213,10 +371,50 @@ impl GraphSnapshot for Snapshot {
 
     fn nodes_with_label(&self, label: LabelId) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
         Box::new(
-            self.inner
-                .prefix(&self.keyspaces.graph_data, label_node_prefix(label))
-                .filter_map(|guard| guard.key().ok())
-                .filter_map(|key| parse_label_node_key(key.as_ref()).map(|(_, node)| node))
+            self.label_chunks(label)
+                .flat_map(|(chunk, members)| {
+                    members
+                        .lows()
+                        .into_iter()
+                        .map(move |low| join_node_id(chunk, low))
+                })
+                .filter(|iid| self.node_is_live(*iid)),
+        )
+    }
+
+    /// Walks the chunks of the label with the smallest stored count and
+    /// intersects each with the same chunk of the other labels.
+    fn nodes_with_labels(
+        &self,
+        labels: &[LabelId],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let mut labels = labels.to_vec();
+        labels.sort_unstable();
+        labels.dedup();
+        match labels.len() {
+            0 => return self.nodes(),
+            1 => return self.nodes_with_label(labels[0]),
+            _ => {}
+        }
+        labels.sort_by_key(|label| self.stored_count(label_count_key(*label)));
+        let driver = labels.remove(0);
+        Box::new(
+            self.label_chunks(driver)
+                .filter_map(move |(chunk, mut members)| {
+                    for label in &labels {
+                        members = members.intersect(&self.label_chunk(*label, chunk)?);
+                        if members.is_empty() {
+                            return None;
+                        }
+                    }
+                    Some((chunk, members))
+                })
+                .flat_map(|(chunk, members)| {
+                    members
+                        .lows()
+                        .into_iter()
+                        .map(move |low| join_node_id(chunk, low))
+                })
                 .filter(|iid| self.node_is_live(*iid)),
         )
     }
@@ -227,6 +425,9 @@ impl GraphSnapshot for Snapshot {
         key: &str,
         value: &PropertyValue,
     ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let Some(key) = self.property_key_id(key) else {
+            return Box::new(std::iter::empty());
+        };
         Box::new(
             self.inner
                 .prefix(
@@ -239,6 +440,225 @@ impl GraphSnapshot for Snapshot {
         )
     }
 
+    fn node_by_unique_property(
+        &self,
+        label: LabelId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Option<InternalNodeId> {
+        let key_id = self.property_key_id(key)?;
+        if unique_value(value) {
+            // A hit costs one point read; a miss one more to tell an
+            // unconstrained key from an absent value.
+            if let Some(node) = self.unique_index_owner(&unique_index_key(label, key_id, value)) {
+                return Some(node).filter(|iid| self.node_is_live(*iid));
+            }
+            if self
+                .get_value(
+                    &self.keyspaces.graph_data,
+                    unique_constraint_key(label, key_id),
+                )
+                .is_some()
+            {
+                return None;
+            }
+        }
+        self.nodes_with_label_and_property(label, key, value).next()
+    }
+
+    fn nodes_with_label_and_terms(
+        &self,
+        label: LabelId,
+        key: &str,
+        query: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        match self.fulltext_candidates(label, key, query) {
+            Some(nodes) => Box::new(nodes.into_iter()),
+            None => self.text_scan(label, key, query, text_matches),
+        }
+    }
+
+    /// Posting lists give the nodes holding every term; term order is
+    /// checked against the stored value of each candidate.
+    fn nodes_with_label_and_phrase(
+        &self,
+        label: LabelId,
+        key: &str,
+        phrase: &str,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let Some(nodes) = self.fulltext_candidates(label, key, phrase) else {
+            return self.text_scan(label, key, phrase, text_phrase_matches);
+        };
+        let key = key.to_string();
+        let phrase = phrase.to_string();
+        Box::new(nodes.into_iter().filter(move |iid| {
+            matches!(self.node_property(*iid, &key),
+                Some(PropertyValue::String(text)) if text_phrase_matches(&text, &phrase))
+        }))
+    }
+
+    fn node_vector(&self, iid: InternalNodeId) -> Option<Vec<f32>> {
+        self.vectors.vector(iid, self.vector_seq)
+    }
+
+    /// Walks the resident HNSW graph, keeping only vectors of this snapshot.
+    /// Labels with few nodes are ranked exactly instead, since most of the
+    /// graph walk would land on nodes without the label.
+    fn search_vectors(
+        &self,
+        query: &[f32],
+        k: usize,
+        label: Option<LabelId>,
+    ) -> Vec<(InternalNodeId, f32)> {
+        let Some(query) = normalize_vector(query) else {
+            return Vec::new();
+        };
+        let Some(label) = label else {
+            return self
+                .vectors
+                .search(&query, k, self.vector_seq, |iid| self.node_is_live(iid));
+        };
+        if self.stored_count(label_count_key(label)) <= VECTOR_EXACT_SCAN_NODES {
+            return self.vectors.search_among(
+                &query,
+                k,
+                self.vector_seq,
+                self.nodes_with_label(label),
+            );
+        }
+        let mut chunks: HashMap<u16, Option<LabelChunk>> = HashMap::new();
+        self.vectors.search(&query, k, self.vector_seq, |iid| {
+            let (chunk, low) = split_node_id(iid);
+            self.node_is_live(iid)
+                && chunks
+                    .entry(chunk)
+                    .or_insert_with(|| self.label_chunk(label, chunk))
+                    .as_ref()
+                    .is_some_and(|members| members.contains(low))
+        })
+    }
+
+    fn nodes_with_label_and_properties(
+        &self,
+        label: LabelId,
+        props: &[(&str, &PropertyValue)],
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let mut wanted: BTreeMap<PropertyKeyId, PropertyValue> = BTreeMap::new();
+        for (key, value) in props {
+            let Some(key) = self.property_key_id(key) else {
+                return Box::new(std::iter::empty());
+            };
+            if wanted
+                .insert(key, (*value).clone())
+                .is_some_and(|v| &v != *value)
+            {
+                return Box::new(std::iter::empty());
+            }
+        }
+
+        // Probe the declared index with the longest run of given leading
+        // keys. Null is never probed: it also stands for a missing key.
+        let probe = self
+            .composite_index_defs(label)
+            .into_iter()
+            .map(|keys| {
+                let run = keys
+                    .iter()
+                    .take_while(|key| {
+                        wanted.get(key).is_some_and(|value| {
+                            scalar_indexable_value(value) && *value != PropertyValue::Null
+                        })
+                    })
+                    .count();
+                (run, keys)
+            })
+            .filter(|(run, _)| *run >= 2)
+            .max_by_key(|(run, _)| *run);
+        let candidates: Box<dyn Iterator<Item = InternalNodeId> + '_> = match probe {
+            Some((run, keys)) => {
+                let values: Vec<&PropertyValue> =
+                    keys[..run].iter().map(|key| &wanted[key]).collect();
+                let prefix = composite_index_prefix(label, &keys, &values);
+                for key in &keys[..run] {
+                    wanted.remove(key);
+                }
+                Box::new(
+                    self.inner
+                        .prefix(&self.keyspaces.graph_data, prefix)
+                        .filter_map(|guard| guard.key().ok())
+                        .filter_map(|key| parse_composite_index_node(key.as_ref()))
+                        .filter(|iid| self.node_is_live(*iid)),
+                )
+            }
+            None => match props.first() {
+                Some((key, value)) => {
+                    if let Some(key) = self.property_key_id(key) {
+                        wanted.remove(&key);
+                    }
+                    self.nodes_with_label_and_property(label, key, value)
+                }
+                None => GraphSnapshot::nodes_with_label(self, label),
+            },
+        };
+        if wanted.is_empty() {
+            return candidates;
+        }
+        Box::new(candidates.filter(move |iid| {
+            wanted
+                .iter()
+                .all(|(key, value)| self.node_property_by_id(*iid, *key).as_ref() == Some(value))
+        }))
+    }
+
+    fn nodes_with_label_and_property_range(
+        &self,
+        label: LabelId,
+        key: &str,
+        lower: Bound<&PropertyValue>,
+        upper: Bound<&PropertyValue>,
+    ) -> Box<dyn Iterator<Item = InternalNodeId> + '_> {
+        let Some(key) = self.property_key_id(key) else {
+            return Box::new(std::iter::empty());
+        };
+        Box::new(
+            typed_ranges(lower, upper)
+                .into_iter()
+                .flat_map(move |range| {
+                    self.inner.range(
+                        &self.keyspaces.graph_data,
+                        node_prop_index_range(label, key, &range),
+                    )
+                })
+                .filter_map(|guard| guard.key().ok())
+                .filter_map(|key| parse_node_prop_index_node(key.as_ref()))
+                .filter(|iid| self.node_is_live(*iid)),
+        )
+    }
+
+    fn edges_with_rel_and_property(
+        &self,
+        rel: RelTypeId,
+        key: &str,
+        value: &PropertyValue,
+    ) -> Box<dyn Iterator<Item = EdgeKey> + '_> {
+        let Some(key) = self.property_key_id(key) else {
+            return Box::new(std::iter::empty());
+        };
+        if !scalar_indexable_value(value) {
+            return Box::new(std::iter::empty());
+        }
+        Box::new(
+            self.inner
+                .prefix(
+                    &self.keyspaces.graph_data,
+                    edge_prop_index_prefix(rel, key, value),
+                )
+                .filter_map(|guard| guard.key().ok())
+                .filter_map(|key| parse_edge_prop_index_edge(key.as_ref()))
+                .filter(|edge| self.node_is_live(edge.src) && self.node_is_live(edge.dst)),
+        )
+    }
+
     fn resolve_external(&self, iid: InternalNodeId) -> Option<ExternalId> {
         if !self.node_is_live(iid) {
             return None;
@@ -299,8 +719,8 @@ impl GraphSnapshot for Snapshot {
     fn node_count(&self, label: Option<LabelId>) -> u64 {
         let started = profile::start();
         let count = match label {
-            Some(label) => self.nodes_with_label(label).count() as u64,
-            None => self.nodes().count() as u64,
+            Some(label) => self.stored_count(label_count_key(label)),
+            None => self.liveness.live_count(),
         };
         profile::event_since(
             "node_count",
@@ -323,101 +743,655 @@ impl GraphSnapshot for Snapshot {
         );
         count
     }
+
+    fn property_distinct_count(&self, label: LabelId, key: &str) -> Option<u64> {
+        let key = self.property_key_id(key)?;
+        let record = self.get_value(&self.keyspaces.meta, property_stats_key(label, key))?;
+        stored_distinct(record.as_ref())
+    }
+
+    fn average_degree(&self, label: LabelId, rel: RelTypeId, incoming: bool) -> Option<f64> {
+        let dir = if incoming {
+            AdjDirection::In
+        } else {
+            AdjDirection::Out
+        };
+        let edges = match self.degree_histogram(dir, label, rel) {
+            Some(histogram) => histogram.edges,
+            // ANALYZE stores no record for pairs without edges.
+            None if self.statistics_analyzed() => 0,
+            None => return None,
+        };
+        let nodes = self.stored_count(label_count_key(label));
+        Some(if nodes == 0 {
+            0.0
+        } else {
+            edges as f64 / nodes as f64
+        })
+    }
+}
+
+/// One overflow bucket of a packed adjacency list, as read by the commit path.
+#[derive(Debug)]
+pub(crate) struct AdjacencyBucket {
+    pub(crate) fence: u32,
+    /// Fence of the next bucket, or `None` when this is the last bucket.
+    pub(crate) upper: Option<u32>,
+    pub(crate) nodes: Vec<InternalNodeId>,
 }
 
 impl Snapshot {
-    pub(crate) fn adjacent_out_nodes(
+    /// Reads the base record of a `(node, rel)` list: its header flags and the
+    /// neighbors stored before the first overflow bucket.
+    pub(crate) fn adjacency_base(
         &self,
-        src: InternalNodeId,
+        dir: AdjDirection,
+        node: InternalNodeId,
         rel: RelTypeId,
-    ) -> Vec<InternalNodeId> {
-        self.get(&self.keyspaces.adj_out, adj_out_key(src, rel))
+    ) -> Option<(u8, Vec<InternalNodeId>)> {
+        self.get(self.keyspaces.adjacency(dir), dir.base_key(node, rel))
             .and_then(|value| decode_adjacent_nodes(&value))
-            .unwrap_or_default()
     }
 
-    pub(crate) fn adjacent_in_nodes(
+    /// Point read of the overflow bucket starting at `fence`.
+    pub(crate) fn adjacency_bucket_at(
         &self,
-        dst: InternalNodeId,
+        dir: AdjDirection,
+        node: InternalNodeId,
         rel: RelTypeId,
-    ) -> Vec<InternalNodeId> {
-        self.get(&self.keyspaces.adj_in, adj_in_key(dst, rel))
-            .and_then(|value| decode_adjacent_nodes(&value))
-            .unwrap_or_default()
+        fence: u32,
+    ) -> Option<Vec<InternalNodeId>> {
+        self.get(
+            self.keyspaces.adjacency(dir),
+            adj_bucket_key(node, rel, fence),
+        )
+        .and_then(|value| decode_adjacent_nodes(&value))
+        .map(|(_, nodes)| nodes)
     }
 
-    fn outgoing_edges(&self, src: InternalNodeId, rel: Option<RelTypeId>) -> (Vec<EdgeKey>, u64) {
-        if let Some(rel) = rel {
-            let dsts = self.adjacent_out_nodes(src, rel);
-            let edges = dsts
-                .into_iter()
-                .map(|dst| EdgeKey { src, rel, dst })
-                .collect::<Vec<_>>();
-            let records = u64::from(!edges.is_empty());
-            return (edges, records);
+    /// Fence of the first overflow bucket at or after `from`.
+    pub(crate) fn next_adjacency_fence(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+        from: u32,
+    ) -> Option<u32> {
+        self.inner
+            .range(
+                self.keyspaces.adjacency(dir),
+                adj_bucket_key(node, rel, from)..=adj_bucket_key(node, rel, u32::MAX),
+            )
+            .filter_map(|guard| guard.key().ok())
+            .find_map(|key| parse_adj_record_key(key.as_ref()).and_then(|(_, _, fence)| fence))
+    }
+
+    /// Locates the overflow bucket whose fence range covers `target`.
+    ///
+    /// Returns `None` when `target` sorts before every overflow fence, in which
+    /// case it belongs to the base record.
+    pub(crate) fn adjacency_bucket(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+        target: InternalNodeId,
+    ) -> Option<AdjacencyBucket> {
+        let (key, value) = self
+            .inner
+            .range(
+                self.keyspaces.adjacency(dir),
+                adj_bucket_key(node, rel, 0)..=adj_bucket_key(node, rel, target),
+            )
+            .next_back()?
+            .into_inner()
+            .ok()?;
+        let (_, _, fence) = parse_adj_record_key(key.as_ref())?;
+        let fence = fence?;
+        let (_, nodes) = decode_adjacent_nodes(value.as_ref())?;
+        let upper = fence
+            .checked_add(1)
+            .and_then(|from| self.next_adjacency_fence(dir, node, rel, from));
+        Some(AdjacencyBucket {
+            fence,
+            upper,
+            nodes,
+        })
+    }
+
+    /// Membership check that reads only the bucket covering `target`.
+    pub(crate) fn adjacency_contains(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+        target: InternalNodeId,
+    ) -> bool {
+        if self.deltas.has_list(dir, node, rel)
+            && let Some(present) = self.adjacency_delta_ops(dir, node, rel).get(&target)
+        {
+            return *present;
+        }
+        self.packed_adjacency_contains(dir, node, rel, target)
+    }
+
+    /// Membership in the packed base and bucket records only, ignoring deltas.
+    fn packed_adjacency_contains(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+        target: InternalNodeId,
+    ) -> bool {
+        let Some((flags, base)) = self.adjacency_base(dir, node, rel) else {
+            return false;
+        };
+        if base.binary_search(&target).is_ok() {
+            return true;
+        }
+        flags & ADJ_FLAG_CONTINUED != 0
+            && self
+                .adjacency_bucket(dir, node, rel, target)
+                .is_some_and(|bucket| bucket.nodes.binary_search(&target).is_ok())
+    }
+
+    /// Neighbor count of one list with pending deltas applied. Sums the count
+    /// headers of the base and bucket records and checks each pending delta
+    /// operation against the one record covering it, so the cost follows the
+    /// bucket and delta counts rather than the degree.
+    pub(crate) fn adjacency_degree(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+    ) -> u64 {
+        let mut degree = 0u64;
+        for guard in self
+            .inner
+            .prefix(self.keyspaces.adjacency(dir), dir.base_key(node, rel))
+        {
+            if let Ok(value) = guard.value()
+                && let Some(nodes) = count_adjacent_nodes(value.as_ref())
+            {
+                degree += nodes as u64;
+            }
+        }
+        if self.deltas.has_list(dir, node, rel) {
+            for (other, present) in self.adjacency_delta_ops(dir, node, rel) {
+                match (
+                    present,
+                    self.packed_adjacency_contains(dir, node, rel, other),
+                ) {
+                    (true, false) => degree += 1,
+                    (false, true) => degree = degree.saturating_sub(1),
+                    _ => {}
+                }
+            }
+        }
+        degree
+    }
+
+    /// Folded delta operations of one list, oldest record first; `true` means
+    /// the neighbor is present after the deltas.
+    pub(crate) fn adjacency_delta_ops(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: RelTypeId,
+    ) -> BTreeMap<InternalNodeId, bool> {
+        let mut ops = BTreeMap::new();
+        for guard in self.inner.prefix(
+            &self.keyspaces.graph_data,
+            adj_delta_list_prefix(dir, node, rel),
+        ) {
+            if let Ok(value) = guard.value() {
+                apply_adj_delta(value.as_ref(), &mut ops);
+            }
         }
+        ops
+    }
+
+    pub(crate) fn collect_adjacency_delta_keys(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> Vec<Vec<u8>> {
+        let prefix = match rel {
+            Some(rel) => adj_delta_list_prefix(dir, node, rel),
+            None => adj_delta_node_prefix(dir, node),
+        };
+        self.collect_prefix_keys(&self.keyspaces.graph_data, prefix)
+    }
+
+    /// Keys of every base and overflow record owned by `node` in `dir`.
+    pub(crate) fn collect_adjacency_record_keys(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+    ) -> Vec<Vec<u8>> {
+        let prefix = match dir {
+            AdjDirection::Out => adj_out_prefix(node, None),
+            AdjDirection::In => adj_in_prefix(node, None),
+        };
+        self.collect_prefix_keys(self.keyspaces.adjacency(dir), prefix)
+    }
+
+    /// Opens a lazy cursor over the adjacency records of `node`.
+    ///
+    /// With a relationship type this is a point read of the base record,
+    /// followed by a range scan of overflow buckets only when the base is
+    /// marked continued. Without one it prefix scans every list of `node`.
+    /// Lists with pending delta records are merged eagerly instead.
+    fn adjacency_cursor(
+        &self,
+        stage: &'static str,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> NeighborCursor<'_> {
+        let pending = match rel {
+            Some(rel) => self.deltas.has_list(dir, node, rel),
+            None => self.deltas.has_node(dir, node),
+        };
+        if pending {
+            let edges = self.merged_adjacency_edges(dir, node, rel);
+            return NeighborCursor::new(
+                self,
+                stage,
+                dir,
+                node,
+                RecordSource::Merged(edges.into_iter()),
+            );
+        }
+        self.packed_adjacency_cursor(stage, dir, node, rel)
+    }
+
+    /// Cursor over the packed base and bucket records only, ignoring deltas.
+    fn packed_adjacency_cursor(
+        &self,
+        stage: &'static str,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> NeighborCursor<'_> {
+        let source = match rel {
+            Some(rel) => RecordSource::Base(
+                rel,
+                self.get_value(self.keyspaces.adjacency(dir), dir.base_key(node, rel)),
+            ),
+            None => {
+                let prefix = match dir {
+                    AdjDirection::Out => adj_out_prefix(node, None),
+                    AdjDirection::In => adj_in_prefix(node, None),
+                };
+                RecordSource::Scan(Box::new(
+                    self.inner
+                        .prefix(self.keyspaces.adjacency(dir), prefix)
+                        .filter_map(|guard| guard.into_inner().ok()),
+                ))
+            }
+        };
+        NeighborCursor::new(self, stage, dir, node, source)
+    }
+
+    /// Applies pending delta records on top of the packed lists of `node`.
+    fn merged_adjacency_edges(
+        &self,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        rel: Option<RelTypeId>,
+    ) -> Vec<EdgeKey> {
+        let mut lists: BTreeMap<RelTypeId, Vec<EdgeKey>> = BTreeMap::new();
+        for edge in self.packed_adjacency_cursor("adjacency_delta_merge", dir, node, rel) {
+            lists.entry(edge.rel).or_default().push(edge);
+        }
+        let other = |edge: &EdgeKey| match dir {
+            AdjDirection::Out => edge.dst,
+            AdjDirection::In => edge.src,
+        };
+        let rels = self
+            .deltas
+            .rels(dir, node)
+            .filter(|found| rel.map_or(true, |rel| rel == *found))
+            .collect::<Vec<_>>();
+        for found in rels {
+            let ops = self.adjacency_delta_ops(dir, node, found);
+            let packed = lists.remove(&found).unwrap_or_default();
+            let mut merged = Vec::with_capacity(packed.len() + ops.len());
+            let mut ops = ops.into_iter().peekable();
+            for edge in packed {
+                let id = other(&edge);
+                while let Some((op_id, present)) = ops.next_if(|(op_id, _)| *op_id < id) {
+                    if present {
+                        merged.push(adjacency_edge(dir, node, found, op_id));
+                    }
+                }
+                match ops.next_if(|(op_id, _)| *op_id == id) {
+                    Some((_, false)) => {}
+                    _ => merged.push(edge),
+                }
+            }
+            merged.extend(
+                ops.filter(|(_, present)| *present)
+                    .map(|(op_id, _)| adjacency_edge(dir, node, found, op_id)),
+            );
+            lists.insert(found, merged);
+        }
+        lists.into_values().flatten().collect()
+    }
+
+    /// Exclusive upper bound of allocated internal node ids in this snapshot.
+    pub(crate) fn node_id_bound(&self) -> u32 {
+        self.get(&self.keyspaces.meta, META_NEXT_NODE_ID)
+            .and_then(|value| <[u8; 8]>::try_from(value.as_slice()).ok())
+            .map_or(0, |raw| {
+                u64::from_be_bytes(raw).min(u64::from(u32::MAX)) as u32
+            })
+    }
+
+    /// Visits every edge owned by nodes in `lo..hi`, in `(node, rel, other)`
+    /// order, with pending delta records applied.
+    ///
+    /// One range scan covers the packed records of the whole id range; only
+    /// nodes with pending deltas fall back to the merged per-node path.
+    pub(crate) fn for_each_adjacency_in_range(
+        &self,
+        dir: AdjDirection,
+        lo: InternalNodeId,
+        hi: InternalNodeId,
+        mut visit: impl FnMut(InternalNodeId, RelTypeId, InternalNodeId),
+    ) {
+        if lo >= hi {
+            return;
+        }
+        let mut pending = self
+            .deltas
+            .lists()
+            .filter(|(found, node, _)| *found == dir && (lo..hi).contains(node))
+            .map(|(_, node, _)| node)
+            .collect::<Vec<_>>();
+        pending.sort_unstable();
+        pending.dedup();
+        let mut pending = pending.into_iter().peekable();
+        let visit_merged =
+            |node: InternalNodeId,
+             visit: &mut dyn FnMut(InternalNodeId, RelTypeId, InternalNodeId)| {
+                for edge in self.merged_adjacency_edges(dir, node, None) {
+                    let other = match dir {
+                        AdjDirection::Out => edge.dst,
+                        AdjDirection::In => edge.src,
+                    };
+                    visit(node, edge.rel, other);
+                }
+            };
 
-        let mut edges = Vec::new();
-        let mut records = 0;
         for guard in self
             .inner
-            .prefix(&self.keyspaces.adj_out, adj_out_prefix(src, None))
+            .range(self.keyspaces.adjacency(dir), key_u32(lo)..key_u32(hi))
         {
             let Ok((key, value)) = guard.into_inner() else {
                 continue;
             };
-            let Some((found_src, rel)) = parse_adj_out_key(key.as_ref()) else {
+            let Some((node, rel, _)) = parse_adj_record_key(key.as_ref()) else {
                 continue;
             };
-            if found_src != src {
+            while let Some(merged) = pending.next_if(|merged| *merged <= node) {
+                visit_merged(merged, &mut visit);
+            }
+            if self.deltas.has_node(dir, node) {
                 continue;
             }
-            let Some(dsts) = decode_adjacent_nodes(value.as_ref()) else {
+            let Some((_, ids)) = AdjacencyCursor::new(value) else {
                 continue;
             };
-            records += 1;
-            edges.extend(dsts.into_iter().map(|dst| EdgeKey { src, rel, dst }));
+            for other in ids {
+                visit(node, rel, other);
+            }
+        }
+        for merged in pending {
+            visit_merged(merged, &mut visit);
         }
-        (edges, records)
     }
 
-    fn incoming_edges(&self, dst: InternalNodeId, rel: Option<RelTypeId>) -> (Vec<EdgeKey>, u64) {
-        if let Some(rel) = rel {
-            let srcs = self.adjacent_in_nodes(dst, rel);
-            let edges = srcs
-                .into_iter()
-                .map(|src| EdgeKey { src, rel, dst })
-                .collect::<Vec<_>>();
-            let records = u64::from(!edges.is_empty());
-            return (edges, records);
+    fn count_edges(&self, rel: Option<RelTypeId>) -> u64 {
+        match rel {
+            Some(rel) => self.stored_count(rel_count_key(rel)),
+            None => self
+                .inner
+                .prefix(&self.keyspaces.meta, META_REL_COUNT_PREFIX)
+                .filter_map(|guard| guard.into_inner().ok())
+                .filter_map(|(_, value)| decode_counter(value.as_ref()))
+                .sum(),
         }
+    }
 
-        let mut edges = Vec::new();
-        let mut records = 0;
+    /// Counter maintained by `WriteTxn::commit`; absent means zero.
+    pub(crate) fn stored_count(&self, key: Vec<u8>) -> u64 {
+        self.get_value(&self.keyspaces.meta, key)
+            .and_then(|value| decode_counter(value.as_ref()))
+            .unwrap_or(0)
+    }
+
+    /// Recounts live nodes per label from the label bitmaps. O(nodes); used
+    /// to rebuild the stored counters.
+    pub(crate) fn scan_label_counts(&self) -> BTreeMap<LabelId, u64> {
+        let mut counts = BTreeMap::new();
         for guard in self
             .inner
-            .prefix(&self.keyspaces.adj_in, adj_in_prefix(dst, None))
+            .prefix(&self.keyspaces.graph_data, label_bitmap_scan_prefix())
         {
             let Ok((key, value)) = guard.into_inner() else {
                 continue;
             };
-            let Some((found_dst, rel)) = parse_adj_in_key(key.as_ref()) else {
+            let Some((label, chunk)) = parse_label_bitmap_key(key.as_ref()) else {
                 continue;
             };
-            if found_dst != dst {
+            let Some(members) = LabelChunk::decode(value.as_ref()) else {
                 continue;
+            };
+            let live = members
+                .lows()
+                .into_iter()
+                .filter(|low| self.node_is_live(join_node_id(chunk, *low)))
+                .count() as u64;
+            if live > 0 {
+                *counts.entry(label).or_insert(0) += live;
             }
-            let Some(srcs) = decode_adjacent_nodes(value.as_ref()) else {
+        }
+        counts
+    }
+
+    /// Membership container of one `(label, chunk)`; `None` when empty or
+    /// malformed.
+    pub(crate) fn label_chunk(&self, label: LabelId, chunk: u16) -> Option<LabelChunk> {
+        self.get_value(&self.keyspaces.graph_data, label_bitmap_key(label, chunk))
+            .and_then(|value| LabelChunk::decode(value.as_ref()))
+    }
+
+    fn label_chunks(&self, label: LabelId) -> impl Iterator<Item = (u16, LabelChunk)> + '_ {
+        self.inner
+            .prefix(&self.keyspaces.graph_data, label_bitmap_prefix(label))
+            .filter_map(|guard| guard.into_inner().ok())
+            .filter_map(|(key, value)| {
+                let (_, chunk) = parse_label_bitmap_key(key.as_ref())?;
+                Some((chunk, LabelChunk::decode(value.as_ref())?))
+            })
+    }
+
+    /// Labels of every live node in `lo..hi`, indexed by `node - lo`, from
+    /// one range scan.
+    pub(crate) fn node_labels_in_range(
+        &self,
+        lo: InternalNodeId,
+        hi: InternalNodeId,
+    ) -> Vec<Vec<LabelId>> {
+        let mut labels = vec![Vec::new(); hi.saturating_sub(lo) as usize];
+        if lo >= hi {
+            return labels;
+        }
+        for guard in self.inner.range(
+            &self.keyspaces.graph_data,
+            node_label_prefix(lo)..node_label_prefix(hi),
+        ) {
+            let Ok(key) = guard.key() else {
                 continue;
             };
-            records += 1;
-            edges.extend(srcs.into_iter().map(|src| EdgeKey { src, rel, dst }));
+            if let Some((node, label)) = parse_node_label_key(key.as_ref())
+                && self.node_is_live(node)
+            {
+                labels[(node - lo) as usize].push(label);
+            }
         }
-        (edges, records)
+        labels
     }
 
-    fn count_edges(&self, rel: Option<RelTypeId>) -> u64 {
-        let mut count = 0;
+    /// Visits the properties of every live node in `lo..hi` that has any, in
+    /// id order, from one range scan.
+    pub(crate) fn for_each_node_properties_in_range(
+        &self,
+        lo: InternalNodeId,
+        hi: InternalNodeId,
+        mut visit: impl FnMut(InternalNodeId, BTreeMap<PropertyKeyId, PropertyValue>),
+    ) {
+        if lo >= hi {
+            return;
+        }
+        for guard in self.inner.range(
+            &self.keyspaces.graph_data,
+            node_props_key(lo)..node_props_key(hi),
+        ) {
+            let Ok((key, value)) = guard.into_inner() else {
+                continue;
+            };
+            let Some(node) = parse_node_props_key(key.as_ref()) else {
+                continue;
+            };
+            if !self.node_is_live(node) {
+                continue;
+            }
+            if let Some(props) = decode_property_row(value.as_ref()) {
+                visit(node, props);
+            }
+        }
+    }
+
+    /// Whether ANALYZE has run, after which commits maintain the statistics.
+    pub(crate) fn statistics_analyzed(&self) -> bool {
+        self.get_value(&self.keyspaces.meta, META_STATS_ANALYZED)
+            .is_some()
+    }
+
+    pub(crate) fn degree_histogram(
+        &self,
+        dir: AdjDirection,
+        label: LabelId,
+        rel: RelTypeId,
+    ) -> Option<DegreeHistogram> {
+        self.get_value(&self.keyspaces.meta, degree_stats_key(dir, label, rel))
+            .and_then(|record| DegreeHistogram::decode(record.as_ref()))
+    }
+
+    pub(crate) fn property_sketch(
+        &self,
+        label: LabelId,
+        key: PropertyKeyId,
+    ) -> Option<PropertySketch> {
+        self.get_value(&self.keyspaces.meta, property_stats_key(label, key))
+            .and_then(|record| PropertySketch::decode(record.as_ref()))
+    }
+
+    /// Statistics stored by ANALYZE, or `None` before the first one.
+    pub(crate) fn statistics(&self) -> Option<GraphStatistics> {
+        let analyzed_at = self
+            .get_value(&self.keyspaces.meta, META_STATS_ANALYZED)
+            .and_then(|value| decode_counter(value.as_ref()))?;
+        let meta_records = |prefix: &'static [u8]| {
+            self.inner
+                .prefix(&self.keyspaces.meta, prefix)
+                .filter_map(|guard| guard.into_inner().ok())
+        };
+        let label_name = |label: LabelId| {
+            self.resolve_label_name(label)
+                .unwrap_or_else(|| format!("#{label}"))
+        };
+        let rel_name = |rel: RelTypeId| {
+            self.resolve_rel_type_name(rel)
+                .unwrap_or_else(|| format!("#{rel}"))
+        };
+
+        let mut statistics = GraphStatistics {
+            analyzed_at,
+            ..GraphStatistics::default()
+        };
+        for (key, value) in meta_records(META_LABEL_COUNT_PREFIX) {
+            if let (Some(label), Some(nodes)) = (
+                parse_counter_key(META_LABEL_COUNT_PREFIX, key.as_ref()),
+                decode_counter(value.as_ref()),
+            ) {
+                statistics.labels.push(LabelStatistics {
+                    label: label_name(label),
+                    nodes,
+                });
+            }
+        }
+        for (key, value) in meta_records(META_REL_COUNT_PREFIX) {
+            if let (Some(rel), Some(edges)) = (
+                parse_counter_key(META_REL_COUNT_PREFIX, key.as_ref()),
+                decode_counter(value.as_ref()),
+            ) {
+                statistics.rel_types.push(RelTypeStatistics {
+                    rel_type: rel_name(rel),
+                    edges,
+                });
+            }
+        }
+        for (key, value) in meta_records(META_STATS_DEGREE_PREFIX) {
+            let (Some((dir, label, rel)), Some(histogram)) = (
+                parse_degree_stats_key(key.as_ref()),
+                DegreeHistogram::decode(value.as_ref()),
+            ) else {
+                continue;
+            };
+            let without = self
+                .stored_count(label_count_key(label))
+                .saturating_sub(histogram.nodes());
+            statistics.degrees.push(DegreeStatistics {
+                label: label_name(label),
+                rel_type: rel_name(rel),
+                direction: match dir {
+                    AdjDirection::Out => DegreeDirection::Outgoing,
+                    AdjDirection::In => DegreeDirection::Incoming,
+                },
+                edges: histogram.edges,
+                nodes_by_degree: std::iter::once(without).chain(histogram.buckets).collect(),
+            });
+        }
+        for (key, value) in meta_records(META_STATS_PROPERTY_PREFIX) {
+            let (Some((label, property_key)), Some(sketch)) = (
+                parse_property_stats_key(key.as_ref()),
+                PropertySketch::decode(value.as_ref()),
+            ) else {
+                continue;
+            };
+            let Some(Some(name)) = self.property_keys.names([property_key]).pop() else {
+                continue;
+            };
+            statistics.properties.push(PropertyStatistics {
+                label: label_name(label),
+                key: name,
+                values: sketch.values,
+                distinct: sketch.distinct.estimate(),
+                most_common: sketch.common_values(),
+            });
+        }
+        Some(statistics)
+    }
+
+    /// Recounts edges per relationship type from `adj_out` with pending
+    /// deltas applied. O(edges); used to rebuild the stored counters.
+    pub(crate) fn scan_rel_counts(&self) -> BTreeMap<RelTypeId, u64> {
+        let mut counts = BTreeMap::new();
         for guard in self
             .inner
             .prefix(&self.keyspaces.adj_out, adj_out_scan_prefix())
@@ -425,64 +1399,171 @@ impl Snapshot {
             let Ok((key, value)) = guard.into_inner() else {
                 continue;
             };
-            let Some((_, found_rel)) = parse_adj_out_key(key.as_ref()) else {
+            let Some((node, rel, _)) = parse_adj_record_key(key.as_ref()) else {
                 continue;
             };
-            if rel.is_some_and(|rel| rel != found_rel) {
+            if self.deltas.has_list(AdjDirection::Out, node, rel) {
                 continue;
             }
-            let Some(nodes) = decode_adjacent_nodes(value.as_ref()) else {
+            let Some(nodes) = count_adjacent_nodes(value.as_ref()) else {
                 continue;
             };
-            count += nodes.len() as u64;
+            *counts.entry(rel).or_insert(0) += nodes as u64;
         }
-        count
+        for (dir, node, rel) in self.deltas.lists() {
+            if dir == AdjDirection::Out {
+                *counts.entry(rel).or_insert(0) += self.adjacency_degree(dir, node, rel);
+            }
+        }
+        counts
+    }
+}
+
+enum RecordSource<'a> {
+    /// Base record of one `(node, rel)` list, not yet consumed.
+    Base(RelTypeId, Option<fjall::Slice>),
+    /// Remaining records of a key-ordered scan.
+    Scan(Box<dyn Iterator<Item = (fjall::Slice, fjall::Slice)> + 'a>),
+    /// Edges already merged with pending delta records.
+    Merged(std::vec::IntoIter<EdgeKey>),
+    Done,
+}
+
+fn adjacency_edge(
+    dir: AdjDirection,
+    node: InternalNodeId,
+    rel: RelTypeId,
+    other: InternalNodeId,
+) -> EdgeKey {
+    match dir {
+        AdjDirection::Out => EdgeKey {
+            src: node,
+            rel,
+            dst: other,
+        },
+        AdjDirection::In => EdgeKey {
+            src: other,
+            rel,
+            dst: node,
+        },
     }
 }
 
-struct EdgeScan {
+/// Lazy neighbor iterator returned by [`Snapshot::neighbors`] and
+/// [`Snapshot::incoming_neighbors`].
+///
+/// The cursor holds Fjall value slices directly and decodes neighbor ids on
+/// demand, so a rel-qualified hop over an unbucketed list performs one point
+/// read and no heap allocation.
+pub struct NeighborCursor<'a> {
+    snapshot: &'a Snapshot,
     stage: &'static str,
-    iter: std::vec::IntoIter<EdgeKey>,
+    dir: AdjDirection,
+    node: InternalNodeId,
+    source: RecordSource<'a>,
+    current: Option<(RelTypeId, AdjacencyCursor<fjall::Slice>)>,
     started: Option<Instant>,
     records: u64,
-    decoded: u64,
     live: u64,
 }
 
-impl EdgeScan {
-    fn new(stage: &'static str, edges: Vec<EdgeKey>, records: u64) -> Self {
-        let decoded = edges.len() as u64;
+impl std::fmt::Debug for NeighborCursor<'_> {
+    fn fmt(&self, f: &mut std::fmt::Formatter<'_>) -> std::fmt::Result {
+        f.debug_struct("NeighborCursor")
+            .field("stage", &self.stage)
+            .field("node", &self.node)
+            .finish_non_exhaustive()
+    }
+}
+
+impl<'a> NeighborCursor<'a> {
+    fn new(
+        snapshot: &'a Snapshot,
+        stage: &'static str,
+        dir: AdjDirection,
+        node: InternalNodeId,
+        source: RecordSource<'a>,
+    ) -> Self {
         Self {
+            snapshot,
             stage,
-            iter: edges.into_iter(),
+            dir,
+            node,
+            source,
+            current: None,
             started: profile::start(),
-            records,
-            decoded,
+            records: 0,
             live: 0,
         }
     }
+
+    /// Advances to the next decodable record, skipping malformed ones.
+    fn next_record(&mut self) -> Option<(RelTypeId, AdjacencyCursor<fjall::Slice>)> {
+        loop {
+            match std::mem::replace(&mut self.source, RecordSource::Done) {
+                RecordSource::Done | RecordSource::Merged(_) => return None,
+                RecordSource::Base(rel, value) => {
+                    let (flags, cursor) = value.and_then(AdjacencyCursor::new)?;
+                    if flags & ADJ_FLAG_CONTINUED != 0 {
+                        let keyspace = self.snapshot.keyspaces.adjacency(self.dir);
+                        self.source = RecordSource::Scan(Box::new(
+                            self.snapshot
+                                .inner
+                                .range(
+                                    keyspace,
+                                    adj_bucket_key(self.node, rel, 0)
+                                        ..=adj_bucket_key(self.node, rel, u32::MAX),
+                                )
+                                .filter_map(|guard| guard.into_inner().ok()),
+                        ));
+                    }
+                    self.records += 1;
+                    return Some((rel, cursor));
+                }
+                RecordSource::Scan(mut iter) => {
+                    let (key, value) = iter.next()?;
+                    self.source = RecordSource::Scan(iter);
+                    let Some((found, rel, _)) = parse_adj_record_key(key.as_ref()) else {
+                        continue;
+                    };
+                    if found != self.node {
+                        continue;
+                    }
+                    let Some((_, cursor)) = AdjacencyCursor::new(value) else {
+                        continue;
+                    };
+                    self.records += 1;
+                    return Some((rel, cursor));
+                }
+            }
+        }
+    }
 }
 
-impl Iterator for EdgeScan {
+impl Iterator for NeighborCursor<'_> {
     type Item = EdgeKey;
 
     fn next(&mut self) -> Option<Self::Item> {
-        let edge = self.iter.next()?;
-        if self.started.is_some() {
+        if let RecordSource::Merged(edges) = &mut self.source {
+            let edge = edges.next()?;
             self.live += 1;
+            return Some(edge);
+        }
+        loop {
+            if let Some((rel, cursor)) = &mut self.current
+                && let Some(other) = cursor.next()
+            {
+                let rel = *rel;
+                self.live += 1;
+                return Some(adjacency_edge(self.dir, self.node, rel, other));
+            }
+            self.current = Some(self.next_record()?);
         }
-        Some(edge)
     }
 }
 
-impl Drop for EdgeScan {
+impl Drop for NeighborCursor<'_> {
     fn drop(&mut self) {
-        profile::edge_scan(
-            self.stage,
-            self.started,
-            self.records,
-            self.decoded,
-            self.live,
-        );
+        profile::edge_scan(self.stage, self.started, self.records, self.live, self.live);
     }
 }
@@ -0,0 +1,466 @@
+//! Graph statistics: the sketches ANALYZE collects and their `meta` records.
+//!
+//! Degrees go into power-of-two histograms per `(direction, label, rel)`.
+//! Scalar values of every `(label, key)` the equality index covers go into a
+//! [`PropertySketch`]: a value count, a HyperLogLog distinct-value estimate,
+//! and a Misra-Gries most-common-values summary. Every sketch merges, so
+//! parallel workers combine their results without a second pass, and commits
+//! can fold their writes into the stored records.
+//!
+//! Record layouts, all integers big-endian:
+//!
+//! ```text
+//! stats/degree/   [edges u64][nodes u64 per bucket, trailing empty buckets dropped]
+//! stats/property/ [values u64][distinct u64][HLL registers]
+//!                 [common u8]([count u64][len u32][ordered value])*
+//! ```
+
+use crate::api::PropertyValue;
+use crate::storage::ordered_value::{decode_ordered, encode_ordered};
+use serde::ser::SerializeStruct;
+use std::collections::HashMap;
+
+/// HyperLogLog index bits; 4096 one-byte registers, about 1.6% error.
+const HLL_PRECISION: u32 = 12;
+const HLL_REGISTERS: usize = 1 << HLL_PRECISION;
+/// Values a most-common summary tracks at once.
+const COMMON_TRACKED: usize = 64;
+/// Most common values kept per `(label, key)` record.
+pub(crate) const COMMON_KEPT: usize = 10;
+
+/// Nodes by degree. `buckets[i]` counts nodes with `2^i..2^(i+1)` edges;
+/// nodes without edges are not counted, since the label counter covers them.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub(crate) struct DegreeHistogram {
+    pub(crate) edges: u64,
+    pub(crate) buckets: Vec<u64>,
+}
+
+impl DegreeHistogram {
+    fn bucket(degree: u64) -> usize {
+        (u64::BITS - 1 - degree.leading_zeros()) as usize
+    }
+
+    /// Counts one node with `degree` edges.
+    pub(crate) fn add(&mut self, degree: u64) {
+        if degree == 0 {
+            return;
+        }
+        let bucket = Self::bucket(degree);
+        if self.buckets.len() <= bucket {
+            self.buckets.resize(bucket + 1, 0);
+        }
+        self.buckets[bucket] += 1;
+        self.edges += degree;
+    }
+
+    /// Moves one node from `before` edges to `after` edges.
+    pub(crate) fn shift(&mut self, before: u64, after: u64) {
+        if before > 0
+            && let Some(count) = self.buckets.get_mut(Self::bucket(before))
+        {
+            *count = count.saturating_sub(1);
+            self.edges = self.edges.saturating_sub(before);
+        }
+        self.add(after);
+        while self.buckets.last() == Some(&0) {
+            self.buckets.pop();
+        }
+    }
+
+    pub(crate) fn merge(&mut self, other: &Self) {
+        if self.buckets.len() < other.buckets.len() {
+            self.buckets.resize(other.buckets.len(), 0);
+        }
+        for (count, more) in self.buckets.iter_mut().zip(&other.buckets) {
+            *count += more;
+        }
+        self.edges += other.edges;
+    }
+
+    pub(crate) fn encode(&self) -> Vec<u8> {
+        let mut out = Vec::with_capacity(8 * (1 + self.buckets.len()));
+        out.extend_from_slice(&self.edges.to_be_bytes());
+        for count in &self.buckets {
+            out.extend_from_slice(&count.to_be_bytes());
+        }
+        out
+    }
+
+    pub(crate) fn decode(bytes: &[u8]) -> Option<Self> {
+        if bytes.len() % 8 != 0 || bytes.is_empty() {
+            return None;
+        }
+        let mut words = bytes
+            .chunks_exact(8)
+            .map(|word| u64::from_be_bytes(word.try_into().expect("8 bytes")));
+        let edges = words.next()?;
+        Some(Self {
+            edges,
+            buckets: words.collect(),
+        })
+    }
+
+    /// Nodes with at least one edge.
+    pub(crate) fn nodes(&self) -> u64 {
+        self.buckets.iter().sum()
+    }
+}
+
+/// HyperLogLog distinct-value estimator over 64-bit hashes.
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub(crate) struct Hll {
+    registers: Vec<u8>,
+}
+
+impl Default for Hll {
+    fn default() -> Self {
+        Self {
+            registers: vec![0; HLL_REGISTERS],
+        }
+    }
+}
+
+impl Hll {
+    pub(crate) fn insert(&mut self, hash: u64) {
+        let index = (hash >> (u64::BITS - HLL_PRECISION)) as usize;
+        let rest = hash << HLL_PRECISION | 1 << (HLL_PRECISION - 1);
+        let rank = rest.leading_zeros() as u8 + 1;
+        let register = &mut self.registers[index];
+        *register = (*register).max(rank);
+    }
+
+    pub(crate) fn merge(&mut self, other: &Self) {
+        for (register, more) in self.registers.iter_mut().zip(&other.registers) {
+            *register = (*register).max(*more);
+        }
+    }
+
+    pub(crate) fn estimate(&self) -> u64 {
+        let m = HLL_REGISTERS as f64;
+        let alpha = 0.7213 / (1.0 + 1.079 / m);
+        let sum: f64 = self
+            .registers
+            .iter()
+            .map(|rank| 2f64.powi(-i32::from(*rank)))
+            .sum();
+        let raw = alpha * m * m / sum;
+        let empty = self.registers.iter().filter(|rank| **rank == 0).count();
+        // Linear counting is more accurate while many registers are empty.
+        let estimate = if raw <= 2.5 * m && empty > 0 {
+            m * (m / empty as f64).ln()
+        } else {
+            raw
+        };
+        estimate.round() as u64
+    }
+}
+
+/// Misra-Gries summary: every value seen more than `1 / COMMON_TRACKED` of
+/// the time is tracked, and each count is a lower bound.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub(crate) struct MostCommon {
+    /// Counts by order-preserving value encoding.
+    counts: HashMap<Vec<u8>, u64>,
+}
+
+impl MostCommon {
+    pub(crate) fn insert(&mut self, encoded: &[u8]) {
+        if let Some(count) = self.counts.get_mut(encoded) {
+            *count += 1;
+        } else if self.counts.len() < COMMON_TRACKED {
+            self.counts.insert(encoded.to_vec(), 1);
+        } else {
+            self.counts.retain(|_, count| {
+                *count -= 1;
+                *count > 0
+            });
+        }
+    }
+
+    pub(crate) fn merge(&mut self, other: &Self) {
+        for (value, count) in &other.counts {
+            *self.counts.entry(value.clone()).or_insert(0) += count;
+        }
+        if self.counts.len() > COMMON_TRACKED {
+            let mut counts = self.counts.values().copied().collect::<Vec<_>>();
+            counts.sort_unstable_by(|a, b| b.cmp(a));
+            let cut = counts[COMMON_TRACKED];
+            self.counts.retain(|_, count| {
+                *count = count.saturating_sub(cut);
+                *count > 0
+            });
+        }
+    }
+
+    /// Up to `n` values, most common first; ties go to the smaller value.
+    pub(crate) fn top(&self, n: usize) -> Vec<(&[u8], u64)> {
+        let mut top = self
+            .counts
+            .iter()
+            .map(|(value, count)| (value.as_slice(), *count))
+            .collect::<Vec<_>>();
+        top.sort_unstable_by(|a, b| b.1.cmp(&a.1).then(a.0.cmp(b.0)));
+        top.truncate(n);
+        top
+    }
+}
+
+/// Scalar values of one `(label, key)`.
+#[derive(Debug, Clone, Default, PartialEq, Eq)]
+pub(crate) struct PropertySketch {
+    pub(crate) values: u64,
+    pub(crate) distinct: Hll,
+    pub(crate) common: MostCommon,
+}
+
+impl PropertySketch {
+    pub(crate) fn insert(&mut self, value: &PropertyValue) {
+        let mut encoded = Vec::new();
+        encode_ordered(value, &mut encoded);
+        self.values += 1;
+        self.distinct.insert(hash_bytes(&encoded));
+        self.common.insert(&encoded);
+    }
+
+    pub(crate) fn merge(&mut self, other: &Self) {
+        self.values += other.values;
+        self.distinct.merge(&other.distinct);
+        self.common.merge(&other.common);
+    }
+
+    pub(crate) fn encode(&self) -> Vec<u8> {
+        let common = self.common.top(COMMON_KEPT);
+        let mut out = Vec::with_capacity(17 + HLL_REGISTERS + 24 * common.len());
+        out.extend_from_slice(&self.values.to_be_bytes());
+        out.extend_from_slice(&self.distinct.estimate().to_be_bytes());
+        out.extend_from_slice(&self.distinct.registers);
+        out.push(common.len() as u8);
+        for (value, count) in common {
+            out.extend_from_slice(&count.to_be_bytes());
+            out.extend_from_slice(&(value.len() as u32).to_be_bytes());
+            out.extend_from_slice(value);
+        }
+        out
+    }
+
+    pub(crate) fn decode(bytes: &[u8]) -> Option<Self> {
+        let values = u64::from_be_bytes(bytes.get(..8)?.try_into().ok()?);
+        let registers = bytes.get(16..16 + HLL_REGISTERS)?.to_vec();
+        let mut rest = bytes.get(16 + HLL_REGISTERS..)?;
+        let (&kept, tail) = rest.split_first()?;
+        rest = tail;
+        let mut counts = HashMap::with_capacity(usize::from(kept));
+        for _ in 0..kept {
+            let count = u64::from_be_bytes(rest.get(..8)?.try_into().ok()?);
+            let len = u32::from_be_bytes(rest.get(8..12)?.try_into().ok()?) as usize;
+            counts.insert(rest.get(12..12 + len)?.to_vec(), count);
+            rest = &rest[12 + len..];
+        }
+        Some(Self {
+            values,
+            distinct: Hll { registers },
+            common: MostCommon { counts },
+        })
+    }
+}
+
+/// Distinct-value estimate of an encoded [`PropertySketch`], without
+/// decoding the rest.
+pub(crate) fn stored_distinct(bytes: &[u8]) -> Option<u64> {
+    Some(u64::from_be_bytes(bytes.get(8..16)?.try_into().ok()?))
+}
+
+/// Hash of a value for [`PropertySketch`]. It is persisted in HyperLogLog
+/// registers, so it must not change between releases: FNV-1a, then the
+/// SplitMix64 finalizer to spread the bits.
+pub(crate) fn hash_value(value: &PropertyValue) -> u64 {
+    let mut encoded = Vec::new();
+    encode_ordered(value, &mut encoded);
+    hash_bytes(&encoded)
+}
+
+fn hash_bytes(bytes: &[u8]) -> u64 {
+    let mut hash = 0xcbf2_9ce4_8422_2325u64;
+    for byte in bytes {
+        hash ^= u64::from(*byte);
+        hash = hash.wrapping_mul(0x0000_0100_0000_01b3);
+    }
+    hash = (hash ^ (hash >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+    hash = (hash ^ (hash >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+    hash ^ (hash >> 31)
+}
+
+/// Statistics stored by [`crate::Db::analyze`].
+///
+/// Node and edge counts are exact. Commits keep degree histograms current
+/// for the edges they add or remove and add the values they write to
+/// `distinct`; `values` and `most_common` describe the last ANALYZE.
+#[derive(Debug, Clone, Default, PartialEq, serde::Serialize)]
+pub struct GraphStatistics {
+    /// Seconds since the Unix epoch when ANALYZE last ran.
+    pub analyzed_at: u64,
+    pub labels: Vec<LabelStatistics>,
+    pub rel_types: Vec<RelTypeStatistics>,
+    pub degrees: Vec<DegreeStatistics>,
+    pub properties: Vec<PropertyStatistics>,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize)]
+pub struct LabelStatistics {
+    pub label: String,
+    pub nodes: u64,
+}
+
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize)]
+pub struct RelTypeStatistics {
+    pub rel_type: String,
+    pub edges: u64,
+}
+
+#[derive(Debug, Clone, Copy, PartialEq, Eq, serde::Serialize)]
+#[serde(rename_all = "snake_case")]
+pub enum DegreeDirection {
+    Outgoing,
+    Incoming,
+}
+
+/// Degree distribution of the nodes of one label over one relationship type.
+#[derive(Debug, Clone, PartialEq, Eq, serde::Serialize)]
+pub struct DegreeStatistics {
+    pub label: String,
+    pub rel_type: String,
+    pub direction: DegreeDirection,
+    /// Edges summed over the label's nodes.
+    pub edges: u64,
+    /// `nodes_by_degree[0]` counts nodes without such edges, and
+    /// `nodes_by_degree[i]` nodes with `2^(i-1)..2^i` of them.
+    pub nodes_by_degree: Vec<u64>,
+}
+
+/// Scalar values of one property key on one label.
+#[derive(Debug, Clone, PartialEq, serde::Serialize)]
+pub struct PropertyStatistics {
+    pub label: String,
+    pub key: String,
+    /// Nodes holding a scalar value for the key.
+    pub values: u64,
+    /// Estimated distinct values.
+    pub distinct: u64,
+    /// Most common values, most common first.
+    pub most_common: Vec<CommonValue>,
+}
+
+/// A frequent value; `count` is a lower bound on its occurrences.
+#[derive(Debug, Clone, PartialEq)]
+pub struct CommonValue {
+    pub value: PropertyValue,
+    pub count: u64,
+}
+
+impl serde::Serialize for CommonValue {
+    fn serialize<S: serde::Serializer>(
+        &self,
+        serializer: S,
+    ) -> std::result::Result<S::Ok, S::Error> {
+        let mut out = serializer.serialize_struct("CommonValue", 2)?;
+        match &self.value {
+            PropertyValue::Bool(value) => out.serialize_field("value", value)?,
+            PropertyValue::Int(value) | PropertyValue::DateTime(value) => {
+                out.serialize_field("value", value)?
+            }
+            PropertyValue::Float(value) => out.serialize_field("value", value)?,
+            PropertyValue::String(value) => out.serialize_field("value", value)?,
+            PropertyValue::Blob(_) => out.serialize_field("value", "<binary>")?,
+            PropertyValue::Null | PropertyValue::List(_) | PropertyValue::Map(_) => {
+                out.serialize_field("value", &Option::<()>::None)?
+            }
+        }
+        out.serialize_field("count", &self.count)?;
+        out.end()
+    }
+}
+
+impl PropertySketch {
+    /// Stored most common values, decoded.
+    pub(crate) fn common_values(&self) -> Vec<CommonValue> {
+        self.common
+            .top(COMMON_KEPT)
+            .into_iter()
+            .filter_map(|(encoded, count)| {
+                let (value, _) = decode_ordered(encoded)?;
+                Some(CommonValue { value, count })
+            })
+            .collect()
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::{DegreeHistogram, Hll, MostCommon, PropertySketch, hash_value};
+    use crate::api::PropertyValue;
+
+    #[test]
+    fn hll_estimates_within_a_few_percent_and_merges() {
+        let mut left = Hll::default();
+        let mut right = Hll::default();
+        for value in 0..50_000i64 {
+            let hash = hash_value(&PropertyValue::Int(value));
+            if value % 2 == 0 {
+                left.insert(hash);
+            } else {
+                right.insert(hash);
+            }
+        }
+        left.merge(&right);
+        let estimate = left.estimate() as f64;
+        assert!((estimate - 50_000.0).abs() < 50_000.0 * 0.05, "{estimate}");
+
+        let mut small = Hll::default();
+        for value in ["a", "b", "c", "a"] {
+            small.insert(hash_value(&PropertyValue::from(value)));
+        }
+        assert_eq!(small.estimate(), 3);
+    }
+
+    #[test]
+    fn most_common_keeps_heavy_values_across_merges() {
+        let mut left = MostCommon::default();
+        let mut right = MostCommon::default();
+        for round in 0..1_000u32 {
+            left.insert(b"hot");
+            right.insert(&round.to_be_bytes());
+            right.insert(b"hot");
+        }
+        left.merge(&right);
+        let top = left.top(1);
+        assert_eq!(top[0].0, b"hot");
+        assert!(top[0].1 > 1_000);
+    }
+
+    #[test]
+    fn sketch_and_histogram_records_round_trip() {
+        let mut sketch = PropertySketch::default();
+        for value in ["x", "y", "x"] {
+            sketch.insert(&PropertyValue::from(value));
+        }
+        let decoded = PropertySketch::decode(&sketch.encode()).unwrap();
+        assert_eq!(decoded.values, 3);
+        assert_eq!(decoded.distinct, sketch.distinct);
+        assert_eq!(decoded.common_values()[0].value, PropertyValue::from("x"));
+        assert_eq!(decoded.common_values()[0].count, 2);
+
+        let mut histogram = DegreeHistogram::default();
+        for degree in [1, 2, 3, 9] {
+            histogram.add(degree);
+        }
+        assert_eq!(histogram.buckets, vec![1, 2, 0, 1]);
+        histogram.shift(9, 0);
+        assert_eq!(histogram.buckets, vec![1, 2]);
+        assert_eq!(histogram.edges, 6);
+        assert_eq!(
+            DegreeHistogram::decode(&histogram.encode()),
+            Some(histogram)
+        );
+    }
+}
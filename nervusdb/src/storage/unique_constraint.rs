@@ -0,0 +1,93 @@
+//! Declared unique constraints on `(label, key)`.
+//!
+//! A constraint keeps one entry per value, valued by the node holding it, so
+//! both the existence check of a commit and an upsert probe are one point
+//! read:
+//!
+//! ```text
+//! 0x55 UNIQUE_CONSTRAINT [tag][label][key_id] -> empty
+//! 0x56 UNIQUE_INDEX      [tag][label][key_id][ordered value] -> iid
+//! ```
+//!
+//! Values compare by their order-preserving encoding (see
+//! `ordered_value.rs`), so `1` and `1.0` are distinct. Nulls, lists, and maps
+//! are not constrained.
+
+use crate::api::{LabelId, PropertyValue};
+use crate::storage::Result;
+use crate::storage::engine::scalar_indexable_value;
+use crate::storage::layout::{
+    parse_unique_constraint_key, unique_constraint_scan_prefix, unique_index_key,
+};
+use crate::storage::property_keys::PropertyKeyId;
+use fjall::Keyspace;
+use std::collections::{BTreeMap, BTreeSet};
+use std::sync::{RwLock, RwLockReadGuard};
+
+/// Constrained keys per label.
+pub(crate) type UniqueDefs = BTreeMap<LabelId, BTreeSet<PropertyKeyId>>;
+
+/// Resident copy of the declarations, used by commits to check and maintain
+/// entries.
+#[derive(Debug, Default)]
+pub(crate) struct UniqueConstraints {
+    defs: RwLock<UniqueDefs>,
+}
+
+impl UniqueConstraints {
+    pub(crate) fn load(graph_data: &Keyspace) -> Result<Self> {
+        let mut defs = UniqueDefs::new();
+        for guard in graph_data.prefix(unique_constraint_scan_prefix()) {
+            let key = guard.key()?;
+            if let Some((label, key)) = parse_unique_constraint_key(key.as_ref()) {
+                defs.entry(label).or_default().insert(key);
+            }
+        }
+        Ok(Self {
+            defs: RwLock::new(defs),
+        })
+    }
+
+    pub(crate) fn read(&self) -> RwLockReadGuard<'_, UniqueDefs> {
+        self.defs.read().unwrap()
+    }
+
+    pub(crate) fn contains(&self, label: LabelId, key: PropertyKeyId) -> bool {
+        self.read()
+            .get(&label)
+            .is_some_and(|keys| keys.contains(&key))
+    }
+
+    /// Publishes a constraint whose entries are committed. Callers must hold
+    /// `write_lock`.
+    pub(crate) fn insert(&self, label: LabelId, key: PropertyKeyId) {
+        self.defs
+            .write()
+            .unwrap()
+            .entry(label)
+            .or_default()
+            .insert(key);
+    }
+}
+
+/// Whether `value` is held to a unique constraint.
+pub(crate) fn unique_value(value: &PropertyValue) -> bool {
+    scalar_indexable_value(value) && *value != PropertyValue::Null
+}
+
+/// Entries a node with `labels` and `props` should own.
+pub(crate) fn unique_index_keys<'l>(
+    labels: impl IntoIterator<Item = &'l LabelId>,
+    props: &BTreeMap<PropertyKeyId, PropertyValue>,
+    defs: &UniqueDefs,
+) -> BTreeSet<Vec<u8>> {
+    let mut out = BTreeSet::new();
+    for label in labels {
+        for key in defs.get(label).into_iter().flatten() {
+            if let Some(value) = props.get(key).filter(|value| unique_value(value)) {
+                out.insert(unique_index_key(*label, *key, value));
+            }
+        }
+    }
+    out
+}
@@ -0,0 +1,710 @@
+//! Resident HNSW index over node vectors.
+//!
+//! Every node may carry one embedding. Vectors are unit-normalized on write
+//! and compared by cosine distance. They live in the `vectors` keyspace with
+//! the links of a hierarchical navigable small-world graph (Malkov and
+//! Yashunin), so reopening does not rebuild the index:
+//!
+//! ```text
+//! 0x01 VECTOR_CONFIG [tag] -> dim:u32
+//! 0x02 VECTOR        [tag][iid] -> [level:u8][f32 le]*
+//! 0x03 VECTOR_LINKS  [tag][iid][layer:u8] -> neighbor ids
+//! ```
+//!
+//! The graph and vectors are loaded into memory on open. Commits insert into
+//! the resident graph under `write_lock` and write the new vector plus every
+//! link list they changed in the same batch.
+//!
+//! Searches must see the vectors of their snapshot only. Each vector version
+//! is a slot stamped with the `vector_seq` range `[added, removed)` it is
+//! visible in, and a snapshot reads its `vector_seq` from `meta`. Replaced and
+//! removed slots stay in the graph as waypoints until the next open.
+
+use crate::api::{InternalNodeId, vector_distance};
+use crate::storage::adjacency_codec;
+use crate::storage::layout::{
+    parse_vector_key, parse_vector_links_key, vector_config_key, vector_key, vector_links_key,
+    vector_links_scan_prefix, vector_scan_prefix,
+};
+use crate::storage::{Error, Result};
+use fjall::Keyspace;
+use std::cmp::{Ordering, Reverse};
+use std::collections::{BTreeMap, BTreeSet, BinaryHeap, HashMap, HashSet};
+use std::sync::{Mutex, RwLock};
+
+/// Links kept per node on layers above 0, and links a new node picks.
+const HNSW_M: usize = 16;
+/// Links kept per node on layer 0.
+const HNSW_M0: usize = 2 * HNSW_M;
+const HNSW_EF_CONSTRUCTION: usize = 128;
+/// Candidate list of a search; raised to `k` when larger.
+const HNSW_EF_SEARCH: usize = 64;
+const HNSW_MAX_LEVEL: usize = 15;
+/// Label filters matching at most this many nodes are ranked exactly.
+pub(crate) const VECTOR_EXACT_SCAN_NODES: u64 = 2048;
+
+/// `removed` of a slot that is still the node's vector.
+const SEQ_OPEN: u64 = u64::MAX;
+
+/// One staged change to the `vectors` keyspace; `None` removes the key.
+pub(crate) type VectorWrite = (Vec<u8>, Option<Vec<u8>>);
+
+#[derive(Debug, Clone, Copy, PartialEq)]
+struct Scored {
+    distance: f32,
+    slot: u32,
+}
+
+impl Eq for Scored {}
+
+impl Ord for Scored {
+    fn cmp(&self, other: &Self) -> Ordering {
+        self.distance
+            .total_cmp(&other.distance)
+            .then(self.slot.cmp(&other.slot))
+    }
+}
+
+impl PartialOrd for Scored {
+    fn partial_cmp(&self, other: &Self) -> Option<Ordering> {
+        Some(self.cmp(other))
+    }
+}
+
+/// One version of one node's vector.
+#[derive(Debug)]
+struct Slot {
+    node: InternalNodeId,
+    vector: Box<[f32]>,
+    /// Neighbor slots on layers `0..=level`.
+    links: Vec<Vec<u32>>,
+    added: u64,
+    removed: u64,
+    /// The node's previous version, which older snapshots may still see.
+    previous: Option<u32>,
+}
+
+impl Slot {
+    #[inline]
+    fn visible_at(&self, seq: u64) -> bool {
+        self.added <= seq && seq < self.removed
+    }
+}
+
+#[derive(Debug, Default)]
+struct Graph {
+    dim: Option<usize>,
+    slots: Vec<Slot>,
+    /// Newest slot of every node that has had a vector since open.
+    latest: HashMap<InternalNodeId, u32>,
+    entry: Option<u32>,
+}
+
+impl Graph {
+    #[inline]
+    fn distance(&self, query: &[f32], slot: u32) -> f32 {
+        vector_distance(query, &self.slots[slot as usize].vector)
+    }
+
+    #[inline]
+    fn links(&self, slot: u32, layer: usize) -> &[u32] {
+        self.slots[slot as usize]
+            .links
+            .get(layer)
+            .map_or(&[][..], Vec::as_slice)
+    }
+
+    /// Version of `node` a snapshot with `seq` sees.
+    fn visible_slot(&self, node: InternalNodeId, seq: u64) -> Option<u32> {
+        let mut slot = self.latest.get(&node).copied();
+        while let Some(current) = slot {
+            let version = &self.slots[current as usize];
+            if version.visible_at(seq) {
+                return Some(current);
+            }
+            slot = version.previous;
+        }
+        None
+    }
+
+    /// Greedy descent on one layer: moves to the closest neighbor until none
+    /// is closer.
+    fn greedy(&self, query: &[f32], mut current: Scored, layer: usize) -> Scored {
+        loop {
+            let mut moved = false;
+            for &next in self.links(current.slot, layer) {
+                let distance = self.distance(query, next);
+                if distance < current.distance {
+                    current = Scored {
+                        distance,
+                        slot: next,
+                    };
+                    moved = true;
+                }
+            }
+            if !moved {
+                return current;
+            }
+        }
+    }
+
+    /// Best-first search of one layer. Every reachable slot is a waypoint,
+    /// but only slots passing `accept` are returned: at most `ef`, nearest
+    /// first.
+    fn search_layer(
+        &self,
+        query: &[f32],
+        entry: &[Scored],
+        ef: usize,
+        layer: usize,
+        mut accept: impl FnMut(&Slot) -> bool,
+    ) -> Vec<Scored> {
+        let mut visited: HashSet<u32> = entry.iter().map(|scored| scored.slot).collect();
+        let mut candidates: BinaryHeap<Reverse<Scored>> =
+            entry.iter().copied().map(Reverse).collect();
+        let mut found: BinaryHeap<Scored> = BinaryHeap::with_capacity(ef + 1);
+        for scored in entry {
+            if accept(&self.slots[scored.slot as usize]) {
+                found.push(*scored);
+            }
+        }
+        while found.len() > ef {
+            found.pop();
+        }
+        while let Some(Reverse(current)) = candidates.pop() {
+            if found.len() >= ef && found.peek().is_some_and(|worst| current > *worst) {
+                break;
+            }
+            for &next in self.links(current.slot, layer) {
+                if !visited.insert(next) {
+                    continue;
+                }
+                let scored = Scored {
+                    distance: self.distance(query, next),
+                    slot: next,
+                };
+                if found.len() < ef || found.peek().is_some_and(|worst| scored < *worst) {
+                    candidates.push(Reverse(scored));
+                    if accept(&self.slots[next as usize]) {
+                        found.push(scored);
+                        if found.len() > ef {
+                            found.pop();
+                        }
+                    }
+                }
+            }
+        }
+        found.into_sorted_vec()
+    }
+
+    /// Neighbor heuristic of the HNSW paper: walks `candidates` nearest first
+    /// and keeps one only if it is closer to the base than to every kept
+    /// neighbor, so links spread across directions instead of one cluster.
+    fn select_neighbors(&self, candidates: &[Scored], max: usize) -> Vec<u32> {
+        let mut kept: Vec<u32> = Vec::with_capacity(max);
+        for candidate in candidates {
+            if kept.len() == max {
+                break;
+            }
+            let vector = &self.slots[candidate.slot as usize].vector;
+            if kept
+                .iter()
+                .all(|&other| self.distance(vector, other) > candidate.distance)
+            {
+                kept.push(candidate.slot);
+            }
+        }
+        kept
+    }
+
+    /// Adds the back link `from -> to`, re-selecting `from`'s links when the
+    /// layer is full.
+    fn link(&mut self, from: u32, to: u32, layer: usize) {
+        let max = if layer == 0 { HNSW_M0 } else { HNSW_M };
+        let links = self.links(from, layer);
+        if links.contains(&to) {
+            return;
+        }
+        let links = if links.len() < max {
+            let mut links = links.to_vec();
+            links.push(to);
+            links
+        } else {
+            let base = &self.slots[from as usize].vector;
+            let mut candidates: Vec<Scored> = links
+                .iter()
+                .chain([&to])
+                .map(|&slot| Scored {
+                    distance: self.distance(base, slot),
+                    slot,
+                })
+                .collect();
+            candidates.sort_unstable();
+            self.select_neighbors(&candidates, max)
+        };
+        if let Some(slot_links) = self.slots[from as usize].links.get_mut(layer) {
+            *slot_links = links;
+        }
+    }
+
+    /// Links a new slot into the graph and returns every `(slot, layer)` whose
+    /// link list changed.
+    fn insert(&mut self, new: u32) -> BTreeSet<(u32, usize)> {
+        let level = self.slots[new as usize].links.len() - 1;
+        let mut changed: BTreeSet<(u32, usize)> = (0..=level).map(|layer| (new, layer)).collect();
+        let Some(entry) = self.entry else {
+            self.entry = Some(new);
+            return changed;
+        };
+        let query = self.slots[new as usize].vector.clone();
+        let top = self.slots[entry as usize].links.len() - 1;
+        let mut current = Scored {
+            distance: self.distance(&query, entry),
+            slot: entry,
+        };
+        for layer in (level + 1..=top).rev() {
+            current = self.greedy(&query, current, layer);
+        }
+        let mut entry_points = vec![current];
+        for layer in (0..=level.min(top)).rev() {
+            // Prefer current vectors as neighbors; fall back to waypoints
+            // only when nothing current is reachable.
+            let mut found =
+                self.search_layer(&query, &entry_points, HNSW_EF_CONSTRUCTION, layer, |slot| {
+                    slot.removed == SEQ_OPEN
+                });
+            found.retain(|scored| scored.slot != new);
+            if found.is_empty() {
+                found =
+                    self.search_layer(&query, &entry_points, HNSW_EF_CONSTRUCTION, layer, |_| true);
+                found.retain(|scored| scored.slot != new);
+            }
+            let neighbors = self.select_neighbors(&found, HNSW_M);
+            for &neighbor in &neighbors {
+                self.link(neighbor, new, layer);
+                changed.insert((neighbor, layer));
+            }
+            self.slots[new as usize].links[layer] = neighbors;
+            if !found.is_empty() {
+                entry_points = found;
+            }
+        }
+        if level > top {
+            self.entry = Some(new);
+        }
+        changed
+    }
+}
+
+/// Level of a node in the hierarchy, drawn from the node id so a replaced
+/// vector keeps the same layers: `floor(-ln(U) / ln(M))`.
+fn node_level(node: InternalNodeId) -> usize {
+    // splitmix64 finalizer
+    let mut z = u64::from(node).wrapping_add(0x9e37_79b9_7f4a_7c15);
+    z = (z ^ (z >> 30)).wrapping_mul(0xbf58_476d_1ce4_e5b9);
+    z = (z ^ (z >> 27)).wrapping_mul(0x94d0_49bb_1331_11eb);
+    z ^= z >> 31;
+    let uniform = ((z >> 11) as f64 + 1.0) / (1u64 << 53) as f64;
+    ((-uniform.ln() / (HNSW_M as f64).ln()) as usize).min(HNSW_MAX_LEVEL)
+}
+
+fn encode_vector(level: usize, vector: &[f32]) -> Vec<u8> {
+    let mut out = Vec::with_capacity(1 + vector.len() * 4);
+    out.push(level as u8);
+    for x in vector {
+        out.extend_from_slice(&x.to_le_bytes());
+    }
+    out
+}
+
+/// Level and components of a `VECTOR` record; `None` when malformed.
+pub(crate) fn decode_vector(bytes: &[u8]) -> Option<(usize, Vec<f32>)> {
+    let (&level, body) = bytes.split_first()?;
+    if body.is_empty() || body.len() % 4 != 0 || usize::from(level) > HNSW_MAX_LEVEL {
+        return None;
+    }
+    let vector = body
+        .chunks_exact(4)
+        .map(|x| f32::from_le_bytes([x[0], x[1], x[2], x[3]]))
+        .collect();
+    Some((usize::from(level), vector))
+}
+
+#[derive(Debug, Default)]
+struct Staged {
+    added: Vec<u32>,
+    removed: Vec<u32>,
+    dim_set: bool,
+}
+
+#[derive(Debug, Default)]
+struct Commits {
+    /// `vector_seq` of the last committed change.
+    seq: u64,
+    staged: Option<Staged>,
+}
+
+#[derive(Debug, Default)]
+pub(crate) struct VectorIndex {
+    graph: RwLock<Graph>,
+    commits: Mutex<Commits>,
+}
+
+impl VectorIndex {
+    /// Loads the vectors and links persisted in the `vectors` keyspace.
+    pub(crate) fn load(vectors: &Keyspace, seq: u64) -> Result<Self> {
+        let mut graph = Graph::default();
+        if let Some(value) = vectors.get(vector_config_key())? {
+            let raw = <[u8; 4]>::try_from(value.as_ref()).map_err(|_| {
+                Error::StorageCorrupted("malformed vector config record".to_string())
+            })?;
+            graph.dim = Some(u32::from_be_bytes(raw) as usize);
+        }
+        for guard in vectors.prefix(vector_scan_prefix()) {
+            let (key, value) = guard.into_inner()?;
+            let (Some(node), Some((level, vector))) = (
+                parse_vector_key(key.as_ref()),
+                decode_vector(value.as_ref()),
+            ) else {
+                continue;
+            };
+            if Some(vector.len()) != graph.dim {
+                continue;
+            }
+            let slot = graph.slots.len() as u32;
+            graph.latest.insert(node, slot);
+            graph.slots.push(Slot {
+                node,
+                vector: vector.into_boxed_slice(),
+                links: vec![Vec::new(); level + 1],
+                added: 0,
+                removed: SEQ_OPEN,
+                previous: None,
+            });
+            let top = graph
+                .entry
+                .map(|entry| graph.slots[entry as usize].links.len());
+            if top.is_none_or(|top| level + 1 > top) {
+                graph.entry = Some(slot);
+            }
+        }
+        for guard in vectors.prefix(vector_links_scan_prefix()) {
+            let (key, value) = guard.into_inner()?;
+            let Some((node, layer)) = parse_vector_links_key(key.as_ref()) else {
+                continue;
+            };
+            let (Some(&slot), Some((_, ids))) = (
+                graph.latest.get(&node),
+                adjacency_codec::decode(value.as_ref()),
+            ) else {
+                continue;
+            };
+            let links: Vec<u32> = ids
+                .iter()
+                .filter_map(|id| graph.latest.get(id).copied())
+                .collect();
+            if let Some(slot_links) = graph.slots[slot as usize].links.get_mut(usize::from(layer)) {
+                *slot_links = links;
+            }
+        }
+        Ok(Self {
+            graph: RwLock::new(graph),
+            commits: Mutex::new(Commits { seq, staged: None }),
+        })
+    }
+
+    /// Dimension fixed by the first stored vector.
+    pub(crate) fn dim(&self) -> Option<usize> {
+        self.graph.read().unwrap().dim
+    }
+
+    /// Whether `node` has a vector as of the last commit.
+    pub(crate) fn has_vector(&self, node: InternalNodeId) -> bool {
+        let graph = self.graph.read().unwrap();
+        graph
+            .latest
+            .get(&node)
+            .is_some_and(|&slot| graph.slots[slot as usize].removed == SEQ_OPEN)
+    }
+
+    /// Inserts `puts` (unit vectors of one dimension) and removes the vectors
+    /// of `removals`, invisible to snapshots until the returned `vector_seq`
+    /// is committed. Returns that seq and the keyspace writes of the batch.
+    ///
+    /// Callers must hold `write_lock` and call [`Self::publish`] or
+    /// [`Self::abort`] once the batch is settled.
+    pub(crate) fn stage(
+        &self,
+        puts: &BTreeMap<InternalNodeId, Vec<f32>>,
+        removals: &BTreeSet<InternalNodeId>,
+    ) -> Result<(u64, Vec<VectorWrite>)> {
+        let dim = self.dim().or_else(|| puts.values().next().map(Vec::len));
+        if let Some((dim, found)) = dim.and_then(|dim| {
+            puts.values()
+                .map(Vec::len)
+                .find(|len| *len != dim)
+                .map(|len| (dim, len))
+        }) {
+            return Err(Error::InvalidVector(format!(
+                "expected {dim} dimensions, found {found}"
+            )));
+        }
+
+        let mut commits = self.commits.lock().unwrap();
+        let seq = commits.seq + 1;
+        let mut staged = Staged::default();
+        let mut writes: BTreeMap<Vec<u8>, Option<Vec<u8>>> = BTreeMap::new();
+        let mut changed: BTreeSet<(u32, usize)> = BTreeSet::new();
+        if let Some(dim) = dim
+            && self.dim().is_none()
+        {
+            self.graph.write().unwrap().dim = Some(dim);
+            staged.dim_set = true;
+            writes.insert(
+                vector_config_key(),
+                Some((dim as u32).to_be_bytes().to_vec()),
+            );
+        }
+
+        for &node in removals {
+            let mut graph = self.graph.write().unwrap();
+            let Some(&slot) = graph.latest.get(&node) else {
+                continue;
+            };
+            let version = &mut graph.slots[slot as usize];
+            if version.removed != SEQ_OPEN {
+                continue;
+            }
+            version.removed = seq;
+            staged.removed.push(slot);
+            writes.insert(vector_key(node), None);
+            for layer in 0..version.links.len() {
+                writes.insert(vector_links_key(node, layer as u8), None);
+            }
+        }
+
+        // Readers only block for one insert at a time.
+        for (&node, vector) in puts {
+            let mut graph = self.graph.write().unwrap();
+            let previous = graph.latest.get(&node).copied();
+            if let Some(previous) = previous {
+                let version = &mut graph.slots[previous as usize];
+                if version.removed == SEQ_OPEN {
+                    version.removed = seq;
+                    staged.removed.push(previous);
+                }
+            }
+            let level = node_level(node);
+            let slot = graph.slots.len() as u32;
+            graph.slots.push(Slot {
+                node,
+                vector: vector.clone().into_boxed_slice(),
+                links: vec![Vec::new(); level + 1],
+                added: seq,
+                removed: SEQ_OPEN,
+                previous,
+            });
+            graph.latest.insert(node, slot);
+            staged.added.push(slot);
+            changed.extend(graph.insert(slot));
+            writes.insert(vector_key(node), Some(encode_vector(level, vector)));
+        }
+
+        // Only current versions own the records of their node.
+        let graph = self.graph.read().unwrap();
+        for (slot, layer) in changed {
+            let version = &graph.slots[slot as usize];
+            if version.removed != SEQ_OPEN || graph.latest.get(&version.node) != Some(&slot) {
+                continue;
+            }
+            let mut ids: Vec<InternalNodeId> = version.links[layer]
+                .iter()
+                .map(|&other| graph.slots[other as usize].node)
+                .filter(|&other| other != version.node)
+                .collect();
+            ids.sort_unstable();
+            ids.dedup();
+            writes.insert(
+                vector_links_key(version.node, layer as u8),
+                Some(adjacency_codec::encode(0, &ids)),
+            );
+        }
+        commits.staged = Some(staged);
+        Ok((seq, writes.into_iter().collect()))
+    }
+
+    pub(crate) fn publish(&self) {
+        let mut commits = self.commits.lock().unwrap();
+        if commits.staged.take().is_some() {
+            commits.seq += 1;
+        }
+    }
+
+    /// Hides the slots of a failed batch and reopens the versions it
+    /// replaced. Hidden slots stay linked as waypoints.
+    pub(crate) fn abort(&self) {
+        let Some(staged) = self.commits.lock().unwrap().staged.take() else {
+            return;
+        };
+        let mut graph = self.graph.write().unwrap();
+        for slot in staged.added.into_iter().rev() {
+            let version = &mut graph.slots[slot as usize];
+            version.removed = 0;
+            let (node, previous) = (version.node, version.previous);
+            match previous {
+                Some(previous) => graph.latest.insert(node, previous),
+                None => graph.latest.remove(&node),
+            };
+        }
+        for slot in staged.removed {
+            graph.slots[slot as usize].removed = SEQ_OPEN;
+        }
+        if staged.dim_set {
+            graph.dim = None;
+        }
+    }
+
+    /// The vector of `node` in the snapshot with `seq`.
+    pub(crate) fn vector(&self, node: InternalNodeId, seq: u64) -> Option<Vec<f32>> {
+        let graph = self.graph.read().unwrap();
+        let slot = graph.visible_slot(node, seq)?;
+        Some(graph.slots[slot as usize].vector.to_vec())
+    }
+
+    /// Up to `k` nodes passing `accept` whose vectors in the snapshot with
+    /// `seq` are nearest to the unit vector `query`, nearest first.
+    pub(crate) fn search(
+        &self,
+        query: &[f32],
+        k: usize,
+        seq: u64,
+        mut accept: impl FnMut(InternalNodeId) -> bool,
+    ) -> Vec<(InternalNodeId, f32)> {
+        let graph = self.graph.read().unwrap();
+        let Some(entry) = graph.entry else {
+            return Vec::new();
+        };
+        if k == 0 || graph.dim != Some(query.len()) {
+            return Vec::new();
+        }
+        let mut current = Scored {
+            distance: graph.distance(query, entry),
+            slot: entry,
+        };
+        for layer in (1..graph.slots[entry as usize].links.len()).rev() {
+            current = graph.greedy(query, current, layer);
+        }
+        let mut hits: Vec<(InternalNodeId, f32)> = graph
+            .search_layer(query, &[current], HNSW_EF_SEARCH.max(k), 0, |slot| {
+                slot.visible_at(seq) && accept(slot.node)
+            })
+            .into_iter()
+            .map(|scored| (graph.slots[scored.slot as usize].node, scored.distance))
+            .collect();
+        hits.truncate(k);
+        hits
+    }
+
+    /// Exact top `k` among `nodes`, for filters too narrow for the graph walk.
+    pub(crate) fn search_among(
+        &self,
+        query: &[f32],
+        k: usize,
+        seq: u64,
+        nodes: impl IntoIterator<Item = InternalNodeId>,
+    ) -> Vec<(InternalNodeId, f32)> {
+        let graph = self.graph.read().unwrap();
+        if graph.dim != Some(query.len()) {
+            return Vec::new();
+        }
+        let mut hits: Vec<(InternalNodeId, f32)> = nodes
+            .into_iter()
+            .filter_map(|node| {
+                let slot = graph.visible_slot(node, seq)?;
+                Some((node, graph.distance(query, slot)))
+            })
+            .collect();
+        hits.sort_by(|a, b| a.1.total_cmp(&b.1).then(a.0.cmp(&b.0)));
+        hits.truncate(k);
+        hits
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::api::normalize_vector;
+
+    fn unit(seed: u32, dim: usize) -> Vec<f32> {
+        let mut state = u64::from(seed).wrapping_mul(0x9e37_79b9_7f4a_7c15) | 1;
+        let raw: Vec<f32> = (0..dim)
+            .map(|_| {
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                (state % 2001) as f32 - 1000.0
+            })
+            .collect();
+        normalize_vector(&raw).unwrap()
+    }
+
+    fn staged(index: &VectorIndex, puts: &[(u32, Vec<f32>)], removals: &[u32]) -> u64 {
+        let puts = puts.iter().cloned().collect();
+        let removals = removals.iter().copied().collect();
+        let (seq, _) = index.stage(&puts, &removals).unwrap();
+        index.publish();
+        seq
+    }
+
+    #[test]
+    fn search_matches_exact_top_k_on_small_sets() {
+        let index = VectorIndex::default();
+        let dim = 24;
+        let puts: Vec<(u32, Vec<f32>)> = (0..400).map(|node| (node, unit(node, dim))).collect();
+        let seq = staged(&index, &puts, &[]);
+        for probe in [3, 150, 399] {
+            let query = unit(probe * 7 + 1, dim);
+            let approx = index.search(&query, 10, seq, |_| true);
+            let exact = index.search_among(&query, 10, seq, 0..400);
+            let recalled = approx.iter().filter(|hit| exact.contains(hit)).count();
+            assert!(recalled >= 9, "recall {recalled}/10 for probe {probe}");
+        }
+        assert_eq!(index.search(&unit(5, dim), 1, seq, |_| true)[0].0, 5);
+    }
+
+    #[test]
+    fn slots_follow_snapshot_seq_and_abort_restores_versions() {
+        let index = VectorIndex::default();
+        let dim = 8;
+        let first = staged(&index, &[(1, unit(1, dim)), (2, unit(2, dim))], &[]);
+        let second = staged(&index, &[(1, unit(9, dim))], &[2]);
+
+        assert_eq!(index.vector(1, first), Some(unit(1, dim)));
+        assert_eq!(index.vector(1, second), Some(unit(9, dim)));
+        assert_eq!(index.vector(2, second), None);
+        assert_eq!(index.search(&unit(2, dim), 5, first, |_| true).len(), 2);
+        assert_eq!(index.search(&unit(2, dim), 5, second, |_| true).len(), 1);
+
+        let puts = [(1, unit(4, dim)), (3, unit(3, dim))].into_iter().collect();
+        let (seq, _) = index.stage(&puts, &BTreeSet::new()).unwrap();
+        index.abort();
+        assert_eq!(seq, second + 1);
+        assert_eq!(index.vector(1, seq), Some(unit(9, dim)));
+        assert_eq!(index.vector(3, seq), None);
+        assert!(index.has_vector(1) && !index.has_vector(3));
+
+        let wrong = [(4, unit(4, dim + 1))].into_iter().collect();
+        assert!(matches!(
+            index.stage(&wrong, &BTreeSet::new()),
+            Err(Error::InvalidVector(_))
+        ));
+    }
+
+    #[test]
+    fn vector_records_roundtrip() {
+        let vector = unit(3, 5);
+        assert_eq!(decode_vector(&encode_vector(2, &vector)), Some((2, vector)));
+        assert_eq!(decode_vector(&[0, 1, 2]), None);
+        assert_eq!(decode_vector(&[0]), None);
+    }
+}
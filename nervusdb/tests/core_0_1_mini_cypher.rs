@@ -1,4 +1,9 @@
-use nervusdb::query::{Params, Result as QueryResult, Value, prepare, query_collect};
+use nervusdb::query::ast::{Expression, FunctionCall, PropertyAccess};
+use nervusdb::query::executor::{Plan, execute_plan};
+use nervusdb::query::{
+    ExecuteOptions, Params, Result as QueryResult, Row, Value, WriteableGraph, prepare,
+    query_collect,
+};
 use nervusdb::{Db, GraphSnapshot, PropertyValue};
 use tempfile::tempdir;
 
@@ -264,6 +269,696 @@ fn core_0_1_property_equality_index_query_shapes() -> QueryResult<()> {
     Ok(())
 }
 
+#[test]
+fn core_0_1_property_range_index_query_shapes() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    seed_people(&db);
+
+    let names = |query: &str, params: &Params| -> QueryResult<Vec<PropertyValue>> {
+        let snapshot = db.snapshot();
+        let mut names: Vec<_> = query_collect(&snapshot, query, params)?
+            .iter()
+            .filter_map(|row| snapshot.node_property(row.get_node("n")?, "name"))
+            .collect();
+        names.sort_by_key(|name| format!("{name:?}"));
+        Ok(names)
+    };
+
+    assert_eq!(
+        names("MATCH (n:Person) WHERE n.age > 30 RETURN n", &Params::new())?,
+        vec![PropertyValue::String("Bob".to_string())]
+    );
+    assert_eq!(
+        names(
+            "MATCH (n:Person) WHERE 40 > n.age AND n.age >= 30 RETURN n",
+            &Params::new()
+        )?,
+        vec![
+            PropertyValue::String("Ada".to_string()),
+            PropertyValue::String("Alice".to_string()),
+        ]
+    );
+    assert_eq!(
+        names(
+            "MATCH (n:Person) WHERE n.name < 'B' RETURN n",
+            &Params::new()
+        )?,
+        vec![
+            PropertyValue::String("Ada".to_string()),
+            PropertyValue::String("Alice".to_string()),
+        ]
+    );
+
+    let mut params = Params::new();
+    params.insert("min", Value::Float(30.5));
+    assert_eq!(
+        names("MATCH (n:Person) WHERE n.age >= $min RETURN n", &params)?,
+        vec![PropertyValue::String("Bob".to_string())]
+    );
+    params.insert("min", Value::Null);
+    assert!(names("MATCH (n:Person) WHERE n.age >= $min RETURN n", &params)?.is_empty());
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (n:Person) WHERE n.age > 30 RETURN n",
+        &Params::new(),
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("property_range=(age"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_composite_index_query_shapes() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    seed_people(&db);
+    db.create_composite_index("Person", &["name", "age"])
+        .unwrap();
+
+    let mut params = Params::new();
+    params.insert("name", Value::String("Alice".to_string()));
+    params.insert("age", Value::Int(30));
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (n:Person {name: $name, age: $age}) RETURN n",
+        &params,
+    )?;
+    assert_eq!(rows.len(), 1);
+    let node = rows[0].get_node("n").expect("expected n binding");
+    assert_eq!(
+        db.snapshot().node_property(node, "name"),
+        Some(PropertyValue::String("Alice".to_string()))
+    );
+
+    params.insert("age", Value::Float(30.0));
+    let float_age = query_collect(
+        &db.snapshot(),
+        "MATCH (n:Person) WHERE n.name = $name AND n.age = $age RETURN n",
+        &params,
+    )?;
+    assert_eq!(float_age.len(), 1);
+
+    let none = query_collect(
+        &db.snapshot(),
+        "MATCH (n:Person) WHERE n.name = 'Ada' AND n.age = 40 RETURN n",
+        &Params::new(),
+    )?;
+    assert!(none.is_empty());
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (n:Person {name: $name, age: $age}) RETURN n",
+        &params,
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("composite_eq=[\"age\", \"name\"]"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_fulltext_predicates_anchor_node_scan() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    for query in [
+        "CREATE (n:Person {name: 'Alice', bio: 'Writes Rust storage engines'})",
+        "CREATE (n:Person {name: 'Bob', bio: 'Storage in rust, mostly'})",
+        "CREATE (n:Person {name: 'Ada', bio: 'Engines of analysis'})",
+    ] {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare(query)?.execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+    db.create_fulltext_index("Person", "bio").unwrap();
+
+    let names = |query: &str, params: &Params| -> QueryResult<Vec<Value>> {
+        let rows = query_collect(&db.snapshot(), query, params)?;
+        let mut names: Vec<Value> = rows
+            .iter()
+            .map(|row| row.get("name").cloned().unwrap_or(Value::Null))
+            .collect();
+        names.sort_by_key(|name| format!("{name:?}"));
+        Ok(names)
+    };
+    let mut params = Params::new();
+    params.insert("q", Value::String("RUST storage".to_string()));
+    assert_eq!(
+        names(
+            "MATCH (n:Person) WHERE textMatch(n.bio, $q) RETURN n.name AS name",
+            &params,
+        )?,
+        vec![
+            Value::String("Alice".to_string()),
+            Value::String("Bob".to_string()),
+        ]
+    );
+    assert_eq!(
+        names(
+            "MATCH (n:Person) WHERE textPhrase(n.bio, 'rust storage') AND n.name <> 'Bob' RETURN n.name AS name",
+            &Params::new(),
+        )?,
+        vec![Value::String("Alice".to_string())]
+    );
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (n:Person) WHERE textMatch(n.bio, $q) RETURN n",
+        &params,
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("text_search=(bio, terms="), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_edge_property_index_query_shapes() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    for query in [
+        "CREATE (a:Fn {name: 'main'})-[:CALLS {weight: 5}]->(b:Fn {name: 'parse'})",
+        "CREATE (a:Fn {name: 'run'})-[:CALLS {weight: 7}]->(b:Fn {name: 'exec'})",
+        "CREATE (a:Fn {name: 'init'})-[:LOADS {weight: 5}]->(b:Fn {name: 'config'})",
+    ] {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare(query)?.execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a)-[r:CALLS]->(b) WHERE r.weight = 5 RETURN a.name, b.name",
+        &Params::new(),
+    )?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("main".to_string()));
+    assert_eq!(rows[0].columns()[1].1, Value::String("parse".to_string()));
+
+    let mut params = Params::new();
+    params.insert("weight", Value::Int(7));
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a {name: 'run'})-[r:CALLS {weight: $weight}]->(b) RETURN b.name",
+        &params,
+    )?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("exec".to_string()));
+
+    params.insert("weight", Value::Float(5.0));
+    let float_weight = query_collect(
+        &db.snapshot(),
+        "MATCH (a)-[r:CALLS]->(b) WHERE r.weight = $weight RETURN b",
+        &params,
+    )?;
+    assert_eq!(float_weight.len(), 1);
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (a)-[r:CALLS]->(b) WHERE r.weight = 5 RETURN b",
+        &Params::new(),
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("edge_eq=weight"), "{plan}");
+    assert!(!plan.contains("NodeScan"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_one_hop_match_starts_from_source_anchor() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    for query in [
+        "CREATE (a:Person {email: 'a@x'})-[:KNOWS]->(b:Person {email: 'b@x'})",
+        "CREATE (a:Person:Admin {email: 'c@x'})-[:KNOWS]->(b:Person {email: 'd@x'})",
+        "CREATE (a:Robot {email: 'a@x'})-[:KNOWS]->(b:Person {email: 'e@x'})",
+    ] {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare(query)?.execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+
+    let mut params = Params::new();
+    params.insert("e", Value::String("a@x".to_string()));
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:Person {email: $e})-[:KNOWS]->(b) RETURN b.email",
+        &params,
+    )?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("b@x".to_string()));
+
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:Person)-[:KNOWS]->(b) RETURN b.email",
+        &Params::new(),
+    )?;
+    assert_eq!(rows.len(), 2);
+
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:Person:Admin {email: 'c@x'})-[:KNOWS]->(b) RETURN b.email",
+        &Params::new(),
+    )?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("d@x".to_string()));
+
+    // A float never reaches the index; the filter still compares it.
+    params.insert("e", Value::Float(1.0));
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:Person {email: $e})-[:KNOWS]->(b) RETURN b",
+        &params,
+    )?;
+    assert!(rows.is_empty());
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (a:Person {email: $e})-[:KNOWS]->(b) RETURN b",
+        &Params::new(),
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("src_anchor=Person.email"), "{plan}");
+    assert!(!plan.contains("NodeScan"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_anchored_destination_reverses_first_hop() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    for query in [
+        "CREATE (a:Crate {name: 'cli'})-[:USES]->(b:Crate {name: 'serde'})",
+        "CREATE (a:Crate {name: 'web'})-[:USES]->(b:Crate {name: 'tokio'})",
+        "CREATE (a:App {name: 'site'})-[:USES]->(b:Crate {name: 'serde_json'})",
+    ] {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare(query)?.execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+    {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare("MATCH (a:App) WHERE a.name = 'site' MATCH (b:Crate) WHERE b.name = 'serde' CREATE (a)-[:USES]->(b)")?
+            .execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+
+    let mut params = Params::new();
+    params.insert("name", Value::String("serde".to_string()));
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a)-[r:USES]->(b:Crate {name: $name}) RETURN a.name, b.name",
+        &params,
+    )?;
+    let mut users: Vec<_> = rows
+        .iter()
+        .map(|row| {
+            assert_eq!(row.columns()[1].1, Value::String("serde".to_string()));
+            format!("{:?}", row.columns()[0].1)
+        })
+        .collect();
+    users.sort();
+    assert_eq!(users, vec!["String(\"cli\")", "String(\"site\")"]);
+
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:Crate)-[:USES]->(b:Crate) WHERE b.name = 'serde' RETURN a.name",
+        &Params::new(),
+    )?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("cli".to_string()));
+
+    let rows = query_collect(
+        &db.snapshot(),
+        "MATCH (a:App)-[:USES]->(b:Crate) RETURN b.name",
+        &Params::new(),
+    )?;
+    assert_eq!(rows.len(), 2);
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (a)-[:USES]->(b:Crate {name: $name}) RETURN a",
+        &Params::new(),
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("dst_anchor=Crate.name"), "{plan}");
+    assert!(!plan.contains("src_anchor"), "{plan}");
+    assert!(!plan.contains("NodeScan"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_multi_hop_match_starts_from_anchored_end() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    for query in [
+        "CREATE (a:App {name: 'site'})-[:USES]->(b:Crate {name: 'web'})-[:USES]->(c:Crate {name: 'serde'})",
+        "CREATE (a:App {name: 'cli'})-[:USES]->(b:Crate {name: 'args'})-[:USES]->(c:Crate {name: 'tokio'})",
+    ] {
+        let snapshot = db.snapshot();
+        let mut txn = db.begin_write();
+        prepare(query)?.execute_write(&snapshot, &mut txn, &Params::new())?;
+        txn.commit().unwrap();
+    }
+
+    let query = "MATCH (a)-[:USES]->(b)-[:USES]->(c:Crate {name: 'serde'}) RETURN a.name, b.name";
+    let rows = query_collect(&db.snapshot(), query, &Params::new())?;
+    assert_eq!(rows.len(), 1);
+    assert_eq!(rows[0].columns()[0].1, Value::String("site".to_string()));
+    assert_eq!(rows[0].columns()[1].1, Value::String("web".to_string()));
+
+    let explain = query_collect(&db.snapshot(), &format!("EXPLAIN {query}"), &Params::new())?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("src_anchor=Crate.name"), "{plan}");
+    assert!(
+        plan.lines().all(|line| line.contains("est_rows=")),
+        "{plan}"
+    );
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_doubly_anchored_chain_starts_from_the_cheaper_end() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    {
+        let mut txn = db.begin_write();
+        let person = txn.get_or_create_label("Person").unwrap();
+        let city = txn.get_or_create_label("City").unwrap();
+        let knows = txn.get_or_create_rel_type("KNOWS").unwrap();
+        let lives_in = txn.get_or_create_rel_type("LIVES_IN").unwrap();
+        let cities = [1000u64, 1001].map(|id| txn.create_node(id, city).unwrap());
+        txn.set_node_property(cities[0], "name".to_string(), "Oslo".into())
+            .unwrap();
+        txn.set_node_property(cities[1], "name".to_string(), "Rome".into())
+            .unwrap();
+        let mut people = Vec::new();
+        for i in 0..300u64 {
+            let node = txn.create_node(i + 1, person).unwrap();
+            let team = if i % 10 == 0 { "x" } else { "y" };
+            txn.set_node_property(node, "team".to_string(), team.into())
+                .unwrap();
+            txn.create_edge(node, lives_in, cities[(i % 2) as usize])
+                .unwrap();
+            people.push(node);
+        }
+        for (i, src) in people.iter().enumerate() {
+            txn.create_edge(*src, knows, people[(i + 1) % people.len()])
+                .unwrap();
+        }
+        txn.commit().unwrap();
+    }
+
+    // The optimizer prefers the equality on `a`, but two cities anchor fewer
+    // rows than a tenth of the people.
+    let query = "MATCH (a:Person {team: 'x'})-[:KNOWS]->(b)-[:LIVES_IN]->(c:City) RETURN c.name";
+    let rows = query_collect(&db.snapshot(), query, &Params::new())?;
+    assert_eq!(rows.len(), 30);
+    assert!(
+        rows.iter()
+            .all(|row| row.columns()[0].1 == Value::String("Rome".to_string()))
+    );
+
+    let explain = query_collect(&db.snapshot(), &format!("EXPLAIN {query}"), &Params::new())?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains("src_anchor=City"), "{plan}");
+    assert!(!plan.contains("src_anchor=Person"), "{plan}");
+
+    // The string API renders the same chosen plan as the EXPLAIN row.
+    let snapshot = db.snapshot();
+    let prepared = prepare(&format!("EXPLAIN {query}"))?;
+    assert_eq!(
+        prepared
+            .explain_string_for(&snapshot, &Params::new())
+            .as_ref(),
+        Some(plan)
+    );
+    assert_eq!(
+        prepare(query)?.explain_string_for(&snapshot, &Params::new()),
+        None
+    );
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_multi_label_match_intersects_labels() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    seed_people(&db);
+    {
+        let snapshot = db.snapshot();
+        let person = snapshot.resolve_label_id("Person").unwrap();
+        let people: Vec<_> = snapshot.nodes_with_label(person).collect();
+        let mut txn = db.begin_write();
+        let admin = txn.get_or_create_label("Admin").unwrap();
+        txn.add_node_label(people[0], admin).unwrap();
+        txn.add_node_label(people[2], admin).unwrap();
+        txn.commit().unwrap();
+    }
+
+    let admins = query_collect(
+        &db.snapshot(),
+        "MATCH (n:Person:Admin) RETURN n.name",
+        &Params::new(),
+    )?;
+    let mut names: Vec<_> = admins
+        .iter()
+        .map(|row| row.columns()[0].1.clone())
+        .collect();
+    names.sort_by_key(|value| format!("{value:?}"));
+    assert_eq!(
+        names,
+        vec![
+            Value::String("Ada".to_string()),
+            Value::String("Alice".to_string())
+        ]
+    );
+
+    let indexed = query_collect(
+        &db.snapshot(),
+        "MATCH (n:Admin:Person {name: 'Ada'}) RETURN n",
+        &Params::new(),
+    )?;
+    assert_eq!(indexed.len(), 1);
+
+    let explain = query_collect(
+        &db.snapshot(),
+        "EXPLAIN MATCH (n:Person:Admin) RETURN n",
+        &Params::new(),
+    )?;
+    let plan = match &explain[0].columns()[0].1 {
+        Value::String(plan) => plan,
+        other => panic!("expected plan string, got {other:?}"),
+    };
+    assert!(plan.contains(r#"labels=["Person", "Admin"]"#), "{plan}");
+    assert!(!plan.contains("Filter"), "{plan}");
+
+    Ok(())
+}
+
+#[test]
+fn core_0_1_batched_execution_matches_row_execution() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    {
+        let mut txn = db.begin_write();
+        let item = txn.get_or_create_label("Item").unwrap();
+        let next = txn.get_or_create_rel_type("NEXT").unwrap();
+        let mut nodes = Vec::new();
+        for i in 0..1500u64 {
+            let node = txn.create_node(i + 1, item).unwrap();
+            txn.set_node_property(node, "rank".to_string(), PropertyValue::Int((i % 7) as i64))
+                .unwrap();
+            nodes.push(node);
+        }
+        for (i, src) in nodes.iter().enumerate() {
+            for step in 1..=3 {
+                txn.create_edge(*src, next, nodes[(i + step) % nodes.len()])
+                    .unwrap();
+            }
+        }
+        txn.commit().unwrap();
+    }
+
+    let mut row_params = Params::with_execute_options(ExecuteOptions {
+        batch_rows: 0,
+        ..ExecuteOptions::default()
+    });
+    let mut batch_params = Params::new();
+    for params in [&mut row_params, &mut batch_params] {
+        params.insert("rank", Value::Int(2));
+    }
+    let snapshot = db.snapshot();
+    for query in [
+        "MATCH (a:Item)-[:NEXT]->(b) WHERE b.rank <> 0 AND a.rank < 5 RETURN a.rank, b.rank",
+        "MATCH (a:Item)-[r:NEXT]->(b)-[:NEXT]->(c) WHERE c.rank = $rank RETURN a, r, c.rank + 1 AS next_rank",
+        "MATCH (a:Item) WHERE toString(a.rank) = '3' RETURN a.rank, -a.rank AS negated",
+        "MATCH (a:Item)-[:NEXT]->(b) RETURN b LIMIT 100",
+    ] {
+        let rows = query_collect(&snapshot, query, &row_params)?;
+        let batched = query_collect(&snapshot, query, &batch_params)?;
+        assert!(rows.len() > 64, "{query}");
+        assert_eq!(rows, batched, "{query}");
+    }
+
+    Ok(())
+}
+
+/// Rows a query streams before its first error, and that error.
+fn rows_until_error(rows: impl Iterator<Item = QueryResult<Row>>) -> (Vec<Row>, Option<String>) {
+    let mut streamed = Vec::new();
+    for row in rows {
+        match row {
+            Ok(row) => streamed.push(row),
+            Err(err) => return (streamed, Some(err.to_string())),
+        }
+    }
+    (streamed, None)
+}
+
+#[test]
+fn core_0_1_batched_execution_fails_after_the_same_rows_as_row_execution() -> QueryResult<()> {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path()).unwrap();
+    {
+        let mut txn = db.begin_write();
+        let item = txn.get_or_create_label("Item").unwrap();
+        let next = txn.get_or_create_rel_type("NEXT").unwrap();
+        let mut nodes = Vec::new();
+        for i in 0..300u64 {
+            let node = txn.create_node(i + 1, item).unwrap();
+            txn.set_node_property(node, "rank".to_string(), PropertyValue::Int(i as i64))
+                .unwrap();
+            // Row 100 is inside the second batch, after rows that pass.
+            let flag = if i == 100 {
+                PropertyValue::Bool(true)
+            } else {
+                PropertyValue::String((i % 3).to_string())
+            };
+            txn.set_node_property(node, "flag".to_string(), flag)
+                .unwrap();
+            if i == 100 {
+                txn.set_node_property(node, "alt".to_string(), PropertyValue::Int(1))
+                    .unwrap();
+            }
+            nodes.push(node);
+        }
+        for (i, src) in nodes.iter().enumerate() {
+            for step in 1..=3 {
+                txn.create_edge(*src, next, nodes[(i + step) % nodes.len()])
+                    .unwrap();
+            }
+        }
+        txn.commit().unwrap();
+    }
+
+    let row_params = Params::with_execute_options(ExecuteOptions {
+        batch_rows: 0,
+        ..ExecuteOptions::default()
+    });
+    let batch_params = Params::new();
+    let snapshot = db.snapshot();
+
+    // `toInteger` rejects the boolean flag of row 100 in its runtime check.
+    for query in [
+        "MATCH (a:Item) WHERE toInteger(a.flag) > 0 RETURN a.rank",
+        "MATCH (a:Item) RETURN a.rank, toInteger(a.flag) AS flag",
+    ] {
+        let prepared = prepare(query)?;
+        let rows = rows_until_error(prepared.execute_streaming(&snapshot, &row_params));
+        let batched = rows_until_error(prepared.execute_streaming(&snapshot, &batch_params));
+        assert!(rows.0.len() > 64, "{query}");
+        assert!(rows.1.is_some(), "{query}");
+        assert_eq!(rows, batched, "{query}");
+    }
+
+    // Mini-Cypher cannot rebind a hop source to a non-node, so the plan is
+    // built directly: `coalesce(a.alt, a)` is the integer 1 on row 100.
+    let scan = Plan::NodeScan {
+        alias: "a".into(),
+        labels: vec!["Item".to_string()],
+        property_eq: None,
+        composite_eq: Vec::new(),
+        text_search: None,
+        property_range: None,
+        optional: false,
+    };
+    let source = Expression::FunctionCall(FunctionCall {
+        name: "coalesce".to_string(),
+        args: vec![
+            Expression::PropertyAccess(PropertyAccess {
+                variable: "a".to_string(),
+                property: "alt".to_string(),
+            }),
+            Expression::Variable("a".to_string()),
+        ],
+    });
+    let plan = Plan::MatchOut {
+        input: Some(Box::new(Plan::Project {
+            input: Box::new(scan),
+            projections: vec![("a".to_string(), source)],
+        })),
+        src_alias: "a".into(),
+        rels: vec!["NEXT".to_string()],
+        edge_alias: None,
+        edge_eq: None,
+        src_anchor: None,
+        dst_anchor: None,
+        dst_alias: "b".into(),
+        dst_labels: Vec::new(),
+        src_prebound: true,
+        limit: None,
+        project: Vec::new(),
+        project_external: false,
+        optional: false,
+        optional_unbind: Vec::new(),
+        path_alias: None,
+    };
+    let rows = rows_until_error(execute_plan(&snapshot, &plan, &row_params));
+    let batched = rows_until_error(execute_plan(&snapshot, &plan, &batch_params));
+    assert_eq!(rows.0.len(), 300);
+    assert_eq!(rows.1.as_deref(), Some("Variable a is not a node"));
+    assert_eq!(rows, batched);
+
+    Ok(())
+}
+
 #[test]
 fn core_0_1_one_hop_and_two_hop_traversal() {
     let dir = tempdir().unwrap();
@@ -110,3 +110,172 @@ fn core_0_1_rust_facade_write_snapshot_and_reopen() {
         Some(PropertyValue::Int(2024))
     );
 }
+
+#[test]
+fn core_0_1_csr_view_matches_lsm_snapshot_and_queries() {
+    use nervusdb::query::{Params, query_collect};
+
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path().join("graph")).unwrap();
+
+    let mut txn = db.begin_write();
+    let person = txn.get_or_create_label("Person").unwrap();
+    let knows = txn.get_or_create_rel_type("KNOWS").unwrap();
+    let likes = txn.get_or_create_rel_type("LIKES").unwrap();
+    let nodes = (0..64)
+        .map(|i| txn.create_node(i + 1, person).unwrap())
+        .collect::<Vec<_>>();
+    for (i, node) in nodes.iter().enumerate() {
+        txn.set_node_property(*node, "name".into(), format!("p{i}").into())
+            .unwrap();
+        txn.create_edge(*node, knows, nodes[(i + 1) % nodes.len()])
+            .unwrap();
+        txn.create_edge(*node, likes, nodes[(i * 7 + 3) % nodes.len()])
+            .unwrap();
+    }
+    txn.commit().unwrap();
+
+    // Edits on existing nodes stay as delta records until merged; the view
+    // must apply them.
+    let mut txn = db.begin_write();
+    txn.tombstone_edge(nodes[0], knows, nodes[1]).unwrap();
+    txn.create_edge(nodes[0], knows, nodes[5]).unwrap();
+    txn.tombstone_node(nodes[9]).unwrap();
+    txn.commit().unwrap();
+
+    let snapshot = db.snapshot();
+    let csr = snapshot.build_csr_view();
+    for node in &nodes {
+        for rel in [None, Some(knows), Some(likes)] {
+            assert_eq!(
+                csr.neighbors(*node, rel).collect::<Vec<_>>(),
+                snapshot.neighbors(*node, rel).collect::<Vec<_>>()
+            );
+            assert_eq!(
+                csr.incoming_neighbors(*node, rel).collect::<Vec<_>>(),
+                snapshot.incoming_neighbors(*node, rel).collect::<Vec<_>>()
+            );
+        }
+    }
+    assert_eq!(csr.edge_count(None), snapshot.edge_count(None));
+    assert_eq!(
+        csr.edge_count(Some(likes)),
+        snapshot.edge_count(Some(likes))
+    );
+    assert!(csr.neighbors(u32::MAX - 1, None).next().is_none());
+
+    let cypher = "MATCH (a:Person)-[:KNOWS]->(b)-[:KNOWS]->(c) WHERE a.name = 'p0' RETURN c.name";
+    let lsm_rows = query_collect(&snapshot, cypher, &Params::new()).unwrap();
+    let csr_rows = query_collect(&csr, cypher, &Params::new()).unwrap();
+    assert_eq!(csr_rows.len(), 1);
+    assert_eq!(
+        format!("{:?}", csr_rows[0].columns()),
+        format!("{:?}", lsm_rows[0].columns())
+    );
+
+    let mut txn = db.begin_write();
+    txn.create_edge(nodes[2], likes, nodes[3]).unwrap();
+    txn.commit().unwrap();
+    assert_eq!(
+        csr.edge_count(Some(likes)),
+        snapshot.edge_count(Some(likes))
+    );
+    assert_eq!(
+        db.build_csr_view().edge_count(Some(likes)),
+        snapshot.edge_count(Some(likes)) + 1
+    );
+}
+
+#[test]
+fn core_0_1_analyze_collects_statistics_and_commits_refresh_them() {
+    let dir = tempdir().unwrap();
+    let db = Db::open(dir.path().join("graph")).unwrap();
+    assert!(db.statistics().is_none());
+
+    let mut txn = db.begin_write();
+    let person = txn.get_or_create_label("Person").unwrap();
+    let knows = txn.get_or_create_rel_type("KNOWS").unwrap();
+    let mut people = Vec::new();
+    for (i, team) in ["a", "a", "b", "a"].into_iter().enumerate() {
+        let node = txn.create_node(i as u64 + 1, person).unwrap();
+        txn.set_node_property(node, "name".to_string(), format!("p{i}").into())
+            .unwrap();
+        txn.set_node_property(node, "team".to_string(), team.into())
+            .unwrap();
+        people.push(node);
+    }
+    for (src, dst) in [(0, 1), (0, 2), (0, 3), (1, 2)] {
+        txn.create_edge(people[src], knows, people[dst]).unwrap();
+    }
+    txn.commit().unwrap();
+    assert_eq!(db.snapshot().average_degree(person, knows, false), None);
+
+    let degrees = |statistics: &nervusdb::GraphStatistics, direction| {
+        statistics
+            .degrees
+            .iter()
+            .find(|degree| degree.direction == direction)
+            .map(|degree| (degree.edges, degree.nodes_by_degree.clone()))
+            .unwrap()
+    };
+    let property = |statistics: &nervusdb::GraphStatistics, key: &str| {
+        statistics
+            .properties
+            .iter()
+            .find(|property| property.key == key)
+            .cloned()
+            .unwrap()
+    };
+
+    let statistics = db.analyze().unwrap();
+    assert_eq!(statistics.labels[0].nodes, 4);
+    assert_eq!(statistics.rel_types[0].edges, 4);
+    // Out: p2 and p3 have none, p1 has 1, p0 has 3.
+    assert_eq!(
+        degrees(&statistics, nervusdb::DegreeDirection::Outgoing),
+        (4, vec![2, 1, 1])
+    );
+    assert_eq!(
+        degrees(&statistics, nervusdb::DegreeDirection::Incoming),
+        (4, vec![1, 2, 1])
+    );
+    let team = property(&statistics, "team");
+    assert_eq!((team.values, team.distinct), (4, 2));
+    assert_eq!(team.most_common[0].value, PropertyValue::from("a"));
+    assert_eq!(team.most_common[0].count, 3);
+    assert_eq!(property(&statistics, "name").distinct, 4);
+
+    let snapshot = db.snapshot();
+    assert_eq!(snapshot.average_degree(person, knows, false), Some(1.0));
+    assert_eq!(snapshot.property_distinct_count(person, "team"), Some(2));
+
+    let mut txn = db.begin_write();
+    let p4 = txn.create_node(5, person).unwrap();
+    txn.set_node_property(p4, "team".to_string(), "c".into())
+        .unwrap();
+    txn.create_edge(people[3], knows, p4).unwrap();
+    txn.tombstone_edge(people[0], knows, people[1]).unwrap();
+    txn.commit().unwrap();
+
+    let statistics = db.statistics().unwrap();
+    assert_eq!(statistics.labels[0].nodes, 5);
+    assert_eq!(statistics.rel_types[0].edges, 4);
+    // Out: p0 now has 2 and p3 has 1.
+    assert_eq!(
+        degrees(&statistics, nervusdb::DegreeDirection::Outgoing),
+        (4, vec![2, 2, 1])
+    );
+    assert_eq!(property(&statistics, "team").distinct, 3);
+    assert_eq!(db.snapshot().average_degree(person, knows, true), Some(0.8));
+
+    // p1's list is packed; the degree it moves from is read from its count
+    // header and pending deltas.
+    let mut txn = db.begin_write();
+    txn.create_edge(people[1], knows, p4).unwrap();
+    txn.commit().unwrap();
+    let statistics = db.statistics().unwrap();
+    assert_eq!(
+        degrees(&statistics, nervusdb::DegreeDirection::Outgoing),
+        (5, vec![2, 1, 2])
+    );
+}
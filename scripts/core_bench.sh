@@ -9,6 +9,7 @@ nodes=""
 degree=""
 iters=""
 write_iters=""
+supernode_degree=""
 custom=0
 
 while [[ $# -gt 0 ]]; do
@@ -19,6 +20,7 @@ while [[ $# -gt 0 ]]; do
     --degree) degree="$2"; custom=1; shift 2 ;;
     --iters) iters="$2"; custom=1; shift 2 ;;
     --write-iters) write_iters="$2"; custom=1; shift 2 ;;
+    --supernode-degree) supernode_degree="$2"; custom=1; shift 2 ;;
     *) echo "unknown arg: $1" >&2; exit 2 ;;
   esac
 done
@@ -28,11 +30,13 @@ if [[ "$mode" == "large" ]]; then
   degree="${degree:-5}"
   iters="${iters:-5000}"
   write_iters="${write_iters:-500}"
+  supernode_degree="${supernode_degree:-65536}"
 else
   nodes="${nodes:-1000}"
   degree="${degree:-5}"
   iters="${iters:-100}"
   write_iters="${write_iters:-20}"
+  supernode_degree="${supernode_degree:-4096}"
 fi
 
 out_dir="artifacts/core-bench"
@@ -47,7 +51,7 @@ fi
 out_file="$out_dir/core-bench-$label-$ts.json"
 log_file="$out_dir/core-bench-$label-$ts.log"
 
-echo "[core-bench] mode=$mode label=$label nodes=$nodes degree=$degree iters=$iters write_iters=$write_iters"
+echo "[core-bench] mode=$mode label=$label nodes=$nodes degree=$degree iters=$iters write_iters=$write_iters supernode_degree=$supernode_degree"
 echo "[core-bench] output=$out_file"
 
 set +e
@@ -56,6 +60,7 @@ cargo run --example bench_v2 -p nervusdb --release -- \
   --degree "$degree" \
   --iters "$iters" \
   --write-iters "$write_iters" \
+  --supernode-degree "$supernode_degree" \
   2>&1 | tee "$log_file"
 rc=${PIPESTATUS[0]}
 set -e
@@ -89,7 +94,18 @@ for field in \
   property_lookup_rows \
   property_lookup_scan_p99_us \
   property_lookup_index_p99_us \
-  property_lookup_speedup
+  property_lookup_speedup \
+  supernode_commit_p99_us \
+  stage_csr_build_ms \
+  two_hop_lsm_paths_per_sec \
+  two_hop_csr_paths_per_sec \
+  two_hop_csr_speedup \
+  three_hop_lsm_paths_per_sec \
+  three_hop_csr_paths_per_sec \
+  three_hop_csr_speedup \
+  pipeline_row_rows_per_sec \
+  pipeline_batch_rows_per_sec \
+  pipeline_batch_speedup
 do
   if [[ "$json_line" != *"\"$field\":"* ]]; then
     echo "[core-bench] missing JSON field: $field" >&2
@@ -7,12 +7,11 @@ cd "$ROOT_DIR"
 TMP_DIR="$(mktemp -d "${TMPDIR:-/tmp}/nervusdb-core-crash.XXXXXX")"
 trap 'rm -rf "$TMP_DIR"' EXIT
 
-DB_PATH="$TMP_DIR/core-crash"
-
 iterations=5
 batch=64
 node_pool=64
 rel_pool=8
+modes="sync-all sync-data buffered periodic"
 
 while [[ $# -gt 0 ]]; do
   case "$1" in
@@ -20,21 +19,34 @@ while [[ $# -gt 0 ]]; do
     --batch) batch="$2"; shift 2 ;;
     --node-pool) node_pool="$2"; shift 2 ;;
     --rel-pool) rel_pool="$2"; shift 2 ;;
+    --durability) modes="$2"; shift 2 ;;
     *) echo "unknown arg: $1" >&2; exit 2 ;;
   esac
 done
 
-echo "[core-crash] iterations=$iterations batch=$batch node_pool=$node_pool rel_pool=$rel_pool"
-cargo run -p nervusdb-storage --bin nervusdb-v2-crash-test -- \
-  driver "$DB_PATH" \
-  --iterations "$iterations" \
-  --min-ms 2 \
-  --max-ms 8 \
-  --batch "$batch" \
-  --node-pool "$node_pool" \
-  --rel-pool "$rel_pool" \
-  --verify-retries 20 \
-  --verify-backoff-ms 10
+for mode in $modes; do
+  # Periodic commits only count once two flush intervals have passed, so its
+  # writers run long enough for some to.
+  if [[ "$mode" == "periodic" ]]; then
+    min_ms=150
+    max_ms=300
+  else
+    min_ms=2
+    max_ms=8
+  fi
+  echo "[core-crash] durability=$mode iterations=$iterations batch=$batch node_pool=$node_pool rel_pool=$rel_pool"
+  cargo run -p nervusdb-storage --bin nervusdb-v2-crash-test -- \
+    driver "$TMP_DIR/core-crash-$mode" \
+    --iterations "$iterations" \
+    --min-ms "$min_ms" \
+    --max-ms "$max_ms" \
+    --batch "$batch" \
+    --node-pool "$node_pool" \
+    --rel-pool "$rel_pool" \
+    --durability "$mode" \
+    --flush-ms 50 \
+    --verify-retries 20 \
+    --verify-backoff-ms 10
+done
 
 echo "[core-crash] ok"
-
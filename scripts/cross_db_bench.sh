@@ -10,6 +10,7 @@ degree=""
 iters=""
 mutation_iters=""
 seed="1"
+nervusdb_load="txn"
 systems=("nervusdb" "sqlite-simple" "sqlite-materialized")
 custom=0
 
@@ -23,6 +24,7 @@ while [[ $# -gt 0 ]]; do
     --iters) iters="$2"; custom=1; shift 2 ;;
     --mutation-iters) mutation_iters="$2"; custom=1; shift 2 ;;
     --seed) seed="$2"; shift 2 ;;
+    --nervusdb-load) nervusdb_load="$2"; shift 2 ;;
     *) echo "unknown arg: $1" >&2; exit 2 ;;
   esac
 done
@@ -52,7 +54,7 @@ fi
 summary_file="$out_dir/cross-db-bench-$label-$ts.ndjson"
 : >"$summary_file"
 
-echo "[cross-db-bench] mode=$mode label=$label nodes=$nodes degree=$degree iters=$iters mutation_iters=$mutation_iters seed=$seed"
+echo "[cross-db-bench] mode=$mode label=$label nodes=$nodes degree=$degree iters=$iters mutation_iters=$mutation_iters seed=$seed nervusdb_load=$nervusdb_load"
 echo "[cross-db-bench] summary=$summary_file"
 
 for system in "${systems[@]}"; do
@@ -68,6 +70,7 @@ for system in "${systems[@]}"; do
     --iters "$iters" \
     --mutation-iters "$mutation_iters" \
     --seed "$seed" \
+    --nervusdb-load "$nervusdb_load" \
     2>&1 | tee "$log_file"
   rc=${PIPESTATUS[0]}
   set -e